@@ -214,9 +214,28 @@ class Formatter {
 public:
   virtual ~Formatter() {}
 
+  /**
+   * Return a formatted access log line.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param request_info supplies additional information about the request.
+   * @return std::string the formatted line.
+   */
   virtual std::string format(const Http::HeaderMap& request_headers,
                              const Http::HeaderMap& response_headers,
                              const RequestInfo& request_info) const PURE;
+
+  /**
+   * Append a formatted access log line to an existing buffer. Unlike format() this does not
+   * create a temporary string, so a caller that reuses the buffer does not allocate per line.
+   * @param request_headers supplies the request headers.
+   * @param response_headers supplies the response headers.
+   * @param request_info supplies additional information about the request.
+   * @param output supplies the buffer to append to.
+   */
+  virtual void appendTo(const Http::HeaderMap& request_headers,
+                        const Http::HeaderMap& response_headers, const RequestInfo& request_info,
+                        std::string& output) const PURE;
 };
 
 typedef std::unique_ptr<Formatter> FormatterPtr;
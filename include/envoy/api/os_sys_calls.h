@@ -3,6 +3,7 @@
 #include <sys/mman.h>   // for mode_t
 #include <sys/socket.h> // for sockaddr
 #include <sys/stat.h>
+#include <sys/uio.h> // for iovec
 
 #include <memory>
 #include <string>
@@ -33,6 +34,12 @@ public:
    */
   virtual ssize_t write(int fd, const void* buffer, size_t num_bytes) PURE;
 
+  /**
+   * Write iovcnt buffers to fd in a single call.
+   * @return number of bytes written if non negative, otherwise error code.
+   */
+  virtual ssize_t writev(int fd, const iovec* iov, int iovcnt) PURE;
+
   /**
    * Release all resources allocated for fd.
    * @return zero on success, -1 returned otherwise.
@@ -18,6 +18,31 @@ struct RawSlice {
   size_t len_ = 0;
 };
 
+/**
+ * A memory region which is added to a buffer without being copied. The buffer references the
+ * memory until the data is drained (or moved out of every buffer it was moved into), at which
+ * point done() is called. The memory must stay valid and unchanged until then.
+ */
+class BufferFragment {
+public:
+  virtual ~BufferFragment() {}
+
+  /**
+   * @return a pointer to the referenced data.
+   */
+  virtual const void* data() const PURE;
+
+  /**
+   * @return the size of the referenced data.
+   */
+  virtual size_t size() const PURE;
+
+  /**
+   * Called once no buffer references the data any more.
+   */
+  virtual void done() PURE;
+};
+
 /**
  * A basic buffer abstraction.
  */
@@ -44,6 +69,13 @@ public:
    */
   virtual void add(const Instance& data) PURE;
 
+  /**
+   * Add a reference to external memory to the end of the buffer, without copying it.
+   * @param fragment supplies the memory to reference. It must outlive the buffer's use of it,
+   *        which ends when fragment.done() is called.
+   */
+  virtual void addBufferFragment(BufferFragment& fragment) PURE;
+
   /**
    * Commit a set of slices originally obtained from reserve(). The number of slices can be
    * different from the number obtained from reserve(). The size of each slice can also be altered.
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/event/file_event.h"
 #include "envoy/event/signal.h"
 #include "envoy/event/timer.h"
@@ -116,6 +117,11 @@ public:
                     Network::ListenSocket& socket, Network::ListenerCallbacks& cb,
                     Stats::Scope& scope, const Network::ListenerOptions& listener_options) PURE;
 
+  /**
+   * @return MonotonicTimeSource& the monotonic clock read by code running on this dispatcher.
+   */
+  virtual MonotonicTimeSource& timeSource() PURE;
+
   /**
    * Allocate a timer. @see Event::Timer for docs on how to use the timer.
    * @param cb supplies the callback to invoke when the timer fires.
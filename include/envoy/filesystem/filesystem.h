@@ -10,6 +10,22 @@
 namespace Envoy {
 namespace Filesystem {
 
+/**
+ * What a file does with a write when the buffer of the writing thread is full because the flush
+ * thread has fallen behind.
+ */
+enum class WriteOverflowPolicy {
+  // Queue the write in an unbounded buffer under a lock. Nothing is lost and the writing thread
+  // never waits for the disk, but memory grows while the flush thread is behind.
+  Spill,
+  // Wait for the flush thread to make room. Nothing is lost, but the writing thread stalls.
+  Block,
+  // Drop the write.
+  Drop,
+  // Once the buffer is half full keep only a sample of writes, and drop writes when it is full.
+  Sample
+};
+
 /**
  * Abstraction for a file on disk.
  */
@@ -181,6 +181,9 @@ struct Http1Settings {
   // Enable codec to parse absolute uris. This enables forward/explicit proxy support for non TLS
   // traffic
   bool allow_absolute_url_{false};
+  // Let the server codec parse whole requests in the common form with Http1::RequestParser before
+  // falling back to http_parser.
+  bool fast_request_parser_{false};
 };
 
 /**
@@ -5,11 +5,76 @@
 #include <string>
 
 #include "envoy/common/exception.h"
+#include "envoy/network/address.h"
 #include "envoy/network/connection.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * A listener which can be handed connections accepted by the listeners of other threads.
+ */
+class BalancedListener {
+public:
+  virtual ~BalancedListener() {}
+
+  /**
+   * @return uint64_t the number of connections owned by the thread of the listener, including
+   *         connections which were handed to the listener but not yet created. May be called from
+   *         any thread.
+   */
+  virtual uint64_t numConnections() PURE;
+
+  /**
+   * Hand an accepted connection to the listener. The connection is created on the thread of the
+   * listener. May be called from any thread.
+   * @param fd supplies the accepted socket.
+   * @param remote_address supplies the remote address of the connection.
+   * @param local_address supplies the local address of the connection.
+   * @param using_original_dst supplies whether the local address is the original destination.
+   */
+  virtual void post(int fd, Address::InstanceConstSharedPtr remote_address,
+                    Address::InstanceConstSharedPtr local_address, bool using_original_dst) PURE;
+};
+
+/**
+ * Spreads the connections accepted by the listeners of one listener configuration, which run on
+ * different threads, across those listeners.
+ */
+class ConnectionBalancer {
+public:
+  virtual ~ConnectionBalancer() {}
+
+  /**
+   * Add a listener which connections may be handed to. Called on the thread of the listener.
+   */
+  virtual void registerListener(BalancedListener& listener) PURE;
+
+  /**
+   * Remove a listener. Once this returns, no more connections are handed to the listener. Called
+   * on the thread of the listener.
+   */
+  virtual void unregisterListener(BalancedListener& listener) PURE;
+
+  /**
+   * Hand a connection accepted by a listener to the least loaded listener, if that is not the
+   * accepting listener.
+   * @param listener supplies the listener which accepted the connection.
+   * @param fd supplies the accepted socket.
+   * @param remote_address supplies the remote address of the connection.
+   * @param local_address supplies the local address of the connection.
+   * @param using_original_dst supplies whether the local address is the original destination.
+   * @return bool whether the connection was handed to another listener. If not, the accepting
+   *         listener creates the connection.
+   */
+  virtual bool balanceConnection(BalancedListener& listener, int fd,
+                                 Address::InstanceConstSharedPtr remote_address,
+                                 Address::InstanceConstSharedPtr local_address,
+                                 bool using_original_dst) PURE;
+};
+
+typedef std::unique_ptr<ConnectionBalancer> ConnectionBalancerPtr;
+
 /**
  * Listener configurations options.
  */
@@ -25,6 +90,13 @@ struct ListenerOptions {
   bool use_original_dst_;
   // Soft limit on size of the listener's new connection read and write buffers.
   uint32_t per_connection_buffer_limit_bytes_;
+  // Maximum number of connections accepted each time the listen socket becomes readable, or 0 to
+  // accept until the accept queue is empty. Connections left in the queue are accepted on the next
+  // iteration of the event loop, after the other ready events.
+  uint32_t accept_batch_size_;
+  // If not null, the balancer which may hand accepted connections to the listeners of other
+  // threads. Not owned by the listener.
+  ConnectionBalancer* connection_balancer_;
 
   /**
    * Factory for ListenerOptions with bind_to_port_ set.
@@ -34,7 +106,9 @@ struct ListenerOptions {
     return {.bind_to_port_ = true,
             .use_proxy_proto_ = false,
             .use_original_dst_ = false,
-            .per_connection_buffer_limit_bytes_ = 0};
+            .per_connection_buffer_limit_bytes_ = 0,
+            .accept_batch_size_ = 0,
+            .connection_balancer_ = nullptr};
   }
 };
 
@@ -30,6 +30,31 @@ public:
 
 typedef std::unique_ptr<RandomGenerator> RandomGeneratorPtr;
 
+/**
+ * Handle to a runtime key registered with Loader::registerKey(). Snapshots resolve the values of
+ * all registered keys when they are loaded, so a lookup by handle is an array read rather than a
+ * hash of the key name. A handle may only be used with snapshots of the loader that returned it.
+ */
+class Key {
+public:
+  Key() {}
+  Key(const std::string& name, uint32_t index) : name_(name), index_(index) {}
+
+  /**
+   * @return const std::string& the name of the runtime key.
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * @return uint32_t the index of the key in the registry of its loader.
+   */
+  uint32_t index() const { return index_; }
+
+private:
+  std::string name_;
+  uint32_t index_{UINT32_MAX};
+};
+
 /**
  * A snapshot of runtime data.
  */
@@ -96,6 +121,16 @@ public:
    * @return uint64_t the runtime value or the default value.
    */
   virtual uint64_t getInteger(const std::string& key, uint64_t default_value) const PURE;
+
+  /**
+   * Variants of the lookups above which take a registered key. @see Loader::registerKey().
+   */
+  virtual bool featureEnabled(const Key& key, uint64_t default_value) const PURE;
+  virtual bool featureEnabled(const Key& key, uint64_t default_value,
+                              uint64_t random_value) const PURE;
+  virtual bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                              uint16_t num_buckets) const PURE;
+  virtual uint64_t getInteger(const Key& key, uint64_t default_value) const PURE;
 };
 
 /**
@@ -111,6 +146,17 @@ public:
    *         fetched again when needed.
    */
   virtual Snapshot& snapshot() PURE;
+
+  /**
+   * Register a runtime key which is looked up on a hot path. Keys should be registered at
+   * configuration time. Registering a key name more than once returns the same handle. This
+   * routine is thread safe.
+   * @param name supplies the name of the runtime key.
+   * @return Key a handle that can be used in place of the name with any snapshot of this loader.
+   *         Until the loader has resolved a newly registered key in a new snapshot, the key is
+   *         looked up by name.
+   */
+  virtual Key registerKey(const std::string& name) PURE;
 };
 
 typedef std::unique_ptr<Loader> LoaderPtr;
@@ -5,6 +5,7 @@
 
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/ssl/session_cache.h"
 
 namespace Envoy {
 namespace Server {
@@ -39,9 +40,15 @@ public:
    * Retrieve a listening socket on the specified address from the parent process. The socket will
    * be duplicated across process boundaries.
    * @param address supplies the address of the socket to duplicate, e.g. tcp://127.0.0.1:5000.
+   * @param worker_index supplies the worker the socket is for, if the listener has a socket for
+   *        each worker. A listener with a single socket returns it for any worker.
+   * @param parent_sockets supplies where to store the number of sockets the parent's listener on
+   *        the address has: one per parent worker if it uses SO_REUSEPORT, otherwise one. Zero if
+   *        there is no such listener in the parent.
    * @return int the fd or -1 if there is no bound listen port in the parent.
    */
-  virtual int duplicateParentListenSocket(const std::string& address) PURE;
+  virtual int duplicateParentListenSocket(const std::string& address, uint32_t worker_index,
+                                          uint32_t& parent_sockets) PURE;
 
   /**
    * Retrieve stats from our parent process.
@@ -78,6 +85,11 @@ public:
    * perform a full or hot restart.
    */
   virtual std::string version() PURE;
+
+  /**
+   * @return the TLS session cache which outlives hot restarts, or nullptr if there is none.
+   */
+  virtual Ssl::SessionCache* sslSessionCache() PURE;
 };
 
 } // namespace Server
@@ -2,6 +2,7 @@
 
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
+#include "envoy/network/listener.h"
 #include "envoy/server/drain_manager.h"
 #include "envoy/server/filter_config.h"
 #include "envoy/server/guarddog.h"
@@ -30,6 +31,17 @@ public:
   virtual Network::ListenSocketSharedPtr
   createListenSocket(Network::Address::InstanceConstSharedPtr address, bool bind_to_port) PURE;
 
+  /**
+   * Creates a bound socket with SO_REUSEPORT set, one of the sockets of a listener which has a
+   * socket for each worker.
+   * @param address supplies the socket's address.
+   * @param worker_index supplies the index of the worker the socket is for.
+   * @return Network::ListenSocketSharedPtr an initialized and bound socket.
+   */
+  virtual Network::ListenSocketSharedPtr
+  createReusePortListenSocket(Network::Address::InstanceConstSharedPtr address,
+                              uint32_t worker_index) PURE;
+
   /**
    * Creates a list of filter factories.
    * @param filters supplies the proto configuration.
@@ -71,6 +83,14 @@ public:
    */
   virtual Network::ListenSocket& socket() PURE;
 
+  /**
+   * @param worker_index supplies the index of a worker.
+   * @return Network::ListenSocket* the socket the worker accepts connections on. This is socket(),
+   *         unless the listener has a SO_REUSEPORT socket for each worker. In that case, nullptr
+   *         if the listener has no socket for worker_index.
+   */
+  virtual Network::ListenSocket* workerSocket(uint32_t worker_index) PURE;
+
   /**
    * @return Ssl::ServerContext* the default SSL context.
    */
@@ -101,6 +121,19 @@ public:
    */
   virtual uint32_t perConnectionBufferLimitBytes() PURE;
 
+  /**
+   * @return uint32_t the maximum number of connections accepted each time the listen socket
+   *         becomes readable, or 0 to accept until the accept queue is empty.
+   */
+  virtual uint32_t acceptBatchSize() PURE;
+
+  /**
+   * @return Network::ConnectionBalancer* the balancer which spreads the connections accepted by
+   *         the listener across workers, or nullptr if each worker keeps the connections it
+   *         accepts.
+   */
+  virtual Network::ConnectionBalancer* connectionBalancer() PURE;
+
   /**
    * @return Stats::Scope& the stats scope to use for all listener specific stats.
    */
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "envoy/common/pure.h"
+#include "envoy/filesystem/filesystem.h"
 #include "envoy/network/address.h"
 
 #include "spdlog/spdlog.h"
@@ -112,6 +113,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() PURE;
 
+  /**
+   * @return Filesystem::WriteOverflowPolicy what to do with log writes when the flush thread falls
+   *         behind.
+   */
+  virtual Filesystem::WriteOverflowPolicy fileOverflowPolicy() PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
@@ -137,6 +144,30 @@ public:
    * router/cluster/listener.
    */
   virtual uint64_t maxObjNameLength() PURE;
+
+  /**
+   * @return uint64_t the number of TLS sessions kept in the session cache shared by all server
+   * contexts, or 0 for each context to keep its own cache.
+   */
+  virtual uint64_t sslSessionCacheSize() PURE;
+
+  /**
+   * @return bool whether each worker accepts connections on a SO_REUSEPORT socket of its own,
+   * rather than all workers accepting on one socket per listener.
+   */
+  virtual bool listenerReusePort() PURE;
+
+  /**
+   * @return uint32_t the maximum number of connections a listener accepts each time its socket
+   * becomes readable, or 0 to accept until the accept queue is empty.
+   */
+  virtual uint32_t listenerAcceptBatchSize() PURE;
+
+  /**
+   * @return bool whether listeners hand accepted connections to the worker with the fewest
+   * connections.
+   */
+  virtual bool listenerBalanceConnections() PURE;
 };
 
 } // namespace Server
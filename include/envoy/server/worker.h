@@ -80,9 +80,10 @@ public:
   virtual ~WorkerFactory() {}
 
   /**
+   * @param index supplies the index of the worker, which identifies it in per worker stats.
    * @return WorkerPtr a new worker.
    */
-  virtual WorkerPtr createWorker() PURE;
+  virtual WorkerPtr createWorker(uint32_t index) PURE;
 };
 
 } // namespace Server
@@ -103,6 +103,13 @@ public:
    * are candidates for decrypting received tickets.
    */
   virtual const std::vector<SessionTicketKey>& sessionTicketKeys() const PURE;
+
+  /**
+   * @return The files the session ticket keys were read from, in the order of
+   * sessionTicketKeys(). Empty if any key was given inline, in which case the
+   * keys are never reloaded.
+   */
+  virtual const std::vector<std::string>& sessionTicketKeyPaths() const PURE;
 };
 
 } // namespace Ssl
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * A cache of serialized TLS sessions keyed by session ID, which server contexts use to resume
+ * sessions of clients that do not offer a session ticket. A single cache is shared by all server
+ * contexts and worker threads, so implementations must be thread safe. A cache may drop any session
+ * at any time.
+ */
+class SessionCache {
+public:
+  virtual ~SessionCache() {}
+
+  /**
+   * Add a session, replacing any session with the same ID.
+   * @param id supplies the session ID.
+   * @param id_length supplies the length of the session ID.
+   * @param session supplies the serialized session.
+   * @param session_length supplies the length of the serialized session.
+   * @param expire_time supplies when the session expires, in seconds since the epoch. Sessions
+   *        which expire first are evicted first.
+   * @return bool whether the session was added.
+   */
+  virtual bool insert(const uint8_t* id, size_t id_length, const uint8_t* session,
+                      size_t session_length, uint64_t expire_time) PURE;
+
+  /**
+   * Find a session.
+   * @param id supplies the session ID.
+   * @param id_length supplies the length of the session ID.
+   * @param session supplies the buffer the serialized session is copied to.
+   * @return bool whether the session was found.
+   */
+  virtual bool lookup(const uint8_t* id, size_t id_length,
+                      std::vector<uint8_t>& session) const PURE;
+
+  /**
+   * Remove a session, if it is present.
+   * @param id supplies the session ID.
+   * @param id_length supplies the length of the session ID.
+   */
+  virtual void remove(const uint8_t* id, size_t id_length) PURE;
+};
+
+typedef std::unique_ptr<SessionCache> SessionCachePtr;
+
+} // namespace Ssl
+} // namespace Envoy
@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/stats/symbol_table.h"
 
 namespace Envoy {
 namespace Event {
@@ -135,6 +136,62 @@ public:
 
 typedef std::shared_ptr<Histogram> HistogramSharedPtr;
 
+/**
+ * Summary statistics computed from the values recorded by a histogram.
+ */
+class HistogramStatistics {
+public:
+  virtual ~HistogramStatistics() {}
+
+  /**
+   * @return the quantiles for which values are computed, in increasing order, each in [0, 1].
+   */
+  virtual const std::vector<double>& supportedQuantiles() const PURE;
+
+  /**
+   * @return the value at each of supportedQuantiles(). Values are approximate, with an error of at
+   *         most a few percent. If there are no samples the values are NaN.
+   */
+  virtual const std::vector<double>& computedQuantiles() const PURE;
+
+  /**
+   * @return the number of values the statistics were computed from.
+   */
+  virtual uint64_t sampleCount() const PURE;
+
+  /**
+   * @return a human readable summary of the quantiles, e.g. "P50: 3, P99: 25".
+   */
+  virtual std::string summary() const PURE;
+};
+
+/**
+ * A histogram which keeps the distribution of the values recorded, typically by merging values
+ * recorded on each thread. The distribution is summarized on merge().
+ */
+class ParentHistogram : public Histogram {
+public:
+  virtual ~ParentHistogram() {}
+
+  /**
+   * Merge the values recorded since the last merge into the interval and cumulative statistics.
+   * This is called on the main thread when stats are flushed.
+   */
+  virtual void merge() PURE;
+
+  /**
+   * @return statistics for the values recorded between the last two calls to merge().
+   */
+  virtual const HistogramStatistics& intervalStatistics() const PURE;
+
+  /**
+   * @return statistics for all the values recorded up to the last call to merge().
+   */
+  virtual const HistogramStatistics& cumulativeStatistics() const PURE;
+};
+
+typedef std::shared_ptr<ParentHistogram> ParentHistogramSharedPtr;
+
 /**
  * A sink for stats. Each sink is responsible for writing stats to a backing store.
  */
@@ -168,6 +225,12 @@ public:
    * Flush a histogram value.
    */
   virtual void onHistogramComplete(const Histogram& histogram, uint64_t value) PURE;
+
+  /**
+   * Flush the summary of a histogram's distribution. This will be called between beginFlush() and
+   * endFlush(), after the histogram has been merged.
+   */
+  virtual void flushHistogram(const ParentHistogram& histogram) PURE;
 };
 
 typedef std::unique_ptr<Sink> SinkPtr;
@@ -210,6 +273,28 @@ public:
    * @return a histogram within the scope's namespace with a particular value type.
    */
   virtual Histogram& histogram(const std::string& name) PURE;
+
+  /**
+   * @return the table that names passed to counterFromStatName(), gaugeFromStatName() and
+   *         histogramFromStatName() must be encoded in. All scopes of a store share the table.
+   */
+  virtual SymbolTable& symbolTable() PURE;
+
+  /**
+   * @return a counter within the scope's namespace. This is the same counter as counter() returns
+   *         for the decoded name, but it can be looked up without building or hashing a string.
+   */
+  virtual Counter& counterFromStatName(const StatName& name) PURE;
+
+  /**
+   * @return a gauge within the scope's namespace. See counterFromStatName().
+   */
+  virtual Gauge& gaugeFromStatName(const StatName& name) PURE;
+
+  /**
+   * @return a histogram within the scope's namespace. See counterFromStatName().
+   */
+  virtual Histogram& histogramFromStatName(const StatName& name) PURE;
 };
 
 /**
@@ -226,6 +311,11 @@ public:
    * @return a list of all known gauges.
    */
   virtual std::list<GaugeSharedPtr> gauges() const PURE;
+
+  /**
+   * @return a list of all known histograms which keep their distribution.
+   */
+  virtual std::list<ParentHistogramSharedPtr> histograms() const PURE;
 };
 
 typedef std::unique_ptr<Store> StorePtr;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * A stat name interned in a SymbolTable. Each '.' separated token of the name is replaced by a
+ * symbol shared by every name containing that token, so hashing or comparing an interned name only
+ * touches a handful of integers. A StatName holds a reference on each of its symbols for as long
+ * as it exists, so it must be destroyed before the table it was encoded in.
+ */
+class StatName {
+public:
+  virtual ~StatName() {}
+
+  /**
+   * @return std::string the name decoded from its table.
+   */
+  virtual std::string toString() const PURE;
+};
+
+typedef std::unique_ptr<StatName> StatNamePtr;
+
+/**
+ * Thread safe table of interned stat name tokens.
+ */
+class SymbolTable {
+public:
+  virtual ~SymbolTable() {}
+
+  /**
+   * Intern a stat name. This takes a lock, so callers should encode the names they charge per
+   * request once, when they are configured, and keep the result.
+   * @param name supplies the stat name.
+   * @return StatNamePtr the interned name.
+   */
+  virtual StatNamePtr encode(const std::string& name) PURE;
+};
+
+} // namespace Stats
+} // namespace Envoy
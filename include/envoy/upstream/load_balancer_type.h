@@ -14,7 +14,15 @@ namespace Upstream {
 /**
  * Type of load balancing to perform.
  */
-enum class LoadBalancerType { RoundRobin, LeastRequest, Random, RingHash, OriginalDst };
+enum class LoadBalancerType { RoundRobin, LeastRequest, Random, RingHash, OriginalDst, Maglev };
+
+/**
+ * Cluster lb_policy value which selects LoadBalancerType::Maglev. The pinned envoy_api Cluster proto
+ * has no MAGLEV enumerator yet, so this is the value the enumerator is given upstream. Proto3 enums
+ * keep values they do not know about, so it survives parsing and copying unchanged.
+ */
+constexpr envoy::api::v2::Cluster::LbPolicy MaglevLbPolicy =
+    static_cast<envoy::api::v2::Cluster::LbPolicy>(5);
 
 /**
  * Load Balancer subset configuration.
@@ -175,6 +175,18 @@ public:
    */
   virtual const std::vector<std::vector<HostSharedPtr>>& healthyHostsPerLocality() const PURE;
 
+  /**
+   * Shared pointer versions of the host lists. A list is never modified once it has been passed to
+   * updateHosts(), updates replace it instead, so the lists can be shared with other host sets
+   * (e.g. the per worker copies of a cluster) without copying.
+   * @return the list currently returned by hosts(), healthyHosts(), hostsPerLocality() or
+   *         healthyHostsPerLocality() respectively.
+   */
+  virtual HostVectorConstSharedPtr hostsPtr() const PURE;
+  virtual HostVectorConstSharedPtr healthyHostsPtr() const PURE;
+  virtual HostListsConstSharedPtr hostsPerLocalityPtr() const PURE;
+  virtual HostListsConstSharedPtr healthyHostsPerLocalityPtr() const PURE;
+
   /**
    * Updates the hosts in a given host set.
    *
@@ -239,6 +251,8 @@ public:
  */
 // clang-format off
 #define ALL_CLUSTER_STATS(COUNTER, GAUGE, HISTOGRAM)                                               \
+  HISTOGRAM(lb_hash_table_build_ms)                                                                \
+  COUNTER  (lb_hash_table_rebuilds)                                                                \
   COUNTER  (lb_healthy_panic)                                                                      \
   COUNTER  (lb_local_cluster_not_ok)                                                               \
   COUNTER  (lb_recalculate_zone_structures)                                                        \
@@ -300,6 +314,8 @@ public:
   GAUGE    (max_host_weight)                                                                       \
   COUNTER  (membership_change)                                                                     \
   GAUGE    (membership_healthy)                                                                    \
+  HISTOGRAM(membership_snapshot_build_ms)                                                          \
+  GAUGE    (membership_snapshot_bytes)                                                             \
   GAUGE    (membership_total)                                                                      \
   COUNTER  (retry_or_shadow_abandoned)                                                             \
   COUNTER  (update_attempt)                                                                        \
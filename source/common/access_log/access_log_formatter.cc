@@ -5,7 +5,9 @@
 #include <vector>
 
 #include "common/common/assert.h"
+#include "common/common/macros.h"
 #include "common/common/utility.h"
+#include "common/http/headers.h"
 
 #include "fmt/format.h"
 
@@ -28,66 +30,74 @@ const std::string ResponseFlagUtils::DELAY_INJECTED = "DI";
 const std::string ResponseFlagUtils::FAULT_INJECTED = "FI";
 const std::string ResponseFlagUtils::RATE_LIMITED = "RL";
 
-void ResponseFlagUtils::appendString(std::string& result, const std::string& append) {
-  if (result.empty()) {
-    result = append;
-  } else {
-    result += "," + append;
+void ResponseFlagUtils::appendString(std::string& output, size_t start,
+                                     const std::string& append) {
+  if (output.size() > start) {
+    output += ',';
   }
+  output += append;
 }
 
 const std::string ResponseFlagUtils::toShortString(const RequestInfo& request_info) {
   std::string result;
+  appendShortString(request_info, result);
+  return result;
+}
+
+void ResponseFlagUtils::appendShortString(const RequestInfo& request_info, std::string& output) {
+  const size_t start = output.size();
 
   if (request_info.getResponseFlag(ResponseFlag::FailedLocalHealthCheck)) {
-    appendString(result, FAILED_LOCAL_HEALTH_CHECK);
+    appendString(output, start, FAILED_LOCAL_HEALTH_CHECK);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::NoHealthyUpstream)) {
-    appendString(result, NO_HEALTHY_UPSTREAM);
+    appendString(output, start, NO_HEALTHY_UPSTREAM);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::UpstreamRequestTimeout)) {
-    appendString(result, UPSTREAM_REQUEST_TIMEOUT);
+    appendString(output, start, UPSTREAM_REQUEST_TIMEOUT);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::LocalReset)) {
-    appendString(result, LOCAL_RESET);
+    appendString(output, start, LOCAL_RESET);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::UpstreamRemoteReset)) {
-    appendString(result, UPSTREAM_REMOTE_RESET);
+    appendString(output, start, UPSTREAM_REMOTE_RESET);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::UpstreamConnectionFailure)) {
-    appendString(result, UPSTREAM_CONNECTION_FAILURE);
+    appendString(output, start, UPSTREAM_CONNECTION_FAILURE);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::UpstreamConnectionTermination)) {
-    appendString(result, UPSTREAM_CONNECTION_TERMINATION);
+    appendString(output, start, UPSTREAM_CONNECTION_TERMINATION);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::UpstreamOverflow)) {
-    appendString(result, UPSTREAM_OVERFLOW);
+    appendString(output, start, UPSTREAM_OVERFLOW);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::NoRouteFound)) {
-    appendString(result, NO_ROUTE_FOUND);
+    appendString(output, start, NO_ROUTE_FOUND);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::DelayInjected)) {
-    appendString(result, DELAY_INJECTED);
+    appendString(output, start, DELAY_INJECTED);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::FaultInjected)) {
-    appendString(result, FAULT_INJECTED);
+    appendString(output, start, FAULT_INJECTED);
   }
 
   if (request_info.getResponseFlag(ResponseFlag::RateLimited)) {
-    appendString(result, RATE_LIMITED);
+    appendString(output, start, RATE_LIMITED);
   }
 
-  return result.empty() ? NONE : result;
+  if (output.size() == start) {
+    output += NONE;
+  }
 }
 
 const std::string AccessLogFormatUtils::DEFAULT_FORMAT =
@@ -132,12 +142,16 @@ std::string FormatterImpl::format(const Http::HeaderMap& request_headers,
                                   const RequestInfo& request_info) const {
   std::string log_line;
   log_line.reserve(256);
+  appendTo(request_headers, response_headers, request_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::appendTo(const Http::HeaderMap& request_headers,
+                             const Http::HeaderMap& response_headers,
+                             const RequestInfo& request_info, std::string& output) const {
   for (const FormatterPtr& formatter : formatters_) {
-    log_line += formatter->format(request_headers, response_headers, request_info);
+    formatter->appendTo(request_headers, response_headers, request_info, output);
   }
-
-  return log_line;
 }
 
 void AccessLogFormatParser::parseCommand(const std::string& token, const size_t start,
@@ -232,94 +246,104 @@ std::vector<FormatterPtr> AccessLogFormatParser::parse(const std::string& format
   return formatters;
 }
 
+namespace {
+
+void appendInteger(uint64_t value, std::string& output) {
+  char buffer[32];
+  output.append(buffer, StringUtil::itoa(buffer, sizeof(buffer), value));
+}
+
+void appendMilliseconds(const Optional<std::chrono::microseconds>& duration,
+                        std::string& output) {
+  if (duration.valid()) {
+    appendInteger(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count(), output);
+  } else {
+    output += UnspecifiedValueString;
+  }
+}
+
+} // namespace
+
 RequestInfoFormatter::RequestInfoFormatter(const std::string& field_name) {
   if (field_name == "START_TIME") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return AccessLogDateTimeFormatter::fromTime(request_info.startTime());
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      AccessLogDateTimeFormatter::appendTime(request_info.startTime(), output);
     };
   } else if (field_name == "REQUEST_DURATION") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      Optional<std::chrono::microseconds> duration = request_info.requestReceivedDuration();
-      if (duration.valid()) {
-        return std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      appendMilliseconds(request_info.requestReceivedDuration(), output);
     };
   } else if (field_name == "RESPONSE_DURATION") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      Optional<std::chrono::microseconds> duration = request_info.responseReceivedDuration();
-      if (duration.valid()) {
-        return std::to_string(
-            std::chrono::duration_cast<std::chrono::milliseconds>(duration.value()).count());
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      appendMilliseconds(request_info.responseReceivedDuration(), output);
     };
   } else if (field_name == "BYTES_RECEIVED") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return std::to_string(request_info.bytesReceived());
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      appendInteger(request_info.bytesReceived(), output);
     };
   } else if (field_name == "PROTOCOL") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return AccessLogFormatUtils::protocolToString(request_info.protocol());
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      output += AccessLogFormatUtils::protocolToString(request_info.protocol());
     };
   } else if (field_name == "RESPONSE_CODE") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return request_info.responseCode().valid()
-                 ? std::to_string(request_info.responseCode().value())
-                 : "0";
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      const Optional<uint32_t>& response_code = request_info.responseCode();
+      appendInteger(response_code.valid() ? response_code.value() : 0, output);
     };
   } else if (field_name == "BYTES_SENT") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return std::to_string(request_info.bytesSent());
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      appendInteger(request_info.bytesSent(), output);
     };
   } else if (field_name == "DURATION") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return std::to_string(
-          std::chrono::duration_cast<std::chrono::milliseconds>(request_info.duration()).count());
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      appendInteger(
+          std::chrono::duration_cast<std::chrono::milliseconds>(request_info.duration()).count(),
+          output);
     };
   } else if (field_name == "RESPONSE_FLAGS") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      return ResponseFlagUtils::toShortString(request_info);
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      ResponseFlagUtils::appendShortString(request_info, output);
     };
   } else if (field_name == "UPSTREAM_HOST") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      if (request_info.upstreamHost()) {
-        return request_info.upstreamHost()->address()->asString();
-      } else {
-        return UnspecifiedValueString;
-      }
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      Upstream::HostDescriptionConstSharedPtr host = request_info.upstreamHost();
+      output += host ? host->address()->asString() : UnspecifiedValueString;
     };
   } else if (field_name == "UPSTREAM_CLUSTER") {
-    field_extractor_ = [](const RequestInfo& request_info) {
-      std::string upstream_cluster_name;
-      if (nullptr != request_info.upstreamHost()) {
-        upstream_cluster_name = request_info.upstreamHost()->cluster().name();
-      }
-
-      return upstream_cluster_name.empty() ? UnspecifiedValueString : upstream_cluster_name;
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
+      Upstream::HostDescriptionConstSharedPtr host = request_info.upstreamHost();
+      const std::string& upstream_cluster_name =
+          host != nullptr ? host->cluster().name() : UnspecifiedValueString;
+      output += upstream_cluster_name.empty() ? UnspecifiedValueString : upstream_cluster_name;
     };
   } else if (field_name == "UPSTREAM_LOCAL_ADDRESS") {
-    field_extractor_ = [](const RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
       const Optional<std::string>& upstream_local_address = request_info.upstreamLocalAddress();
-      return upstream_local_address.valid() ? upstream_local_address.value()
-                                            : UnspecifiedValueString;
+      output += upstream_local_address.valid() ? upstream_local_address.value()
+                                               : UnspecifiedValueString;
     };
   } else if (field_name == "DOWNSTREAM_ADDRESS") {
-    field_extractor_ = [](const RequestInfo& request_info) {
+    field_extractor_ = [](const RequestInfo& request_info, std::string& output) {
       const std::string& downstream_address = request_info.getDownstreamAddress();
-      return downstream_address.empty() ? UnspecifiedValueString : downstream_address;
+      output += downstream_address.empty() ? UnspecifiedValueString : downstream_address;
     };
   } else {
     throw EnvoyException(fmt::format("Not supported field in RequestInfo: {}", field_name));
   }
 }
 
-std::string RequestInfoFormatter::format(const Http::HeaderMap&, const Http::HeaderMap&,
+std::string RequestInfoFormatter::format(const Http::HeaderMap& request_headers,
+                                         const Http::HeaderMap& response_headers,
                                          const RequestInfo& request_info) const {
-  return field_extractor_(request_info);
+  std::string output;
+  appendTo(request_headers, response_headers, request_info, output);
+  return output;
+}
+
+void RequestInfoFormatter::appendTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                    const RequestInfo& request_info, std::string& output) const {
+  field_extractor_(request_info, output);
 }
 
 PlainStringFormatter::PlainStringFormatter(const std::string& str) : str_(str) {}
@@ -329,30 +353,67 @@ std::string PlainStringFormatter::format(const Http::HeaderMap&, const Http::Hea
   return str_;
 }
 
+void PlainStringFormatter::appendTo(const Http::HeaderMap&, const Http::HeaderMap&,
+                                    const RequestInfo&, std::string& output) const {
+  output += str_;
+}
+
 HeaderFormatter::HeaderFormatter(const std::string& main_header,
                                  const std::string& alternative_header,
                                  const Optional<size_t>& max_length)
-    : main_header_(main_header), alternative_header_(alternative_header), max_length_(max_length) {}
+    : main_header_(main_header), alternative_header_(alternative_header),
+      main_getter_(findInlineHeaderGetter(main_header_)),
+      alternative_getter_(findInlineHeaderGetter(alternative_header_)), max_length_(max_length) {}
+
+#define INLINE_HEADER_GETTER(name)                                                                 \
+  {Http::Headers::get().name.get(), static_cast<InlineHeaderGetter>(&Http::HeaderMap::name)},
+
+const HeaderFormatter::InlineHeaderGetterMap& HeaderFormatter::inlineHeaderGetters() {
+  CONSTRUCT_ON_FIRST_USE(InlineHeaderGetterMap, {ALL_INLINE_HEADERS(INLINE_HEADER_GETTER)});
+}
+
+#undef INLINE_HEADER_GETTER
+
+HeaderFormatter::InlineHeaderGetter
+HeaderFormatter::findInlineHeaderGetter(const Http::LowerCaseString& header) {
+  auto it = inlineHeaderGetters().find(header.get());
+  return it != inlineHeaderGetters().end() ? it->second : nullptr;
+}
+
+const Http::HeaderEntry* HeaderFormatter::findHeader(const Http::HeaderMap& headers,
+                                                     const Http::LowerCaseString& header,
+                                                     InlineHeaderGetter getter) {
+  return getter != nullptr ? (headers.*getter)() : headers.get(header);
+}
 
 std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
-  const Http::HeaderEntry* header = headers.get(main_header_);
+  std::string output;
+  appendTo(headers, output);
+  return output;
+}
+
+void HeaderFormatter::appendTo(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers, main_header_, main_getter_);
 
   if (!header && !alternative_header_.get().empty()) {
-    header = headers.get(alternative_header_);
+    header = findHeader(headers, alternative_header_, alternative_getter_);
   }
 
-  std::string header_value_string;
+  const char* value;
+  size_t length;
   if (!header) {
-    header_value_string = UnspecifiedValueString;
+    value = UnspecifiedValueString.c_str();
+    length = UnspecifiedValueString.size();
   } else {
-    header_value_string = header->value().c_str();
+    value = header->value().c_str();
+    length = header->value().size();
   }
 
-  if (max_length_.valid() && header_value_string.length() > max_length_.value()) {
-    return header_value_string.substr(0, max_length_.value());
+  if (max_length_.valid() && length > max_length_.value()) {
+    length = max_length_.value();
   }
 
-  return header_value_string;
+  output.append(value, length);
 }
 
 ResponseHeaderFormatter::ResponseHeaderFormatter(const std::string& main_header,
@@ -366,6 +427,12 @@ std::string ResponseHeaderFormatter::format(const Http::HeaderMap&,
   return HeaderFormatter::format(response_headers);
 }
 
+void ResponseHeaderFormatter::appendTo(const Http::HeaderMap&,
+                                       const Http::HeaderMap& response_headers,
+                                       const RequestInfo&, std::string& output) const {
+  HeaderFormatter::appendTo(response_headers, output);
+}
+
 RequestHeaderFormatter::RequestHeaderFormatter(const std::string& main_header,
                                                const std::string& alternative_header,
                                                const Optional<size_t>& max_length)
@@ -376,5 +443,11 @@ std::string RequestHeaderFormatter::format(const Http::HeaderMap& request_header
   return HeaderFormatter::format(request_headers);
 }
 
+void RequestHeaderFormatter::appendTo(const Http::HeaderMap& request_headers,
+                                      const Http::HeaderMap&, const RequestInfo&,
+                                      std::string& output) const {
+  HeaderFormatter::appendTo(request_headers, output);
+}
+
 } // namespace AccessLog
 } // namespace Envoy
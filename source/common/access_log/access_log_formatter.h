@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "envoy/access_log/access_log.h"
@@ -15,10 +16,11 @@ namespace AccessLog {
 class ResponseFlagUtils {
 public:
   static const std::string toShortString(const RequestInfo& request_info);
+  static void appendShortString(const RequestInfo& request_info, std::string& output);
 
 private:
   ResponseFlagUtils();
-  static void appendString(std::string& result, const std::string& append);
+  static void appendString(std::string& output, size_t start, const std::string& append);
 
   const static std::string NONE;
   const static std::string FAILED_LOCAL_HEALTH_CHECK;
@@ -62,7 +64,8 @@ private:
 };
 
 /**
- * Composite formatter implementation.
+ * Composite formatter implementation. The format is parsed once into a list of formatters, each of
+ * which appends its part of the line directly into the output.
  */
 class FormatterImpl : public Formatter {
 public:
@@ -72,6 +75,8 @@ public:
   std::string format(const Http::HeaderMap& request_headers,
                      const Http::HeaderMap& response_headers,
                      const RequestInfo& request_info) const override;
+  void appendTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const RequestInfo& request_info, std::string& output) const override;
 
 private:
   std::vector<FormatterPtr> formatters_;
@@ -88,21 +93,39 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const RequestInfo&) const override;
+  void appendTo(const Http::HeaderMap&, const Http::HeaderMap&, const RequestInfo&,
+                std::string& output) const override;
 
 private:
   std::string str_;
 };
 
+/**
+ * Looks up a header by name. Headers which the header map stores inline (e.g. :path or
+ * user-agent) are read through their O(1) accessors rather than by searching the map.
+ */
 class HeaderFormatter {
 public:
   HeaderFormatter(const std::string& main_header, const std::string& alternative_header,
                   const Optional<size_t>& max_length);
 
   std::string format(const Http::HeaderMap& headers) const;
+  void appendTo(const Http::HeaderMap& headers, std::string& output) const;
 
 private:
+  typedef const Http::HeaderEntry* (Http::HeaderMap::*InlineHeaderGetter)() const;
+  typedef std::unordered_map<std::string, InlineHeaderGetter> InlineHeaderGetterMap;
+
+  static const InlineHeaderGetterMap& inlineHeaderGetters();
+  static InlineHeaderGetter findInlineHeaderGetter(const Http::LowerCaseString& header);
+  static const Http::HeaderEntry* findHeader(const Http::HeaderMap& headers,
+                                             const Http::LowerCaseString& header,
+                                             InlineHeaderGetter getter);
+
   Http::LowerCaseString main_header_;
   Http::LowerCaseString alternative_header_;
+  InlineHeaderGetter main_getter_;
+  InlineHeaderGetter alternative_getter_;
   Optional<size_t> max_length_;
 };
 
@@ -117,6 +140,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
                      const RequestInfo&) const override;
+  void appendTo(const Http::HeaderMap& request_headers, const Http::HeaderMap&, const RequestInfo&,
+                std::string& output) const override;
 };
 
 /**
@@ -130,6 +155,8 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap& response_headers,
                      const RequestInfo&) const override;
+  void appendTo(const Http::HeaderMap&, const Http::HeaderMap& response_headers, const RequestInfo&,
+                std::string& output) const override;
 };
 
 /**
@@ -142,9 +169,11 @@ public:
   // Formatter::format
   std::string format(const Http::HeaderMap&, const Http::HeaderMap&,
                      const RequestInfo& request_info) const override;
+  void appendTo(const Http::HeaderMap&, const Http::HeaderMap&, const RequestInfo& request_info,
+                std::string& output) const override;
 
 private:
-  std::function<std::string(const RequestInfo&)> field_extractor_;
+  std::function<void(const RequestInfo&, std::string&)> field_extractor_;
 };
 
 } // namespace AccessLog
@@ -186,8 +186,11 @@ void FileAccessLog::log(const Http::HeaderMap* request_headers,
     }
   }
 
-  std::string access_log_line =
-      formatter_->format(*request_headers, *response_headers, request_info);
+  // The line is formatted into a per thread buffer which keeps its capacity between requests, so
+  // logging does not allocate in the steady state.
+  static thread_local std::string access_log_line;
+  access_log_line.clear();
+  formatter_->appendTo(*request_headers, *response_headers, request_info, access_log_line);
   log_file_->write(access_log_line);
 }
 
@@ -0,0 +1,152 @@
+#include "common/access_log/binary_access_log_format.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "envoy/common/exception.h"
+#include "envoy/upstream/upstream.h"
+
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace AccessLog {
+
+namespace {
+
+int64_t durationToMicros(const Optional<std::chrono::microseconds>& duration) {
+  return duration.valid() ? duration.value().count() : BinaryAccessLogRecord::UNSET_DURATION;
+}
+
+uint64_t alignRecordLength(uint64_t length) {
+  const uint64_t alignment = BinaryAccessLogRecord::RECORD_ALIGNMENT;
+  return (length + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+std::string BinaryFormatter::format(const Http::HeaderMap& request_headers,
+                                    const Http::HeaderMap& response_headers,
+                                    const RequestInfo& request_info) const {
+  std::string output;
+  appendTo(request_headers, response_headers, request_info, output);
+  return output;
+}
+
+void BinaryFormatter::appendTo(const Http::HeaderMap& request_headers, const Http::HeaderMap&,
+                               const RequestInfo& request_info, std::string& output) const {
+  BinaryAccessLogRecord record{};
+  record.magic_ = BinaryAccessLogRecord::MAGIC;
+  record.version_ = BinaryAccessLogRecord::VERSION;
+  record.start_time_us_ = std::chrono::duration_cast<std::chrono::microseconds>(
+                              request_info.startTime().time_since_epoch())
+                              .count();
+  record.duration_us_ = request_info.duration().count();
+  record.request_received_duration_us_ = durationToMicros(request_info.requestReceivedDuration());
+  record.response_received_duration_us_ = durationToMicros(request_info.responseReceivedDuration());
+  record.bytes_received_ = request_info.bytesReceived();
+  record.bytes_sent_ = request_info.bytesSent();
+  if (request_info.responseCode().valid()) {
+    record.response_code_ = request_info.responseCode().value();
+  }
+  for (uint32_t flag = ResponseFlag::FailedLocalHealthCheck; flag <= ResponseFlag::RateLimited;
+       flag <<= 1) {
+    if (request_info.getResponseFlag(static_cast<ResponseFlag>(flag))) {
+      record.response_flags_ |= flag;
+    }
+  }
+  if (request_info.protocol().valid()) {
+    record.protocol_ = static_cast<uint8_t>(request_info.protocol().value()) + 1;
+  }
+  record.health_check_ = request_info.healthCheck();
+
+  const char* strings[BinaryAccessLogRecord::NumStringFields]{};
+  auto set_string = [&record, &strings](BinaryAccessLogRecord::StringField field, const char* data,
+                                        size_t length) -> void {
+    strings[field] = data;
+    record.string_lengths_[field] = std::min<size_t>(length, std::numeric_limits<uint16_t>::max());
+  };
+  auto set_header = [&set_string](BinaryAccessLogRecord::StringField field,
+                                  const Http::HeaderEntry* header) -> void {
+    if (header != nullptr) {
+      set_string(field, header->value().c_str(), header->value().size());
+    }
+  };
+
+  set_header(BinaryAccessLogRecord::Method, request_headers.Method());
+  set_header(BinaryAccessLogRecord::Path, request_headers.EnvoyOriginalPath() != nullptr
+                                              ? request_headers.EnvoyOriginalPath()
+                                              : request_headers.Path());
+  set_header(BinaryAccessLogRecord::Authority, request_headers.Host());
+  set_header(BinaryAccessLogRecord::UserAgent, request_headers.UserAgent());
+  set_header(BinaryAccessLogRecord::RequestId, request_headers.RequestId());
+  set_header(BinaryAccessLogRecord::ForwardedFor, request_headers.ForwardedFor());
+
+  const Upstream::HostDescriptionConstSharedPtr host = request_info.upstreamHost();
+  if (host != nullptr) {
+    const std::string& address = host->address()->asString();
+    set_string(BinaryAccessLogRecord::UpstreamHost, address.data(), address.size());
+    const std::string& cluster = host->cluster().name();
+    set_string(BinaryAccessLogRecord::UpstreamCluster, cluster.data(), cluster.size());
+  }
+  const std::string& downstream_address = request_info.getDownstreamAddress();
+  set_string(BinaryAccessLogRecord::DownstreamAddress, downstream_address.data(),
+             downstream_address.size());
+
+  uint64_t length = sizeof(record);
+  for (uint16_t string_length : record.string_lengths_) {
+    length += string_length;
+  }
+  record.length_ = alignRecordLength(length);
+
+  // Growing the output zero fills the padding, so the record is fully initialized.
+  const size_t start = output.size();
+  output.resize(start + record.length_);
+  char* position = &output[start];
+  memcpy(position, &record, sizeof(record));
+  position += sizeof(record);
+  for (size_t i = 0; i < BinaryAccessLogRecord::NumStringFields; i++) {
+    if (record.string_lengths_[i] > 0) {
+      memcpy(position, strings[i], record.string_lengths_[i]);
+      position += record.string_lengths_[i];
+    }
+  }
+}
+
+bool BinaryAccessLogReader::next(BinaryAccessLogEntry& entry) {
+  if (length_ - offset_ < sizeof(BinaryAccessLogRecord)) {
+    return false;
+  }
+
+  const BinaryAccessLogRecord* header =
+      reinterpret_cast<const BinaryAccessLogRecord*>(data_ + offset_);
+  if (header->magic_ != BinaryAccessLogRecord::MAGIC ||
+      header->version_ != BinaryAccessLogRecord::VERSION ||
+      header->length_ < sizeof(BinaryAccessLogRecord) ||
+      header->length_ % BinaryAccessLogRecord::RECORD_ALIGNMENT != 0) {
+    throw EnvoyException(fmt::format("corrupt binary access log record at offset {}", offset_));
+  }
+  if (length_ - offset_ < header->length_) {
+    return false;
+  }
+
+  const char* position = data_ + offset_ + sizeof(BinaryAccessLogRecord);
+  const char* end = data_ + offset_ + header->length_;
+  for (size_t i = 0; i < BinaryAccessLogRecord::NumStringFields; i++) {
+    entry.strings_[i] = position;
+    position += header->string_lengths_[i];
+  }
+  if (position > end) {
+    throw EnvoyException(fmt::format("corrupt binary access log record at offset {}", offset_));
+  }
+
+  entry.header_ = header;
+  offset_ += header->length_;
+  return true;
+}
+
+} // namespace AccessLog
+} // namespace Envoy
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/http/header_map.h"
+
+namespace Envoy {
+namespace AccessLog {
+
+/**
+ * Fixed layout header of a binary access log record. A record is the header followed by the bytes
+ * of each string field in StringField order, padded to a multiple of RECORD_ALIGNMENT so that the
+ * header of the next record is aligned when the file is mapped into memory. Records are appended
+ * in host byte order and there is no file header, so a log can be reopened, rotated or
+ * concatenated at any record boundary.
+ */
+struct BinaryAccessLogRecord {
+  enum StringField {
+    Method,
+    Path,
+    Authority,
+    UserAgent,
+    RequestId,
+    ForwardedFor,
+    UpstreamHost,
+    UpstreamCluster,
+    DownstreamAddress,
+    NumStringFields
+  };
+
+  static const uint16_t MAGIC = 0xe1a7;
+  static const uint16_t VERSION = 1;
+  static const uint32_t RECORD_ALIGNMENT = 8;
+  // Written for optional durations which were not set.
+  static const int64_t UNSET_DURATION = -1;
+
+  // Total size of the record, including this header, the string fields and the padding.
+  uint32_t length_;
+  uint16_t magic_;
+  uint16_t version_;
+  // Microseconds since the epoch.
+  uint64_t start_time_us_;
+  uint64_t duration_us_;
+  int64_t request_received_duration_us_;
+  int64_t response_received_duration_us_;
+  uint64_t bytes_received_;
+  uint64_t bytes_sent_;
+  // 0 if no response was sent.
+  uint32_t response_code_;
+  // Bitwise or of ResponseFlag.
+  uint32_t response_flags_;
+  // 0 if unknown, otherwise Http::Protocol + 1.
+  uint8_t protocol_;
+  uint8_t health_check_;
+  // Strings longer than UINT16_MAX are truncated.
+  uint16_t string_lengths_[NumStringFields];
+};
+
+static_assert(sizeof(BinaryAccessLogRecord) % BinaryAccessLogRecord::RECORD_ALIGNMENT == 0,
+              "binary access log record header must keep records aligned");
+
+/**
+ * Formatter which encodes each request as a BinaryAccessLogRecord rather than a line of text.
+ * Encoding is a handful of stores and memcpy() calls, with no number or time formatting.
+ */
+class BinaryFormatter : public Formatter {
+public:
+  // Formatter::format
+  std::string format(const Http::HeaderMap& request_headers,
+                     const Http::HeaderMap& response_headers,
+                     const RequestInfo& request_info) const override;
+  void appendTo(const Http::HeaderMap& request_headers, const Http::HeaderMap& response_headers,
+                const RequestInfo& request_info, std::string& output) const override;
+};
+
+/**
+ * A decoded view of a record. The pointers refer to the buffer passed to BinaryAccessLogReader.
+ */
+struct BinaryAccessLogEntry {
+  /**
+   * @return std::string a copy of one of the record's string fields.
+   */
+  std::string field(BinaryAccessLogRecord::StringField field) const {
+    return std::string(strings_[field], header_->string_lengths_[field]);
+  }
+
+  const BinaryAccessLogRecord* header_;
+  const char* strings_[BinaryAccessLogRecord::NumStringFields];
+};
+
+/**
+ * Iterates over the records of a binary access log held in memory (e.g. a mapped file). Nothing
+ * is copied, so scanning a log costs little more than reading it.
+ */
+class BinaryAccessLogReader {
+public:
+  /**
+   * @param data supplies the log, which must be aligned to RECORD_ALIGNMENT.
+   * @param length supplies the size of the log in bytes.
+   */
+  BinaryAccessLogReader(const char* data, uint64_t length) : data_(data), length_(length) {}
+
+  /**
+   * Decode the next record.
+   * @param entry supplies the entry to fill in.
+   * @return bool false if there are no more complete records. A partial record at the end of the
+   *         log (e.g. one which is still being written) is not returned.
+   * @throw EnvoyException if the next record is corrupt.
+   */
+  bool next(BinaryAccessLogEntry& entry);
+
+  /**
+   * @return uint64_t the offset of the first record which has not been returned by next().
+   */
+  uint64_t offset() const { return offset_; }
+
+private:
+  const char* data_;
+  const uint64_t length_;
+  uint64_t offset_{};
+};
+
+} // namespace AccessLog
+} // namespace Envoy
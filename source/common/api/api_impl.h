@@ -6,6 +6,8 @@
 #include "envoy/api/api.h"
 #include "envoy/filesystem/filesystem.h"
 
+#include "common/filesystem/filesystem_impl.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -14,7 +16,9 @@ namespace Api {
  */
 class Impl : public Api::Api {
 public:
-  Impl(std::chrono::milliseconds file_flush_interval_msec);
+  Impl(std::chrono::milliseconds file_flush_interval_msec,
+       Filesystem::WriteOverflowPolicy file_overflow_policy =
+           Filesystem::WriteOverflowPolicy::Spill);
 
   // Api::Api
   Event::DispatcherPtr allocateDispatcher() override;
@@ -26,6 +30,8 @@ public:
 
 private:
   std::chrono::milliseconds file_flush_interval_msec_;
+  Filesystem::WriteOverflowPolicy file_overflow_policy_;
+  Filesystem::FlushThreadSharedPtr file_flush_thread_; // Shared by all files, created on demand.
 };
 
 } // namespace Api
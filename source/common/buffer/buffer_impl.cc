@@ -34,6 +34,12 @@ void OwnedImpl::add(const Instance& data) {
   }
 }
 
+void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
+  evbuffer_add_reference(
+      buffer_.get(), fragment.data(), fragment.size(),
+      [](const void*, size_t, void* arg) { static_cast<BufferFragment*>(arg)->done(); }, &fragment);
+}
+
 void OwnedImpl::commit(RawSlice* iovecs, uint64_t num_iovecs) {
   int rc =
       evbuffer_commit_space(buffer_.get(), reinterpret_cast<evbuffer_iovec*>(iovecs), num_iovecs);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
@@ -10,6 +11,36 @@
 namespace Envoy {
 namespace Buffer {
 
+/**
+ * A BufferFragment which calls a function once it is no longer referenced.
+ */
+class BufferFragmentImpl : public BufferFragment {
+public:
+  /**
+   * @param data supplies the referenced data.
+   * @param size supplies the size of the referenced data.
+   * @param releasor supplies a function called with the fragment once no buffer references it. It
+   *        may delete the fragment.
+   */
+  BufferFragmentImpl(const void* data, size_t size,
+                     std::function<void(const void*, size_t, const BufferFragmentImpl*)> releasor)
+      : data_(data), size_(size), releasor_(releasor) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override {
+    if (releasor_) {
+      releasor_(data_, size_, this);
+    }
+  }
+
+private:
+  const void* const data_;
+  const size_t size_;
+  const std::function<void(const void*, size_t, const BufferFragmentImpl*)> releasor_;
+};
+
 class LibEventInstance : public Instance {
 public:
   // Allows access into the underlying buffer for move() optimizations.
@@ -35,6 +66,7 @@ public:
   void add(const void* data, uint64_t size) override;
   void add(const std::string& data) override;
   void add(const Instance& data) override;
+  void addBufferFragment(BufferFragment& fragment) override;
   void commit(RawSlice* iovecs, uint64_t num_iovecs) override;
   void copyOut(size_t start, uint64_t size, void* data) const override;
   void drain(uint64_t size) override;
@@ -0,0 +1,373 @@
+#include "common/buffer/slice_buffer_impl.h"
+
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Buffer {
+
+SliceBufferImpl::SliceBufferImpl(uint64_t slice_size) : slice_size_(slice_size) {
+  ASSERT(slice_size > 0);
+}
+
+SliceBufferImpl::SliceBufferImpl(const std::string& data) : SliceBufferImpl() { add(data); }
+
+SliceBufferImpl::SliceBufferImpl(const Instance& data) : SliceBufferImpl() { add(data); }
+
+SliceBufferImpl::SliceBufferImpl(const void* data, uint64_t size) : SliceBufferImpl() {
+  add(data, size);
+}
+
+void SliceBufferImpl::addSlice(const SliceStorageSharedPtr& storage, uint64_t offset,
+                               uint64_t size) {
+  slices_.push_back({storage, offset, size});
+  length_ += size;
+}
+
+void SliceBufferImpl::add(const void* data, uint64_t size) {
+  const uint8_t* src = static_cast<const uint8_t*>(data);
+  while (size > 0) {
+    if (slices_.empty() || slices_.back().reservableSize() == 0) {
+      addSlice(std::make_shared<OwnedSliceStorage>(std::max(slice_size_, size)), 0, 0);
+    }
+
+    Slice& slice = slices_.back();
+    const uint64_t copy_size = std::min(size, slice.reservableSize());
+    memcpy(slice.data() + slice.size_, src, copy_size);
+    slice.size_ += copy_size;
+    length_ += copy_size;
+    src += copy_size;
+    size -= copy_size;
+  }
+}
+
+void SliceBufferImpl::add(const std::string& data) { add(data.data(), data.size()); }
+
+void SliceBufferImpl::add(const Instance& data) {
+  const SliceBufferImpl* other = dynamic_cast<const SliceBufferImpl*>(&data);
+  if (other == nullptr) {
+    const uint64_t num_slices = data.getRawSlices(nullptr, 0);
+    RawSlice slices[num_slices];
+    data.getRawSlices(slices, num_slices);
+    for (const RawSlice& slice : slices) {
+      add(slice.mem_, slice.len_);
+    }
+    return;
+  }
+
+  // Share the other buffer's storage. Adding to ourselves would grow the list being iterated, so
+  // stop after the slices which were there to begin with.
+  const uint64_t num_slices = other->slices_.size();
+  for (uint64_t i = 0; i < num_slices; i++) {
+    const Slice& slice = other->slices_[i];
+    if (slice.size_ > 0) {
+      addSlice(slice.storage_, slice.offset_, slice.size_);
+    }
+  }
+}
+
+void SliceBufferImpl::addBufferFragment(BufferFragment& fragment) {
+  addSlice(std::make_shared<FragmentSliceStorage>(fragment), 0, fragment.size());
+}
+
+void SliceBufferImpl::commit(RawSlice* iovecs, uint64_t num_iovecs) {
+  // Reserved space is always at the end of the reservable slices at the tail of the buffer, in
+  // the order it was handed out.
+  auto slice = slices_.rbegin();
+  while (slice != slices_.rend() && std::next(slice) != slices_.rend() &&
+         std::next(slice)->reservableSize() > 0) {
+    slice++;
+  }
+
+  for (uint64_t i = 0; i < num_iovecs; i++) {
+    if (iovecs[i].len_ == 0) {
+      continue;
+    }
+
+    while (slice->data() + slice->size_ != iovecs[i].mem_) {
+      ASSERT(slice != slices_.rbegin());
+      slice--;
+    }
+    ASSERT(iovecs[i].len_ <= slice->reservableSize());
+    slice->size_ += iovecs[i].len_;
+    length_ += iovecs[i].len_;
+  }
+
+  removeEmptyTailSlices();
+}
+
+void SliceBufferImpl::removeEmptyTailSlices() {
+  while (!slices_.empty() && slices_.back().size_ == 0) {
+    slices_.pop_back();
+  }
+}
+
+void SliceBufferImpl::copyOut(size_t start, uint64_t size, void* data) const {
+  ASSERT(start + size <= length_);
+
+  uint8_t* dest = static_cast<uint8_t*>(data);
+  for (const Slice& slice : slices_) {
+    if (size == 0) {
+      break;
+    }
+    if (start >= slice.size_) {
+      start -= slice.size_;
+      continue;
+    }
+
+    const uint64_t copy_size = std::min(size, slice.size_ - start);
+    memcpy(dest, slice.data() + start, copy_size);
+    dest += copy_size;
+    size -= copy_size;
+    start = 0;
+  }
+}
+
+void SliceBufferImpl::drain(uint64_t size) {
+  ASSERT(size <= length_);
+  length_ -= size;
+  while (size > 0) {
+    Slice& slice = slices_.front();
+    if (slice.size_ > size) {
+      slice.offset_ += size;
+      slice.size_ -= size;
+      return;
+    }
+
+    size -= slice.size_;
+    slices_.pop_front();
+  }
+}
+
+uint64_t SliceBufferImpl::getRawSlices(RawSlice* out, uint64_t out_size) const {
+  uint64_t num_slices = 0;
+  for (const Slice& slice : slices_) {
+    if (slice.size_ == 0) {
+      continue;
+    }
+    if (num_slices < out_size) {
+      out[num_slices].mem_ = slice.data();
+      out[num_slices].len_ = slice.size_;
+    }
+    num_slices++;
+  }
+
+  return num_slices;
+}
+
+void* SliceBufferImpl::linearize(uint32_t size) {
+  ASSERT(size <= length_);
+  if (slices_.empty()) {
+    return nullptr;
+  }
+  if (slices_.front().size_ >= size) {
+    return slices_.front().data();
+  }
+
+  SliceStorageSharedPtr storage = std::make_shared<OwnedSliceStorage>(size);
+  copyOut(0, size, storage->base());
+  drain(size);
+  slices_.push_front({storage, 0, size});
+  length_ += size;
+  return storage->base();
+}
+
+void SliceBufferImpl::move(Instance& rhs) {
+  ASSERT(&rhs != this);
+  SliceBufferImpl* other = dynamic_cast<SliceBufferImpl*>(&rhs);
+  if (other == nullptr) {
+    add(rhs);
+    rhs.drain(rhs.length());
+    return;
+  }
+
+  for (Slice& slice : other->slices_) {
+    if (slice.size_ > 0) {
+      slices_.push_back(std::move(slice));
+    }
+  }
+  length_ += other->length_;
+  other->slices_.clear();
+  other->length_ = 0;
+}
+
+void SliceBufferImpl::move(Instance& rhs, uint64_t length) {
+  ASSERT(&rhs != this);
+  SliceBufferImpl* other = dynamic_cast<SliceBufferImpl*>(&rhs);
+  if (other == nullptr) {
+    const uint64_t num_slices = rhs.getRawSlices(nullptr, 0);
+    RawSlice slices[num_slices];
+    rhs.getRawSlices(slices, num_slices);
+    uint64_t remaining = length;
+    for (uint64_t i = 0; i < num_slices && remaining > 0; i++) {
+      const uint64_t copy_size = std::min<uint64_t>(slices[i].len_, remaining);
+      add(slices[i].mem_, copy_size);
+      remaining -= copy_size;
+    }
+    rhs.drain(length);
+    return;
+  }
+
+  ASSERT(length <= other->length_);
+  other->length_ -= length;
+  while (length > 0) {
+    Slice& slice = other->slices_.front();
+    if (slice.size_ > length) {
+      // Split the slice, sharing its storage between both buffers.
+      addSlice(slice.storage_, slice.offset_, length);
+      slice.offset_ += length;
+      slice.size_ -= length;
+      return;
+    }
+
+    length -= slice.size_;
+    length_ += slice.size_;
+    slices_.push_back(std::move(slice));
+    other->slices_.pop_front();
+  }
+}
+
+int SliceBufferImpl::read(int fd, uint64_t max_length) {
+  if (max_length == 0) {
+    return 0;
+  }
+
+  RawSlice slices[2];
+  const uint64_t num_slices = reserve(max_length, slices, 2);
+  iovec iov[2];
+  uint64_t remaining = max_length;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = std::min<uint64_t>(slices[i].len_, remaining);
+    remaining -= iov[i].iov_len;
+  }
+
+  const ssize_t rc = ::readv(fd, iov, num_slices);
+  uint64_t bytes_read = rc > 0 ? rc : 0;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    slices[i].len_ = std::min<uint64_t>(iov[i].iov_len, bytes_read);
+    bytes_read -= slices[i].len_;
+  }
+
+  // On error this commits nothing and releases any newly allocated space. The deallocation does
+  // not change errno.
+  commit(slices, num_slices);
+  return rc;
+}
+
+uint64_t SliceBufferImpl::reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) {
+  ASSERT(num_iovecs > 0);
+  uint64_t num_used = 0;
+  uint64_t reserved = 0;
+
+  // Use the free space in the last slice first, unless the caller needs contiguous space which it
+  // cannot provide.
+  if (!slices_.empty()) {
+    Slice& slice = slices_.back();
+    const uint64_t reservable = slice.reservableSize();
+    if (reservable > 0 && (num_iovecs > 1 || reservable >= length)) {
+      iovecs[0].mem_ = slice.data() + slice.size_;
+      iovecs[0].len_ = reservable;
+      num_used = 1;
+      reserved = reservable;
+    }
+  }
+
+  while ((reserved < length || num_used == 0) && num_used < num_iovecs) {
+    const uint64_t size = std::max(slice_size_, length - std::min(length, reserved));
+    addSlice(std::make_shared<OwnedSliceStorage>(size), 0, 0);
+    iovecs[num_used].mem_ = slices_.back().data();
+    iovecs[num_used].len_ = size;
+    num_used++;
+    reserved += size;
+  }
+
+  return num_used;
+}
+
+bool SliceBufferImpl::matchesAt(const std::deque<Slice>::const_iterator& slice, uint64_t offset,
+                                const uint8_t* data, uint64_t size) const {
+  for (auto it = slice; it != slices_.end(); it++) {
+    const uint64_t compare_size = std::min(size, it->size_ - offset);
+    if (memcmp(it->data() + offset, data, compare_size) != 0) {
+      return false;
+    }
+    data += compare_size;
+    size -= compare_size;
+    if (size == 0) {
+      return true;
+    }
+    offset = 0;
+  }
+
+  return false;
+}
+
+ssize_t SliceBufferImpl::search(const void* data, uint64_t size, size_t start) const {
+  if (start > length_) {
+    return -1;
+  }
+  if (size == 0) {
+    return start;
+  }
+
+  const uint8_t* needle = static_cast<const uint8_t*>(data);
+  uint64_t slice_start = 0;
+  for (auto slice = slices_.begin(); slice != slices_.end(); slice++) {
+    if (start >= slice_start + slice->size_) {
+      slice_start += slice->size_;
+      continue;
+    }
+
+    // Look for the first byte of the needle with memchr() and only compare the rest on a hit.
+    const uint8_t* begin = slice->data();
+    const uint8_t* end = begin + slice->size_;
+    const uint8_t* position = begin + (start > slice_start ? start - slice_start : 0);
+    while (position < end) {
+      position = static_cast<const uint8_t*>(memchr(position, needle[0], end - position));
+      if (position == nullptr) {
+        break;
+      }
+      if (matchesAt(slice, position - begin, needle, size)) {
+        return slice_start + (position - begin);
+      }
+      position++;
+    }
+    slice_start += slice->size_;
+  }
+
+  return -1;
+}
+
+int SliceBufferImpl::write(int fd) {
+  iovec iov[MAX_IO_SLICES];
+  uint64_t num_iov = 0;
+  for (const Slice& slice : slices_) {
+    if (num_iov == MAX_IO_SLICES) {
+      break;
+    }
+    if (slice.size_ > 0) {
+      iov[num_iov].iov_base = slice.data();
+      iov[num_iov].iov_len = slice.size_;
+      num_iov++;
+    }
+  }
+  if (num_iov == 0) {
+    return 0;
+  }
+
+  const ssize_t rc = ::writev(fd, iov, num_iov);
+  if (rc > 0) {
+    drain(rc);
+  }
+  return rc;
+}
+
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * Memory referenced by one or more slices of SliceBufferImpl buffers. Storage is reference
+ * counted, so copying a buffer or moving part of a slice shares the memory rather than copying it.
+ */
+class SliceStorage {
+public:
+  virtual ~SliceStorage() {}
+
+  uint8_t* base() const { return base_; }
+  uint64_t capacity() const { return capacity_; }
+
+  /**
+   * @return bool whether data may be appended into the unused part of the storage. External
+   *         memory is never written to.
+   */
+  bool writable() const { return writable_; }
+
+protected:
+  SliceStorage(uint8_t* base, uint64_t capacity, bool writable)
+      : base_(base), capacity_(capacity), writable_(writable) {}
+
+private:
+  uint8_t* const base_;
+  const uint64_t capacity_;
+  const bool writable_;
+};
+
+typedef std::shared_ptr<SliceStorage> SliceStorageSharedPtr;
+
+/**
+ * Heap allocated storage owned by the buffers which reference it.
+ */
+class OwnedSliceStorage : public SliceStorage {
+public:
+  OwnedSliceStorage(uint64_t capacity)
+      : SliceStorage(new uint8_t[capacity], capacity, true), memory_(base()) {}
+
+private:
+  std::unique_ptr<uint8_t[]> memory_;
+};
+
+/**
+ * Storage referencing a BufferFragment, which is released once the last slice referencing it is
+ * drained.
+ */
+class FragmentSliceStorage : public SliceStorage {
+public:
+  FragmentSliceStorage(BufferFragment& fragment)
+      : SliceStorage(static_cast<uint8_t*>(const_cast<void*>(fragment.data())), fragment.size(),
+                     false),
+        fragment_(fragment) {}
+  ~FragmentSliceStorage() { fragment_.done(); }
+
+private:
+  BufferFragment& fragment_;
+};
+
+/**
+ * Buffer built from a queue of slices of reference counted storage, without libevent.
+ *
+ * Compared to OwnedImpl:
+ * - read() reserves the requested amount up front and reads with a single readv(), rather than
+ *   asking the kernel how much data is pending with ioctl(FIONREAD) first.
+ * - move() works from any Buffer::Instance. Moving from another SliceBufferImpl transfers the
+ *   slices without copying, including when only part of a slice is moved.
+ * - Copying from another SliceBufferImpl shares its storage.
+ *
+ * Data is only ever appended into the last slice, and only when that slice is the sole reference
+ * to its storage, so shared memory is never modified.
+ */
+class SliceBufferImpl : public Instance {
+public:
+  // Size of the storage allocated for small writes and reads.
+  static const uint64_t DEFAULT_SLICE_SIZE = 16384;
+
+  /**
+   * @param slice_size supplies the minimum size of newly allocated storage.
+   */
+  SliceBufferImpl(uint64_t slice_size = DEFAULT_SLICE_SIZE);
+  SliceBufferImpl(const std::string& data);
+  SliceBufferImpl(const Instance& data);
+  SliceBufferImpl(const void* data, uint64_t size);
+
+  // Buffer::Instance
+  void add(const void* data, uint64_t size) override;
+  void add(const std::string& data) override;
+  void add(const Instance& data) override;
+  void addBufferFragment(BufferFragment& fragment) override;
+  void commit(RawSlice* iovecs, uint64_t num_iovecs) override;
+  void copyOut(size_t start, uint64_t size, void* data) const override;
+  void drain(uint64_t size) override;
+  uint64_t getRawSlices(RawSlice* out, uint64_t out_size) const override;
+  uint64_t length() const override { return length_; }
+  void* linearize(uint32_t size) override;
+  void move(Instance& rhs) override;
+  void move(Instance& rhs, uint64_t length) override;
+  int read(int fd, uint64_t max_length) override;
+  uint64_t reserve(uint64_t length, RawSlice* iovecs, uint64_t num_iovecs) override;
+  ssize_t search(const void* data, uint64_t size, size_t start) const override;
+  int write(int fd) override;
+
+private:
+  struct Slice {
+    uint8_t* data() const { return storage_->base() + offset_; }
+    uint64_t reservableSize() const {
+      return storage_->writable() && storage_.use_count() == 1
+                 ? storage_->capacity() - offset_ - size_
+                 : 0;
+    }
+
+    SliceStorageSharedPtr storage_;
+    uint64_t offset_;
+    uint64_t size_;
+  };
+
+  // The most slices filled in by a single read() or write().
+  static const uint64_t MAX_IO_SLICES = 16;
+
+  void addSlice(const SliceStorageSharedPtr& storage, uint64_t offset, uint64_t size);
+  bool matchesAt(const std::deque<Slice>::const_iterator& slice, uint64_t offset,
+                 const uint8_t* data, uint64_t size) const;
+  void removeEmptyTailSlices();
+
+  const uint64_t slice_size_;
+  std::deque<Slice> slices_;
+  uint64_t length_{};
+};
+
+} // namespace Buffer
+} // namespace Envoy
@@ -24,6 +24,7 @@ public:
   void add(const void* data, uint64_t size) override;
   void add(const std::string& data) override;
   void add(const Instance& data) override;
+  void addBufferFragment(BufferFragment& fragment) override;
   void commit(RawSlice* iovecs, uint64_t num_iovecs) override;
   void drain(uint64_t size) override;
   void move(Instance& rhs) override;
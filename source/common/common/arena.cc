@@ -0,0 +1,44 @@
+#include "common/common/arena.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+const size_t Arena::BLOCK_SIZE;
+
+Arena::Arena(void* first_block, size_t first_block_size)
+    : current_(static_cast<uint8_t*>(first_block)), remaining_(first_block_size) {}
+
+Arena::~Arena() {
+  while (blocks_ != nullptr) {
+    Block* next = blocks_->next_;
+    ::operator delete(blocks_);
+    blocks_ = next;
+  }
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  size_t padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+  if (current_ == nullptr || padding + size > remaining_) {
+    // Whatever is left of the current block is abandoned. Allocations larger than a block get a
+    // block of their own.
+    const size_t block_size = std::max(BLOCK_SIZE, sizeof(Block) + alignment + size);
+    Block* block = static_cast<Block*>(::operator new(block_size));
+    block->next_ = blocks_;
+    blocks_ = block;
+    heap_blocks_++;
+    current_ = reinterpret_cast<uint8_t*>(block + 1);
+    remaining_ = block_size - sizeof(Block);
+    padding = -reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+  }
+
+  void* memory = current_ + padding;
+  current_ += padding + size;
+  remaining_ -= padding + size;
+  return memory;
+}
+
+} // namespace Envoy
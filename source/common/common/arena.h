@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Bump allocator for objects which share a lifetime. Memory is handed out in order from blocks
+ * and is released all at once when the arena is destroyed. Objects placed in an arena must still
+ * be destroyed by their owner, see ArenaDeleter. The first block may be supplied by the owner,
+ * see InlineArena, so that an arena which stays within it makes no heap allocations.
+ */
+class Arena : NonCopyable {
+public:
+  /**
+   * @param first_block supplies memory for the first block, or nullptr.
+   * @param first_block_size supplies the size of first_block.
+   */
+  Arena(void* first_block, size_t first_block_size);
+  Arena() : Arena(nullptr, 0) {}
+  ~Arena();
+
+  /**
+   * Allocate memory which lives as long as the arena.
+   * @param size supplies the number of bytes.
+   * @param alignment supplies the alignment, which must be a power of 2.
+   * @return void* the memory.
+   */
+  void* allocate(size_t size, size_t alignment);
+
+  /**
+   * Construct an object in the arena. The caller must destroy it before the arena.
+   */
+  template <class T, class... Args> T* create(Args&&... args) {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @return uint32_t the number of blocks allocated from the heap.
+   */
+  uint32_t heapBlocks() const { return heap_blocks_; }
+
+  static const size_t BLOCK_SIZE = 1024;
+
+private:
+  struct Block {
+    Block* next_;
+  };
+
+  uint8_t* current_;
+  size_t remaining_;
+  Block* blocks_{};
+  uint32_t heap_blocks_{};
+};
+
+/**
+ * Arena whose first block is part of the object.
+ */
+template <size_t Size> class InlineArena : public Arena {
+public:
+  InlineArena() : Arena(storage_, Size) {}
+
+private:
+  alignas(std::max_align_t) uint8_t storage_[Size];
+};
+
+/**
+ * Allocator for standard containers whose memory comes from an arena. Memory is only released
+ * with the arena.
+ */
+template <class T> class ArenaAllocator {
+public:
+  typedef T value_type;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(other.arena_) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  template <class U> bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena_;
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena_;
+  }
+
+private:
+  template <class U> friend class ArenaAllocator;
+
+  Arena* arena_;
+};
+
+/**
+ * Deleter for smart pointers to objects created in an arena. The object is destroyed and its
+ * memory is released with the arena.
+ */
+template <class T> struct ArenaDeleter {
+  void operator()(T* object) const { object->~T(); }
+};
+
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include <array>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -166,12 +167,23 @@ std::string StringUtil::escape(const std::string& source) {
 }
 
 std::string AccessLogDateTimeFormatter::fromTime(const SystemTime& time) {
-  static DateFormatter date_format("%Y-%m-%dT%H:%M:%S");
+  std::string output;
+  appendTime(time, output);
+  return output;
+}
+
+void AccessLogDateTimeFormatter::appendTime(const SystemTime& time, std::string& output) {
+  const time_t seconds = std::chrono::system_clock::to_time_t(time);
+  tm current_tm;
+  gmtime_r(&seconds, &current_tm);
 
-  return fmt::format(
-      "{}.{:03d}Z", date_format.fromTime(time),
+  std::array<char, 64> buf;
+  size_t length = strftime(&buf[0], buf.size(), "%Y-%m-%dT%H:%M:%S", &current_tm);
+  const int64_t milliseconds =
       std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
-          1000);
+      1000;
+  length += snprintf(&buf[length], buf.size() - length, ".%03dZ", static_cast<int>(milliseconds));
+  output.append(&buf[0], length);
 }
 
 bool StringUtil::endsWith(const std::string& source, const std::string& end) {
@@ -40,6 +40,11 @@ private:
 class AccessLogDateTimeFormatter {
 public:
   static std::string fromTime(const SystemTime& time);
+
+  /**
+   * Append the same representation as fromTime() to a string without building a temporary.
+   */
+  static void appendTime(const SystemTime& time, std::string& output);
 };
 
 /**
@@ -153,6 +153,8 @@ void CdsJson::translateCluster(const Json::Object& json_cluster,
     cluster.set_lb_policy(envoy::api::v2::Cluster::RANDOM);
   } else if (lb_type == "original_dst_lb") {
     cluster.set_lb_policy(envoy::api::v2::Cluster::ORIGINAL_DST_LB);
+  } else if (lb_type == "maglev") {
+    cluster.set_lb_policy(Upstream::MaglevLbPolicy);
   } else {
     ASSERT(lb_type == "ring_hash");
     cluster.set_lb_policy(envoy::api::v2::Cluster::RING_HASH);
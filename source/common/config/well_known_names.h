@@ -161,6 +161,8 @@ class AccessLogNameValues {
 public:
   // File access log
   const std::string FILE = "envoy.file_access_log";
+  // File access log writing binary records
+  const std::string BINARY_FILE = "envoy.binary_file_access_log";
 };
 
 typedef ConstSingleton<AccessLogNameValues> AccessLogNames;
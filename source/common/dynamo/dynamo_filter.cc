@@ -19,6 +19,56 @@
 namespace Envoy {
 namespace Dynamo {
 
+DynamoStats::StatusStatNames::StatusStatNames(Stats::SymbolTable& symbol_table,
+                                              const std::string& prefix, uint64_t status) {
+  std::string group_string =
+      Http::CodeUtility::groupStringForResponseCode(static_cast<Http::Code>(status));
+  upstream_rq_total_group_ =
+      symbol_table.encode(fmt::format("{}.upstream_rq_total_{}", prefix, group_string));
+  upstream_rq_total_code_ =
+      symbol_table.encode(fmt::format("{}.upstream_rq_total_{}", prefix, status));
+  upstream_rq_time_group_ =
+      symbol_table.encode(fmt::format("{}.upstream_rq_time_{}", prefix, group_string));
+  upstream_rq_time_code_ =
+      symbol_table.encode(fmt::format("{}.upstream_rq_time_{}", prefix, status));
+}
+
+DynamoStats::EntityStatNames::EntityStatNames(Stats::SymbolTable& symbol_table,
+                                              const std::string& prefix)
+    : prefix_(prefix), upstream_rq_total_(symbol_table.encode(prefix + ".upstream_rq_total")),
+      upstream_rq_time_(symbol_table.encode(prefix + ".upstream_rq_time")) {}
+
+DynamoStats::DynamoStats(const std::string& stat_prefix, Stats::Scope& scope,
+                         ThreadLocal::SlotAllocator& tls)
+    : stat_prefix_(stat_prefix + "dynamodb."), scope_(scope), tls_(tls.allocateSlot()) {
+  tls_->set([](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
+    return std::make_shared<ThreadLocalStatNames>();
+  });
+}
+
+void DynamoStats::chargeEntity(const std::string& entity_type, const std::string& entity,
+                               uint64_t status, std::chrono::milliseconds latency) {
+  EntityStatNamesPtr& entity_names =
+      tls_->getTyped<ThreadLocalStatNames>().entities_[entity_type][entity];
+  if (!entity_names) {
+    entity_names.reset(new EntityStatNames(
+        scope_.symbolTable(), fmt::format("{}{}.{}", stat_prefix_, entity_type, entity)));
+  }
+
+  StatusStatNamesPtr& status_names = entity_names->status_names_[status];
+  if (!status_names) {
+    status_names.reset(new StatusStatNames(scope_.symbolTable(), entity_names->prefix_, status));
+  }
+
+  scope_.counterFromStatName(*entity_names->upstream_rq_total_).inc();
+  scope_.counterFromStatName(*status_names->upstream_rq_total_group_).inc();
+  scope_.counterFromStatName(*status_names->upstream_rq_total_code_).inc();
+
+  scope_.histogramFromStatName(*entity_names->upstream_rq_time_).recordValue(latency.count());
+  scope_.histogramFromStatName(*status_names->upstream_rq_time_group_).recordValue(latency.count());
+  scope_.histogramFromStatName(*status_names->upstream_rq_time_code_).recordValue(latency.count());
+}
+
 Http::FilterHeadersStatus DynamoFilter::decodeHeaders(Http::HeaderMap& headers, bool) {
   if (enabled_) {
     start_decode_ = std::chrono::steady_clock::now();
@@ -171,30 +221,7 @@ void DynamoFilter::chargeStatsPerEntity(const std::string& entity, const std::st
                                         uint64_t status) {
   std::chrono::milliseconds latency = std::chrono::duration_cast<std::chrono::milliseconds>(
       std::chrono::steady_clock::now() - start_decode_);
-
-  std::string group_string =
-      Http::CodeUtility::groupStringForResponseCode(static_cast<Http::Code>(status));
-
-  scope_.counter(fmt::format("{}{}.{}.upstream_rq_total", stat_prefix_, entity_type, entity)).inc();
-  scope_
-      .counter(fmt::format("{}{}.{}.upstream_rq_total_{}", stat_prefix_, entity_type, entity,
-                           group_string))
-      .inc();
-  scope_
-      .counter(fmt::format("{}{}.{}.upstream_rq_total_{}", stat_prefix_, entity_type, entity,
-                           std::to_string(status)))
-      .inc();
-
-  scope_.histogram(fmt::format("{}{}.{}.upstream_rq_time", stat_prefix_, entity_type, entity))
-      .recordValue(latency.count());
-  scope_
-      .histogram(fmt::format("{}{}.{}.upstream_rq_time_{}", stat_prefix_, entity_type, entity,
-                             group_string))
-      .recordValue(latency.count());
-  scope_
-      .histogram(fmt::format("{}{}.{}.upstream_rq_time_{}", stat_prefix_, entity_type, entity,
-                             std::to_string(status)))
-      .recordValue(latency.count());
+  stats_->chargeEntity(entity_type, entity, status, latency);
 }
 
 void DynamoFilter::chargeUnProcessedKeysStats(const Json::Object& json_body) {
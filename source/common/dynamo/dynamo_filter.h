@@ -1,11 +1,16 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "envoy/http/filter.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/symbol_table.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/dynamo/dynamo_request_parser.h"
 #include "common/json/json_loader.h"
@@ -13,6 +18,61 @@
 namespace Envoy {
 namespace Dynamo {
 
+/**
+ * The per operation and per table stats that the filter charges for every request. Each worker
+ * interns the names of an operation or table (and of a response code) the first time it sees it,
+ * so that charging them does not build a name or take a lock per request.
+ */
+class DynamoStats {
+public:
+  DynamoStats(const std::string& stat_prefix, Stats::Scope& scope, ThreadLocal::SlotAllocator& tls);
+
+  /**
+   * Charge a request to an operation or table.
+   * @param entity_type supplies the type of the entity, "operation" or "table".
+   * @param entity supplies the name of the operation or table.
+   * @param status supplies the response code.
+   * @param latency supplies the time from the start of the request to the response.
+   */
+  void chargeEntity(const std::string& entity_type, const std::string& entity, uint64_t status,
+                    std::chrono::milliseconds latency);
+
+private:
+  struct StatusStatNames {
+    StatusStatNames(Stats::SymbolTable& symbol_table, const std::string& prefix, uint64_t status);
+
+    Stats::StatNamePtr upstream_rq_total_group_;
+    Stats::StatNamePtr upstream_rq_total_code_;
+    Stats::StatNamePtr upstream_rq_time_group_;
+    Stats::StatNamePtr upstream_rq_time_code_;
+  };
+
+  typedef std::unique_ptr<StatusStatNames> StatusStatNamesPtr;
+
+  struct EntityStatNames {
+    EntityStatNames(Stats::SymbolTable& symbol_table, const std::string& prefix);
+
+    const std::string prefix_;
+    const Stats::StatNamePtr upstream_rq_total_;
+    const Stats::StatNamePtr upstream_rq_time_;
+    // Keyed by response code.
+    std::unordered_map<uint64_t, StatusStatNamesPtr> status_names_;
+  };
+
+  typedef std::unique_ptr<EntityStatNames> EntityStatNamesPtr;
+
+  struct ThreadLocalStatNames : public ThreadLocal::ThreadLocalObject {
+    // Keyed by entity type, then by entity.
+    std::unordered_map<std::string, std::unordered_map<std::string, EntityStatNamesPtr>> entities_;
+  };
+
+  const std::string stat_prefix_;
+  Stats::Scope& scope_;
+  ThreadLocal::SlotPtr tls_;
+};
+
+typedef std::shared_ptr<DynamoStats> DynamoStatsSharedPtr;
+
 /**
  * DynamoDb filter to process egress request to dynamo and capture comprehensive stats
  * It captures RPS/latencies:
@@ -21,8 +81,9 @@ namespace Dynamo {
  */
 class DynamoFilter : public Http::StreamFilter {
 public:
-  DynamoFilter(Runtime::Loader& runtime, const std::string& stat_prefix, Stats::Scope& scope)
-      : runtime_(runtime), stat_prefix_(stat_prefix + "dynamodb."), scope_(scope) {
+  DynamoFilter(Runtime::Loader& runtime, const std::string& stat_prefix, Stats::Scope& scope,
+               const DynamoStatsSharedPtr& stats)
+      : runtime_(runtime), stat_prefix_(stat_prefix + "dynamodb."), scope_(scope), stats_(stats) {
     enabled_ = runtime_.snapshot().featureEnabled("dynamodb.filter_enabled", 100);
   }
 
@@ -59,6 +120,7 @@ private:
   Runtime::Loader& runtime_;
   std::string stat_prefix_;
   Stats::Scope& scope_;
+  DynamoStatsSharedPtr stats_;
 
   bool enabled_{};
   std::string operation_{};
@@ -11,6 +11,7 @@
 #include "envoy/network/listener.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/utility.h"
 #include "common/event/file_event_impl.h"
 #include "common/event/signal_impl.h"
 #include "common/event/timer_impl.h"
@@ -29,7 +30,15 @@ DispatcherImpl::DispatcherImpl()
     : DispatcherImpl(Buffer::WatermarkFactoryPtr{new Buffer::WatermarkBufferFactory}) {}
 
 DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory)
-    : buffer_factory_(std::move(factory)), base_(event_base_new()),
+    : DispatcherImpl(std::move(factory), ProdMonotonicTimeSource::instance_) {}
+
+DispatcherImpl::DispatcherImpl(MonotonicTimeSource& time_source)
+    : DispatcherImpl(Buffer::WatermarkFactoryPtr{new Buffer::WatermarkBufferFactory}, time_source) {
+}
+
+DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory,
+                               MonotonicTimeSource& time_source)
+    : time_source_(time_source), buffer_factory_(std::move(factory)), base_(event_base_new()),
       deferred_delete_timer_(createTimer([this]() -> void { clearDeferredDeleteList(); })),
       post_timer_(createTimer([this]() -> void { runPostCallbacks(); })),
       current_to_delete_(&to_delete_1_) {}
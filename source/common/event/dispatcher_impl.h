@@ -6,6 +6,7 @@
 #include <mutex>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/connection_handler.h"
@@ -24,6 +25,8 @@ class DispatcherImpl : Logger::Loggable<Logger::Id::main>, public Dispatcher {
 public:
   DispatcherImpl();
   DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory);
+  DispatcherImpl(MonotonicTimeSource& time_source);
+  DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory, MonotonicTimeSource& time_source);
   ~DispatcherImpl();
 
   /**
@@ -60,6 +63,7 @@ public:
   void post(std::function<void()> callback) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
+  MonotonicTimeSource& timeSource() override { return time_source_; }
 
 private:
   void runPostCallbacks();
@@ -73,6 +77,7 @@ private:
 #endif
 
   Thread::ThreadId run_tid_{};
+  MonotonicTimeSource& time_source_;
   Buffer::WatermarkFactoryPtr buffer_factory_;
   Libevent::BasePtr base_;
   TimerPtr deferred_delete_timer_;
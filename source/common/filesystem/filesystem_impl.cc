@@ -1,7 +1,10 @@
 #include "common/filesystem/filesystem_impl.h"
 
 #include <dirent.h>
+#include <limits.h>
+#include <sys/uio.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <fstream>
@@ -9,6 +12,8 @@
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "envoy/common/exception.h"
 #include "envoy/event/dispatcher.h"
@@ -53,18 +58,147 @@ std::string fileReadToEnd(const std::string& path) {
   return file_string.str();
 }
 
+namespace {
+
+// The counters of a WriteRing have a single writer, so a plain increment is enough. This avoids a
+// locked instruction on every write.
+void incrementProducerCounter(std::atomic<uint64_t>& counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+/**
+ * The rings of the calling thread, keyed by file id rather than address, since a new file may be
+ * allocated where a destroyed one was. The rings are owned by their files, so when the thread exits
+ * it can only mark the rings of files which still exist as retired.
+ */
+struct ThreadRings {
+  struct Entry {
+    WriteRing* ring_; // Valid while the file exists, which it does whenever the thread writes.
+    std::weak_ptr<WriteRing> owner_;
+  };
+
+  ~ThreadRings() {
+    for (const auto& entry : entries_) {
+      WriteRingSharedPtr ring = entry.second.owner_.lock();
+      if (ring) {
+        ring->retired_.store(true, std::memory_order_release);
+      }
+    }
+  }
+
+  std::unordered_map<uint64_t, Entry> entries_;
+};
+
+} // namespace
+
+WriteRing::WriteRing(uint64_t size) : size_(size), buffer_(new char[size]) {
+  ASSERT((size & (size - 1)) == 0);
+}
+
+bool WriteRing::push(const std::string& data) {
+  const uint64_t tail = tail_.load(std::memory_order_relaxed);
+  if (size_ - (tail - head_.load(std::memory_order_acquire)) < data.size()) {
+    return false;
+  }
+
+  const uint64_t offset = tail & (size_ - 1);
+  const uint64_t first = std::min<uint64_t>(data.size(), size_ - offset);
+  memcpy(&buffer_[offset], data.data(), first);
+  memcpy(&buffer_[0], data.data() + first, data.size() - first);
+  tail_.store(tail + data.size(), std::memory_order_release);
+  return true;
+}
+
+int WriteRing::peek(iovec* iov) const {
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+  const uint64_t length = tail_.load(std::memory_order_acquire) - head;
+  if (length == 0) {
+    return 0;
+  }
+
+  const uint64_t offset = head & (size_ - 1);
+  const uint64_t first = std::min(length, size_ - offset);
+  iov[0].iov_base = &buffer_[offset];
+  iov[0].iov_len = first;
+  if (first == length) {
+    return 1;
+  }
+
+  iov[1].iov_base = &buffer_[0];
+  iov[1].iov_len = length - first;
+  return 2;
+}
+
+FlushThread::FlushThread() : thread_(new Thread::Thread([this]() -> void { threadRoutine(); })) {}
+
+FlushThread::~FlushThread() {
+  {
+    std::lock_guard<std::mutex> lock(wakeup_lock_);
+    exit_ = true;
+  }
+
+  wakeup_event_.notify_one();
+  thread_->join();
+  ASSERT(files_.empty());
+}
+
+void FlushThread::addFile(FileImpl& file) {
+  std::lock_guard<std::mutex> lock(files_lock_);
+  files_.push_back(&file);
+}
+
+void FlushThread::removeFile(FileImpl& file) {
+  std::lock_guard<std::mutex> lock(files_lock_);
+  files_.remove(&file);
+}
+
+void FlushThread::wakeup() {
+  // Only the first wakeup since the flush thread last started flushing takes the lock.
+  if (!wakeup_pending_.exchange(true)) {
+    std::lock_guard<std::mutex> lock(wakeup_lock_);
+    wakeup_event_.notify_one();
+  }
+}
+
+void FlushThread::threadRoutine() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(wakeup_lock_);
+      wakeup_event_.wait(lock, [this]() -> bool { return wakeup_pending_ || exit_; });
+      if (exit_) {
+        return;
+      }
+
+      // Clear the flag before flushing, so that writes made during the flush wake us up again.
+      wakeup_pending_ = false;
+    }
+
+    std::lock_guard<std::mutex> lock(files_lock_);
+    for (FileImpl* file : files_) {
+      file->flushQueued();
+    }
+  }
+}
+
+std::atomic<uint64_t> FileImpl::next_id_;
+
 FileImpl::FileImpl(const std::string& path, Event::Dispatcher& dispatcher,
                    Thread::BasicLockable& lock, Stats::Store& stats_store,
-                   std::chrono::milliseconds flush_interval_msec)
-    : path_(path), file_lock_(lock), flush_timer_(dispatcher.createTimer([this]() -> void {
+                   std::chrono::milliseconds flush_interval_msec, FlushThreadSharedPtr flush_thread,
+                   WriteOverflowPolicy overflow_policy)
+    : id_(next_id_++), path_(path), file_lock_(lock),
+      flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notify_one();
+        flush_thread_->wakeup();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
       os_sys_calls_(Api::OsSysCallsSingleton::get()), flush_interval_msec_(flush_interval_msec),
+      overflow_policy_(overflow_policy),
       stats_{FILESYSTEM_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
-                              POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {
+                              POOL_GAUGE_PREFIX(stats_store, "filesystem."))},
+      flush_thread_(flush_thread != nullptr ? flush_thread : std::make_shared<FlushThread>()) {
   open();
+  flush_thread_->addFile(*this);
 }
 
 void FileImpl::open() {
@@ -79,136 +213,259 @@ void FileImpl::open() {
 void FileImpl::reopen() { reopen_file_ = true; }
 
 FileImpl::~FileImpl() {
-  {
-    std::unique_lock<std::mutex> lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notify_one();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flush_thread_->removeFile(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (fd_ != -1) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
-    }
-
+    flush();
     os_sys_calls_.close(fd_);
   }
 }
 
-void FileImpl::doWrite(Buffer::Instance& buffer) {
-  uint64_t num_slices = buffer.getRawSlices(nullptr, 0);
-  Buffer::RawSlice slices[num_slices];
-  buffer.getRawSlices(slices, num_slices);
-
-  // We must do the actual writes to disk under lock, so that we don't intermix chunks from
-  // different FileImpl pointing to the same underlying file. This can happen either via hot
-  // restart or if calling code opens the same underlying file into a different FileImpl in the
-  // same process.
-  // TODO PERF: Currently, we use a single cross process lock to serialize all disk writes. This
-  //            will never block network workers, but does mean that only a single flush thread can
-  //            actually flush to disk. In the future it would be nice if we did away with the cross
-  //            process lock or had multiple locks.
+void FileImpl::doWrite(bool allow_reopen) {
+  std::vector<WriteRing*> rings;
+  std::vector<bool> retired;
+  std::vector<iovec> iovecs;
+  std::vector<uint64_t> ring_lengths;
+  uint64_t total_length = 0;
+
+  // Overflow writes are written after the rings. A thread which has overflowed keeps writing to
+  // the overflow buffer until it is taken here, so its writes stay in order. The rings are peeked
+  // under the same lock that the overflow buffer is taken under. Any ring write made before an
+  // overflow write is then included in the peek, and no ring write can be made between the peek
+  // and the overflow flag being cleared.
   {
+    std::lock_guard<std::mutex> lock(overflow_lock_);
+
+    // Rings are only removed below, under flush_lock_, so a snapshot of the list is enough to flush
+    // from. Rings added after the snapshot are picked up by the next flush.
+    {
+      std::lock_guard<std::mutex> rings_lock(rings_lock_);
+      for (const WriteRingSharedPtr& ring : rings_) {
+        rings.push_back(ring.get());
+      }
+    }
+
+    for (WriteRing* ring : rings) {
+      // A ring which was retired before it is peeked gets no more writes, so it is empty once what
+      // is peeked here has been consumed.
+      retired.push_back(ring->retired_.load(std::memory_order_acquire));
+      iovec ring_iovecs[2];
+      const int num_iovecs = ring->peek(ring_iovecs);
+      uint64_t ring_length = 0;
+      for (int i = 0; i < num_iovecs; i++) {
+        iovecs.push_back(ring_iovecs[i]);
+        ring_length += ring_iovecs[i].iov_len;
+      }
+      ring_lengths.push_back(ring_length);
+      total_length += ring_length;
+    }
+
+    about_to_write_buffer_.move(overflow_buffer_);
+    for (WriteRing* ring : rings) {
+      ring->overflowed_.store(false, std::memory_order_relaxed);
+    }
+  }
+
+  for (size_t i = 0; i < rings.size(); i++) {
+    publishStats(*rings[i], rings[i]->head() + ring_lengths[i]);
+  }
+
+  const uint64_t num_slices = about_to_write_buffer_.getRawSlices(nullptr, 0);
+  Buffer::RawSlice slices[num_slices];
+  about_to_write_buffer_.getRawSlices(slices, num_slices);
+  for (const Buffer::RawSlice& slice : slices) {
+    iovecs.push_back({slice.mem_, slice.len_});
+    total_length += slice.len_;
+  }
+
+  if (total_length == 0) {
+    removeRetiredRings(rings, retired);
+    return;
+  }
+
+  // If we failed to open the file before (-1 == fd_), the data is discarded.
+  if (allow_reopen && reopen_file_ && fd_ != -1) {
+    try {
+      reopen_file_ = false;
+      os_sys_calls_.close(fd_);
+      open();
+    } catch (const EnvoyException&) {
+      stats_.reopen_failed_.inc();
+    }
+  }
+
+  if (fd_ != -1) {
+    // We must do the actual writes to disk under lock, so that we don't intermix chunks from
+    // different FileImpl pointing to the same underlying file. This can happen either via hot
+    // restart or if calling code opens the same underlying file into a different FileImpl in the
+    // same process.
     std::lock_guard<Thread::BasicLockable> lock(file_lock_);
-    for (Buffer::RawSlice& slice : slices) {
-      ssize_t rc = os_sys_calls_.write(fd_, slice.mem_, slice.len_);
-      ASSERT(rc == static_cast<ssize_t>(slice.len_));
-      UNREFERENCED_PARAMETER(rc);
+    ssize_t written = 0;
+    for (size_t i = 0; i < iovecs.size(); i += IOV_MAX) {
+      const int num_iovecs = std::min<size_t>(IOV_MAX, iovecs.size() - i);
+      written += os_sys_calls_.writev(fd_, &iovecs[i], num_iovecs);
       stats_.write_completed_.inc();
     }
+    ASSERT(written == static_cast<ssize_t>(total_length));
+    UNREFERENCED_PARAMETER(written);
   }
 
-  stats_.write_total_buffered_.sub(buffer.length());
-  buffer.drain(buffer.length());
+  for (size_t i = 0; i < rings.size(); i++) {
+    rings[i]->consume(ring_lengths[i]);
+  }
+  about_to_write_buffer_.drain(about_to_write_buffer_.length());
+  stats_.write_total_buffered_.sub(total_length);
+  removeRetiredRings(rings, retired);
+
+  // Wake up any writers waiting for space. Taking the lock orders this after a waiting writer's
+  // failed push, so the notification cannot be missed.
+  { std::lock_guard<std::mutex> lock(space_lock_); }
+  space_event_.notify_all();
 }
 
-void FileImpl::flushThreadFunc() {
+void FileImpl::publishStats(WriteRing& ring, uint64_t tail) {
+  stats_.write_total_buffered_.add(tail - ring.published_tail_);
+  ring.published_tail_ = tail;
 
-  while (true) {
-    std::unique_lock<std::mutex> flush_lock;
+  const uint64_t writes = ring.writes_.load(std::memory_order_relaxed);
+  stats_.write_buffered_.add(writes - ring.published_writes_);
+  ring.published_writes_ = writes;
 
-    {
-      std::unique_lock<std::mutex> write_lock(write_lock_);
+  const uint64_t dropped = ring.dropped_.load(std::memory_order_relaxed);
+  stats_.write_dropped_.add(dropped - ring.published_dropped_);
+  ring.published_dropped_ = dropped;
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_) {
-        flush_event_.wait(write_lock);
-      }
+  const uint64_t blocked = ring.blocked_.load(std::memory_order_relaxed);
+  stats_.write_blocked_.add(blocked - ring.published_blocked_);
+  ring.published_blocked_ = blocked;
+}
 
-      if (flush_thread_exit_) {
-        return;
-      }
+void FileImpl::flushQueued() {
+  std::lock_guard<std::mutex> flush_lock(flush_lock_);
+  doWrite(true);
+}
 
-      flush_lock = std::unique_lock<std::mutex>(flush_lock_);
-      ASSERT(flush_buffer_.length() > 0);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-    }
+void FileImpl::flush() {
+  std::lock_guard<std::mutex> flush_lock(flush_lock_);
+  doWrite(false);
+}
 
-    // if we failed to open file before (-1 == fd_), then simply ignore
-    if (fd_ != -1) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          os_sys_calls_.close(fd_);
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
-      }
+void FileImpl::write(const std::string& data) {
+  std::call_once(start_flush_timer_,
+                 [this]() -> void { flush_timer_->enableTimer(flush_interval_msec_); });
+
+  // Once a write has overflowed, later ones follow it until the flush thread takes it, whatever the
+  // policy. Otherwise they would go into the ring and be written out before it.
+  WriteRing& ring = threadRing();
+  if (data.size() > RING_SIZE || ring.overflowed_.load(std::memory_order_relaxed)) {
+    writeOverflow(ring, data);
+    return;
+  }
+
+  if (!pushToRing(ring, data)) {
+    if (overflow_policy_ == WriteOverflowPolicy::Spill) {
+      writeOverflow(ring, data);
+    } else {
+      incrementProducerCounter(ring.dropped_);
     }
+    return;
+  }
+
+  incrementProducerCounter(ring.writes_);
+  if (ring.used() >= MIN_FLUSH_SIZE) {
+    flush_thread_->wakeup();
   }
 }
 
-void FileImpl::flush() {
-  std::unique_lock<std::mutex> flush_buffer_lock;
+bool FileImpl::pushToRing(WriteRing& ring, const std::string& data) {
+  switch (overflow_policy_) {
+  case WriteOverflowPolicy::Spill:
+  case WriteOverflowPolicy::Drop:
+    return ring.push(data);
 
-  {
-    std::lock_guard<std::mutex> write_lock(write_lock_);
+  case WriteOverflowPolicy::Sample:
+    // Shed load gradually rather than dropping everything once the ring is full.
+    if (ring.used() + data.size() > ring.size() / 2 && ring.sampled_++ % SAMPLE_RATE != 0) {
+      return false;
+    }
+    return ring.push(data);
 
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<std::mutex>(flush_lock_);
+  case WriteOverflowPolicy::Block:
+    if (ring.push(data)) {
+      return true;
+    }
 
-    if (flush_buffer_.length() == 0) {
-      return;
+    incrementProducerCounter(ring.blocked_);
+    while (true) {
+      flush_thread_->wakeup();
+      std::unique_lock<std::mutex> lock(space_lock_);
+      if (ring.push(data)) {
+        return true;
+      }
+      space_event_.wait(lock);
     }
+  }
 
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+  NOT_REACHED;
+}
+
+void FileImpl::writeOverflow(WriteRing& ring, const std::string& data) {
+  {
+    std::lock_guard<std::mutex> lock(overflow_lock_);
+    overflow_buffer_.add(data);
+    ring.overflowed_.store(true, std::memory_order_relaxed);
   }
 
-  doWrite(about_to_write_buffer_);
+  stats_.write_buffered_.inc();
+  stats_.write_total_buffered_.add(data.size());
+  flush_thread_->wakeup();
 }
 
-void FileImpl::write(const std::string& data) {
-  std::lock_guard<std::mutex> lock(write_lock_);
+uint64_t FileImpl::numRings() {
+  std::lock_guard<std::mutex> lock(rings_lock_);
+  return rings_.size();
+}
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+void FileImpl::removeRetiredRings(const std::vector<WriteRing*>& rings,
+                                  const std::vector<bool>& retired) {
+  if (std::find(retired.begin(), retired.end(), true) == retired.end()) {
+    return;
   }
 
-  stats_.write_buffered_.inc();
-  stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data);
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notify_one();
+  std::lock_guard<std::mutex> lock(rings_lock_);
+  for (size_t i = 0; i < rings.size(); i++) {
+    if (retired[i]) {
+      ASSERT(rings[i]->used() == 0);
+      rings_.erase(
+          std::find_if(rings_.begin(), rings_.end(), [&](const WriteRingSharedPtr& ring) -> bool {
+            return ring.get() == rings[i];
+          }));
+    }
   }
 }
 
-void FileImpl::createFlushStructures() {
-  flush_thread_.reset(new Thread::Thread([this]() -> void { flushThreadFunc(); }));
-  flush_timer_->enableTimer(flush_interval_msec_);
+WriteRing& FileImpl::threadRing() {
+  static thread_local ThreadRings thread_rings;
+  auto it = thread_rings.entries_.find(id_);
+  if (it != thread_rings.entries_.end()) {
+    return *it->second.ring_;
+  }
+
+  // Entries of destroyed files are never looked up again, so drop them while adding a new one.
+  for (auto entry = thread_rings.entries_.begin(); entry != thread_rings.entries_.end();) {
+    if (entry->second.owner_.expired()) {
+      entry = thread_rings.entries_.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+
+  WriteRingSharedPtr ring(new WriteRing(RING_SIZE));
+  thread_rings.entries_[id_] = {ring.get(), ring};
+  std::lock_guard<std::mutex> lock(rings_lock_);
+  rings_.push_back(ring);
+  return *ring;
 }
 
 } // namespace Filesystem
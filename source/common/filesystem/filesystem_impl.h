@@ -4,8 +4,11 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdint>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "envoy/api/os_sys_calls.h"
 #include "envoy/event/dispatcher.h"
@@ -20,6 +23,8 @@ namespace Envoy {
 #define FILESYSTEM_STATS(COUNTER, GAUGE)                                                           \
   COUNTER(write_buffered)                                                                          \
   COUNTER(write_completed)                                                                         \
+  COUNTER(write_dropped)                                                                           \
+  COUNTER(write_blocked)                                                                           \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
   GAUGE  (write_total_buffered)
@@ -47,17 +52,134 @@ bool directoryExists(const std::string& path);
  */
 std::string fileReadToEnd(const std::string& path);
 
+/**
+ * Single producer, single consumer ring of bytes. Only the producer moves the tail and only the
+ * consumer moves the head, so neither side takes a lock. Head and tail count bytes since the ring
+ * was created and are reduced modulo the size (a power of two) to index the buffer.
+ */
+class WriteRing {
+public:
+  WriteRing(uint64_t size);
+
+  /**
+   * Append data to the ring. Must only be called by the producer.
+   * @return bool false if there was not enough free space, in which case nothing was appended.
+   */
+  bool push(const std::string& data);
+
+  /**
+   * Describe the queued data. Must only be called by the consumer.
+   * @param iov supplies an array of at least two entries which is filled in with the queued data.
+   * @return int the number of entries used.
+   */
+  int peek(iovec* iov) const;
+
+  /**
+   * Release data previously returned by peek(). Must only be called by the consumer.
+   */
+  void consume(uint64_t length) {
+    head_.store(head_.load(std::memory_order_relaxed) + length, std::memory_order_release);
+  }
+
+  /**
+   * @return uint64_t the number of bytes consumed since the ring was created. Must only be called
+   *         by the consumer.
+   */
+  uint64_t head() const { return head_.load(std::memory_order_relaxed); }
+
+  /**
+   * @return uint64_t the number of bytes queued. May be called by either side.
+   */
+  uint64_t used() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  uint64_t size() const { return size_; }
+
+  // Counters which are only incremented by the producer. The consumer publishes them to stats.
+  std::atomic<uint64_t> writes_{};
+  std::atomic<uint64_t> dropped_{};
+  std::atomic<uint64_t> blocked_{};
+  uint64_t sampled_{}; // Producer only.
+  // Set by the producer when it queues a write in the overflow buffer, and cleared by the consumer
+  // when it takes the overflow buffer. While set, later writes must follow the overflow buffer
+  // rather than go into the ring, so that they stay in order.
+  std::atomic<bool> overflowed_{};
+  // Set when the producer's thread exits. The consumer removes the ring once it has been emptied.
+  std::atomic<bool> retired_{};
+
+  // Totals already published to stats. Consumer only.
+  uint64_t published_tail_{};
+  uint64_t published_writes_{};
+  uint64_t published_dropped_{};
+  uint64_t published_blocked_{};
+
+private:
+  const uint64_t size_;
+  std::unique_ptr<char[]> buffer_;
+  // Keep the producer and consumer positions on separate cache lines.
+  alignas(64) std::atomic<uint64_t> head_{};
+  alignas(64) std::atomic<uint64_t> tail_{};
+};
+
+typedef std::shared_ptr<WriteRing> WriteRingSharedPtr;
+
+class FileImpl;
+
+/**
+ * A single thread that flushes buffered writes to disk for any number of files. It flushes every
+ * file whenever it is woken up, either by a file's flush timer or because a file's buffers are
+ * filling up.
+ */
+class FlushThread {
+public:
+  FlushThread();
+  ~FlushThread();
+
+  void addFile(FileImpl& file);
+
+  /**
+   * Stop flushing a file. Once this returns the flush thread is not touching the file.
+   */
+  void removeFile(FileImpl& file);
+
+  /**
+   * Wake up the flush thread. May be called from any thread.
+   */
+  void wakeup();
+
+private:
+  void threadRoutine();
+
+  std::mutex files_lock_; // Held while flushing, so that files are not removed mid flush.
+  std::list<FileImpl*> files_;
+  std::mutex wakeup_lock_;
+  std::condition_variable wakeup_event_;
+  std::atomic<bool> wakeup_pending_{};
+  bool exit_{};
+  Thread::ThreadPtr thread_;
+};
+
+typedef std::shared_ptr<FlushThread> FlushThreadSharedPtr;
+
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore queued and written to disk by a flush thread, which is shared by all of the
+ * files created by an Api::Impl.
+ *
+ * Each thread which writes to the file gets its own WriteRing, so writers never contend with each
+ * other or take a lock. The flush thread writes out the rings of all threads with one writev(), and
+ * removes the ring of a thread which has exited once it is empty.
+ * When a thread's ring is full the WriteOverflowPolicy decides whether the write is queued in an
+ * overflow buffer under a lock, waits, is dropped or is sampled.
  */
 class FileImpl : public File {
 public:
   FileImpl(const std::string& path, Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-           Stats::Store& stats_store, std::chrono::milliseconds flush_interval_msec);
+           Stats::Store& stats_store, std::chrono::milliseconds flush_interval_msec,
+           FlushThreadSharedPtr flush_thread = nullptr,
+           WriteOverflowPolicy overflow_policy = WriteOverflowPolicy::Spill);
   ~FileImpl();
 
   // Filesystem::File
@@ -74,52 +196,70 @@ public:
   // Fileystem::File
   void flush() override;
 
+  /**
+   * Write out everything which is currently queued. Called by the flush thread.
+   */
+  void flushQueued();
+
+  /**
+   * @return uint64_t the number of writing threads which have a ring.
+   */
+  uint64_t numRings();
+
+  // Size of the ring of each writing thread. Writes larger than this are queued under a lock.
+  static const uint64_t RING_SIZE = 1024 * 32;
+  // Once the ring of a thread is this full, the flush thread will be told to flush.
+  static const uint64_t MIN_FLUSH_SIZE = RING_SIZE / 2;
+  // With WriteOverflowPolicy::Sample, one in this many writes is kept once a ring is half full.
+  static const uint64_t SAMPLE_RATE = 10;
+
 private:
-  void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  WriteRing& threadRing();
+  bool pushToRing(WriteRing& ring, const std::string& data);
+  void writeOverflow(WriteRing& ring, const std::string& data);
+  void doWrite(bool allow_reopen);
+  void publishStats(WriteRing& ring, uint64_t tail);
+  void removeRetiredRings(const std::vector<WriteRing*>& rings, const std::vector<bool>& retired);
   void open();
-  void createFlushStructures();
 
-  // Minimum size before the flush thread will be told to flush.
-  static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+  static std::atomic<uint64_t> next_id_;
 
+  const uint64_t id_; // Unique for the life of the process, unlike the address of the file.
   int fd_;
   std::string path_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
-  //    3) file_lock_
-  Thread::BasicLockable& file_lock_; // This lock is used only by the flush thread when writing
-                                     // to disk. This is used to make sure that file blocks do
-                                     // not get interleaved by multiple processes writing to
-                                     // the same file during hot-restart.
+  //    1) flush_lock_
+  //    2) overflow_lock_
+  //    3) rings_lock_
+  //    4) file_lock_
+  Thread::BasicLockable& file_lock_; // This lock is used only when writing to disk. This is used
+                                     // to make sure that file blocks do not get interleaved by
+                                     // multiple processes writing to the same file during
+                                     // hot-restart.
   std::mutex flush_lock_;            // This lock is used to prevent simulataneous flushes from
-                                     // the flush thread and a syncronous flush. This protects
-                                     // concurrent access to the about_to_write_buffer_, fd_,
+                                     // the flush thread and a syncronous flush. This protects fd_
                                      // and all other data used during flushing and file
                                      // re-opening.
-  std::mutex write_lock_;            // The lock is used when filling the flush buffer. It allows
-                                     // multiple threads to write to the same file at relatively
-                                     // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  std::condition_variable_any flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  std::mutex rings_lock_;            // Protects rings_, which grows when a new thread writes and
+                                     // shrinks when a thread which wrote exits.
+  std::vector<WriteRingSharedPtr> rings_;
+  std::mutex overflow_lock_;        // Protects overflow_buffer_.
+  Buffer::OwnedImpl overflow_buffer_; // Writes which did not fit in a ring.
+  Buffer::OwnedImpl about_to_write_buffer_; // Overflow writes being flushed. This buffer is only
+                                            // used under flush_lock_.
+  std::mutex space_lock_;            // Used with space_event_ by writers waiting for ring space.
+  std::condition_variable space_event_;
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl flush_buffer_; // This buffer is used by multiple threads. It gets filled and
-                                   // then flushed either when max size is reached or when a timer
-                                   // fires.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
+  std::once_flag start_flush_timer_;
   Event::TimerPtr flush_timer_;
   Api::OsSysCalls& os_sys_calls_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
+  const WriteOverflowPolicy overflow_policy_;
   FileSystemStats stats_;
+  FlushThreadSharedPtr flush_thread_;
 };
 
 } // namespace Filesystem
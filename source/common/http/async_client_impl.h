@@ -123,7 +123,9 @@ private:
   struct NullShadowPolicy : public Router::ShadowPolicy {
     // Router::ShadowPolicy
     const std::string& cluster() const override { return EMPTY_STRING; }
-    const std::string& runtimeKey() const override { return EMPTY_STRING; }
+    const Runtime::Key& runtimeKey() const override { return runtime_key_; }
+
+    static const Runtime::Key runtime_key_;
   };
 
   struct NullVirtualHost : public Router::VirtualHost {
@@ -1,6 +1,7 @@
 #include "common/http/codes.h"
 
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "envoy/http/header_map.h"
@@ -16,6 +17,60 @@
 namespace Envoy {
 namespace Http {
 
+CodeStatNames::CodeStatNames(Stats::SymbolTable& symbol_table) : symbol_table_(symbol_table) {
+  for (uint64_t code = MIN_CODE; code <= MAX_CODE; code++) {
+    if (strcmp(CodeUtility::toString(static_cast<Code>(code)), "Unknown") != 0) {
+      code_names_[code - MIN_CODE].reset(new Names());
+      encode(*code_names_[code - MIN_CODE], std::to_string(code));
+    }
+  }
+
+  for (uint64_t group = 0; group < group_names_.size(); group++) {
+    encode(group_names_[group], fmt::format("{}xx", group + 2));
+  }
+}
+
+const CodeStatNames::Names* CodeStatNames::codeNames(uint64_t code) const {
+  if (code < MIN_CODE || code > MAX_CODE) {
+    return nullptr;
+  }
+
+  return code_names_[code - MIN_CODE].get();
+}
+
+const CodeStatNames::Names* CodeStatNames::groupNames(uint64_t code) const {
+  if (code < 200 || code >= 600) {
+    return nullptr;
+  }
+
+  return &group_names_[code / 100 - 2];
+}
+
+void CodeStatNames::encode(Names& names, const std::string& code_string) {
+  names.upstream_rq_ = symbol_table_.encode("upstream_rq_" + code_string);
+  names.canary_upstream_rq_ = symbol_table_.encode("canary.upstream_rq_" + code_string);
+  names.internal_upstream_rq_ = symbol_table_.encode("internal.upstream_rq_" + code_string);
+  names.external_upstream_rq_ = symbol_table_.encode("external.upstream_rq_" + code_string);
+}
+
+namespace {
+
+void chargeClusterResponseStat(const CodeUtility::ResponseStatInfo& info,
+                               const CodeStatNames::Names& names) {
+  info.cluster_scope_.counterFromStatName(*names.upstream_rq_).inc();
+  if (info.upstream_canary_) {
+    info.cluster_scope_.counterFromStatName(*names.canary_upstream_rq_).inc();
+  }
+
+  if (info.internal_request_) {
+    info.cluster_scope_.counterFromStatName(*names.internal_upstream_rq_).inc();
+  } else {
+    info.cluster_scope_.counterFromStatName(*names.external_upstream_rq_).inc();
+  }
+}
+
+} // namespace
+
 void CodeUtility::chargeBasicResponseStat(Stats::Scope& scope, const std::string& prefix,
                                           Code response_code) {
   // Build a dynamic stat for the response code and increment it.
@@ -26,33 +81,50 @@ void CodeUtility::chargeBasicResponseStat(Stats::Scope& scope, const std::string
 
 void CodeUtility::chargeResponseStat(const ResponseStatInfo& info) {
   const uint64_t response_code = info.response_status_code_;
-  chargeBasicResponseStat(info.cluster_scope_, info.prefix_, static_cast<Code>(response_code));
-
   std::string group_string = groupStringForResponseCode(static_cast<Code>(response_code));
 
-  // If the response is from a canary, also create canary stats.
-  if (info.upstream_canary_) {
-    info.cluster_scope_.counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, group_string))
-        .inc();
-    info.cluster_scope_.counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, response_code))
-        .inc();
+  // The interned names are relative to the cluster scope, so they can only be used without a
+  // prefix, and only if they are encoded in the cluster scope's table.
+  const CodeStatNames::Names* code_names = nullptr;
+  const CodeStatNames::Names* group_names = nullptr;
+  if (info.stat_names_ != nullptr && info.prefix_.empty() &&
+      &info.stat_names_->symbolTable() == &info.cluster_scope_.symbolTable()) {
+    code_names = info.stat_names_->codeNames(response_code);
+    group_names = info.stat_names_->groupNames(response_code);
   }
 
-  // Split stats into external vs. internal.
-  if (info.internal_request_) {
-    info.cluster_scope_
-        .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, group_string))
-        .inc();
-    info.cluster_scope_
-        .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, response_code))
-        .inc();
+  if (code_names != nullptr && group_names != nullptr) {
+    chargeClusterResponseStat(info, *group_names);
+    chargeClusterResponseStat(info, *code_names);
   } else {
-    info.cluster_scope_
-        .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, group_string))
-        .inc();
-    info.cluster_scope_
-        .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, response_code))
-        .inc();
+    chargeBasicResponseStat(info.cluster_scope_, info.prefix_, static_cast<Code>(response_code));
+
+    // If the response is from a canary, also create canary stats.
+    if (info.upstream_canary_) {
+      info.cluster_scope_
+          .counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, group_string))
+          .inc();
+      info.cluster_scope_
+          .counter(fmt::format("{}canary.upstream_rq_{}", info.prefix_, response_code))
+          .inc();
+    }
+
+    // Split stats into external vs. internal.
+    if (info.internal_request_) {
+      info.cluster_scope_
+          .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, group_string))
+          .inc();
+      info.cluster_scope_
+          .counter(fmt::format("{}internal.upstream_rq_{}", info.prefix_, response_code))
+          .inc();
+    } else {
+      info.cluster_scope_
+          .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, group_string))
+          .inc();
+      info.cluster_scope_
+          .counter(fmt::format("{}external.upstream_rq_{}", info.prefix_, response_code))
+          .inc();
+    }
   }
 
   // Handle request virtual cluster.
@@ -1,16 +1,64 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 
 #include "envoy/http/codes.h"
 #include "envoy/http/header_map.h"
 #include "envoy/stats/stats.h"
+#include "envoy/stats/symbol_table.h"
 
 namespace Envoy {
 namespace Http {
 
+/**
+ * The cluster stat names that CodeUtility::chargeResponseStat() charges for each response code and
+ * code group, interned once in a store's symbol table. Charging them then does not build or hash a
+ * string per response.
+ */
+class CodeStatNames {
+public:
+  /**
+   * The names charged for one response code (e.g. "200") or code group (e.g. "2xx").
+   */
+  struct Names {
+    Stats::StatNamePtr upstream_rq_;
+    Stats::StatNamePtr canary_upstream_rq_;
+    Stats::StatNamePtr internal_upstream_rq_;
+    Stats::StatNamePtr external_upstream_rq_;
+  };
+
+  CodeStatNames(Stats::SymbolTable& symbol_table);
+
+  /**
+   * @return the names for a response code, or nullptr if the code is not a known Http::Code.
+   */
+  const Names* codeNames(uint64_t code) const;
+
+  /**
+   * @return the names for the group of a response code, or nullptr if the code is not a 2xx, 3xx,
+   *         4xx or 5xx code.
+   */
+  const Names* groupNames(uint64_t code) const;
+
+  Stats::SymbolTable& symbolTable() const { return symbol_table_; }
+
+private:
+  static const uint64_t MIN_CODE = 100;
+  static const uint64_t MAX_CODE = 599;
+
+  void encode(Names& names, const std::string& code_string);
+
+  Stats::SymbolTable& symbol_table_;
+  // Indexed by code - MIN_CODE. Null for codes which are not a known Http::Code.
+  std::array<std::unique_ptr<Names>, MAX_CODE - MIN_CODE + 1> code_names_;
+  // Indexed by code / 100 - 2.
+  std::array<Names, 4> group_names_;
+};
+
 /**
  * General utility routines for HTTP codes.
  */
@@ -33,6 +81,8 @@ public:
     const std::string& from_zone_;
     const std::string& to_zone_;
     bool upstream_canary_;
+    // Optional. If set and the prefix is empty, the cluster stats are charged by interned name.
+    const CodeStatNames* stat_names_;
   };
 
   /**
@@ -25,6 +25,7 @@
 
 #include "common/access_log/request_info_impl.h"
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena.h"
 #include "common/common/linked_object.h"
 #include "common/http/date_provider.h"
 #include "common/http/user_agent.h"
@@ -324,6 +325,18 @@ public:
 
 private:
   struct ActiveStream;
+  struct ActiveStreamDecoderFilter;
+  struct ActiveStreamEncoderFilter;
+
+  // Filter wrappers and the list nodes which hold them are allocated from the stream's arena.
+  typedef std::unique_ptr<ActiveStreamDecoderFilter, ArenaDeleter<ActiveStreamDecoderFilter>>
+      ActiveStreamDecoderFilterPtr;
+  typedef std::list<ActiveStreamDecoderFilterPtr, ArenaAllocator<ActiveStreamDecoderFilterPtr>>
+      ActiveStreamDecoderFilterList;
+  typedef std::unique_ptr<ActiveStreamEncoderFilter, ArenaDeleter<ActiveStreamEncoderFilter>>
+      ActiveStreamEncoderFilterPtr;
+  typedef std::list<ActiveStreamEncoderFilterPtr, ArenaAllocator<ActiveStreamEncoderFilterPtr>>
+      ActiveStreamEncoderFilterList;
 
   /**
    * Base class wrapper for both stream encoder and decoder filters.
@@ -371,7 +384,8 @@ private:
    */
   struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
                                      public StreamDecoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamDecoderFilter> {
+                                     LinkedObject<ActiveStreamDecoderFilter,
+                                                  ActiveStreamDecoderFilterList> {
     ActiveStreamDecoderFilter(ActiveStream& parent, StreamDecoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -421,14 +435,13 @@ private:
     StreamDecoderFilterSharedPtr handle_;
   };
 
-  typedef std::unique_ptr<ActiveStreamDecoderFilter> ActiveStreamDecoderFilterPtr;
-
   /**
    * Wrapper for a stream encoder filter.
    */
   struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
                                      public StreamEncoderFilterCallbacks,
-                                     LinkedObject<ActiveStreamEncoderFilter> {
+                                     LinkedObject<ActiveStreamEncoderFilter,
+                                                  ActiveStreamEncoderFilterList> {
     ActiveStreamEncoderFilter(ActiveStream& parent, StreamEncoderFilterSharedPtr filter,
                               bool dual_filter)
         : ActiveStreamFilterBase(parent, dual_filter), handle_(filter) {}
@@ -464,8 +477,6 @@ private:
     StreamEncoderFilterSharedPtr handle_;
   };
 
-  typedef std::unique_ptr<ActiveStreamEncoderFilter> ActiveStreamEncoderFilterPtr;
-
   /**
    * Wraps a single active stream on the connection. These are either full request/response pairs
    * or pushes.
@@ -483,8 +494,8 @@ private:
     void addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr filter, bool dual_filter);
     void addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr filter, bool dual_filter);
     void chargeStats(HeaderMap& headers);
-    std::list<ActiveStreamEncoderFilterPtr>::iterator
-    commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream);
+    ActiveStreamEncoderFilterList::iterator commonEncodePrefix(ActiveStreamEncoderFilter* filter,
+                                                               bool end_stream);
     uint64_t connectionId();
     const Network::Connection* connection();
     Ssl::Connection* ssl();
@@ -571,7 +582,13 @@ private:
     // Possibly increases buffer_limit_ to the value of limit.
     void setBufferLimit(uint32_t limit);
 
+    // Room for about a dozen filter wrappers, and their list nodes, without going to the heap.
+    static const size_t ARENA_SIZE = 1536;
+
     ConnectionManagerImpl& connection_manager_;
+    // Memory for the filter chain, which is released when the stream is deleted. Declared before
+    // anything allocated from it.
+    InlineArena<ARENA_SIZE> arena_;
     Router::ConfigConstSharedPtr snapped_route_config_;
     Tracing::SpanPtr active_span_;
     const uint64_t stream_id_;
@@ -582,10 +599,11 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
-    std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
-    std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
-    std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
-    Stats::TimespanPtr request_timer_;
+    ActiveStreamDecoderFilterList decoder_filters_;
+    ActiveStreamEncoderFilterList encoder_filters_;
+    std::list<AccessLog::InstanceSharedPtr, ArenaAllocator<AccessLog::InstanceSharedPtr>>
+        access_log_handlers_;
+    Stats::Timespan request_timer_;
     State state_;
     AccessLog::RequestInfoImpl request_info_;
     Optional<Router::RouteConstSharedPtr> cached_route_;
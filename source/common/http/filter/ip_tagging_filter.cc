@@ -1,15 +1,190 @@
 #include "common/http/filter/ip_tagging_filter.h"
 
+#include <unordered_map>
+
+#include "envoy/common/exception.h"
+#include "envoy/network/connection.h"
+
+#include "common/http/headers.h"
+#include "common/json/json_loader.h"
+#include "common/network/cidr_range.h"
+#include "common/network/utility.h"
+
+#include "fmt/format.h"
+
 namespace Envoy {
 namespace Http {
 
+namespace {
+
+/**
+ * @return the range for an entry of an "ip_list". Entries are either CIDR ranges or single
+ *         addresses.
+ */
+Network::Address::CidrRange parseRange(const std::string& entry) {
+  Network::Address::CidrRange range;
+  try {
+    if (entry.find('/') != std::string::npos) {
+      range = Network::Address::CidrRange::create(entry);
+    } else {
+      // The length is reduced to the address length of the IP version.
+      range =
+          Network::Address::CidrRange::create(Network::Utility::parseInternetAddress(entry), 128);
+    }
+  } catch (const EnvoyException&) {
+  }
+
+  if (!range.isValid()) {
+    throw EnvoyException(fmt::format(
+        "ip tagging: invalid ip/mask combo '{}' (format is <ip>[/<# mask bits>])", entry));
+  }
+  return range;
+}
+
+} // namespace
+
+IpTagTable::IpTagTable(const std::vector<Json::ObjectSharedPtr>& config,
+                       const std::string& stat_prefix, Stats::Scope& scope)
+    : trie_([&]() {
+        // A tag may be listed more than once, its ranges are merged.
+        std::unordered_map<std::string, uint32_t> tag_indexes;
+        std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>> data;
+        for (const Json::ObjectSharedPtr& ip_tag : config) {
+          const std::string name = ip_tag->getString("ip_tag_name");
+          auto it = tag_indexes.find(name);
+          if (it == tag_indexes.end()) {
+            it = tag_indexes.emplace(name, tags_.size()).first;
+            tags_.push_back({name, scope.counter(fmt::format("{}{}.hit", stat_prefix, name))});
+            data.emplace_back(it->second, std::vector<Network::Address::CidrRange>());
+          }
+          for (const std::string& entry : ip_tag->getStringArray("ip_list")) {
+            data[it->second].second.push_back(parseRange(entry));
+          }
+        }
+        return Network::LcTrie::LcTrie<uint32_t>(data);
+      }()) {}
+
+std::string IpTagTable::tags(const Network::Address::Instance& address) const {
+  std::string tags;
+  for (uint32_t index : trie_.getData(address)) {
+    if (!tags.empty()) {
+      tags += ',';
+    }
+    tags += tags_[index].name_;
+    tags_[index].hit_.inc();
+  }
+  return tags;
+}
+
+IpTaggingFilterConfig::IpTaggingFilterConfig(const Json::Object& json_config,
+                                             const std::string& stat_prefix, Stats::Scope& scope,
+                                             Event::Dispatcher& dispatcher,
+                                             ThreadLocal::SlotAllocator& tls)
+    : Json::Validator(json_config, Json::Schema::IP_TAGGING_HTTP_FILTER_SCHEMA),
+      request_type_(stringToType(json_config.getString("request_type", "both"))),
+      stat_prefix_(fmt::format("{}ip_tagging.", stat_prefix)), scope_(scope),
+      stats_(generateStats(stat_prefix_, scope)),
+      ip_tags_path_(json_config.getString("ip_tags_path", "")), tls_(tls.allocateSlot()) {
+  if (ip_tags_path_.empty()) {
+    setTable(std::make_shared<IpTagTable>(json_config.getObjectArray("ip_tags", true), stat_prefix_,
+                                          scope_));
+    return;
+  }
+
+  if (json_config.hasObject("ip_tags")) {
+    throw EnvoyException("ip tagging: only one of 'ip_tags' and 'ip_tags_path' may be set");
+  }
+  setTable(loadTableFromFile());
+
+  // As with runtime, a new tags file is expected to be moved into place atomically.
+  watcher_ = dispatcher.createFilesystemWatcher();
+  watcher_->addWatch(ip_tags_path_, Filesystem::Watcher::Events::MovedTo,
+                     [this](uint32_t) -> void { onTagsFileMoved(); });
+}
+
+IpTaggingStats IpTaggingFilterConfig::generateStats(const std::string& prefix,
+                                                    Stats::Scope& scope) {
+  return {ALL_IP_TAGGING_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+IpTagTableSharedPtr IpTaggingFilterConfig::loadTableFromFile() {
+  Json::ObjectSharedPtr json = Json::Factory::loadFromFile(ip_tags_path_);
+  json->validateSchema(Json::Schema::IP_TAGGING_HTTP_FILTER_SCHEMA);
+  return std::make_shared<IpTagTable>(json->getObjectArray("ip_tags", true), stat_prefix_, scope_);
+}
+
+void IpTaggingFilterConfig::onTagsFileMoved() {
+  // The table is built here on the main thread. Workers keep using the table they have until the
+  // new one is posted to them, so a reload never stalls request processing.
+  IpTagTableSharedPtr table;
+  try {
+    table = loadTableFromFile();
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "ip tagging: failed to reload '{}', keeping the current tags: {}",
+              ip_tags_path_, e.what());
+    stats_.reload_failed_.inc();
+    return;
+  }
+
+  setTable(table);
+  stats_.reload_success_.inc();
+}
+
+void IpTaggingFilterConfig::setTable(IpTagTableSharedPtr table) {
+  tls_->set(
+      [table](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return table; });
+}
+
 IpTaggingFilter::IpTaggingFilter(IpTaggingFilterConfigSharedPtr config) : config_(config) {}
 
 IpTaggingFilter::~IpTaggingFilter() {}
 
 void IpTaggingFilter::onDestroy() {}
 
-FilterHeadersStatus IpTaggingFilter::decodeHeaders(HeaderMap&, bool) {
+FilterHeadersStatus IpTaggingFilter::decodeHeaders(HeaderMap& headers, bool) {
+  const bool is_internal_request =
+      headers.EnvoyInternalRequest() && headers.EnvoyInternalRequest()->value() ==
+                                            Headers::get().EnvoyInternalRequestValues.True.c_str();
+  if ((is_internal_request && config_->requestType() == FilterRequestType::External) ||
+      (!is_internal_request && config_->requestType() == FilterRequestType::Internal)) {
+    return FilterHeadersStatus::Continue;
+  }
+
+  config_->stats().total_.inc();
+
+  // Tag by the trusted downstream address from x-forwarded-for. It is only parsed when it differs
+  // from the already resolved remote address of the connection, and the remote address is used if
+  // the downstream address is absent or not an IP.
+  std::string tags;
+  const Network::Connection* connection = callbacks_->connection();
+  const Network::Address::Instance* remote_address =
+      connection != nullptr ? &connection->remoteAddress() : nullptr;
+  const std::string& downstream_address = callbacks_->downstreamAddress();
+  Network::Address::InstanceConstSharedPtr parsed_address;
+  if (!downstream_address.empty() &&
+      (remote_address == nullptr || remote_address->ip() == nullptr ||
+       remote_address->ip()->addressAsString() != downstream_address)) {
+    parsed_address = Network::Utility::parseInternetAddressNoThrow(downstream_address);
+  }
+  if (parsed_address != nullptr) {
+    tags = config_->table().tags(*parsed_address);
+  } else if (remote_address != nullptr) {
+    tags = config_->table().tags(*remote_address);
+  }
+
+  if (tags.empty()) {
+    config_->stats().no_hit_.inc();
+    return FilterHeadersStatus::Continue;
+  }
+
+  HeaderString& value = headers.insertEnvoyIpTags().value();
+  if (!value.empty()) {
+    value.append(",", 1);
+  }
+  value.append(tags.c_str(), tags.size());
+
+  // Routes may match on the tags, so any route picked before they were added is stale.
+  callbacks_->clearRouteCache();
   return FilterHeadersStatus::Continue;
 }
 
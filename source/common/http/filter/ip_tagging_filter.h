@@ -5,12 +5,19 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/dispatcher.h"
+#include "envoy/filesystem/filesystem.h"
 #include "envoy/http/filter.h"
 #include "envoy/json/json_object.h"
+#include "envoy/network/address.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/assert.h"
+#include "common/common/logger.h"
 #include "common/json/config_schemas.h"
 #include "common/json/json_validator.h"
+#include "common/network/lc_trie.h"
 
 namespace Envoy {
 namespace Http {
@@ -21,15 +28,76 @@ namespace Http {
 enum class FilterRequestType { Internal, External, Both };
 
 /**
- * Configuration for the ip tagging filter.
+ * All stats for the ip tagging filter. @see stats_macros.h
  */
-class IpTaggingFilterConfig : Json::Validator {
+// clang-format off
+#define ALL_IP_TAGGING_STATS(COUNTER)                                                              \
+  COUNTER(total)                                                                                   \
+  COUNTER(no_hit)                                                                                  \
+  COUNTER(reload_success)                                                                          \
+  COUNTER(reload_failed)
+// clang-format on
+
+/**
+ * Wrapper struct for ip tagging filter stats. @see stats_macros.h
+ */
+struct IpTaggingStats {
+  ALL_IP_TAGGING_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * Immutable table of the ranges for each ip tag. A table is built on the main thread and shared
+ * by all workers, which look up addresses in it without locking.
+ */
+class IpTagTable : public ThreadLocal::ThreadLocalObject {
+public:
+  /**
+   * @param config supplies the "ip_tags" list of the filter configuration.
+   * @param stat_prefix supplies the prefix of the per tag stats.
+   * @param scope supplies the scope for the per tag stats.
+   */
+  IpTagTable(const std::vector<Json::ObjectSharedPtr>& config, const std::string& stat_prefix,
+             Stats::Scope& scope);
+
+  /**
+   * @param address supplies the address to tag.
+   * @return the comma separated tags of all ranges which contain the address, or the empty string
+   *         if there are none. Every returned tag has its hit counter incremented.
+   */
+  std::string tags(const Network::Address::Instance& address) const;
+
+private:
+  struct Tag {
+    std::string name_;
+    Stats::Counter& hit_;
+  };
+
+  std::vector<Tag> tags_;
+  // Tags are stored by index into tags_.
+  Network::LcTrie::LcTrie<uint32_t> trie_;
+};
+
+typedef std::shared_ptr<IpTagTable> IpTagTableSharedPtr;
+
+/**
+ * Configuration for the ip tagging filter. The tags are either given inline with "ip_tags", or
+ * read from the file at "ip_tags_path". A tags file is watched and the table is rebuilt when a new
+ * file is moved into place, after which workers pick up the new table without waiting on the
+ * main thread.
+ */
+class IpTaggingFilterConfig : Json::Validator, Logger::Loggable<Logger::Id::filter> {
 public:
-  IpTaggingFilterConfig(const Json::Object& json_config)
-      : Json::Validator(json_config, Json::Schema::IP_TAGGING_HTTP_FILTER_SCHEMA),
-        request_type_(stringToType(json_config.getString("request_type", "both"))) {}
+  IpTaggingFilterConfig(const Json::Object& json_config, const std::string& stat_prefix,
+                        Stats::Scope& scope, Event::Dispatcher& dispatcher,
+                        ThreadLocal::SlotAllocator& tls);
 
   FilterRequestType requestType() const { return request_type_; }
+  const IpTaggingStats& stats() const { return stats_; }
+
+  /**
+   * @return the current tag table of the calling thread.
+   */
+  const IpTagTable& table() const { return tls_->getTyped<IpTagTable>(); }
 
 private:
   static FilterRequestType stringToType(const std::string& request_type) {
@@ -43,14 +111,26 @@ private:
     }
   }
 
+  static IpTaggingStats generateStats(const std::string& prefix, Stats::Scope& scope);
+
+  IpTagTableSharedPtr loadTableFromFile();
+  void onTagsFileMoved();
+  void setTable(IpTagTableSharedPtr table);
+
   const FilterRequestType request_type_;
+  const std::string stat_prefix_;
+  Stats::Scope& scope_;
+  const IpTaggingStats stats_;
+  const std::string ip_tags_path_;
+  ThreadLocal::SlotPtr tls_;
+  Filesystem::WatcherPtr watcher_;
 };
 
 typedef std::shared_ptr<IpTaggingFilterConfig> IpTaggingFilterConfigSharedPtr;
 
 /**
  * A filter that tags requests via the x-envoy-ip-tags header based on the request's trusted XFF
- * address.
+ * address, or the connection's remote address if there is no usable XFF address.
  */
 class IpTaggingFilter : public StreamDecoderFilter {
 public:
@@ -125,7 +125,8 @@ void Filter::complete(Envoy::RateLimit::LimitStatus status) {
                                              EMPTY_STRING,
                                              EMPTY_STRING,
                                              EMPTY_STRING,
-                                             false};
+                                             false,
+                                             nullptr};
     Http::CodeUtility::chargeResponseStat(info);
     break;
   }
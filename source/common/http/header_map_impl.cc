@@ -1,7 +1,7 @@
 #include "common/http/header_map_impl.h"
 
 #include <cstdint>
-#include <list>
+#include <new>
 #include <string>
 
 #include "common/common/assert.h"
@@ -212,6 +212,51 @@ void HeaderMapImpl::HeaderEntryImpl::value(const HeaderEntry& header) {
   value(header.value().c_str(), header.value().size());
 }
 
+const uint32_t HeaderMapImpl::HeaderList::FIRST_BLOCK_SIZE;
+const uint32_t HeaderMapImpl::HeaderList::MAX_BLOCKS;
+
+HeaderMapImpl::HeaderList::~HeaderList() {
+  HeaderEntryImpl* entry = head_;
+  while (entry != nullptr) {
+    HeaderEntryImpl* next = entry->next_;
+    entry->~HeaderEntryImpl();
+    entry = next;
+  }
+}
+
+void* HeaderMapImpl::HeaderList::allocate() {
+  if (free_slots_ != nullptr) {
+    FreeSlot* slot = free_slots_;
+    free_slots_ = slot->next_;
+    return slot;
+  }
+
+  if (num_blocks_ == 0 || last_block_used_ == FIRST_BLOCK_SIZE << (num_blocks_ - 1)) {
+    RELEASE_ASSERT(num_blocks_ < MAX_BLOCKS);
+    blocks_[num_blocks_].reset(new Slot[FIRST_BLOCK_SIZE << num_blocks_]);
+    num_blocks_++;
+    last_block_used_ = 0;
+  }
+  return &blocks_[num_blocks_ - 1][last_block_used_++];
+}
+
+void HeaderMapImpl::HeaderList::erase(HeaderEntryImpl& entry) {
+  if (entry.prev_ != nullptr) {
+    entry.prev_->next_ = entry.next_;
+  } else {
+    head_ = entry.next_;
+  }
+  if (entry.next_ != nullptr) {
+    entry.next_->prev_ = entry.prev_;
+  } else {
+    tail_ = entry.prev_;
+  }
+  size_--;
+
+  entry.~HeaderEntryImpl();
+  free_slots_ = new (&entry) FreeSlot{free_slots_};
+}
+
 #define INLINE_HEADER_STATIC_MAP_ENTRY(name)                                                       \
   add(Headers::get().name.get().c_str(), [](HeaderMapImpl& h) -> StaticLookupResponse {            \
     return {&h.inline_headers_.name##_, &Headers::get().name};                                     \
@@ -290,7 +335,8 @@ bool HeaderMapImpl::operator==(const HeaderMapImpl& rhs) const {
     return false;
   }
 
-  for (auto i = headers_.begin(), j = rhs.headers_.begin(); i != headers_.end(); ++i, ++j) {
+  for (const HeaderEntryImpl *i = headers_.front(), *j = rhs.headers_.front(); i != nullptr;
+       i = i->next_, j = j->next_) {
     if (i->key() != j->key().c_str() || i->value() != j->value().c_str()) {
       return false;
     }
@@ -311,9 +357,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     maybeCreateInline(ref_lookup_response.entry_, *ref_lookup_response.key_, std::move(value));
   } else {
-    std::list<HeaderEntryImpl>::iterator i =
-        headers_.emplace(headers_.end(), std::move(key), std::move(value));
-    i->entry_ = i;
+    headers_.emplaceBack(std::move(key), std::move(value));
   }
 }
 
@@ -381,18 +425,20 @@ void HeaderMapImpl::setReferenceKey(const LowerCaseString& key, const std::strin
 
 uint64_t HeaderMapImpl::byteSize() const {
   uint64_t byte_size = 0;
-  for (const HeaderEntryImpl& header : headers_) {
-    byte_size += header.key().size();
-    byte_size += header.value().size();
+  for (const HeaderEntryImpl* header = headers_.front(); header != nullptr;
+       header = header->next_) {
+    byte_size += header->key().size();
+    byte_size += header->value().size();
   }
 
   return byte_size;
 }
 
 const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      return &header;
+  for (const HeaderEntryImpl* header = headers_.front(); header != nullptr;
+       header = header->next_) {
+    if (header->key() == key.get().c_str()) {
+      return header;
     }
   }
 
@@ -400,16 +446,18 @@ const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
 }
 
 void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
-  for (const HeaderEntryImpl& header : headers_) {
-    if (cb(header, context) == HeaderMap::Iterate::Break) {
+  for (const HeaderEntryImpl* header = headers_.front(); header != nullptr;
+       header = header->next_) {
+    if (cb(*header, context) == HeaderMap::Iterate::Break) {
       break;
     }
   }
 }
 
 void HeaderMapImpl::iterateReverse(ConstIterateCb cb, void* context) const {
-  for (auto it = headers_.rbegin(); it != headers_.rend(); it++) {
-    if (cb(*it, context) == HeaderMap::Iterate::Break) {
+  for (const HeaderEntryImpl* header = headers_.back(); header != nullptr;
+       header = header->prev_) {
+    if (cb(*header, context) == HeaderMap::Iterate::Break) {
       break;
     }
   }
@@ -421,12 +469,13 @@ void HeaderMapImpl::remove(const LowerCaseString& key) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     removeInline(ref_lookup_response.entry_);
   } else {
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key.get().c_str()) {
-        i = headers_.erase(i);
-      } else {
-        ++i;
+    HeaderEntryImpl* header = headers_.front();
+    while (header != nullptr) {
+      HeaderEntryImpl* next = header->next_;
+      if (header->key() == key.get().c_str()) {
+        headers_.erase(*header);
       }
+      header = next;
     }
   }
 }
@@ -437,9 +486,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.emplace(headers_.end(), key);
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.emplaceBack(key);
   return **entry;
 }
 
@@ -451,9 +498,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
     return **entry;
   }
 
-  std::list<HeaderEntryImpl>::iterator i = headers_.emplace(headers_.end(), key, std::move(value));
-  i->entry_ = i;
-  *entry = &(*i);
+  *entry = &headers_.emplaceBack(key, std::move(value));
   return **entry;
 }
 
@@ -464,7 +509,7 @@ void HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
 
   HeaderEntryImpl* entry = *ptr_to_entry;
   *ptr_to_entry = nullptr;
-  headers_.erase(entry->entry_);
+  headers_.erase(*entry);
 }
 
 } // namespace Http
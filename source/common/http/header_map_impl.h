@@ -2,9 +2,9 @@
 
 #include <array>
 #include <cstdint>
-#include <list>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 #include "envoy/http/header_map.h"
 
@@ -33,7 +33,8 @@ public:
  * headers are added to the map, we do a hash lookup to see if it's one of the O(1) headers.
  * If it is, we store a reference to it that can be accessed later directly. Most high performance
  * paths use O(1) direct access. In general, we try to copy as little as possible and allocate as
- * little as possible in any of the paths.
+ * little as possible in any of the paths. Entries are allocated in blocks rather than one at a
+ * time, see HeaderList.
  */
 class HeaderMapImpl : public HeaderMap {
 public:
@@ -86,7 +87,63 @@ protected:
 
     HeaderString key_;
     HeaderString value_;
-    std::list<HeaderEntryImpl>::iterator entry_;
+    // The neighbours of the entry in insertion order.
+    HeaderEntryImpl* prev_{};
+    HeaderEntryImpl* next_{};
+  };
+
+  /**
+   * The entries of a map in insertion order. Entries are allocated from blocks which double in
+   * size as the list grows, so a typical request needs a few allocations rather than one per
+   * header, and headers added one after another sit next to each other in memory. Entries never
+   * move, which keeps the inline header pointers valid. Removal is O(1), and the slot of a removed
+   * entry is reused by the next entry added.
+   */
+  class HeaderList : NonCopyable {
+  public:
+    HeaderList() {}
+    ~HeaderList();
+
+    template <class... Args> HeaderEntryImpl& emplaceBack(Args&&... args) {
+      HeaderEntryImpl* entry = new (allocate()) HeaderEntryImpl(std::forward<Args>(args)...);
+      entry->prev_ = tail_;
+      if (tail_ != nullptr) {
+        tail_->next_ = entry;
+      } else {
+        head_ = entry;
+      }
+      tail_ = entry;
+      size_++;
+      return *entry;
+    }
+
+    void erase(HeaderEntryImpl& entry);
+    const HeaderEntryImpl* front() const { return head_; }
+    HeaderEntryImpl* front() { return head_; }
+    const HeaderEntryImpl* back() const { return tail_; }
+    size_t size() const { return size_; }
+
+  private:
+    typedef std::aligned_storage<sizeof(HeaderEntryImpl), alignof(HeaderEntryImpl)>::type Slot;
+
+    // Holds the next free slot while a slot is free.
+    struct FreeSlot {
+      FreeSlot* next_;
+    };
+
+    static const uint32_t FIRST_BLOCK_SIZE = 4;
+    static const uint32_t MAX_BLOCKS = 20;
+
+    void* allocate();
+
+    std::array<std::unique_ptr<Slot[]>, MAX_BLOCKS> blocks_;
+    uint32_t num_blocks_{};
+    // The number of slots handed out from the last block.
+    uint32_t last_block_used_{};
+    FreeSlot* free_slots_{};
+    HeaderEntryImpl* head_{};
+    HeaderEntryImpl* tail_{};
+    size_t size_{};
   };
 
   struct StaticLookupResponse {
@@ -124,7 +181,7 @@ protected:
   void removeInline(HeaderEntryImpl** entry);
 
   AllInlineHeaders inline_headers_;
-  std::list<HeaderEntryImpl> headers_;
+  HeaderList headers_;
 
   ALL_INLINE_HEADERS(DEFINE_INLINE_HEADER_FUNCS)
 };
@@ -251,7 +251,7 @@ http_parser_settings ConnectionImpl::settings_{
       return 0;
     },
     [](http_parser* parser) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onMessageComplete();
+      static_cast<ConnectionImpl*>(parser->data)->onMessageCompleteBase();
       return 0;
     },
     nullptr, // on_chunk_header
@@ -263,9 +263,11 @@ const ToLowerTable& ConnectionImpl::toLowerTable() {
   return *table;
 }
 
-ConnectionImpl::ConnectionImpl(Network::Connection& connection, http_parser_type type)
-    : connection_(connection), output_buffer_([&]() -> void { this->onBelowLowWatermark(); },
-                                              [&]() -> void { this->onAboveHighWatermark(); }) {
+ConnectionImpl::ConnectionImpl(Network::Connection& connection, http_parser_type type,
+                               bool fast_request_parser)
+    : connection_(connection), fast_request_parser_(fast_request_parser),
+      output_buffer_([&]() -> void { this->onBelowLowWatermark(); },
+                     [&]() -> void { this->onAboveHighWatermark(); }) {
   output_buffer_.setWatermarks(connection.bufferLimit());
   http_parser_init(&parser_, type);
   parser_.data = this;
@@ -308,6 +310,16 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
 }
 
 size_t ConnectionImpl::dispatchSlice(const char* slice, size_t len) {
+  // When enabled, whole requests in the common form skip http_parser's byte at a time state
+  // machine. Anything else, including a request split across slices, is left to http_parser.
+  if (fast_request_parser_ && parser_at_message_start_ && HTTP_PARSER_ERRNO(&parser_) == HPE_OK) {
+    const size_t parsed = request_parser_.parse(slice, len);
+    if (parsed != 0) {
+      dispatchParsedRequest();
+      return parsed;
+    }
+  }
+
   ssize_t rc = http_parser_execute(&parser_, &settings_, slice, len);
   if (HTTP_PARSER_ERRNO(&parser_) != HPE_OK && HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED) {
     sendProtocolError();
@@ -318,6 +330,23 @@ size_t ConnectionImpl::dispatchSlice(const char* slice, size_t len) {
   return rc;
 }
 
+void ConnectionImpl::dispatchParsedRequest() {
+  parser_.method = request_parser_.method();
+  parser_.http_major = 1;
+  parser_.http_minor = 1;
+  parser_.flags = 0;
+  parser_.content_length = ULLONG_MAX;
+
+  onMessageBeginBase();
+  onUrl(request_parser_.url(), request_parser_.urlSize());
+  for (const RequestParser::Header& header : request_parser_.headers()) {
+    onHeaderField(header.name_, header.name_size_);
+    onHeaderValue(header.value_, header.value_size_);
+  }
+  onHeadersCompleteBase();
+  onMessageCompleteBase();
+}
+
 void ConnectionImpl::onHeaderField(const char* data, size_t length) {
   if (header_parsing_state_ == HeaderParsingState::Done) {
     // Ignore trailers.
@@ -360,9 +389,16 @@ void ConnectionImpl::onMessageBeginBase() {
   ASSERT(!current_header_map_);
   current_header_map_.reset(new HeaderMapImpl());
   header_parsing_state_ = HeaderParsingState::Field;
+  parser_at_message_start_ = false;
   onMessageBegin();
 }
 
+void ConnectionImpl::onMessageCompleteBase() {
+  // After a message which does not keep the connection alive, http_parser rejects anything more.
+  parser_at_message_start_ = http_should_keep_alive(&parser_);
+  onMessageComplete();
+}
+
 void ConnectionImpl::onResetStreamBase(StreamResetReason reason) {
   ASSERT(!reset_stream_called_);
   reset_stream_called_ = true;
@@ -372,7 +408,8 @@ void ConnectionImpl::onResetStreamBase(StreamResetReason reason) {
 ServerConnectionImpl::ServerConnectionImpl(Network::Connection& connection,
                                            ServerConnectionCallbacks& callbacks,
                                            Http1Settings settings)
-    : ConnectionImpl(connection, HTTP_REQUEST), callbacks_(callbacks), codec_settings_(settings) {}
+    : ConnectionImpl(connection, HTTP_REQUEST, settings.fast_request_parser_),
+      callbacks_(callbacks), codec_settings_(settings) {}
 
 void ServerConnectionImpl::onEncodeComplete() {
   ASSERT(active_request_);
@@ -585,7 +622,7 @@ void ServerConnectionImpl::onBelowLowWatermark() {
 }
 
 ClientConnectionImpl::ClientConnectionImpl(Network::Connection& connection, ConnectionCallbacks&)
-    : ConnectionImpl(connection, HTTP_RESPONSE) {}
+    : ConnectionImpl(connection, HTTP_RESPONSE, false) {}
 
 bool ClientConnectionImpl::cannotHaveBody() {
   if ((!pending_responses_.empty() && pending_responses_.front().head_request_) ||
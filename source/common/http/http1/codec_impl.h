@@ -17,6 +17,7 @@
 #include "common/http/codec_helper.h"
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http1/request_parser.h"
 
 namespace Envoy {
 namespace Http {
@@ -150,7 +151,11 @@ public:
   uint32_t bufferLimit() { return connection_.bufferLimit(); }
 
 protected:
-  ConnectionImpl(Network::Connection& connection, http_parser_type type);
+  /**
+   * @param fast_request_parser supplies whether requests in the common form are parsed by
+   *        request_parser_ rather than http_parser.
+   */
+  ConnectionImpl(Network::Connection& connection, http_parser_type type, bool fast_request_parser);
 
   bool resetStreamCalled() { return reset_stream_called_; }
 
@@ -174,6 +179,12 @@ private:
    */
   size_t dispatchSlice(const char* slice, size_t len);
 
+  /**
+   * Raise the callbacks for a request which request_parser_ accepted, in the same order and with
+   * the same parser_ fields that http_parser would have.
+   */
+  void dispatchParsedRequest();
+
   /**
    * Called when a request/response is beginning. A base routine happens first then a virtual
    * dispatch is invoked.
@@ -218,8 +229,10 @@ private:
   virtual void onBody(const char* data, size_t length) PURE;
 
   /**
-   * Called when the request/response is complete.
+   * Called when the request/response is complete. A base routine happens first then a virtual
+   * dispatch is invoked.
    */
+  void onMessageCompleteBase();
   virtual void onMessageComplete() PURE;
 
   /**
@@ -249,6 +262,11 @@ private:
 
   HeaderMapImplPtr current_header_map_;
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
+  const bool fast_request_parser_;
+  RequestParser request_parser_;
+  // Whether http_parser is waiting for the start of a message which it would accept, so that the
+  // next message may be parsed by request_parser_ instead.
+  bool parser_at_message_start_{true};
   HeaderString current_header_field_;
   HeaderString current_header_value_;
   bool reset_stream_called_{};
@@ -0,0 +1,359 @@
+#include "common/http/http1/request_parser.h"
+
+#include <strings.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define REQUEST_PARSER_X86
+#include <immintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+const size_t RequestParser::MAX_REQUEST_SIZE;
+
+struct RequestParser::ScanFunctions {
+  // Each returns the first byte in [begin, end) which can not be part of a URL, header name or
+  // header value respectively, or end if there is none.
+  const char* (*url_end_)(const char* begin, const char* end);
+  const char* (*name_end_)(const char* begin, const char* end);
+  const char* (*value_end_)(const char* begin, const char* end);
+};
+
+namespace {
+
+// The tchar of RFC 7230, which is also what http_parser accepts in methods and header names.
+const std::array<bool, 256>& tokenTable() {
+  static const std::array<bool, 256> table = []() {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; c++) {
+      table[c] = true;
+    }
+    for (int c = 'a'; c <= 'z'; c++) {
+      table[c] = true;
+      table[c - 'a' + 'A'] = true;
+    }
+    for (const char* c = "!#$%&'*+-.^_`|~"; *c != 0; c++) {
+      table[static_cast<uint8_t>(*c)] = true;
+    }
+    return table;
+  }();
+  return table;
+}
+
+bool isUrlChar(uint8_t c) { return c > ' ' && c < 0x7f; }
+
+// As http_parser, header values may hold anything but control characters other than HTAB.
+bool isValueChar(uint8_t c) { return (c >= ' ' || c == '\t') && c != 0x7f; }
+
+const char* urlEndScalar(const char* p, const char* end) {
+  while (p != end && isUrlChar(*p)) {
+    p++;
+  }
+  return p;
+}
+
+const char* nameEndScalar(const char* p, const char* end) {
+  const std::array<bool, 256>& table = tokenTable();
+  while (p != end && table[static_cast<uint8_t>(*p)]) {
+    p++;
+  }
+  return p;
+}
+
+const char* valueEndScalar(const char* p, const char* end) {
+  while (p != end && isValueChar(*p)) {
+    p++;
+  }
+  return p;
+}
+
+#ifdef REQUEST_PARSER_X86
+
+// Byte ranges for _mm_cmpestri, in pairs of lowest and highest byte. The name ranges also match
+// '|' and '~', which the scalar check that follows a match lets through.
+alignas(16) const char URL_RANGES[16] = "\x00\x20\x7f\xff";
+const int URL_RANGES_SIZE = 4;
+alignas(16) const char NAME_RANGES[16] = {'\x00', ' ', '"', '"', '(', ')', ',', ',',
+                                          '/',    '/', ':', '@', '[', ']', '{', '\xff'};
+const int NAME_RANGES_SIZE = 16;
+alignas(16) const char VALUE_RANGES[16] = "\x00\x08\x0a\x1f\x7f\x7f";
+const int VALUE_RANGES_SIZE = 6;
+
+// Returns the first byte in one of the ranges, or the start of the last 15 or fewer bytes which
+// were not searched.
+__attribute__((target("sse4.2"))) const char* findRangesSse42(const char* p, const char* end,
+                                                               const char* ranges,
+                                                               int ranges_size) {
+  const __m128i ranges16 = _mm_load_si128(reinterpret_cast<const __m128i*>(ranges));
+  while (end - p >= 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int index = _mm_cmpestri(ranges16, ranges_size, chunk, 16,
+                                   _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_LEAST_SIGNIFICANT);
+    if (index != 16) {
+      return p + index;
+    }
+    p += 16;
+  }
+  return p;
+}
+
+const char* urlEndSse42(const char* p, const char* end) {
+  return urlEndScalar(findRangesSse42(p, end, URL_RANGES, URL_RANGES_SIZE), end);
+}
+
+const char* nameEndSse42(const char* p, const char* end) {
+  return nameEndScalar(findRangesSse42(p, end, NAME_RANGES, NAME_RANGES_SIZE), end);
+}
+
+const char* valueEndSse42(const char* p, const char* end) {
+  return valueEndScalar(findRangesSse42(p, end, VALUE_RANGES, VALUE_RANGES_SIZE), end);
+}
+
+// The AVX2 scanners compare bytes as signed, so bytes from 0x80 are below any ASCII character.
+__attribute__((target("avx2"))) const char* urlEndAvx2(const char* p, const char* end) {
+  const __m256i above_space = _mm256_set1_epi8(' ' + 1);
+  const __m256i del = _mm256_set1_epi8(0x7f);
+  while (end - p >= 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const __m256i invalid = _mm256_or_si256(_mm256_cmpgt_epi8(above_space, chunk),
+                                            _mm256_cmpeq_epi8(chunk, del));
+    const uint32_t mask = _mm256_movemask_epi8(invalid);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 32;
+  }
+  return urlEndScalar(p, end);
+}
+
+__attribute__((target("avx2"))) const char* valueEndAvx2(const char* p, const char* end) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i space = _mm256_set1_epi8(' ');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i del = _mm256_set1_epi8(0x7f);
+  while (end - p >= 32) {
+    const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    // Below space but not from 0x80, and not HTAB.
+    const __m256i control = _mm256_andnot_si256(
+        _mm256_or_si256(_mm256_cmpgt_epi8(zero, chunk), _mm256_cmpeq_epi8(chunk, tab)),
+        _mm256_cmpgt_epi8(space, chunk));
+    const __m256i invalid = _mm256_or_si256(control, _mm256_cmpeq_epi8(chunk, del));
+    const uint32_t mask = _mm256_movemask_epi8(invalid);
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 32;
+  }
+  return valueEndScalar(p, end);
+}
+
+#endif // REQUEST_PARSER_X86
+
+struct Method {
+  const char* name_;
+  size_t size_;
+  http_method method_;
+};
+
+// POST, PUT and PATCH requests almost always have a body, which is framed by headers that are
+// rejected, so they are left to http_parser before their headers are scanned.
+const Method METHODS[] = {
+    {"GET", 3, HTTP_GET},
+    {"HEAD", 4, HTTP_HEAD},
+    {"DELETE", 6, HTTP_DELETE},
+    {"OPTIONS", 7, HTTP_OPTIONS},
+};
+
+bool equalsIgnoreCase(const char* data, size_t size, const char* lower_case) {
+  return size == strlen(lower_case) && strncasecmp(data, lower_case, size) == 0;
+}
+
+} // namespace
+
+const RequestParser::ScanFunctions& RequestParser::scanFunctions(Scanner scanner) {
+  static const ScanFunctions scalar{urlEndScalar, nameEndScalar, valueEndScalar};
+#ifdef REQUEST_PARSER_X86
+  // Names are short, so they are not worth a wider scanner than SSE4.2.
+  static const ScanFunctions sse42{urlEndSse42, nameEndSse42, valueEndSse42};
+  static const ScanFunctions avx2{urlEndAvx2, nameEndSse42, valueEndAvx2};
+  switch (scanner) {
+  case Scanner::Sse42:
+    return sse42;
+  case Scanner::Avx2:
+    return avx2;
+  case Scanner::Scalar:
+    break;
+  }
+#else
+  UNREFERENCED_PARAMETER(scanner);
+#endif
+  return scalar;
+}
+
+RequestParser::RequestParser(Scanner scanner) : scan_(scanFunctions(scanner)) {
+  ASSERT(supported(scanner));
+}
+
+bool RequestParser::supported(Scanner scanner) {
+  switch (scanner) {
+  case Scanner::Scalar:
+    return true;
+#ifdef REQUEST_PARSER_X86
+  case Scanner::Sse42:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+  case Scanner::Avx2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("avx2");
+#endif
+  default:
+    return false;
+  }
+}
+
+RequestParser::Scanner RequestParser::bestScanner() {
+  static const Scanner best = []() {
+    if (supported(Scanner::Avx2)) {
+      return Scanner::Avx2;
+    }
+    if (supported(Scanner::Sse42)) {
+      return Scanner::Sse42;
+    }
+    return Scanner::Scalar;
+  }();
+  return best;
+}
+
+size_t RequestParser::parse(const char* data, size_t length) {
+  scanned_ = 0;
+  headers_.clear();
+  // Data which does not end with the end of a head is either a head which is not complete yet or a
+  // request with a body, so it is rejected without being scanned.
+  static const char HEAD_END[] = "\r\n\r\n";
+  if (length < sizeof(HEAD_END) - 1 ||
+      memcmp(data + length - (sizeof(HEAD_END) - 1), HEAD_END, sizeof(HEAD_END) - 1) != 0) {
+    return 0;
+  }
+
+  const char* p = data;
+  const char* end = data + std::min(length, MAX_REQUEST_SIZE);
+  const bool accepted = parseHead(p, end);
+  scanned_ = p - data;
+  return accepted ? scanned_ : 0;
+}
+
+bool RequestParser::parseHead(const char*& p, const char* end) {
+  if (!parseRequestLine(p, end)) {
+    return false;
+  }
+
+  while (end - p >= 2) {
+    if (p[0] == '\r' && p[1] == '\n') {
+      p += 2;
+      return true;
+    }
+    if (!parseHeader(p, end)) {
+      return false;
+    }
+  }
+  return false;
+}
+
+bool RequestParser::parseRequestLine(const char*& p, const char* end) {
+  const char* method_end = scan_.name_end_(p, end);
+  if (method_end == end || *method_end != ' ') {
+    return false;
+  }
+  const Method* method = nullptr;
+  for (const Method& known : METHODS) {
+    if (static_cast<size_t>(method_end - p) == known.size_ &&
+        memcmp(p, known.name_, known.size_) == 0) {
+      method = &known;
+      break;
+    }
+  }
+  if (method == nullptr) {
+    return false;
+  }
+  method_ = method->method_;
+
+  // Only origin-form, as http_parser checks other forms more closely.
+  p = method_end + 1;
+  const char* url_end = scan_.url_end_(p, end);
+  if (url_end == end || *url_end != ' ' || *p != '/') {
+    return false;
+  }
+  url_ = p;
+  url_size_ = url_end - p;
+
+  static const char VERSION[] = "HTTP/1.1\r\n";
+  p = url_end + 1;
+  if (static_cast<size_t>(end - p) < sizeof(VERSION) - 1 ||
+      memcmp(p, VERSION, sizeof(VERSION) - 1) != 0) {
+    return false;
+  }
+  p += sizeof(VERSION) - 1;
+  return true;
+}
+
+bool RequestParser::parseHeader(const char*& p, const char* end) {
+  Header header;
+  const char* name_end = scan_.name_end_(p, end);
+  if (name_end == p || name_end == end || *name_end != ':') {
+    return false;
+  }
+  header.name_ = p;
+  header.name_size_ = name_end - p;
+
+  p = name_end + 1;
+  while (p != end && (*p == ' ' || *p == '\t')) {
+    p++;
+  }
+  // http_parser handles empty values and trailing whitespace in ways which are not worth copying.
+  const char* value_end = scan_.value_end_(p, end);
+  if (value_end == p || end - value_end < 2 || value_end[0] != '\r' || value_end[1] != '\n' ||
+      value_end[-1] == ' ' || value_end[-1] == '\t') {
+    return false;
+  }
+  header.value_ = p;
+  header.value_size_ = value_end - p;
+  if (!checkHeader(header)) {
+    return false;
+  }
+
+  headers_.push_back(header);
+  p = value_end + 2;
+  return true;
+}
+
+bool RequestParser::checkHeader(const Header& header) {
+  // Headers which give the request a body or change how the connection is used.
+  switch (header.name_size_) {
+  case 7:
+    return !equalsIgnoreCase(header.name_, header.name_size_, "upgrade");
+  case 10:
+    return !equalsIgnoreCase(header.name_, header.name_size_, "connection") ||
+           equalsIgnoreCase(header.value_, header.value_size_, "keep-alive");
+  case 14:
+    return !equalsIgnoreCase(header.name_, header.name_size_, "content-length");
+  case 16:
+    return !equalsIgnoreCase(header.name_, header.name_size_, "proxy-connection");
+  case 17:
+    return !equalsIgnoreCase(header.name_, header.name_size_, "transfer-encoding");
+  default:
+    return true;
+  }
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
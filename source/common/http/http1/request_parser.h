@@ -0,0 +1,97 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser for HTTP/1.1 requests which arrive whole in one block of memory, in the style of
+ * picohttpparser. Where http_parser steps through a state machine a byte at a time, this scans for
+ * the next delimiter 16 or 32 bytes at a time with SSE4.2 or AVX2, picked at runtime from what the
+ * CPU supports, with a scalar fallback. The method, URL and headers are returned as views into the
+ * parsed memory.
+ *
+ * Only the strict form of the common case is accepted: a request line with a method which does not
+ * usually have a body, an origin-form URL and HTTP/1.1, headers with non-empty values and CRLF line
+ * endings, and no body or connection handling headers. Anything else is rejected, and is expected
+ * to be handed to http_parser, which either accepts it or reports the error. A request which
+ * http_parser would reject is never accepted. Data which does not end with the end of a head, and
+ * requests with the methods which are left out, are rejected before anything is scanned, so that
+ * the common reasons to fall back do not parse the head twice.
+ */
+class RequestParser {
+public:
+  enum class Scanner { Scalar, Sse42, Avx2 };
+
+  struct Header {
+    const char* name_;
+    size_t name_size_;
+    const char* value_;
+    size_t value_size_;
+  };
+
+  /**
+   * @param scanner supplies the delimiter scanner to use, which must be supported.
+   */
+  explicit RequestParser(Scanner scanner = bestScanner());
+
+  /**
+   * Parse a request.
+   * @param data supplies the start of the request.
+   * @param length supplies the number of bytes available.
+   * @return size_t the length of the request, or 0 if data does not start with a whole request
+   *         which is accepted. The results below are only valid if the return is not 0, and until
+   *         data is changed or freed.
+   */
+  size_t parse(const char* data, size_t length);
+
+  http_method method() const { return method_; }
+  const char* url() const { return url_; }
+  size_t urlSize() const { return url_size_; }
+  const std::vector<Header>& headers() const { return headers_; }
+
+  /**
+   * @return size_t the number of bytes of the last data which were parsed before the request was
+   *         accepted or rejected.
+   */
+  size_t scanned() const { return scanned_; }
+
+  /**
+   * @return bool whether the CPU supports a scanner.
+   */
+  static bool supported(Scanner scanner);
+
+  /**
+   * @return Scanner the fastest scanner the CPU supports.
+   */
+  static Scanner bestScanner();
+
+  // Requests with longer heads are left to http_parser, which enforces its own limit.
+  static const size_t MAX_REQUEST_SIZE = 64 * 1024;
+
+private:
+  struct ScanFunctions;
+
+  static const ScanFunctions& scanFunctions(Scanner scanner);
+  bool parseHead(const char*& p, const char* end);
+  bool parseRequestLine(const char*& p, const char* end);
+  bool parseHeader(const char*& p, const char* end);
+  bool checkHeader(const Header& header);
+
+  const ScanFunctions& scan_;
+  http_method method_{};
+  const char* url_{};
+  size_t url_size_{};
+  std::vector<Header> headers_;
+  size_t scanned_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "common/http/http2/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -78,31 +79,31 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
                                               const HeaderMap& headers) {
   // nghttp2 requires that all ':' headers come before all other headers. To avoid making higher
-  // layers understand that we do two passes here to build the final header list to encode.
+  // layers understand that, a ':' header which follows other headers is rotated up behind the
+  // ':' headers found so far. This keeps the order within each group in one pass over the map.
+  struct Context {
+    std::vector<nghttp2_nv>& final_headers_;
+    size_t pseudo_headers_;
+  } context{final_headers, 0};
+
+  final_headers.clear();
   final_headers.reserve(headers.size());
   headers.iterate(
       [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
-        std::vector<nghttp2_nv>* final_headers = static_cast<std::vector<nghttp2_nv>*>(context);
+        Context& build = *static_cast<Context*>(context);
+        insertHeader(build.final_headers_, header);
         if (header.key().c_str()[0] == ':') {
-          insertHeader(*final_headers, header);
+          std::rotate(build.final_headers_.begin() + build.pseudo_headers_,
+                      build.final_headers_.end() - 1, build.final_headers_.end());
+          build.pseudo_headers_++;
         }
         return HeaderMap::Iterate::Continue;
       },
-      &final_headers);
-
-  headers.iterate(
-      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
-        std::vector<nghttp2_nv>* final_headers = static_cast<std::vector<nghttp2_nv>*>(context);
-        if (header.key().c_str()[0] != ':') {
-          insertHeader(*final_headers, header);
-        }
-        return HeaderMap::Iterate::Continue;
-      },
-      &final_headers);
+      &context);
 }
 
 void ConnectionImpl::StreamImpl::encodeHeaders(const HeaderMap& headers, bool end_stream) {
-  std::vector<nghttp2_nv> final_headers;
+  std::vector<nghttp2_nv>& final_headers = parent_.final_headers_;
   buildHeaders(final_headers, headers);
 
   nghttp2_data_provider provider;
@@ -185,7 +186,7 @@ void ConnectionImpl::StreamImpl::saveHeader(HeaderString&& name, HeaderString&&
 }
 
 void ConnectionImpl::StreamImpl::submitTrailers(const HeaderMap& trailers) {
-  std::vector<nghttp2_nv> final_headers;
+  std::vector<nghttp2_nv>& final_headers = parent_.final_headers_;
   buildHeaders(final_headers, trailers);
   int rc =
       nghttp2_submit_trailer(parent_.session_, stream_id_, &final_headers[0], final_headers.size());
@@ -380,10 +381,9 @@ int ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
                                                 Headers::get().ExpectValues._100Continue.c_str())) {
       // Deal with expect: 100-continue here since higher layers are never going to do anything
       // other than say to continue so that we can respond before request complete if necessary.
-      std::vector<nghttp2_nv> final_headers;
-      StreamImpl::buildHeaders(final_headers, *CONTINUE_HEADER);
-      int rc = nghttp2_submit_headers(session_, 0, stream->stream_id_, nullptr, &final_headers[0],
-                                      final_headers.size(), nullptr);
+      StreamImpl::buildHeaders(final_headers_, *CONTINUE_HEADER);
+      int rc = nghttp2_submit_headers(session_, 0, stream->stream_id_, nullptr,
+                                      &final_headers_[0], final_headers_.size(), nullptr);
       ASSERT(rc == 0);
       UNREFERENCED_PARAMETER(rc);
 
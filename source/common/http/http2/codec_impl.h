@@ -237,6 +237,9 @@ protected:
   static Http2Options http2_options_;
 
   std::list<StreamImplPtr> active_streams_;
+  // The nv array for each frame of headers is built here. nghttp2 copies the array when the frame
+  // is submitted, so one per connection can be reused without allocating one per frame.
+  std::vector<nghttp2_nv> final_headers_;
   nghttp2_session* session_{};
   CodecStats stats_;
   Network::Connection& connection_;
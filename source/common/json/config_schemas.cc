@@ -1030,6 +1030,7 @@ const std::string Json::Schema::IP_TAGGING_HTTP_FILTER_SCHEMA(R"EOF(
         "type" : "string",
         "enum" : ["internal", "external", "both"]
       },
+      "ip_tags_path" : {"type" : "string"},
       "ip_tags" : {
         "type" : "array",
         "minItems" : 1,
@@ -1439,7 +1440,9 @@ const std::string Json::Schema::CLUSTER_SCHEMA(R"EOF(
       },
       "lb_type" : {
         "type" : "string",
-        "enum" : ["round_robin", "least_request", "random", "ring_hash", "original_dst_lb"]
+        "enum" : [
+          "round_robin", "least_request", "random", "ring_hash", "original_dst_lb", "maglev"
+        ]
       },
       "ring_hash_lb_config" : {
         "type" : "object",
@@ -36,6 +36,15 @@ void AccessLog::logMessage(const Message& message, bool full,
   file_->write(log_line);
 }
 
+ProxyFilter::QueryStatNames::QueryStatNames(Stats::SymbolTable& symbol_table,
+                                            const std::string& prefix)
+    : total_(symbol_table.encode(prefix + ".total")),
+      scatter_get_(symbol_table.encode(prefix + ".scatter_get")),
+      multi_get_(symbol_table.encode(prefix + ".multi_get")),
+      reply_num_docs_(symbol_table.encode(prefix + ".reply_num_docs")),
+      reply_size_(symbol_table.encode(prefix + ".reply_size")),
+      reply_time_ms_(symbol_table.encode(prefix + ".reply_time_ms")) {}
+
 ProxyFilter::ProxyFilter(const std::string& stat_prefix, Stats::Scope& scope,
                          Runtime::Loader& runtime, AccessLogSharedPtr access_log,
                          const FaultConfigSharedPtr& fault_config,
@@ -100,21 +109,17 @@ void ProxyFilter::decodeQuery(QueryMessagePtr&& message) {
   ActiveQueryPtr active_query(new ActiveQuery(*this, *message));
   if (!active_query->query_info_.command().empty()) {
     // First field key is the operation.
-    scope_.counter(fmt::format("{}cmd.{}.total", stat_prefix_, active_query->query_info_.command()))
-        .inc();
+    scope_.counterFromStatName(*commandStatNames(active_query->query_info_.command()).total_).inc();
   } else {
     // Normal query, get stats on a per collection basis first.
-    std::string collection_stat_prefix =
-        fmt::format("{}collection.{}", stat_prefix_, active_query->query_info_.collection());
     QueryMessageInfo::QueryType query_type = active_query->query_info_.type();
-    chargeQueryStats(collection_stat_prefix, query_type);
+    chargeQueryStats(collectionStatNames(active_query->query_info_.collection()), query_type);
 
     // Callsite stats if we have it.
     if (!active_query->query_info_.callsite().empty()) {
-      std::string callsite_stat_prefix =
-          fmt::format("{}collection.{}.callsite.{}", stat_prefix_,
-                      active_query->query_info_.collection(), active_query->query_info_.callsite());
-      chargeQueryStats(callsite_stat_prefix, query_type);
+      chargeQueryStats(callsiteStatNames(active_query->query_info_.collection(),
+                                         active_query->query_info_.callsite()),
+                       query_type);
     }
 
     // Global stats.
@@ -131,13 +136,45 @@ void ProxyFilter::decodeQuery(QueryMessagePtr&& message) {
   active_query_list_.emplace_back(std::move(active_query));
 }
 
-void ProxyFilter::chargeQueryStats(const std::string& prefix,
+const ProxyFilter::QueryStatNames& ProxyFilter::commandStatNames(const std::string& command) {
+  QueryStatNamesPtr& names = command_stat_names_[command];
+  if (!names) {
+    names.reset(
+        new QueryStatNames(scope_.symbolTable(), fmt::format("{}cmd.{}", stat_prefix_, command)));
+  }
+
+  return *names;
+}
+
+const ProxyFilter::QueryStatNames& ProxyFilter::collectionStatNames(const std::string& collection) {
+  QueryStatNamesPtr& names = collection_stat_names_[collection];
+  if (!names) {
+    names.reset(new QueryStatNames(scope_.symbolTable(),
+                                   fmt::format("{}collection.{}.query", stat_prefix_, collection)));
+  }
+
+  return *names;
+}
+
+const ProxyFilter::QueryStatNames& ProxyFilter::callsiteStatNames(const std::string& collection,
+                                                                  const std::string& callsite) {
+  QueryStatNamesPtr& names = callsite_stat_names_[collection][callsite];
+  if (!names) {
+    names.reset(
+        new QueryStatNames(scope_.symbolTable(), fmt::format("{}collection.{}.callsite.{}.query",
+                                                             stat_prefix_, collection, callsite)));
+  }
+
+  return *names;
+}
+
+void ProxyFilter::chargeQueryStats(const QueryStatNames& names,
                                    QueryMessageInfo::QueryType query_type) {
-  scope_.counter(fmt::format("{}.query.total", prefix)).inc();
+  scope_.counterFromStatName(*names.total_).inc();
   if (query_type == QueryMessageInfo::QueryType::ScatterGet) {
-    scope_.counter(fmt::format("{}.query.scatter_get", prefix)).inc();
+    scope_.counterFromStatName(*names.scatter_get_).inc();
   } else if (query_type == QueryMessageInfo::QueryType::MultiGet) {
-    scope_.counter(fmt::format("{}.query.multi_get", prefix)).inc();
+    scope_.counterFromStatName(*names.multi_get_).inc();
   }
 }
 
@@ -163,21 +200,19 @@ void ProxyFilter::decodeReply(ReplyMessagePtr&& message) {
     }
 
     if (!active_query.query_info_.command().empty()) {
-      std::string stat_prefix =
-          fmt::format("{}cmd.{}", stat_prefix_, active_query.query_info_.command());
-      chargeReplyStats(active_query, stat_prefix, *message);
+      chargeReplyStats(active_query, commandStatNames(active_query.query_info_.command()),
+                       *message);
     } else {
       // Collection stats first.
-      std::string stat_prefix =
-          fmt::format("{}collection.{}.query", stat_prefix_, active_query.query_info_.collection());
-      chargeReplyStats(active_query, stat_prefix, *message);
+      chargeReplyStats(active_query, collectionStatNames(active_query.query_info_.collection()),
+                       *message);
 
       // Callsite stats if we have it.
       if (!active_query.query_info_.callsite().empty()) {
-        std::string callsite_stat_prefix =
-            fmt::format("{}collection.{}.callsite.{}.query", stat_prefix_,
-                        active_query.query_info_.collection(), active_query.query_info_.callsite());
-        chargeReplyStats(active_query, callsite_stat_prefix, *message);
+        chargeReplyStats(active_query,
+                         callsiteStatNames(active_query.query_info_.collection(),
+                                           active_query.query_info_.callsite()),
+                         *message);
       }
     }
 
@@ -209,17 +244,16 @@ void ProxyFilter::onDrainClose() {
   read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
 }
 
-void ProxyFilter::chargeReplyStats(ActiveQuery& active_query, const std::string& prefix,
+void ProxyFilter::chargeReplyStats(ActiveQuery& active_query, const QueryStatNames& names,
                                    const ReplyMessage& message) {
   uint64_t reply_documents_byte_size = 0;
   for (const Bson::DocumentSharedPtr& document : message.documents()) {
     reply_documents_byte_size += document->byteSize();
   }
 
-  scope_.histogram(fmt::format("{}.reply_num_docs", prefix))
-      .recordValue(message.documents().size());
-  scope_.histogram(fmt::format("{}.reply_size", prefix)).recordValue(reply_documents_byte_size);
-  scope_.histogram(fmt::format("{}.reply_time_ms", prefix))
+  scope_.histogramFromStatName(*names.reply_num_docs_).recordValue(message.documents().size());
+  scope_.histogramFromStatName(*names.reply_size_).recordValue(reply_documents_byte_size);
+  scope_.histogramFromStatName(*names.reply_time_ms_)
       .recordValue(std::chrono::duration_cast<std::chrono::milliseconds>(
                        std::chrono::steady_clock::now() - active_query.start_time_)
                        .count());
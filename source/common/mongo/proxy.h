@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/common/time.h"
@@ -16,6 +17,7 @@
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/stats/symbol_table.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
@@ -165,14 +167,37 @@ private:
 
   typedef std::unique_ptr<ActiveQuery> ActiveQueryPtr;
 
+  /**
+   * The stats charged for the queries of a command, collection or callsite. They are interned the
+   * first time the connection sees the command, collection or callsite, so that charging them does
+   * not build a name for every message.
+   */
+  struct QueryStatNames {
+    QueryStatNames(Stats::SymbolTable& symbol_table, const std::string& prefix);
+
+    const Stats::StatNamePtr total_;
+    const Stats::StatNamePtr scatter_get_;
+    const Stats::StatNamePtr multi_get_;
+    const Stats::StatNamePtr reply_num_docs_;
+    const Stats::StatNamePtr reply_size_;
+    const Stats::StatNamePtr reply_time_ms_;
+  };
+
+  typedef std::unique_ptr<QueryStatNames> QueryStatNamesPtr;
+  typedef std::unordered_map<std::string, QueryStatNamesPtr> QueryStatNamesMap;
+
   MongoProxyStats generateStats(const std::string& prefix, Stats::Scope& scope) {
     return MongoProxyStats{ALL_MONGO_PROXY_STATS(POOL_COUNTER_PREFIX(scope, prefix),
                                                  POOL_GAUGE_PREFIX(scope, prefix),
                                                  POOL_HISTOGRAM_PREFIX(scope, prefix))};
   }
 
-  void chargeQueryStats(const std::string& prefix, QueryMessageInfo::QueryType query_type);
-  void chargeReplyStats(ActiveQuery& active_query, const std::string& prefix,
+  const QueryStatNames& commandStatNames(const std::string& command);
+  const QueryStatNames& collectionStatNames(const std::string& collection);
+  const QueryStatNames& callsiteStatNames(const std::string& collection,
+                                          const std::string& callsite);
+  void chargeQueryStats(const QueryStatNames& names, QueryMessageInfo::QueryType query_type);
+  void chargeReplyStats(ActiveQuery& active_query, const QueryStatNames& names,
                         const ReplyMessage& message);
   void doDecode(Buffer::Instance& buffer);
   void logMessage(Message& message, bool full);
@@ -185,6 +210,10 @@ private:
   std::string stat_prefix_;
   Stats::Scope& scope_;
   MongoProxyStats stats_;
+  QueryStatNamesMap command_stat_names_;
+  QueryStatNamesMap collection_stat_names_;
+  // Keyed by collection, then by callsite.
+  std::unordered_map<std::string, QueryStatNamesMap> callsite_stat_names_;
   Runtime::Loader& runtime_;
   const Network::DrainDecision& drain_decision_;
   Buffer::OwnedImpl read_buffer_;
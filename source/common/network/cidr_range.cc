@@ -14,6 +14,7 @@
 #include "common/common/assert.h"
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
+#include "common/network/lc_trie.h"
 #include "common/network/utility.h"
 
 #include "fmt/format.h"
@@ -220,39 +221,52 @@ InstanceConstSharedPtr CidrRange::truncateIpAddressAndLength(InstanceConstShared
   NOT_REACHED
 }
 
-IpList::IpList(const std::vector<std::string>& subnets) {
+namespace {
+
+std::vector<CidrRange> parseSubnets(const std::vector<std::string>& subnets) {
+  std::vector<CidrRange> ip_list;
   for (const std::string& entry : subnets) {
     CidrRange list_entry = CidrRange::create(entry);
     if (list_entry.isValid()) {
-      ip_list_.push_back(list_entry);
+      ip_list.push_back(list_entry);
     } else {
       throw EnvoyException(
           fmt::format("invalid ip/mask combo '{}' (format is <ip>/<# mask bits>)", entry));
     }
   }
+  return ip_list;
 }
 
-IpList::IpList(const Protobuf::RepeatedPtrField<envoy::api::v2::CidrRange>& cidrs) {
+std::vector<CidrRange>
+parseCidrs(const Protobuf::RepeatedPtrField<envoy::api::v2::CidrRange>& cidrs) {
+  std::vector<CidrRange> ip_list;
   for (const envoy::api::v2::CidrRange& entry : cidrs) {
     CidrRange list_entry = CidrRange::create(entry);
     if (list_entry.isValid()) {
-      ip_list_.push_back(list_entry);
+      ip_list.push_back(list_entry);
     } else {
       throw EnvoyException(
           fmt::format("invalid ip/mask combo '{}/{}' (format is <ip>/<# mask bits>)",
                       entry.address_prefix(), entry.prefix_len().value()));
     }
   }
+  return ip_list;
 }
 
-bool IpList::contains(const Instance& address) const {
-  for (const CidrRange& entry : ip_list_) {
-    if (entry.isInRange(address)) {
-      return true;
-    }
-  }
-  return false;
-}
+} // namespace
+
+IpList::IpList(const std::vector<CidrRange>& ip_list)
+    : trie_(std::make_shared<const LcTrie::LcTrie<bool>>(
+          std::vector<std::pair<bool, std::vector<CidrRange>>>{{true, ip_list}})) {}
+
+IpList::IpList(const std::vector<std::string>& subnets) : IpList(parseSubnets(subnets)) {}
+
+IpList::IpList(const Protobuf::RepeatedPtrField<envoy::api::v2::CidrRange>& cidrs)
+    : IpList(parseCidrs(cidrs)) {}
+
+bool IpList::contains(const Instance& address) const { return !trie_->getData(address).empty(); }
+
+bool IpList::empty() const { return trie_->empty(); }
 
 IpList::IpList(const Json::Object& config, const std::string& member_name)
     : IpList(config.hasObject(member_name) ? config.getStringArray(member_name)
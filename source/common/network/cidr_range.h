@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,10 @@
 
 namespace Envoy {
 namespace Network {
+namespace LcTrie {
+template <class T> class LcTrie;
+} // namespace LcTrie
+
 namespace Address {
 
 /**
@@ -120,20 +125,24 @@ private:
 
 /**
  * Class for keeping a list of CidrRanges, and then determining whether an
- * IP address is in the CidrRange list.
+ * IP address is in the CidrRange list. The ranges are kept in an LC-trie, so lookups do not
+ * scale with the length of the list.
  */
 class IpList {
 public:
   IpList(const std::vector<std::string>& subnets);
   IpList(const Json::Object& config, const std::string& member_name);
   IpList(const Protobuf::RepeatedPtrField<envoy::api::v2::CidrRange>& cidrs);
-  IpList(){};
+  IpList() : IpList(std::vector<CidrRange>()) {}
 
   bool contains(const Instance& address) const;
-  bool empty() const { return ip_list_.empty(); }
+  bool empty() const;
 
 private:
-  std::vector<CidrRange> ip_list_;
+  IpList(const std::vector<CidrRange>& ip_list);
+
+  // Shared so that copies of a list share the trie, which is immutable.
+  std::shared_ptr<const LcTrie::LcTrie<bool>> trie_;
 };
 
 } // namespace Address
@@ -0,0 +1,46 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+void ConnectionBalancerImpl::registerListener(BalancedListener& listener) {
+  std::lock_guard<std::mutex> guard(lock_);
+  listeners_.push_back(&listener);
+}
+
+void ConnectionBalancerImpl::unregisterListener(BalancedListener& listener) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto it = std::find(listeners_.begin(), listeners_.end(), &listener);
+  ASSERT(it != listeners_.end());
+  listeners_.erase(it);
+}
+
+bool ConnectionBalancerImpl::balanceConnection(BalancedListener& listener, int fd,
+                                               Address::InstanceConstSharedPtr remote_address,
+                                               Address::InstanceConstSharedPtr local_address,
+                                               bool using_original_dst) {
+  std::lock_guard<std::mutex> guard(lock_);
+  BalancedListener* target = &listener;
+  uint64_t target_connections = listener.numConnections();
+  for (BalancedListener* other : listeners_) {
+    // Ties stay with the accepting listener, which avoids a hop to another thread.
+    const uint64_t connections = other->numConnections();
+    if (connections < target_connections) {
+      target = other;
+      target_connections = connections;
+    }
+  }
+
+  if (target == &listener) {
+    return false;
+  }
+  target->post(fd, remote_address, local_address, using_original_dst);
+  return true;
+}
+
+} // namespace Network
+} // namespace Envoy
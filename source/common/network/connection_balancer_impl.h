@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "envoy/network/listener.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * ConnectionBalancer which hands each connection to the listener whose thread owns the fewest
+ * connections. The listeners are scanned under a lock, which also keeps a listener from being
+ * destroyed while a connection is handed to it.
+ */
+class ConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  // Network::ConnectionBalancer
+  void registerListener(BalancedListener& listener) override;
+  void unregisterListener(BalancedListener& listener) override;
+  bool balanceConnection(BalancedListener& listener, int fd,
+                         Address::InstanceConstSharedPtr remote_address,
+                         Address::InstanceConstSharedPtr local_address,
+                         bool using_original_dst) override;
+
+private:
+  std::mutex lock_;
+  std::vector<BalancedListener*> listeners_;
+};
+
+} // namespace Network
+} // namespace Envoy
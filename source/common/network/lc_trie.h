@@ -0,0 +1,369 @@
+#pragma once
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "envoy/network/address.h"
+
+#include "common/common/assert.h"
+#include "common/network/cidr_range.h"
+
+#include "absl/numeric/int128.h"
+
+namespace Envoy {
+namespace Network {
+namespace LcTrie {
+
+/**
+ * Level compressed trie (LC-trie) for matching IP addresses against a set of CIDR ranges, see
+ * "IP-address lookup using LC-tries" by S. Nilsson and G. Karlsson (IEEE Journal on Selected Areas
+ * in Communications, 1999).
+ *
+ * Every range is associated with one or more pieces of data (e.g. tags). A lookup finds the longest
+ * range containing the address and returns the data of that range together with the data of every
+ * range containing it, i.e. the data of all ranges which contain the address. Nodes with densely
+ * populated subtrees branch on several bits at once, so a lookup typically takes a handful of
+ * memory accesses regardless of the number of ranges.
+ *
+ * The trie is immutable once built and is safe to share between threads.
+ */
+template <class T> class LcTrie {
+public:
+  /**
+   * @param data supplies the ranges for each piece of data. A range may be listed for several
+   *        pieces of data. Pieces of data are compared with operator==.
+   * @param fill_factor supplies the fraction of a node's children which must lead to a range for
+   *        the node to branch on another bit. Lower values give a shallower trie with more empty
+   *        children. Must be in (0, 1].
+   * @param root_branching_factor supplies the number of bits the root branches on, or 0 to pick it
+   *        with fill_factor like every other node.
+   */
+  LcTrie(const std::vector<std::pair<T, std::vector<Address::CidrRange>>>& data,
+         double fill_factor = 0.5, uint32_t root_branching_factor = 0) {
+    ASSERT(fill_factor > 0 && fill_factor <= 1);
+    std::vector<typename Trie<Ipv4>::Entry> ipv4_entries;
+    std::vector<typename Trie<Ipv6>::Entry> ipv6_entries;
+    for (uint32_t i = 0; i < data.size(); i++) {
+      for (const Address::CidrRange& range : data[i].second) {
+        if (!range.isValid()) {
+          continue;
+        }
+        if (range.ip()->version() == Address::IpVersion::v4) {
+          ipv4_entries.push_back(
+              {toIpType(*range.ip()->ipv4()), static_cast<uint32_t>(range.length()), {i}});
+        } else {
+          ipv6_entries.push_back(
+              {toIpType(*range.ip()->ipv6()), static_cast<uint32_t>(range.length()), {i}});
+        }
+      }
+    }
+
+    // Prefixes share the data set of their containing ranges, so the sets are interned and every
+    // distinct set is stored once.
+    std::map<std::vector<uint32_t>, uint32_t> data_set_indexes;
+    const auto intern = [&data, &data_set_indexes, this](const std::vector<uint32_t>& set) {
+      auto it = data_set_indexes.find(set);
+      if (it != data_set_indexes.end()) {
+        return it->second;
+      }
+      std::vector<T> data_set;
+      for (uint32_t index : set) {
+        if (std::find(data_set.begin(), data_set.end(), data[index].first) == data_set.end()) {
+          data_set.push_back(data[index].first);
+        }
+      }
+      data_sets_.emplace_back(std::move(data_set));
+      data_set_indexes.emplace(set, data_sets_.size() - 1);
+      return static_cast<uint32_t>(data_sets_.size() - 1);
+    };
+
+    ipv4_trie_.build(std::move(ipv4_entries), fill_factor, root_branching_factor, intern);
+    ipv6_trie_.build(std::move(ipv6_entries), fill_factor, root_branching_factor, intern);
+  }
+
+  /**
+   * @param address supplies the address to look up.
+   * @return the data of all ranges which contain the address, which is empty if there are none or
+   *         if the address is not an IP address.
+   */
+  const std::vector<T>& getData(const Address::Instance& address) const {
+    if (address.type() != Address::Type::Ip) {
+      return empty_data_;
+    }
+
+    uint32_t data_set;
+    if (address.ip()->version() == Address::IpVersion::v4) {
+      data_set = ipv4_trie_.lookup(toIpType(*address.ip()->ipv4()));
+    } else {
+      data_set = ipv6_trie_.lookup(toIpType(*address.ip()->ipv6()));
+    }
+    return data_set == NO_MATCH ? empty_data_ : data_sets_[data_set];
+  }
+
+  /**
+   * @return bool whether the trie contains no ranges.
+   */
+  bool empty() const { return ipv4_trie_.empty() && ipv6_trie_.empty(); }
+
+private:
+  typedef uint32_t Ipv4;
+  typedef absl::uint128 Ipv6;
+
+  static const uint32_t NO_MATCH = UINT32_MAX;
+  // The most bits a node branches on, which bounds the size of a node's children array.
+  static const uint32_t MAX_BRANCH = 20;
+
+  static Ipv4 toIpType(const Address::Ipv4& ip) { return ntohl(ip.address()); }
+  static Ipv6 toIpType(const Address::Ipv6& ip) {
+    const std::array<uint8_t, 16> bytes = ip.address();
+    uint64_t high = 0;
+    uint64_t low = 0;
+    for (uint32_t i = 0; i < 8; i++) {
+      high = (high << 8) | bytes[i];
+      low = (low << 8) | bytes[i + 8];
+    }
+    return absl::MakeUint128(high, low);
+  }
+
+  /**
+   * Trie for the addresses of one IP version. IpType holds an address in host order, with the
+   * first bit of the address as its most significant bit.
+   */
+  template <class IpType, uint32_t address_size = 8 * sizeof(IpType)> class Trie {
+  public:
+    struct Entry {
+      IpType ip_;
+      uint32_t length_;
+      std::vector<uint32_t> data_;
+    };
+
+    void build(std::vector<Entry> entries, double fill_factor, uint32_t root_branching_factor,
+               const std::function<uint32_t(const std::vector<uint32_t>&)>& intern) {
+      for (Entry& entry : entries) {
+        entry.ip_ = mask(entry.ip_, entry.length_);
+      }
+      std::sort(entries.begin(), entries.end(), [](const Entry& lhs, const Entry& rhs) {
+        return lhs.ip_ < rhs.ip_ || (lhs.ip_ == rhs.ip_ && lhs.length_ < rhs.length_);
+      });
+
+      // Merge duplicate ranges, and index the ranges to find the ranges containing an address.
+      std::vector<std::vector<uint32_t>> data;
+      for (Entry& entry : entries) {
+        if (!prefixes_.empty() && prefixes_.back().ip_ == entry.ip_ &&
+            prefixes_.back().length_ == entry.length_) {
+          data.back().insert(data.back().end(), entry.data_.begin(), entry.data_.end());
+          continue;
+        }
+        prefixes_.push_back({entry.ip_, entry.length_, NO_MATCH, NO_MATCH});
+        data.emplace_back(std::move(entry.data_));
+        prefix_indexes_.emplace(std::make_pair(entry.ip_, entry.length_), prefixes_.size() - 1);
+      }
+
+      // Link every range to the longest range containing it. A range which contains another is
+      // only reachable through these links and is left out of the trie itself, so the ranges in
+      // the trie never overlap.
+      std::vector<bool> contains_other(prefixes_.size());
+      std::vector<uint32_t> by_length(prefixes_.size());
+      for (uint32_t i = 0; i < prefixes_.size(); i++) {
+        IpPrefix& prefix = prefixes_[i];
+        if (prefix.length_ > 0) {
+          prefix.contained_by_ = longestContaining(prefix.ip_, prefix.length_ - 1);
+        }
+        if (prefix.contained_by_ != NO_MATCH) {
+          contains_other[prefix.contained_by_] = true;
+        }
+        by_length[i] = i;
+      }
+
+      // A range's data includes the data of the ranges containing it. Shorter ranges are done
+      // first so that the data of the containing range is complete.
+      std::stable_sort(by_length.begin(), by_length.end(), [this](uint32_t lhs, uint32_t rhs) {
+        return prefixes_[lhs].length_ < prefixes_[rhs].length_;
+      });
+      for (uint32_t i : by_length) {
+        const uint32_t contained_by = prefixes_[i].contained_by_;
+        if (contained_by != NO_MATCH) {
+          data[i].insert(data[i].end(), data[contained_by].begin(), data[contained_by].end());
+        }
+        std::sort(data[i].begin(), data[i].end());
+        data[i].erase(std::unique(data[i].begin(), data[i].end()), data[i].end());
+        prefixes_[i].data_set_ = intern(data[i]);
+      }
+
+      for (uint32_t i = 0; i < prefixes_.size(); i++) {
+        if (!contains_other[i]) {
+          base_.push_back(i);
+        }
+      }
+      if (!base_.empty()) {
+        nodes_.resize(1);
+        buildNode(0, 0, base_.size(), 0, fill_factor, root_branching_factor);
+      }
+      prefix_indexes_.clear();
+      base_.clear();
+      base_.shrink_to_fit();
+    }
+
+    /**
+     * @return uint32_t the data set of the longest range containing the address, or NO_MATCH.
+     */
+    uint32_t lookup(IpType ip) const {
+      if (nodes_.empty()) {
+        return NO_MATCH;
+      }
+
+      const Node* node = &nodes_[0];
+      uint32_t pos = node->skip_;
+      while (node->branch_ != 0) {
+        const uint32_t child = node->address_ + extractBits(ip, pos, node->branch_);
+        pos += node->branch_;
+        node = &nodes_[child];
+        pos += node->skip_;
+      }
+
+      // Skipped bits are not compared on the way down, so the range at the leaf may not contain
+      // the address. One of the ranges containing it then does, if any range does.
+      for (uint32_t i = node->address_; i != NO_MATCH; i = prefixes_[i].contained_by_) {
+        if (mask(ip, prefixes_[i].length_) == prefixes_[i].ip_) {
+          return prefixes_[i].data_set_;
+        }
+      }
+      return NO_MATCH;
+    }
+
+    bool empty() const { return prefixes_.empty(); }
+
+  private:
+    struct IpPrefix {
+      IpType ip_;
+      uint32_t length_;
+      // Index of the longest range containing this one, or NO_MATCH.
+      uint32_t contained_by_;
+      uint32_t data_set_;
+    };
+
+    /**
+     * A trie node. Internal nodes have 2^branch_ children starting at nodes_[address_], leaves
+     * have a branch_ of 0 and address_ is the index of a range in prefixes_, or NO_MATCH.
+     */
+    struct Node {
+      uint8_t branch_;
+      // Number of bits, common to every range below the node, skipped before branching.
+      uint8_t skip_;
+      uint32_t address_;
+    };
+
+    static IpType mask(IpType ip, uint32_t length) {
+      return length == 0 ? IpType(0) : ip & (~IpType(0) << (address_size - length));
+    }
+
+    static uint32_t extractBits(IpType ip, uint32_t pos, uint32_t count) {
+      ASSERT(count > 0 && pos + count <= address_size);
+      return static_cast<uint32_t>((ip << pos) >> (address_size - count));
+    }
+
+    uint32_t longestContaining(IpType ip, int32_t length) const {
+      for (; length >= 0; length--) {
+        auto it = prefix_indexes_.find(std::make_pair(mask(ip, length), length));
+        if (it != prefix_indexes_.end()) {
+          return it->second;
+        }
+      }
+      return NO_MATCH;
+    }
+
+    const IpType& baseIp(uint32_t index) const { return prefixes_[base_[index]].ip_; }
+
+    /**
+     * Build the node for the ranges base_[first, first + n), which share their first pos bits.
+     */
+    void buildNode(uint32_t node, uint32_t first, uint32_t n, uint32_t pos, double fill_factor,
+                   uint32_t root_branching_factor) {
+      if (n == 1) {
+        nodes_[node] = {0, 0, base_[first]};
+        return;
+      }
+
+      // No range is a prefix of another, so all of them are longer than the bits they share and
+      // the node can branch on at least one bit.
+      uint32_t min_length = address_size;
+      for (uint32_t i = first; i < first + n; i++) {
+        min_length = std::min(min_length, prefixes_[base_[i]].length_);
+      }
+      uint32_t skip = 0;
+      while (pos + skip + 1 < min_length &&
+             extractBits(baseIp(first), pos + skip, 1) ==
+                 extractBits(baseIp(first + n - 1), pos + skip, 1)) {
+        skip++;
+      }
+      pos += skip;
+      ASSERT(pos < min_length);
+
+      // Branch on as many bits as the ranges fill at least fill_factor of the children for. The
+      // ranges are sorted, so counting the distinct patterns only needs to compare neighbours.
+      const uint32_t max_branch = std::min(static_cast<uint32_t>(MAX_BRANCH), min_length - pos);
+      uint32_t branch = 1;
+      if (node == 0 && root_branching_factor > 0) {
+        branch = std::min(root_branching_factor, max_branch);
+      } else {
+        while (branch < max_branch) {
+          uint32_t patterns = 1;
+          for (uint32_t i = first + 1; i < first + n; i++) {
+            if (extractBits(baseIp(i), pos, branch + 1) !=
+                extractBits(baseIp(i - 1), pos, branch + 1)) {
+              patterns++;
+            }
+          }
+          if (patterns < fill_factor * (1ULL << (branch + 1))) {
+            break;
+          }
+          branch++;
+        }
+      }
+
+      const uint32_t children = nodes_.size();
+      nodes_.resize(nodes_.size() + (1 << branch));
+      nodes_[node] = {static_cast<uint8_t>(branch), static_cast<uint8_t>(skip), children};
+
+      uint32_t i = first;
+      for (uint32_t pattern = 0; pattern < (1U << branch); pattern++) {
+        const uint32_t child_first = i;
+        while (i < first + n && extractBits(baseIp(i), pos, branch) == pattern) {
+          i++;
+        }
+        if (i > child_first) {
+          buildNode(children + pattern, child_first, i - child_first, pos + branch, fill_factor,
+                    root_branching_factor);
+        } else {
+          // No range in the trie starts with this pattern, but a range containing all addresses
+          // which do may still exist.
+          const IpType region = mask(baseIp(first), pos) |
+                                (IpType(pattern) << (address_size - pos - branch));
+          nodes_[children + pattern] = {0, 0, longestContaining(region, pos + branch)};
+        }
+      }
+    }
+
+    std::vector<IpPrefix> prefixes_;
+    std::vector<Node> nodes_;
+    // Only used while building.
+    std::map<std::pair<IpType, uint32_t>, uint32_t> prefix_indexes_;
+    std::vector<uint32_t> base_;
+  };
+
+  Trie<Ipv4> ipv4_trie_;
+  Trie<Ipv6> ipv6_trie_;
+  std::vector<std::vector<T>> data_sets_;
+  std::vector<T> empty_data_;
+};
+
+} // namespace LcTrie
+} // namespace Network
+} // namespace Envoy
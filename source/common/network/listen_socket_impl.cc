@@ -30,7 +30,11 @@ void ListenSocketImpl::doBind() {
   }
 }
 
-TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port) {
+TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port)
+    : TcpListenSocket(address, bind_to_port, false) {}
+
+TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port,
+                                 bool reuse_port) {
   local_address_ = address;
   fd_ = local_address_->socket(Address::SocketType::Stream);
   RELEASE_ASSERT(fd_ != -1);
@@ -39,6 +43,11 @@ TcpListenSocket::TcpListenSocket(Address::InstanceConstSharedPtr address, bool b
   int rc = setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
   RELEASE_ASSERT(rc != -1);
 
+  if (reuse_port) {
+    rc = setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    RELEASE_ASSERT(rc != -1);
+  }
+
   if (bind_to_port) {
     doBind();
   }
@@ -40,6 +40,11 @@ protected:
 class TcpListenSocket : public ListenSocketImpl {
 public:
   TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port);
+  /**
+   * @param reuse_port supplies whether to set SO_REUSEPORT, which lets several sockets bind the
+   *        same address. The kernel spreads new connections across them.
+   */
+  TcpListenSocket(Address::InstanceConstSharedPtr address, bool bind_to_port, bool reuse_port);
   TcpListenSocket(int fd, Address::InstanceConstSharedPtr address);
 };
 
@@ -1,6 +1,9 @@
 #include "common/network/listener_impl.h"
 
+#include <fcntl.h>
+#include <sys/socket.h>
 #include <sys/un.h>
+#include <unistd.h>
 
 #include "envoy/common/exception.h"
 #include "envoy/network/connection_handler.h"
@@ -13,7 +16,6 @@
 #include "common/network/utility.h"
 #include "common/ssl/connection_impl.h"
 
-#include "event2/listener.h"
 #include "fmt/format.h"
 
 namespace Envoy {
@@ -27,9 +29,38 @@ Address::InstanceConstSharedPtr ListenerImpl::getOriginalDst(int fd) {
   return Utility::getOriginalDst(fd);
 }
 
-void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
-                                  int remote_addr_len, void* arg) {
-  ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
+void ListenerImpl::onSocketEvent() {
+  for (uint32_t i = 0; options_.accept_batch_size_ == 0 || i < options_.accept_batch_size_; i++) {
+    sockaddr_storage remote_addr;
+    socklen_t remote_addr_len = sizeof(remote_addr);
+#ifdef __APPLE__
+    const int fd = ::accept(socket_.fd(), reinterpret_cast<sockaddr*>(&remote_addr),
+                            &remote_addr_len);
+    if (fd != -1) {
+      // Cannot set SOCK_NONBLOCK as an accept flag.
+      RELEASE_ASSERT(fcntl(fd, F_SETFL, O_NONBLOCK) != -1);
+    }
+#else
+    const int fd = ::accept4(socket_.fd(), reinterpret_cast<sockaddr*>(&remote_addr),
+                             &remote_addr_len, SOCK_NONBLOCK);
+#endif
+    if (fd == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR || errno == ECONNABORTED) {
+        // The socket is level triggered, so any connection still queued is accepted later.
+        return;
+      }
+      // We should never get an error here. This can happen if we run out of FDs or memory. In
+      // those cases just crash.
+      PANIC(fmt::format("listener accept failure: {}", strerror(errno)));
+    }
+
+    onAccept(fd, remote_addr, remote_addr_len);
+  }
+}
+
+void ListenerImpl::onAccept(int fd, const sockaddr_storage& remote_addr,
+                            socklen_t remote_addr_len) {
+  ListenerImpl* listener = this;
   Address::InstanceConstSharedPtr final_local_address = listener->socket_.localAddress();
   bool using_original_dst = false;
 
@@ -67,20 +98,20 @@ void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr*
     listener->proxy_protocol_.newConnection(listener->dispatcher_, fd, *listener);
   } else {
     Address::InstanceConstSharedPtr final_remote_address;
-    if (remote_addr->sa_family == AF_UNIX) {
+    if (remote_addr.ss_family == AF_UNIX) {
       // The accept() call that filled in remote_addr doesn't fill in more than the sa_family field
       // for Unix domain sockets; apparently there isn't a mechanism in the kernel to get the
       // sockaddr_un associated with the client socket when starting from the server socket.
       // We work around this by using our own name for the socket in this case.
       final_remote_address = Address::peerAddressFromFd(fd);
     } else {
-      final_remote_address = Address::addressFromSockAddr(
-          *reinterpret_cast<const sockaddr_storage*>(remote_addr), remote_addr_len);
+      final_remote_address = Address::addressFromSockAddr(remote_addr, remote_addr_len);
     }
     // TODO(jamessynge): We need to keep per-family stats. BUT, should it be based on the original
     // family or the local family? Probably local family, as the original proxy can take care of
     // stats for the original family.
-    listener->newConnection(fd, final_remote_address, final_local_address, using_original_dst);
+    listener->dispatchConnection(fd, final_remote_address, final_local_address,
+                                 using_original_dst);
   }
 }
 
@@ -89,25 +120,91 @@ ListenerImpl::ListenerImpl(Network::ConnectionHandler& conn_handler,
                            ListenerCallbacks& cb, Stats::Scope& scope,
                            const Network::ListenerOptions& listener_options)
     : connection_handler_(conn_handler), dispatcher_(dispatcher), socket_(socket), cb_(cb),
-      proxy_protocol_(scope), options_(listener_options), listener_(nullptr) {
+      proxy_protocol_(scope), options_(listener_options) {
 
   if (options_.bind_to_port_) {
-    listener_.reset(
-        evconnlistener_new(&dispatcher_.base(), listenCallback, this, 0, -1, socket.fd()));
-
-    if (!listener_) {
+    if (::listen(socket.fd(), 128) != 0) {
       throw CreateListenerException(
           fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
     }
 
-    evconnlistener_set_error_cb(listener_.get(), errorCallback);
+    file_event_ = dispatcher_.createFileEvent(socket.fd(),
+                                              [this](uint32_t) -> void { onSocketEvent(); },
+                                              Event::FileTriggerType::Level,
+                                              Event::FileReadyType::Read);
+  }
+
+  if (options_.connection_balancer_ != nullptr) {
+    options_.connection_balancer_->registerListener(*this);
   }
 }
 
-void ListenerImpl::errorCallback(evconnlistener*, void*) {
-  // We should never get an error callback. This can happen if we run out of FDs or memory. In those
-  // cases just crash.
-  PANIC(fmt::format("listener accept failure: {}", strerror(errno)));
+ListenerImpl::~ListenerImpl() {
+  if (options_.connection_balancer_ != nullptr) {
+    options_.connection_balancer_->unregisterListener(*this);
+  }
+}
+
+uint64_t ListenerImpl::numConnections() {
+  return connection_handler_.numConnections() + posted_connections_;
+}
+
+namespace {
+
+/**
+ * Accepted fd which is closed on destruction unless it has been released.
+ */
+class PostedFd {
+public:
+  PostedFd(int fd) : fd_(fd) {}
+  ~PostedFd() {
+    if (fd_ != -1) {
+      ::close(fd_);
+    }
+  }
+
+  /**
+   * @return int the fd, which the caller now owns.
+   */
+  int release() {
+    const int fd = fd_;
+    fd_ = -1;
+    return fd;
+  }
+
+private:
+  int fd_;
+};
+
+} // namespace
+
+void ListenerImpl::post(int fd, Address::InstanceConstSharedPtr remote_address,
+                        Address::InstanceConstSharedPtr local_address, bool using_original_dst) {
+  posted_connections_++;
+  std::weak_ptr<bool> alive = alive_;
+  // The fd is owned by the posted callback, so it is closed if the callback never creates a
+  // connection from it. This includes the dispatcher being destroyed with the callback queued.
+  std::shared_ptr<PostedFd> posted_fd = std::make_shared<PostedFd>(fd);
+  dispatcher_.post(
+      [this, alive, posted_fd, remote_address, local_address, using_original_dst]() -> void {
+        // The listener is destroyed on this thread, so it cannot go away while this runs.
+        if (alive.expired()) {
+          return;
+        }
+        posted_connections_--;
+        newConnection(posted_fd->release(), remote_address, local_address, using_original_dst);
+      });
+}
+
+void ListenerImpl::dispatchConnection(int fd, Address::InstanceConstSharedPtr remote_address,
+                                      Address::InstanceConstSharedPtr local_address,
+                                      bool using_original_dst) {
+  if (options_.connection_balancer_ != nullptr &&
+      options_.connection_balancer_->balanceConnection(*this, fd, remote_address, local_address,
+                                                       using_original_dst)) {
+    return;
+  }
+  newConnection(fd, remote_address, local_address, using_original_dst);
 }
 
 void ListenerImpl::newConnection(int fd, Address::InstanceConstSharedPtr remote_address,
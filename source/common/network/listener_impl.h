@@ -1,26 +1,46 @@
 #pragma once
 
+#include <sys/socket.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/event/file_event.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/network/listener.h"
 
 #include "common/event/dispatcher_impl.h"
-#include "common/event/libevent.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/proxy_protocol.h"
 
-#include "event2/event.h"
-
 namespace Envoy {
 namespace Network {
 
 /**
  * libevent implementation of Network::Listener.
  */
-class ListenerImpl : public Listener {
+class ListenerImpl : public Listener, public BalancedListener {
 public:
   ListenerImpl(Network::ConnectionHandler& conn_handler, Event::DispatcherImpl& dispatcher,
                ListenSocket& socket, ListenerCallbacks& cb, Stats::Scope& scope,
                const ListenerOptions& listener_options);
+  ~ListenerImpl();
+
+  // Network::BalancedListener
+  uint64_t numConnections() override;
+  void post(int fd, Address::InstanceConstSharedPtr remote_address,
+            Address::InstanceConstSharedPtr local_address, bool using_original_dst) override;
+
+  /**
+   * Hand a connection accepted by this listener to the connection balancer, if there is one,
+   * otherwise create it with newConnection().
+   * @param fd supplies the new connection's fd.
+   * @param remote_address supplies the remote address for the new connection.
+   * @param local_address supplies the local address for the new connection.
+   */
+  void dispatchConnection(int fd, Address::InstanceConstSharedPtr remote_address,
+                          Address::InstanceConstSharedPtr local_address, bool using_original_dst);
 
   /**
    * Accept/process a new connection.
@@ -49,11 +69,14 @@ protected:
   const ListenerOptions options_;
 
 private:
-  static void errorCallback(evconnlistener* listener, void* context);
-  static void listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
-                             int remote_addr_len, void* arg);
+  void onSocketEvent();
+  void onAccept(int fd, const sockaddr_storage& remote_addr, socklen_t remote_addr_len);
 
-  Event::Libevent::ListenerPtr listener_;
+  Event::FileEventPtr file_event_;
+  // Connections posted to this listener by other threads which are not created yet.
+  std::atomic<uint64_t> posted_connections_{};
+  // Expires when the listener is destroyed, which tells posted connections to close instead.
+  const std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
 };
 
 class SslListenerImpl : public ListenerImpl {
@@ -137,7 +137,7 @@ void ProxyProtocol::ActiveConnection::finishConnection(
 
   removeFromList(parent_.connections_);
 
-  listener.newConnection(fd, remote_address, local_address, true);
+  listener.dispatchConnection(fd, remote_address, local_address, true);
 }
 
 void ProxyProtocol::ActiveConnection::close() {
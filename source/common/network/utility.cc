@@ -80,8 +80,8 @@ uint32_t Utility::portFromTcpUrl(const std::string& url) {
   }
 }
 
-Address::InstanceConstSharedPtr Utility::parseInternetAddress(const std::string& ip_address,
-                                                              uint16_t port) {
+Address::InstanceConstSharedPtr Utility::parseInternetAddressNoThrow(const std::string& ip_address,
+                                                                     uint16_t port) {
   sockaddr_in sa4;
   if (inet_pton(AF_INET, ip_address.c_str(), &sa4.sin_addr) == 1) {
     sa4.sin_family = AF_INET;
@@ -94,8 +94,16 @@ Address::InstanceConstSharedPtr Utility::parseInternetAddress(const std::string&
     sa6.sin6_port = htons(port);
     return std::make_shared<Address::Ipv6Instance>(sa6);
   }
-  throwWithMalformedIp(ip_address);
-  NOT_REACHED;
+  return nullptr;
+}
+
+Address::InstanceConstSharedPtr Utility::parseInternetAddress(const std::string& ip_address,
+                                                              uint16_t port) {
+  Address::InstanceConstSharedPtr address = parseInternetAddressNoThrow(ip_address, port);
+  if (address == nullptr) {
+    throwWithMalformedIp(ip_address);
+  }
+  return address;
 }
 
 Address::InstanceConstSharedPtr
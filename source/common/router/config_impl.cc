@@ -61,13 +61,16 @@ CorsPolicyImpl::CorsPolicyImpl(const envoy::api::v2::CorsPolicy& config) {
   enabled_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, enabled, true);
 }
 
-ShadowPolicyImpl::ShadowPolicyImpl(const envoy::api::v2::RouteAction& config) {
+ShadowPolicyImpl::ShadowPolicyImpl(const envoy::api::v2::RouteAction& config,
+                                   Runtime::Loader& loader) {
   if (!config.has_request_mirror_policy()) {
     return;
   }
 
   cluster_ = config.request_mirror_policy().cluster();
-  runtime_key_ = config.request_mirror_policy().runtime_key();
+  if (!config.request_mirror_policy().runtime_key().empty()) {
+    runtime_key_ = loader.registerKey(config.request_mirror_policy().runtime_key());
+  }
 }
 
 class HeaderHashMethod : public HashPolicyImpl::HashMethod {
@@ -228,10 +231,10 @@ RouteEntryImplBase::RouteEntryImplBase(const VirtualHostImpl& vhost,
       cluster_not_found_response_code_(ConfigUtility::parseClusterNotFoundResponseCode(
           route.route().cluster_not_found_response_code())),
       timeout_(PROTOBUF_GET_MS_OR_DEFAULT(route.route(), timeout, DEFAULT_ROUTE_TIMEOUT_MS)),
-      runtime_(loadRuntimeData(route.match())), loader_(loader),
+      runtime_(loadRuntimeData(route.match(), loader)), loader_(loader),
       host_redirect_(route.redirect().host_redirect()),
       path_redirect_(route.redirect().path_redirect()), retry_policy_(route.route()),
-      rate_limit_policy_(route.route().rate_limits()), shadow_policy_(route.route()),
+      rate_limit_policy_(route.route().rate_limits()), shadow_policy_(route.route(), loader),
       priority_(ConfigUtility::parsePriority(route.route().priority())),
       request_headers_parser_(HeaderParser::configure(route.route().request_headers_to_add())),
       response_headers_parser_(HeaderParser::configure(route.route().response_headers_to_add(),
@@ -342,11 +345,12 @@ void RouteEntryImplBase::finalizeResponseHeaders(Http::HeaderMap& headers,
 }
 
 Optional<RouteEntryImplBase::RuntimeData>
-RouteEntryImplBase::loadRuntimeData(const envoy::api::v2::RouteMatch& route_match) {
+RouteEntryImplBase::loadRuntimeData(const envoy::api::v2::RouteMatch& route_match,
+                                    Runtime::Loader& loader) {
   Optional<RuntimeData> runtime;
   if (route_match.has_runtime()) {
     RuntimeData data;
-    data.key_ = route_match.runtime().runtime_key();
+    data.key_ = loader.registerKey(route_match.runtime().runtime_key());
     data.default_ = route_match.runtime().default_value();
     runtime.value(data);
   }
@@ -621,14 +625,20 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::VirtualHost& virtual_host
     const bool has_path = route.match().path_specifier_case() == envoy::api::v2::RouteMatch::kPath;
     const bool has_regex =
         route.match().path_specifier_case() == envoy::api::v2::RouteMatch::kRegex;
+    const uint32_t route_index = routes_.size();
+    const bool case_sensitive =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
     if (has_prefix) {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, runtime));
+      route_index_.addPrefix(route_index, route.match().prefix(), case_sensitive);
     } else if (has_path) {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, runtime));
+      route_index_.addPath(route_index, route.match().path(), case_sensitive);
     } else {
       ASSERT(has_regex);
       UNREFERENCED_PARAMETER(has_regex);
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, runtime));
+      route_index_.addUnindexed(route_index);
     }
 
     if (validate_clusters) {
@@ -642,6 +652,8 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::VirtualHost& virtual_host
     }
   }
 
+  route_index_.finalize();
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster));
   }
@@ -718,15 +730,27 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
-  // Check for a route that matches the request.
-  for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
-    RouteConstSharedPtr route_entry = route->matches(headers, random_value);
-    if (nullptr != route_entry) {
-      return route_entry;
+  // Check for a route that matches the request. The index only yields routes whose path
+  // specifier can match, in configuration order, so the first full match still wins.
+  RouteConstSharedPtr route_entry;
+  if (headers.Path() == nullptr) {
+    // There is nothing to look up in the index, so try every route in order.
+    for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
+      route_entry = route->matches(headers, random_value);
+      if (route_entry != nullptr) {
+        break;
+      }
     }
+    return route_entry;
   }
 
-  return nullptr;
+  const Http::HeaderString& path = headers.Path()->value();
+  route_index_.findFirst(path.c_str(), path.size(), [&](uint32_t route_index) -> bool {
+    route_entry = routes_[route_index]->matches(headers, random_value);
+    return route_entry != nullptr;
+  });
+
+  return route_entry;
 }
 
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& headers) const {
@@ -18,6 +18,7 @@
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
+#include "common/router/route_index.h"
 #include "common/router/router_ratelimit.h"
 
 #include "api/rds.pb.h"
@@ -141,6 +142,7 @@ private:
 
   const std::string name_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  RouteIndex route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
@@ -176,15 +178,15 @@ private:
  */
 class ShadowPolicyImpl : public ShadowPolicy {
 public:
-  ShadowPolicyImpl(const envoy::api::v2::RouteAction& config);
+  ShadowPolicyImpl(const envoy::api::v2::RouteAction& config, Runtime::Loader& loader);
 
   // Router::ShadowPolicy
   const std::string& cluster() const override { return cluster_; }
-  const std::string& runtimeKey() const override { return runtime_key_; }
+  const Runtime::Key& runtimeKey() const override { return runtime_key_; }
 
 private:
   std::string cluster_;
-  std::string runtime_key_;
+  Runtime::Key runtime_key_;
 };
 
 /**
@@ -351,7 +353,7 @@ protected:
 
 private:
   struct RuntimeData {
-    std::string key_{};
+    Runtime::Key key_{};
     uint64_t default_{};
   };
 
@@ -422,8 +424,8 @@ private:
     WeightedClusterEntry(const RouteEntryImplBase* parent, const std::string runtime_key,
                          Runtime::Loader& loader, const std::string& name, uint64_t weight,
                          MetadataMatchCriteriaImplConstPtr cluster_metadata_match_criteria)
-        : DynamicRouteEntry(parent, name), runtime_key_(runtime_key), loader_(loader),
-          cluster_weight_(weight),
+        : DynamicRouteEntry(parent, name), runtime_key_(loader.registerKey(runtime_key)),
+          loader_(loader), cluster_weight_(weight),
           cluster_metadata_match_criteria_(std::move(cluster_metadata_match_criteria)) {}
 
     uint64_t clusterWeight() const {
@@ -440,7 +442,7 @@ private:
     static const uint64_t MAX_CLUSTER_WEIGHT;
 
   private:
-    const std::string runtime_key_;
+    const Runtime::Key runtime_key_;
     Runtime::Loader& loader_;
     const uint64_t cluster_weight_;
     MetadataMatchCriteriaImplConstPtr cluster_metadata_match_criteria_;
@@ -448,7 +450,8 @@ private:
 
   typedef std::shared_ptr<WeightedClusterEntry> WeightedClusterEntrySharedPtr;
 
-  static Optional<RuntimeData> loadRuntimeData(const envoy::api::v2::RouteMatch& route);
+  static Optional<RuntimeData> loadRuntimeData(const envoy::api::v2::RouteMatch& route,
+                                               Runtime::Loader& loader);
 
   static std::multimap<std::string, std::string>
   parseOpaqueConfig(const envoy::api::v2::Route& route);
@@ -27,6 +27,7 @@ const uint32_t RetryPolicy::RETRY_ON_GRPC_RESOURCE_EXHAUSTED;
 RetryStatePtr RetryStateImpl::create(const RetryPolicy& route_policy,
                                      Http::HeaderMap& request_headers,
                                      const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
+                                     const RetryRuntimeKeys& runtime_keys,
                                      Runtime::RandomGenerator& random,
                                      Event::Dispatcher& dispatcher,
                                      Upstream::ResourcePriority priority) {
@@ -35,8 +36,8 @@ RetryStatePtr RetryStateImpl::create(const RetryPolicy& route_policy,
   // We short circuit here and do not both with an allocation if there is no chance we will retry.
   if (request_headers.EnvoyRetryOn() || request_headers.EnvoyRetryGrpcOn() ||
       route_policy.retryOn()) {
-    ret.reset(new RetryStateImpl(route_policy, request_headers, cluster, runtime, random,
-                                 dispatcher, priority));
+    ret.reset(new RetryStateImpl(route_policy, request_headers, cluster, runtime, runtime_keys,
+                                 random, dispatcher, priority));
   }
 
   request_headers.removeEnvoyRetryOn();
@@ -47,10 +48,11 @@ RetryStatePtr RetryStateImpl::create(const RetryPolicy& route_policy,
 
 RetryStateImpl::RetryStateImpl(const RetryPolicy& route_policy, Http::HeaderMap& request_headers,
                                const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
+                               const RetryRuntimeKeys& runtime_keys,
                                Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
                                Upstream::ResourcePriority priority)
-    : cluster_(cluster), runtime_(runtime), random_(random), dispatcher_(dispatcher),
-      priority_(priority) {
+    : cluster_(cluster), runtime_(runtime), runtime_keys_(runtime_keys), random_(random),
+      dispatcher_(dispatcher), priority_(priority) {
 
   if (request_headers.EnvoyRetryOn()) {
     retry_on_ = parseRetryOn(request_headers.EnvoyRetryOn()->value().c_str());
@@ -77,7 +79,7 @@ void RetryStateImpl::enableBackoffTimer() {
   // We use a fully jittered exponential backoff algorithm.
   current_retry_++;
   uint32_t multiplier = (1 << current_retry_) - 1;
-  uint64_t base = runtime_.snapshot().getInteger("upstream.base_retry_backoff_ms", 25);
+  uint64_t base = runtime_.snapshot().getInteger(runtime_keys_.base_retry_backoff_ms_, 25);
   uint64_t timeout = random_.random() % (base * multiplier);
 
   if (!retry_timer_) {
@@ -153,7 +155,7 @@ RetryStatus RetryStateImpl::shouldRetry(const Http::HeaderMap* response_headers,
     return RetryStatus::NoOverflow;
   }
 
-  if (!runtime_.snapshot().featureEnabled("upstream.use_retry", 100)) {
+  if (!runtime_.snapshot().featureEnabled(runtime_keys_.use_retry_, 100)) {
     return RetryStatus::No;
   }
 
@@ -14,6 +14,19 @@
 namespace Envoy {
 namespace Router {
 
+/**
+ * Runtime keys read by RetryStateImpl. They are registered once per router config rather than
+ * looked up by name on every retry decision.
+ */
+struct RetryRuntimeKeys {
+  RetryRuntimeKeys(Runtime::Loader& runtime)
+      : use_retry_(runtime.registerKey("upstream.use_retry")),
+        base_retry_backoff_ms_(runtime.registerKey("upstream.base_retry_backoff_ms")) {}
+
+  const Runtime::Key use_retry_;
+  const Runtime::Key base_retry_backoff_ms_;
+};
+
 /**
  * Wraps retry state for the router.
  */
@@ -21,6 +34,7 @@ class RetryStateImpl : public RetryState {
 public:
   static RetryStatePtr create(const RetryPolicy& route_policy, Http::HeaderMap& request_headers,
                               const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
+                              const RetryRuntimeKeys& runtime_keys,
                               Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
                               Upstream::ResourcePriority priority);
   ~RetryStateImpl();
@@ -39,8 +53,8 @@ public:
 private:
   RetryStateImpl(const RetryPolicy& route_policy, Http::HeaderMap& request_headers,
                  const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
-                 Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
-                 Upstream::ResourcePriority priority);
+                 const RetryRuntimeKeys& runtime_keys, Runtime::RandomGenerator& random,
+                 Event::Dispatcher& dispatcher, Upstream::ResourcePriority priority);
 
   void enableBackoffTimer();
   void resetRetry();
@@ -49,6 +63,7 @@ private:
 
   const Upstream::ClusterInfo& cluster_;
   Runtime::Loader& runtime_;
+  const RetryRuntimeKeys& runtime_keys_;
   Runtime::RandomGenerator& random_;
   Event::Dispatcher& dispatcher_;
   uint32_t retry_on_{};
@@ -0,0 +1,155 @@
+#include "common/router/route_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+bool childLess(const std::pair<uint8_t, uint32_t>& child, uint8_t c) { return child.first < c; }
+
+} // namespace
+
+RouteIndex::RouteIndex() {
+  // Both tries always have a root node which holds the empty prefix.
+  tries_[0].emplace_back();
+  tries_[1].emplace_back();
+}
+
+void RouteIndex::addPrefix(uint32_t route_index, const std::string& prefix, bool case_sensitive) {
+  ASSERT(!finalized_);
+  ASSERT(!have_routes_ || route_index > last_route_index_);
+  Trie& trie = tries_[case_sensitive ? 0 : 1];
+  trie[insert(trie, prefix, case_sensitive)].prefix_routes_.push_back(route_index);
+  last_route_index_ = route_index;
+  have_routes_ = true;
+}
+
+void RouteIndex::addPath(uint32_t route_index, const std::string& path, bool case_sensitive) {
+  ASSERT(!finalized_);
+  ASSERT(!have_routes_ || route_index > last_route_index_);
+  Trie& trie = tries_[case_sensitive ? 0 : 1];
+  trie[insert(trie, path, case_sensitive)].path_routes_.push_back(route_index);
+  last_route_index_ = route_index;
+  have_routes_ = true;
+}
+
+void RouteIndex::addUnindexed(uint32_t route_index) {
+  ASSERT(!finalized_);
+  ASSERT(!have_routes_ || route_index > last_route_index_);
+  unindexed_routes_.push_back(route_index);
+  last_route_index_ = route_index;
+  have_routes_ = true;
+}
+
+void RouteIndex::finalize() {
+  ASSERT(!finalized_);
+  for (Trie& trie : tries_) {
+    mergeAncestors(trie, 0, {});
+    trie.shrink_to_fit();
+  }
+  finalized_ = true;
+}
+
+uint32_t RouteIndex::insert(Trie& trie, const std::string& key, bool case_sensitive) {
+  uint32_t node = 0;
+  for (char key_char : key) {
+    uint8_t c = static_cast<uint8_t>(key_char);
+    if (!case_sensitive) {
+      c = static_cast<uint8_t>(tolower(c));
+    }
+
+    auto& children = trie[node].children_;
+    auto it = std::lower_bound(children.begin(), children.end(), c, childLess);
+    if (it != children.end() && it->first == c) {
+      node = it->second;
+      continue;
+    }
+
+    // Note that emplace_back() may invalidate the children reference, so insert the child link
+    // before growing the trie.
+    const uint32_t child = trie.size();
+    children.emplace(it, c, child);
+    trie.emplace_back();
+    node = child;
+  }
+
+  return node;
+}
+
+void RouteIndex::mergeAncestors(Trie& trie, uint32_t node, const std::vector<uint32_t>& inherited) {
+  std::vector<uint32_t>& own = trie[node].prefix_routes_;
+  if (!own.empty() && !inherited.empty()) {
+    std::vector<uint32_t> merged;
+    merged.reserve(own.size() + inherited.size());
+    std::merge(inherited.begin(), inherited.end(), own.begin(), own.end(),
+               std::back_inserter(merged));
+    own.swap(merged);
+  }
+
+  // The trie does not grow during the merge, so references into it stay valid.
+  const std::vector<uint32_t>& to_children = own.empty() ? inherited : own;
+  for (const auto& child : trie[node].children_) {
+    mergeAncestors(trie, child.second, to_children);
+  }
+}
+
+void RouteIndex::lookup(const char* path, size_t path_length, Cursor* cursors) const {
+  walk(tries_[0], path, path_length, true, cursors[0], cursors[1]);
+  walk(tries_[1], path, path_length, false, cursors[2], cursors[3]);
+  assignCursor(cursors[4], unindexed_routes_);
+}
+
+void RouteIndex::walk(const Trie& trie, const char* path, size_t path_length, bool case_sensitive,
+                      Cursor& prefix_cursor, Cursor& path_cursor) {
+  // Exact path matchers ignore the query string, while prefix matchers see the entire path.
+  const size_t query_string_start = std::find(path, path + path_length, '?') - path;
+  uint32_t node = 0;
+  size_t position = 0;
+  while (true) {
+    const Node& current = trie[node];
+    // Nodes carry the prefix routes of their ancestors, so the deepest node with prefix routes
+    // supplies the entire set.
+    if (!current.prefix_routes_.empty()) {
+      assignCursor(prefix_cursor, current.prefix_routes_);
+    }
+    if (position == query_string_start) {
+      assignCursor(path_cursor, current.path_routes_);
+    }
+    if (position == path_length) {
+      break;
+    }
+
+    uint8_t c = static_cast<uint8_t>(path[position]);
+    if (!case_sensitive) {
+      c = static_cast<uint8_t>(tolower(c));
+    }
+    node = findChild(current, c);
+    if (node == NoNode) {
+      break;
+    }
+    position++;
+  }
+}
+
+uint32_t RouteIndex::findChild(const Node& node, uint8_t c) {
+  const auto& children = node.children_;
+  auto it = std::lower_bound(children.begin(), children.end(), c, childLess);
+  if (it != children.end() && it->first == c) {
+    return it->second;
+  }
+  return NoNode;
+}
+
+void RouteIndex::assignCursor(Cursor& cursor, const std::vector<uint32_t>& routes) {
+  cursor.begin_ = routes.data();
+  cursor.end_ = routes.data() + routes.size();
+}
+
+} // namespace Router
+} // namespace Envoy
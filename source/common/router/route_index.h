@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Compiled index over the path matchers of a virtual host. Prefix and exact path matchers are
+ * stored in a byte trie (one for case sensitive and one for case insensitive matchers) so that a
+ * single walk over the request path yields every route whose path specifier can match. Matchers
+ * that cannot be indexed (currently regex) are kept in a separate list and are always candidates.
+ *
+ * The index only narrows the set of routes to try. Candidates are handed back in configuration
+ * order, and it is up to the caller to run the full match (runtime and header constraints) on
+ * each of them, which preserves first match wins semantics.
+ */
+class RouteIndex {
+public:
+  RouteIndex();
+
+  /**
+   * Index a prefix matcher.
+   * @param route_index supplies the position of the route in configuration order. Routes must be
+   *        added in increasing order.
+   * @param prefix supplies the prefix to match.
+   * @param case_sensitive supplies whether the match is case sensitive.
+   */
+  void addPrefix(uint32_t route_index, const std::string& prefix, bool case_sensitive);
+
+  /**
+   * Index an exact path matcher. The query string of the request path is ignored.
+   * @param route_index supplies the position of the route in configuration order.
+   * @param path supplies the path to match.
+   * @param case_sensitive supplies whether the match is case sensitive.
+   */
+  void addPath(uint32_t route_index, const std::string& path, bool case_sensitive);
+
+  /**
+   * Add a matcher that cannot be indexed. It is a candidate for every request.
+   * @param route_index supplies the position of the route in configuration order.
+   */
+  void addUnindexed(uint32_t route_index);
+
+  /**
+   * Must be called once all routes have been added and before any lookup.
+   */
+  void finalize();
+
+  /**
+   * Walk every candidate route for a request path in configuration order.
+   * @param path supplies the request path (including any query string).
+   * @param path_length supplies the length of path.
+   * @param cb supplies a callback invoked with each candidate route index. The walk stops as soon
+   *        as the callback returns true.
+   * @return true if a callback returned true.
+   */
+  template <class Callback>
+  bool findFirst(const char* path, size_t path_length, Callback cb) const {
+    ASSERT(finalized_);
+    Cursor cursors[NumLists];
+    lookup(path, path_length, cursors);
+
+    while (true) {
+      Cursor* next = nullptr;
+      for (Cursor& cursor : cursors) {
+        if (cursor.begin_ != cursor.end_ && (next == nullptr || *cursor.begin_ < *next->begin_)) {
+          next = &cursor;
+        }
+      }
+
+      if (next == nullptr) {
+        return false;
+      }
+
+      if (cb(*next->begin_++)) {
+        return true;
+      }
+    }
+  }
+
+  /**
+   * @return the number of trie nodes. Exposed for tests and stats.
+   */
+  size_t nodeCount() const { return tries_[0].size() + tries_[1].size(); }
+
+private:
+  // Sorted range of route indices.
+  struct Cursor {
+    const uint32_t* begin_{};
+    const uint32_t* end_{};
+  };
+
+  struct Node {
+    // Children sorted by byte.
+    std::vector<std::pair<uint8_t, uint32_t>> children_;
+    // Prefix routes which end at this node, and after finalize() also every prefix route ending
+    // at an ancestor, merged in configuration order.
+    std::vector<uint32_t> prefix_routes_;
+    // Exact path routes which end at this node.
+    std::vector<uint32_t> path_routes_;
+  };
+
+  typedef std::vector<Node> Trie;
+
+  // Case sensitive prefix, case sensitive path, case insensitive prefix, case insensitive path,
+  // unindexed.
+  static const size_t NumLists = 5;
+
+  uint32_t insert(Trie& trie, const std::string& key, bool case_sensitive);
+  void mergeAncestors(Trie& trie, uint32_t node, const std::vector<uint32_t>& inherited);
+  void lookup(const char* path, size_t path_length, Cursor* cursors) const;
+  static void walk(const Trie& trie, const char* path, size_t path_length, bool case_sensitive,
+                   Cursor& prefix_cursor, Cursor& path_cursor);
+  static uint32_t findChild(const Node& node, uint8_t c);
+  static void assignCursor(Cursor& cursor, const std::vector<uint32_t>& routes);
+
+  static const uint32_t NoNode = UINT32_MAX;
+
+  // Index 0 holds case sensitive matchers and index 1 case insensitive (lower cased) matchers.
+  Trie tries_[2];
+  std::vector<uint32_t> unindexed_routes_;
+  uint32_t last_route_index_{};
+  bool have_routes_{};
+  bool finalized_{};
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -48,7 +48,7 @@ bool FilterUtility::shouldShadow(const ShadowPolicy& policy, Runtime::Loader& ru
     return false;
   }
 
-  if (!policy.runtimeKey().empty() &&
+  if (!policy.runtimeKey().name().empty() &&
       !runtime.snapshot().featureEnabled(policy.runtimeKey(), 0, stable_random, 10000UL)) {
     return false;
   }
@@ -139,16 +139,23 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
                                                                : EMPTY_STRING,
                                              zone_name,
                                              upstream_zone,
-                                             is_canary};
+                                             is_canary,
+                                             &config_.code_stat_names_};
 
     Http::CodeUtility::chargeResponseStat(info);
 
     if (!alt_stat_prefix_.empty()) {
-      Http::CodeUtility::ResponseStatInfo info{config_.scope_,   cluster_->statsScope(),
-                                               alt_stat_prefix_, response_status_code,
-                                               internal_request, EMPTY_STRING,
-                                               EMPTY_STRING,     zone_name,
-                                               upstream_zone,    is_canary};
+      Http::CodeUtility::ResponseStatInfo info{config_.scope_,
+                                               cluster_->statsScope(),
+                                               alt_stat_prefix_,
+                                               response_status_code,
+                                               internal_request,
+                                               EMPTY_STRING,
+                                               EMPTY_STRING,
+                                               zone_name,
+                                               upstream_zone,
+                                               is_canary,
+                                               &config_.code_stat_names_};
 
       Http::CodeUtility::chargeResponseStat(info);
     }
@@ -272,7 +279,8 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::HeaderMap& headers, bool e
   FilterUtility::setUpstreamScheme(headers, *cluster_);
   retry_state_ =
       createRetryState(route_entry_->retryPolicy(), headers, *cluster_, config_.runtime_,
-                       config_.random_, callbacks_->dispatcher(), route_entry_->priority());
+                       config_.retry_runtime_keys_, config_.random_, callbacks_->dispatcher(),
+                       route_entry_->priority());
   do_shadowing_ = FilterUtility::shouldShadow(route_entry_->shadowPolicy(), config_.runtime_,
                                               callbacks_->streamId());
 
@@ -943,10 +951,11 @@ void Filter::UpstreamRequest::onPoolReady(Http::StreamEncoder& request_encoder,
 RetryStatePtr
 ProdFilter::createRetryState(const RetryPolicy& policy, Http::HeaderMap& request_headers,
                              const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
+                             const RetryRuntimeKeys& runtime_keys,
                              Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
                              Upstream::ResourcePriority priority) {
-  return RetryStateImpl::create(policy, request_headers, cluster, runtime, random, dispatcher,
-                                priority);
+  return RetryStateImpl::create(policy, request_headers, cluster, runtime, runtime_keys, random,
+                                dispatcher, priority);
 }
 
 void Filter::UpstreamRequest::setRequestEncoder(Http::StreamEncoder& request_encoder) {
@@ -21,7 +21,9 @@
 #include "common/common/hash.h"
 #include "common/common/hex.h"
 #include "common/common/logger.h"
+#include "common/http/codes.h"
 #include "common/http/utility.h"
+#include "common/router/retry_state_impl.h"
 
 #include "api/filter/http/router.pb.h"
 
@@ -91,9 +93,10 @@ public:
                Runtime::RandomGenerator& random, ShadowWriterPtr&& shadow_writer,
                bool emit_dynamic_stats, bool start_child_span)
       : scope_(scope), local_info_(local_info), cm_(cm), runtime_(runtime),
-        random_(random), stats_{ALL_ROUTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))},
-        emit_dynamic_stats_(emit_dynamic_stats), start_child_span_(start_child_span),
-        shadow_writer_(std::move(shadow_writer)) {}
+        retry_runtime_keys_(runtime), random_(random),
+        stats_{ALL_ROUTER_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))},
+        code_stat_names_(scope.symbolTable()), emit_dynamic_stats_(emit_dynamic_stats),
+        start_child_span_(start_child_span), shadow_writer_(std::move(shadow_writer)) {}
 
   FilterConfig(const std::string& stat_prefix, Server::Configuration::FactoryContext& context,
                ShadowWriterPtr&& shadow_writer, const envoy::api::v2::filter::http::Router& config)
@@ -112,8 +115,10 @@ public:
   const LocalInfo::LocalInfo& local_info_;
   Upstream::ClusterManager& cm_;
   Runtime::Loader& runtime_;
+  const RetryRuntimeKeys retry_runtime_keys_;
   Runtime::RandomGenerator& random_;
   FilterStats stats_;
+  const Http::CodeStatNames code_stat_names_;
   const bool emit_dynamic_stats_;
   const bool start_child_span_;
   std::list<AccessLog::InstanceSharedPtr> upstream_logs_;
@@ -290,7 +295,9 @@ private:
   virtual RetryStatePtr createRetryState(const RetryPolicy& policy,
                                          Http::HeaderMap& request_headers,
                                          const Upstream::ClusterInfo& cluster,
-                                         Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                                         Runtime::Loader& runtime,
+                                         const RetryRuntimeKeys& runtime_keys,
+                                         Runtime::RandomGenerator& random,
                                          Event::Dispatcher& dispatcher,
                                          Upstream::ResourcePriority priority) PURE;
   Http::ConnectionPool::Instance* getConnPool();
@@ -345,6 +352,7 @@ private:
   // Filter
   RetryStatePtr createRetryState(const RetryPolicy& policy, Http::HeaderMap& request_headers,
                                  const Upstream::ClusterInfo& cluster, Runtime::Loader& runtime,
+                                 const RetryRuntimeKeys& runtime_keys,
                                  Runtime::RandomGenerator& random, Event::Dispatcher& dispatcher,
                                  Upstream::ResourcePriority priority) override;
 };
@@ -149,7 +149,8 @@ std::string RandomGeneratorImpl::uuid() {
 
 SnapshotImpl::SnapshotImpl(const std::string& root_path, const std::string& override_path,
                            RuntimeStats& stats, RandomGenerator& generator,
-                           Api::OsSysCalls& os_sys_calls)
+                           Api::OsSysCalls& os_sys_calls,
+                           const std::vector<std::string>& registered_keys)
     : generator_(generator), os_sys_calls_(os_sys_calls) {
   try {
     walkDirectory(root_path, "");
@@ -167,6 +168,22 @@ SnapshotImpl::SnapshotImpl(const std::string& root_path, const std::string& over
   }
 
   stats.num_keys_.set(values_.size());
+  resolveRegisteredKeys(registered_keys);
+}
+
+SnapshotImpl::SnapshotImpl(const SnapshotImpl& snapshot,
+                           const std::vector<std::string>& registered_keys)
+    : values_(snapshot.values_), generator_(snapshot.generator_),
+      os_sys_calls_(snapshot.os_sys_calls_) {
+  resolveRegisteredKeys(registered_keys);
+}
+
+void SnapshotImpl::resolveRegisteredKeys(const std::vector<std::string>& registered_keys) {
+  registered_values_.reserve(registered_keys.size());
+  for (const std::string& key : registered_keys) {
+    auto entry = values_.find(key);
+    registered_values_.push_back(entry == values_.end() ? nullptr : &entry->second);
+  }
 }
 
 const std::string& SnapshotImpl::get(const std::string& key) const {
@@ -187,6 +204,20 @@ uint64_t SnapshotImpl::getInteger(const std::string& key, uint64_t default_value
   }
 }
 
+uint64_t SnapshotImpl::getInteger(const Key& key, uint64_t default_value) const {
+  if (key.index() >= registered_values_.size()) {
+    // The key was registered after this snapshot was loaded.
+    return getInteger(key.name(), default_value);
+  }
+
+  const Entry* entry = registered_values_[key.index()];
+  if (entry == nullptr || !entry->uint_value_.valid()) {
+    return default_value;
+  } else {
+    return entry->uint_value_.value();
+  }
+}
+
 void SnapshotImpl::walkDirectory(const std::string& path, const std::string& prefix) {
   ENVOY_LOG(debug, "walking directory: {}", path);
   Directory current_dir(path);
@@ -249,11 +280,26 @@ void SnapshotImpl::walkDirectory(const std::string& path, const std::string& pre
   }
 }
 
+Key KeyRegistry::registerKey(const std::string& name) {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto it = indexes_.emplace(name, names_.size());
+  if (it.second) {
+    names_.push_back(name);
+  }
+  return Key(name, it.first->second);
+}
+
+std::vector<std::string> KeyRegistry::keys() const {
+  std::unique_lock<std::mutex> lock(lock_);
+  return names_;
+}
+
 LoaderImpl::LoaderImpl(Event::Dispatcher& dispatcher, ThreadLocal::SlotAllocator& tls,
                        const std::string& root_symlink_path, const std::string& subdir,
                        const std::string& override_dir, Stats::Store& store,
                        RandomGenerator& generator, Api::OsSysCallsPtr os_sys_calls)
-    : watcher_(dispatcher.createFilesystemWatcher()), tls_(tls.allocateSlot()),
+    : dispatcher_(dispatcher), watcher_(dispatcher.createFilesystemWatcher()),
+      tls_(tls.allocateSlot()),
       generator_(generator), root_path_(root_symlink_path + "/" + subdir),
       override_path_(root_symlink_path + "/" + override_dir), stats_(generateStats(store)),
       os_sys_calls_(std::move(os_sys_calls)) {
@@ -270,9 +316,42 @@ RuntimeStats LoaderImpl::generateStats(Stats::Store& store) {
   return stats;
 }
 
+Key LoaderImpl::registerKey(const std::string& name) {
+  Key key = keys_.registerKey(name);
+  // Most keys are registered during configuration, after the first snapshot was loaded. Resolve
+  // them in a copy of the current snapshot rather than waiting for the next runtime swap. Only the
+  // first registration before the refresh runs posts it, so a batch of keys is resolved at once.
+  if (key.index() >= resolved_keys_ && !refresh_pending_.exchange(true)) {
+    std::weak_ptr<bool> alive = alive_;
+    dispatcher_.post([this, alive]() -> void {
+      // The loader is destroyed on the main thread, so it cannot go away while this runs.
+      if (!alive.expired()) {
+        onKeysRegistered();
+      }
+    });
+  }
+  return key;
+}
+
+void LoaderImpl::onKeysRegistered() {
+  // Clear the flag before reading the keys, so a key registered concurrently posts another refresh.
+  refresh_pending_ = false;
+  const std::vector<std::string> keys = keys_.keys();
+  if (keys.size() > resolved_keys_) {
+    setSnapshot(new SnapshotImpl(*current_snapshot_, keys), keys.size());
+  }
+}
+
 void LoaderImpl::onSymlinkSwap() {
-  current_snapshot_.reset(
-      new SnapshotImpl(root_path_, override_path_, stats_, generator_, *os_sys_calls_));
+  const std::vector<std::string> keys = keys_.keys();
+  setSnapshot(new SnapshotImpl(root_path_, override_path_, stats_, generator_, *os_sys_calls_,
+                               keys),
+              keys.size());
+}
+
+void LoaderImpl::setSnapshot(SnapshotImpl* snapshot, uint32_t num_keys) {
+  current_snapshot_.reset(snapshot);
+  resolved_keys_ = num_keys;
   ThreadLocal::ThreadLocalObjectSharedPtr ptr_copy = current_snapshot_;
   tls_->set([ptr_copy](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return ptr_copy;
@@ -2,10 +2,13 @@
 
 #include <dirent.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "envoy/api/os_sys_calls.h"
 #include "envoy/common/exception.h"
@@ -62,36 +65,54 @@ class SnapshotImpl : public Snapshot,
                      public ThreadLocal::ThreadLocalObject,
                      Logger::Loggable<Logger::Id::runtime> {
 public:
+  /**
+   * @param registered_keys supplies the names of the keys registered with the loader, indexed by
+   *        key index. Their values are resolved up front for lookups by Key.
+   */
   SnapshotImpl(const std::string& root_path, const std::string& override_path, RuntimeStats& stats,
-               RandomGenerator& generator, Api::OsSysCalls& os_sys_calls);
+               RandomGenerator& generator, Api::OsSysCalls& os_sys_calls,
+               const std::vector<std::string>& registered_keys);
+
+  /**
+   * Copy the values of an already loaded snapshot without going to disk, resolving the registered
+   * keys again. Used to resolve keys registered after the snapshot was loaded.
+   */
+  SnapshotImpl(const SnapshotImpl& snapshot, const std::vector<std::string>& registered_keys);
 
   // Runtime::Snapshot
   bool featureEnabled(const std::string& key, uint64_t default_value, uint64_t random_value,
                       uint16_t num_buckets) const override {
-    return random_value % static_cast<uint64_t>(num_buckets) <
-           std::min(getInteger(key, default_value), static_cast<uint64_t>(num_buckets));
+    return valueEnabled(getInteger(key, default_value), random_value, num_buckets);
   }
 
   bool featureEnabled(const std::string& key, uint64_t default_value) const override {
-    // Avoid PNRG if we know we don't need it.
-    uint64_t cutoff = std::min(getInteger(key, default_value), static_cast<uint64_t>(100));
-    if (cutoff == 0) {
-      return false;
-    } else if (cutoff == 100) {
-      return true;
-    } else {
-      return generator_.random() % 100 < cutoff;
-    }
+    return valueEnabled(getInteger(key, default_value));
   }
 
   bool featureEnabled(const std::string& key, uint64_t default_value,
                       uint64_t random_value) const override {
-    return featureEnabled(key, default_value, random_value, 100);
+    return valueEnabled(getInteger(key, default_value), random_value, 100);
   }
 
   const std::string& get(const std::string& key) const override;
   uint64_t getInteger(const std::string&, uint64_t default_value) const override;
 
+  bool featureEnabled(const Key& key, uint64_t default_value) const override {
+    return valueEnabled(getInteger(key, default_value));
+  }
+
+  bool featureEnabled(const Key& key, uint64_t default_value,
+                      uint64_t random_value) const override {
+    return valueEnabled(getInteger(key, default_value), random_value, 100);
+  }
+
+  bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                      uint16_t num_buckets) const override {
+    return valueEnabled(getInteger(key, default_value), random_value, num_buckets);
+  }
+
+  uint64_t getInteger(const Key& key, uint64_t default_value) const override;
+
 private:
   struct Directory {
     Directory(const std::string& path) {
@@ -111,13 +132,53 @@ private:
     Optional<uint64_t> uint_value_;
   };
 
+  static bool valueEnabled(uint64_t value, uint64_t random_value, uint16_t num_buckets) {
+    return random_value % static_cast<uint64_t>(num_buckets) <
+           std::min(value, static_cast<uint64_t>(num_buckets));
+  }
+
+  bool valueEnabled(uint64_t value) const {
+    // Avoid PNRG if we know we don't need it.
+    uint64_t cutoff = std::min(value, static_cast<uint64_t>(100));
+    if (cutoff == 0) {
+      return false;
+    } else if (cutoff == 100) {
+      return true;
+    } else {
+      return generator_.random() % 100 < cutoff;
+    }
+  }
+
+  void resolveRegisteredKeys(const std::vector<std::string>& registered_keys);
   void walkDirectory(const std::string& path, const std::string& prefix);
 
   std::unordered_map<std::string, Entry> values_;
+  // Entries of the registered keys by key index, nullptr if the key has no value. Entries are
+  // never added to values_ once it has been loaded, so the pointers stay valid.
+  std::vector<const Entry*> registered_values_;
   RandomGenerator& generator_;
   Api::OsSysCalls& os_sys_calls_;
 };
 
+/**
+ * Registry of the keys registered with a loader. Keys are never removed, so the registry only grows
+ * with the number of distinct key names. All routines are thread safe.
+ */
+class KeyRegistry {
+public:
+  Key registerKey(const std::string& name);
+
+  /**
+   * @return std::vector<std::string> the names of all registered keys, indexed by key index.
+   */
+  std::vector<std::string> keys() const;
+
+private:
+  mutable std::mutex lock_;
+  std::unordered_map<std::string, uint32_t> indexes_;
+  std::vector<std::string> names_;
+};
+
 /**
  * Implementation of Loader that watches a symlink for swapping and loads a specified subdirectory
  * from disk. A single snapshot is shared among all threads and referenced by shared_ptr such that
@@ -133,11 +194,15 @@ public:
 
   // Runtime::Loader
   Snapshot& snapshot() override;
+  Key registerKey(const std::string& name) override;
 
 private:
   RuntimeStats generateStats(Stats::Store& store);
+  void onKeysRegistered();
   void onSymlinkSwap();
+  void setSnapshot(SnapshotImpl* snapshot, uint32_t num_keys);
 
+  Event::Dispatcher& dispatcher_;
   Filesystem::WatcherPtr watcher_;
   ThreadLocal::SlotPtr tls_;
   RandomGenerator& generator_;
@@ -146,6 +211,13 @@ private:
   std::shared_ptr<SnapshotImpl> current_snapshot_;
   RuntimeStats stats_;
   Api::OsSysCallsPtr os_sys_calls_;
+  KeyRegistry keys_;
+  // Number of registered keys resolved by current_snapshot_. Registering a key beyond it posts a
+  // refresh of the snapshot to the main thread, unless one is already pending.
+  std::atomic<uint32_t> resolved_keys_{};
+  std::atomic<bool> refresh_pending_{};
+  // Expires when the loader is destroyed, so that a posted refresh does not outlive it.
+  const std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
 };
 
 /**
@@ -157,6 +229,7 @@ public:
 
   // Runtime::Loader
   Snapshot& snapshot() override { return snapshot_; }
+  Key registerKey(const std::string& name) override { return keys_.registerKey(name); }
 
 private:
   struct NullSnapshotImpl : public Snapshot {
@@ -190,9 +263,28 @@ private:
       return default_value;
     }
 
+    bool featureEnabled(const Key& key, uint64_t default_value) const override {
+      return featureEnabled(key.name(), default_value);
+    }
+
+    bool featureEnabled(const Key& key, uint64_t default_value,
+                        uint64_t random_value) const override {
+      return featureEnabled(key.name(), default_value, random_value);
+    }
+
+    bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                        uint16_t num_buckets) const override {
+      return featureEnabled(key.name(), default_value, random_value, num_buckets);
+    }
+
+    uint64_t getInteger(const Key&, uint64_t default_value) const override {
+      return default_value;
+    }
+
     RandomGenerator& generator_;
   };
 
+  KeyRegistry keys_;
   NullSnapshotImpl snapshot_;
 };
 
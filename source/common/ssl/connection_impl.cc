@@ -1,9 +1,14 @@
 #include "common/ssl/connection_impl.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
+#include "envoy/event/dispatcher.h"
+
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
@@ -17,6 +22,11 @@ using Envoy::Network::PostIoAction;
 namespace Envoy {
 namespace Ssl {
 
+const uint64_t SslSocket::MIN_RECORD_SIZE;
+const uint64_t SslSocket::MAX_RECORD_SIZE;
+const uint64_t SslSocket::RECORD_SIZE_BOOST_THRESHOLD;
+const uint64_t SslSocket::RECORD_SIZE_IDLE_TIMEOUT_MS;
+
 SslSocket::SslSocket(Context& ctx, InitialState state)
     : ctx_(dynamic_cast<Ssl::ContextImpl&>(ctx)), ssl_(ctx_.newSsl()) {
   SSL_set_mode(ssl_.get(), SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
@@ -158,6 +168,10 @@ void SslSocket::drainErrorQueue() {
   }
 }
 
+uint64_t SslSocket::recordSize() const {
+  return bytes_since_idle_ < RECORD_SIZE_BOOST_THRESHOLD ? MIN_RECORD_SIZE : MAX_RECORD_SIZE;
+}
+
 Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer) {
   if (!handshake_complete_) {
     PostIoAction action = doHandshake();
@@ -166,36 +180,96 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer) {
     }
   }
 
+  // The record size never shrinks while a record is blocked, see below.
+  const MonotonicTime now = callbacks_->connection().dispatcher().timeSource().currentTime();
+  if (!write_blocked_ &&
+      now - last_write_time_ >= std::chrono::milliseconds(RECORD_SIZE_IDLE_TIMEOUT_MS)) {
+    bytes_since_idle_ = 0;
+  }
+  last_write_time_ = now;
+
+  // Small slices are copied together so that each SSL_write() fills a record, rather than each
+  // slice being sealed into a record and sent with a write of its own. Only one record is staged
+  // at a time.
+  static thread_local uint8_t staging[MAX_RECORD_SIZE];
+
   uint64_t original_buffer_length = write_buffer.length();
   uint64_t total_bytes_written = 0;
   bool keep_writing = true;
   while ((original_buffer_length != total_bytes_written) && keep_writing) {
     // Protect against stack overflow if the buffer has a very large buffer chain.
-    // TODO(mattklein123): See the comment on getRawSlices() for why we have to also check
-    // original_buffer_length != total_bytes_written during loop iteration.
     // TODO(mattklein123): As it relates to our fairness efforts, we might want to limit the number
     // of iterations of this loop, either by pure iterations, bytes written, etc.
     const uint64_t MAX_SLICES = 32;
     Buffer::RawSlice slices[MAX_SLICES];
-    uint64_t num_slices = write_buffer.getRawSlices(slices, MAX_SLICES);
+    // TODO(mattklein123): See the comment on getRawSlices() for why there may be empty slices
+    // beyond the end of the buffer. They are skipped below.
+    const uint64_t num_slices =
+        std::min(write_buffer.getRawSlices(slices, MAX_SLICES), MAX_SLICES);
 
     uint64_t inner_bytes_written = 0;
-    for (uint64_t i = 0; (i < num_slices) && (original_buffer_length != total_bytes_written); i++) {
+    uint64_t slice = 0;
+    uint64_t slice_offset = 0;
+    while (keep_writing) {
+      while (slice < num_slices && slice_offset == slices[slice].len_) {
+        slice++;
+        slice_offset = 0;
+      }
+      if (slice == num_slices) {
+        break;
+      }
+
+      // A record is cut at the record size, or at the last of the slices fetched above.
+      const uint64_t record_size = recordSize();
+      const uint8_t* record = static_cast<const uint8_t*>(slices[slice].mem_) + slice_offset;
+      uint64_t record_length = slices[slice].len_ - slice_offset;
+      if (record_length >= record_size) {
+        record_length = record_size;
+        slice_offset += record_size;
+      } else {
+        record = staging;
+        record_length = 0;
+        while (slice < num_slices && record_length < record_size) {
+          const uint64_t length =
+              std::min(slices[slice].len_ - slice_offset, record_size - record_length);
+          memcpy(staging + record_length,
+                 static_cast<const uint8_t*>(slices[slice].mem_) + slice_offset, length);
+          record_length += length;
+          slice_offset += length;
+          if (slice_offset == slices[slice].len_) {
+            slice++;
+            slice_offset = 0;
+          }
+        }
+
+        // Rather than cut a record short at the last slice fetched, leave the rest of the buffer
+        // to the next round of slices. A record is only cut short if it is the first of a round,
+        // which is when MAX_SLICES slices in a row do not fill a record.
+        if (record_length < record_size && slice == num_slices && inner_bytes_written > 0 &&
+            total_bytes_written + record_length < original_buffer_length) {
+          break;
+        }
+      }
+
       // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
-      // it again with the same parameters. Most implementations keep track of the last write size.
-      // In our case we don't need to do that because: a) SSL_write() will not write partial
-      // buffers. b) We only move() into the write buffer, which means that it's impossible for a
-      // particular chain to increase in size. So as long as we start writing where we left off we
-      // are guaranteed to call SSL_write() with the same parameters.
-      int rc = SSL_write(ssl_.get(), slices[i].mem_, slices[i].len_);
+      // it again with at least as many bytes, and the same bytes as far as the previous call went.
+      // SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER lets the pointer change. Nothing is drained until it is
+      // written and we only move() into the write buffer, so the next call starts with the same
+      // bytes. Slices only ever grow, and the record size does not shrink while write_blocked_ is
+      // set, so the record built by the next call is not shorter.
+      int rc = SSL_write(ssl_.get(), record, record_length);
       ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
       if (rc > 0) {
+        ASSERT(static_cast<uint64_t>(rc) == record_length);
         inner_bytes_written += rc;
         total_bytes_written += rc;
+        bytes_since_idle_ += rc;
+        write_blocked_ = false;
       } else {
         int err = SSL_get_error(ssl_.get(), rc);
         switch (err) {
         case SSL_ERROR_WANT_WRITE:
+          write_blocked_ = true;
           keep_writing = false;
           break;
         case SSL_ERROR_WANT_READ:
@@ -204,8 +278,6 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer) {
           drainErrorQueue();
           return {PostIoAction::Close, total_bytes_written};
         }
-
-        break;
       }
     }
 
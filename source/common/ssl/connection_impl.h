@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <string>
 
+#include "envoy/common/time.h"
 #include "envoy/network/transport_socket.h"
 
 #include "common/network/connection_impl.h"
@@ -39,15 +40,31 @@ public:
 
   SSL* rawSslForTest() { return ssl_.get(); }
 
+  // Sizes of the TLS records written by doWrite(). A connection starts with records which fit in
+  // one TCP segment, so the peer can decrypt the first bytes of a response as soon as they arrive.
+  // Once it has written RECORD_SIZE_BOOST_THRESHOLD bytes without going idle for
+  // RECORD_SIZE_IDLE_TIMEOUT_MS, it is streaming and switches to the largest records TLS allows,
+  // which have the least framing and encryption overhead.
+  static const uint64_t MIN_RECORD_SIZE = 1400;
+  static const uint64_t MAX_RECORD_SIZE = 16384;
+  static const uint64_t RECORD_SIZE_BOOST_THRESHOLD = 1024 * 1024;
+  static const uint64_t RECORD_SIZE_IDLE_TIMEOUT_MS = 1000;
+
 private:
   Network::PostIoAction doHandshake();
   void drainErrorQueue();
   std::string getUriSanFromCertificate(X509* cert);
+  uint64_t recordSize() const;
 
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImpl& ctx_;
   bssl::UniquePtr<SSL> ssl_;
   bool handshake_complete_{};
+  uint64_t bytes_since_idle_{};
+  MonotonicTime last_write_time_;
+  // Set while the last SSL_write() returned SSL_ERROR_WANT_WRITE. The record it sealed is still
+  // buffered by BoringSSL, and the next SSL_write() must not be shorter.
+  bool write_blocked_{};
 };
 
 // TODO(lizan): Remove Ssl::ConnectionImpl entirely when factory of TransportSocket is ready.
@@ -137,6 +137,19 @@ ServerContextConfigImpl::ServerContextConfigImpl(const envoy::api::v2::Downstrea
                                            config.session_ticket_keys_type_case()));
         }
 
+        return ret;
+      }()),
+      session_ticket_key_paths_([&config] {
+        std::vector<std::string> ret;
+        if (config.session_ticket_keys_type_case() ==
+            envoy::api::v2::DownstreamTlsContext::kSessionTicketKeys) {
+          for (const auto& datasource : config.session_ticket_keys().keys()) {
+            if (datasource.specifier_case() != envoy::api::v2::DataSource::kFilename) {
+              return std::vector<std::string>();
+            }
+            ret.push_back(datasource.filename());
+          }
+        }
         return ret;
       }()) {
   // TODO(PiotrSikora): Support multiple TLS certificates.
@@ -150,8 +163,6 @@ ServerContextConfigImpl::ServerContextConfigImpl(const Json::Object& config)
         return downstream_tls_context;
       }()) {}
 
-// Append a SessionTicketKey to keys, initializing it with key_data.
-// Throws if key_data is invalid.
 void ServerContextConfigImpl::validateAndAppendKey(
     std::vector<ServerContextConfig::SessionTicketKey>& keys, const std::string& key_data) {
   // If this changes, need to figure out how to deal with key files
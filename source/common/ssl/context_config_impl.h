@@ -74,13 +74,21 @@ public:
   const std::vector<SessionTicketKey>& sessionTicketKeys() const override {
     return session_ticket_keys_;
   }
+  const std::vector<std::string>& sessionTicketKeyPaths() const override {
+    return session_ticket_key_paths_;
+  }
+
+  /**
+   * Append a SessionTicketKey to keys, initializing it with key_data.
+   * Throws if key_data is invalid.
+   */
+  static void validateAndAppendKey(std::vector<ServerContextConfig::SessionTicketKey>& keys,
+                                   const std::string& key_data);
 
 private:
   const bool require_client_certificate_;
   const std::vector<SessionTicketKey> session_ticket_keys_;
-
-  static void validateAndAppendKey(std::vector<ServerContextConfig::SessionTicketKey>& keys,
-                                   const std::string& key_data);
+  const std::vector<std::string> session_ticket_key_paths_;
 };
 
 } // namespace Ssl
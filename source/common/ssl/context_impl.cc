@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,8 @@
 
 #include "common/common/assert.h"
 #include "common/common/hex.h"
+#include "common/filesystem/filesystem_impl.h"
+#include "common/ssl/context_config_impl.h"
 
 #include "fmt/format.h"
 #include "openssl/hmac.h"
@@ -366,7 +369,8 @@ ServerContextImpl::ServerContextImpl(ContextManagerImpl& parent, const std::stri
                                      bool skip_context_update, Runtime::Loader& runtime)
     : ContextImpl(parent, scope, config), listener_name_(listener_name),
       server_names_(server_names), skip_context_update_(skip_context_update), runtime_(runtime),
-      session_ticket_keys_(config.sessionTicketKeys()) {
+      session_cache_(parent.sessionCache()), session_ticket_keys_(config.sessionTicketKeys()),
+      session_ticket_key_paths_(config.sessionTicketKeyPaths()) {
   SSL_CTX_set_select_certificate_cb(
       ctx_.get(), [](const SSL_CLIENT_HELLO* client_hello) -> ssl_select_cert_result_t {
         ContextImpl* context_impl = static_cast<ContextImpl*>(
@@ -411,6 +415,42 @@ ServerContextImpl::ServerContextImpl(ContextManagerImpl& parent, const std::stri
           return server_context_impl->sessionTicketProcess(ssl, key_name, iv, ctx, hmac_ctx,
                                                            encrypt);
         });
+
+    if (parent.dispatcher() != nullptr && !session_ticket_key_paths_.empty()) {
+      // As with runtime, a new key file is expected to be moved into place atomically.
+      session_ticket_keys_watcher_ = parent.dispatcher()->createFilesystemWatcher();
+      for (const std::string& path : session_ticket_key_paths_) {
+        session_ticket_keys_watcher_->addWatch(
+            path, Filesystem::Watcher::Events::MovedTo,
+            [this](uint32_t) -> void { onSessionTicketKeyFileMoved(); });
+      }
+    }
+  }
+
+  if (session_cache_ != nullptr) {
+    // Sessions are only kept in the shared cache. BoringSSL checks the session ID context and the
+    // expiry of a session found in the cache, so contexts can safely share one cache.
+    SSL_CTX_set_session_cache_mode(ctx_.get(),
+                                   SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+    SSL_CTX_sess_set_new_cb(ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+      ContextImpl* context_impl =
+          static_cast<ContextImpl*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), sslContextIndex()));
+      return dynamic_cast<ServerContextImpl*>(context_impl)->newSession(session);
+    });
+    SSL_CTX_sess_set_get_cb(
+        ctx_.get(),
+        [](SSL* ssl, const uint8_t* id, int id_length, int* out_copy) -> SSL_SESSION* {
+          ContextImpl* context_impl = static_cast<ContextImpl*>(
+              SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), sslContextIndex()));
+          // The returned session is owned by the caller.
+          *out_copy = 0;
+          return dynamic_cast<ServerContextImpl*>(context_impl)->getSession(id, id_length);
+        });
+    SSL_CTX_sess_set_remove_cb(ctx_.get(), [](SSL_CTX* ctx, SSL_SESSION* session) -> void {
+      ContextImpl* context_impl =
+          static_cast<ContextImpl*>(SSL_CTX_get_ex_data(ctx, sslContextIndex()));
+      dynamic_cast<ServerContextImpl*>(context_impl)->removeSession(session);
+    });
   }
 
   uint8_t session_context_buf[EVP_MAX_MD_SIZE] = {};
@@ -569,6 +609,7 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
                                             EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx, int encrypt) {
   const EVP_MD* hmac = EVP_sha256();
   const EVP_CIPHER* cipher = EVP_aes_256_cbc();
+  std::shared_lock<std::shared_timed_mutex> lock(session_ticket_keys_lock_);
 
   if (encrypt == 1) {
     // Encrypt
@@ -626,5 +667,63 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
   }
 }
 
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  uint8_t* bytes;
+  size_t length;
+  if (SSL_SESSION_to_bytes(session, &bytes, &length)) {
+    unsigned id_length;
+    const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+    session_cache_->insert(id, id_length, bytes, length,
+                           SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session));
+    OPENSSL_free(bytes);
+  }
+
+  // The session is not referenced by the cache.
+  return 0;
+}
+
+SSL_SESSION* ServerContextImpl::getSession(const uint8_t* id, int id_length) {
+  std::vector<uint8_t> bytes;
+  SSL_SESSION* session = nullptr;
+  if (session_cache_->lookup(id, id_length, bytes)) {
+    session = SSL_SESSION_from_bytes(bytes.data(), bytes.size(), ctx_.get());
+  }
+
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+  } else {
+    stats_.session_cache_hit_.inc();
+  }
+  return session;
+}
+
+void ServerContextImpl::removeSession(SSL_SESSION* session) {
+  unsigned id_length;
+  const uint8_t* id = SSL_SESSION_get_id(session, &id_length);
+  session_cache_->remove(id, id_length);
+}
+
+void ServerContextImpl::onSessionTicketKeyFileMoved() {
+  // All files are read again, so that keys which are rotated by moving several files into place
+  // end up in the configured order.
+  std::vector<ServerContextConfig::SessionTicketKey> keys;
+  try {
+    for (const std::string& path : session_ticket_key_paths_) {
+      ServerContextConfigImpl::validateAndAppendKey(keys, Filesystem::fileReadToEnd(path));
+    }
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "failed to reload TLS session ticket keys, keeping the current keys: {}",
+              e.what());
+    stats_.session_ticket_keys_reload_failed_.inc();
+    return;
+  }
+
+  {
+    std::unique_lock<std::shared_timed_mutex> lock(session_ticket_keys_lock_);
+    session_ticket_keys_.swap(keys);
+  }
+  stats_.session_ticket_keys_reload_success_.inc();
+}
+
 } // namespace Ssl
 } // namespace Envoy
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
+#include "envoy/filesystem/filesystem.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/stats/stats.h"
 #include "envoy/stats/stats_macros.h"
 
+#include "common/common/logger.h"
 #include "common/ssl/context_impl.h"
 #include "common/ssl/context_manager_impl.h"
 
@@ -26,6 +30,10 @@ namespace Ssl {
   COUNTER(connection_error)                                                                        \
   COUNTER(handshake)                                                                               \
   COUNTER(session_reused)                                                                          \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(session_ticket_keys_reload_success)                                                      \
+  COUNTER(session_ticket_keys_reload_failed)                                                       \
   COUNTER(no_certificate)                                                                          \
   COUNTER(fail_no_sni_match)                                                                       \
   COUNTER(fail_verify_no_cert)                                                                     \
@@ -134,7 +142,17 @@ private:
   std::string server_name_indication_;
 };
 
-class ServerContextImpl : public ContextImpl, public ServerContext {
+/**
+ * When the context manager has a session cache, sessions are stored in it instead of in the
+ * SSL_CTX, so that a session can be resumed on any worker, by any context with the same session ID
+ * context, and by the next process after a hot restart when the cache is in shared memory.
+ *
+ * Session ticket keys which were read from files are reloaded when a new key file is moved into
+ * place, so that keys can be rotated without a restart.
+ */
+class ServerContextImpl : public ContextImpl,
+                          public ServerContext,
+                          Logger::Loggable<Logger::Id::config> {
 public:
   ServerContextImpl(ContextManagerImpl& parent, const std::string& listener_name,
                     const std::vector<std::string>& server_names, Stats::Scope& scope,
@@ -150,13 +168,23 @@ private:
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* getSession(const uint8_t* id, int id_length);
+  void removeSession(SSL_SESSION* session);
+  void onSessionTicketKeyFileMoved();
 
   const std::string listener_name_;
   const std::vector<std::string> server_names_;
   const bool skip_context_update_;
   Runtime::Loader& runtime_;
   std::vector<uint8_t> parsed_alt_alpn_protocols_;
-  const std::vector<ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  SessionCache* session_cache_;
+  std::vector<ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  // Workers hold a reader lock while they use the keys, the main thread holds a writer lock while
+  // it replaces them.
+  mutable std::shared_timed_mutex session_ticket_keys_lock_;
+  const std::vector<std::string> session_ticket_key_paths_;
+  Filesystem::WatcherPtr session_ticket_keys_watcher_;
 };
 
 } // namespace Ssl
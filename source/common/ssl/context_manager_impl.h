@@ -5,8 +5,10 @@
 #include <shared_mutex>
 #include <unordered_map>
 
+#include "envoy/event/dispatcher.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/ssl/context_manager.h"
+#include "envoy/ssl/session_cache.h"
 
 namespace Envoy {
 namespace Ssl {
@@ -21,8 +23,30 @@ namespace Ssl {
 class ContextManagerImpl final : public ContextManager {
 public:
   ContextManagerImpl(Runtime::Loader& runtime) : runtime_(runtime) {}
+
+  /**
+   * @param runtime supplies the runtime loader.
+   * @param dispatcher supplies the main thread dispatcher, which watches session ticket key files
+   *        for changes.
+   * @param session_cache supplies the session cache shared by all server contexts, or nullptr for
+   *        each context to keep its own cache.
+   */
+  ContextManagerImpl(Runtime::Loader& runtime, Event::Dispatcher& dispatcher,
+                     SessionCache* session_cache)
+      : runtime_(runtime), dispatcher_(&dispatcher), session_cache_(session_cache) {}
   ~ContextManagerImpl();
 
+  /**
+   * @return the dispatcher which watches files for server contexts, or nullptr if files are not
+   *         watched.
+   */
+  Event::Dispatcher* dispatcher() const { return dispatcher_; }
+
+  /**
+   * @return the session cache shared by all server contexts, or nullptr if there is none.
+   */
+  SessionCache* sessionCache() const { return session_cache_; }
+
   /**
    * Allocated contexts are owned by the caller. However, we need to be able to iterate them for
    * admin purposes. When a caller frees a context it will tell us to release it also from the list
@@ -48,6 +72,8 @@ private:
   static bool isWildcardServerName(const std::string& name);
 
   Runtime::Loader& runtime_;
+  Event::Dispatcher* dispatcher_{};
+  SessionCache* session_cache_{};
   std::list<Context*> contexts_;
   mutable std::shared_timed_mutex contexts_lock_;
   std::unordered_map<std::string, std::unordered_map<std::string, ServerContext*>> map_exact_;
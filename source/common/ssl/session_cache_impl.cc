@@ -0,0 +1,183 @@
+#include "common/ssl/session_cache_impl.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/common/assert.h"
+
+#include "xxhash.h"
+
+namespace Envoy {
+namespace Ssl {
+
+const uint64_t SessionCacheImpl::WAYS;
+const size_t SessionCacheImpl::SLOT_SIZE;
+const size_t SessionCacheImpl::MAX_SESSION_SIZE;
+
+SessionCacheImpl::SessionCacheImpl(uint64_t num_sessions)
+    : num_sets_(numSets(num_sessions)), owned_slots_(new Slot[num_sets_ * WAYS]()),
+      slots_(owned_slots_.get()) {
+  ASSERT(num_sets_ > 0);
+}
+
+SessionCacheImpl::SessionCacheImpl(uint8_t* memory, uint64_t num_sessions)
+    : num_sets_(numSets(num_sessions)), slots_(reinterpret_cast<Slot*>(memory)) {
+  ASSERT(num_sets_ > 0);
+  ASSERT(reinterpret_cast<uintptr_t>(memory) % alignof(Slot) == 0);
+}
+
+uint64_t SessionCacheImpl::size(uint64_t num_sessions) {
+  return numSets(num_sessions) * WAYS * sizeof(Slot);
+}
+
+SessionCacheImpl::Slot* SessionCacheImpl::set(const uint8_t* id, size_t id_length) const {
+  return slots_ + (XXH64(id, id_length, 0) % num_sets_) * WAYS;
+}
+
+SessionCacheImpl::Id SessionCacheImpl::toId(const uint8_t* id, size_t id_length) {
+  Id words{};
+  memcpy(words.data(), id, id_length);
+  return words;
+}
+
+bool SessionCacheImpl::matches(const Slot& slot, const Id& id, size_t id_length) {
+  if ((slot.lengths_.load(std::memory_order_relaxed) >> 32) != id_length) {
+    return false;
+  }
+  for (size_t i = 0; i < ID_WORDS; i++) {
+    if (slot.id_[i].load(std::memory_order_relaxed) != id[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void SessionCacheImpl::store(std::atomic<uint64_t>* words, const uint8_t* data, size_t length) {
+  for (size_t i = 0; i * sizeof(uint64_t) < length; i++) {
+    const size_t offset = i * sizeof(uint64_t);
+    uint64_t word = 0;
+    memcpy(&word, data + offset, std::min(sizeof(uint64_t), length - offset));
+    words[i].store(word, std::memory_order_relaxed);
+  }
+}
+
+void SessionCacheImpl::load(const std::atomic<uint64_t>* words, uint8_t* data, size_t length) {
+  for (size_t i = 0; i * sizeof(uint64_t) < length; i++) {
+    const size_t offset = i * sizeof(uint64_t);
+    const uint64_t word = words[i].load(std::memory_order_relaxed);
+    memcpy(data + offset, &word, std::min(sizeof(uint64_t), length - offset));
+  }
+}
+
+bool SessionCacheImpl::insert(const uint8_t* id, size_t id_length, const uint8_t* session,
+                              size_t session_length, uint64_t expire_time) {
+  if (id_length == 0 || id_length > SSL_MAX_SSL_SESSION_ID_LENGTH ||
+      session_length > MAX_SESSION_SIZE) {
+    return false;
+  }
+
+  // The slot is picked without holding any lock. Racing with another writer at worst evicts a
+  // session early.
+  const Id key = toId(id, id_length);
+  Slot* slots = set(id, id_length);
+  Slot* victim = nullptr;
+  bool victim_empty = false;
+  for (uint64_t i = 0; i < WAYS; i++) {
+    Slot& slot = slots[i];
+    if (matches(slot, key, id_length)) {
+      victim = &slot;
+      break;
+    }
+    const bool empty = (slot.lengths_.load(std::memory_order_relaxed) >> 32) == 0;
+    if (victim == nullptr ||
+        (!victim_empty &&
+         (empty || slot.expire_time_.load(std::memory_order_relaxed) <
+                       victim->expire_time_.load(std::memory_order_relaxed)))) {
+      victim = &slot;
+      victim_empty = empty;
+    }
+  }
+
+  uint64_t sequence = victim->sequence_.load(std::memory_order_relaxed);
+  if (sequence % 2 != 0 ||
+      !victim->sequence_.compare_exchange_strong(sequence, sequence + 1,
+                                                 std::memory_order_relaxed)) {
+    return false;
+  }
+  // Readers which see any of the stores below also see the odd sequence.
+  std::atomic_thread_fence(std::memory_order_release);
+
+  victim->expire_time_.store(expire_time, std::memory_order_relaxed);
+  victim->lengths_.store(static_cast<uint64_t>(id_length) << 32 | session_length,
+                         std::memory_order_relaxed);
+  for (size_t i = 0; i < ID_WORDS; i++) {
+    victim->id_[i].store(key[i], std::memory_order_relaxed);
+  }
+  store(victim->session_, session, session_length);
+
+  victim->sequence_.store(sequence + 2, std::memory_order_release);
+  return true;
+}
+
+bool SessionCacheImpl::lookup(const uint8_t* id, size_t id_length,
+                              std::vector<uint8_t>& session) const {
+  if (id_length == 0 || id_length > SSL_MAX_SSL_SESSION_ID_LENGTH) {
+    return false;
+  }
+
+  const Id key = toId(id, id_length);
+  const Slot* slots = set(id, id_length);
+  for (uint64_t i = 0; i < WAYS; i++) {
+    const Slot& slot = slots[i];
+    const uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+    if (sequence % 2 != 0 || !matches(slot, key, id_length)) {
+      continue;
+    }
+
+    // The length may belong to a concurrent write, in which case the copy is discarded below.
+    const size_t length = std::min<size_t>(
+        slot.lengths_.load(std::memory_order_relaxed) & 0xffffffff, MAX_SESSION_SIZE);
+    session.resize(length);
+    load(slot.session_, session.data(), length);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence_.load(std::memory_order_relaxed) == sequence) {
+      return true;
+    }
+    // The slot was rewritten while it was copied. An ID is in at most one slot of its set, so
+    // the session is gone.
+    break;
+  }
+
+  return false;
+}
+
+void SessionCacheImpl::remove(const uint8_t* id, size_t id_length) {
+  if (id_length == 0 || id_length > SSL_MAX_SSL_SESSION_ID_LENGTH) {
+    return;
+  }
+
+  const Id key = toId(id, id_length);
+  Slot* slots = set(id, id_length);
+  for (uint64_t i = 0; i < WAYS; i++) {
+    Slot& slot = slots[i];
+    uint64_t sequence = slot.sequence_.load(std::memory_order_relaxed);
+    if (sequence % 2 != 0 || !matches(slot, key, id_length) ||
+        !slot.sequence_.compare_exchange_strong(sequence, sequence + 1,
+                                                std::memory_order_relaxed)) {
+      continue;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // The slot may have been replaced between the match and the claim.
+    if (matches(slot, key, id_length)) {
+      slot.lengths_.store(0, std::memory_order_relaxed);
+      slot.expire_time_.store(0, std::memory_order_relaxed);
+    }
+
+    slot.sequence_.store(sequence + 2, std::memory_order_release);
+    return;
+  }
+}
+
+} // namespace Ssl
+} // namespace Envoy
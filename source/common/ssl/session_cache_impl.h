@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/ssl/session_cache.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * SessionCache which keeps sessions in a fixed number of fixed size slots in one block of memory.
+ * The block holds no pointers, so it may be shared memory that is mapped at different addresses in
+ * different processes, which lets sessions outlive a hot restart.
+ *
+ * The table is set associative: a session ID hashes to a set of WAYS adjacent slots, and a new
+ * session takes the slot of the set which holds the same ID, else an empty slot, else the slot
+ * which expires first. Each slot is guarded by a sequence lock. Lookups never block and never write
+ * to the block. A writer claims a slot by making its sequence odd, and a writer which finds the
+ * slot already claimed drops its session rather than wait.
+ */
+class SessionCacheImpl : public SessionCache {
+public:
+  /**
+   * Create a cache in memory owned by the cache.
+   * @param num_sessions supplies the number of sessions, which is rounded up to a multiple of WAYS.
+   */
+  explicit SessionCacheImpl(uint64_t num_sessions);
+
+  /**
+   * Create a cache in memory owned by the caller.
+   * @param memory supplies a block of size(num_sessions) bytes aligned to 8 bytes. The block is
+   *        either zero filled, which is an empty cache, or was used by a cache of the same size.
+   * @param num_sessions supplies the number of sessions, which is rounded up to a multiple of WAYS.
+   */
+  SessionCacheImpl(uint8_t* memory, uint64_t num_sessions);
+
+  /**
+   * @return uint64_t the size in bytes of the memory block of a cache of num_sessions sessions.
+   */
+  static uint64_t size(uint64_t num_sessions);
+
+  // Ssl::SessionCache
+  bool insert(const uint8_t* id, size_t id_length, const uint8_t* session, size_t session_length,
+              uint64_t expire_time) override;
+  bool lookup(const uint8_t* id, size_t id_length, std::vector<uint8_t>& session) const override;
+  void remove(const uint8_t* id, size_t id_length) override;
+
+  static const uint64_t WAYS = 4;
+  static const size_t SLOT_SIZE = 2048;
+  static const size_t MAX_SESSION_SIZE =
+      SLOT_SIZE - 3 * sizeof(uint64_t) - SSL_MAX_SSL_SESSION_ID_LENGTH;
+
+private:
+  static const size_t ID_WORDS = SSL_MAX_SSL_SESSION_ID_LENGTH / sizeof(uint64_t);
+  static const size_t SESSION_WORDS = MAX_SESSION_SIZE / sizeof(uint64_t);
+
+  // Everything in a slot is accessed atomically, as the data of a sequence lock may be read while
+  // it is written. Relaxed loads and stores compile to plain moves.
+  struct Slot {
+    // Odd while a writer is changing the slot.
+    std::atomic<uint64_t> sequence_;
+    std::atomic<uint64_t> expire_time_;
+    // The ID length in the upper half and the session length in the lower half. The ID length is
+    // zero if the slot is empty.
+    std::atomic<uint64_t> lengths_;
+    std::atomic<uint64_t> id_[ID_WORDS];
+    std::atomic<uint64_t> session_[SESSION_WORDS];
+  };
+
+  static_assert(sizeof(Slot) == SLOT_SIZE, "Slot has padding");
+  static_assert(SSL_MAX_SSL_SESSION_ID_LENGTH % sizeof(uint64_t) == 0, "ID is not whole words");
+
+  // A session ID padded with zeros to whole words.
+  typedef std::array<uint64_t, ID_WORDS> Id;
+
+  static uint64_t numSets(uint64_t num_sessions) { return (num_sessions + WAYS - 1) / WAYS; }
+  static Id toId(const uint8_t* id, size_t id_length);
+  static bool matches(const Slot& slot, const Id& id, size_t id_length);
+  static void store(std::atomic<uint64_t>* words, const uint8_t* data, size_t length);
+  static void load(const std::atomic<uint64_t>* words, uint8_t* data, size_t length);
+  Slot* set(const uint8_t* id, size_t id_length) const;
+
+  const uint64_t num_sets_;
+  std::unique_ptr<Slot[]> owned_slots_;
+  Slot* slots_;
+};
+
+} // namespace Ssl
+} // namespace Envoy
@@ -0,0 +1,117 @@
+#include "common/stats/histogram_impl.h"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "common/common/macros.h"
+#include "common/common/utility.h"
+
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace Stats {
+
+HistogramBuckets::~HistogramBuckets() {
+  for (auto& group : groups_) {
+    delete[] group.load();
+  }
+}
+
+std::atomic<uint64_t>* HistogramBuckets::allocateGroup(uint32_t group_index) {
+  // Only the writing thread allocates, so there is no race to install the group. The release store
+  // makes the zeroed counts visible to readers before the group itself.
+  std::atomic<uint64_t>* group = new std::atomic<uint64_t>[SUB_BUCKETS];
+  for (uint32_t i = 0; i < SUB_BUCKETS; i++) {
+    group[i].store(0, std::memory_order_relaxed);
+  }
+  groups_[group_index].store(group, std::memory_order_release);
+  return group;
+}
+
+void HistogramBuckets::addTo(std::map<uint32_t, uint64_t>& counts) const {
+  for (uint32_t group_index = 0; group_index < NUM_GROUPS; group_index++) {
+    const std::atomic<uint64_t>* group = groups_[group_index].load(std::memory_order_acquire);
+    if (group == nullptr) {
+      continue;
+    }
+
+    for (uint32_t i = 0; i < SUB_BUCKETS; i++) {
+      const uint64_t count = group[i].load(std::memory_order_relaxed);
+      if (count > 0) {
+        counts[(group_index << SUB_BUCKET_BITS) + i] += count;
+      }
+    }
+  }
+}
+
+uint64_t HistogramBuckets::bucketLowerBound(uint32_t index) {
+  if (index < 2 * SUB_BUCKETS) {
+    return index;
+  }
+
+  const uint32_t shift = (index >> SUB_BUCKET_BITS) - 1;
+  return static_cast<uint64_t>(SUB_BUCKETS + (index & (SUB_BUCKETS - 1))) << shift;
+}
+
+uint64_t HistogramBuckets::bucketWidth(uint32_t index) {
+  if (index < 2 * SUB_BUCKETS) {
+    return 1;
+  }
+
+  return 1ULL << ((index >> SUB_BUCKET_BITS) - 1);
+}
+
+HistogramStatisticsImpl::HistogramStatisticsImpl()
+    : computed_quantiles_(supportedQuantiles().size(), std::nan("")) {}
+
+HistogramStatisticsImpl::HistogramStatisticsImpl(const std::map<uint32_t, uint64_t>& counts)
+    : HistogramStatisticsImpl() {
+  for (const auto& count : counts) {
+    sample_count_ += count.second;
+  }
+  if (sample_count_ == 0) {
+    return;
+  }
+
+  // Walk the buckets in order, interpolating linearly within the first non-empty bucket that
+  // reaches each quantile's rank.
+  const std::vector<double>& quantiles = supportedQuantiles();
+  auto bucket = counts.begin();
+  uint64_t below = 0;
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    const double rank = quantiles[i] * sample_count_;
+    while ((bucket->second == 0 || below + bucket->second < rank) &&
+           std::next(bucket) != counts.end()) {
+      below += bucket->second;
+      bucket++;
+    }
+
+    const double fraction = std::min(1.0, std::max(0.0, (rank - below) / bucket->second));
+    computed_quantiles_[i] = HistogramBuckets::bucketLowerBound(bucket->first) +
+                             fraction * (HistogramBuckets::bucketWidth(bucket->first) - 1);
+  }
+}
+
+const std::vector<double>& HistogramStatisticsImpl::supportedQuantiles() const {
+  CONSTRUCT_ON_FIRST_USE(std::vector<double>, {0, 0.25, 0.5, 0.75, 0.90, 0.95, 0.99, 0.999, 1});
+}
+
+std::string HistogramStatisticsImpl::summary() const {
+  if (sample_count_ == 0) {
+    return "No recorded values";
+  }
+
+  std::vector<std::string> parts;
+  const std::vector<double>& quantiles = supportedQuantiles();
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    parts.push_back(fmt::format("P{:g}: {:.1f}", 100 * quantiles[i], computed_quantiles_[i]));
+  }
+  return StringUtil::join(parts, ", ");
+}
+
+} // namespace Stats
+} // namespace Envoy
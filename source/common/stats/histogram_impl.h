@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "envoy/stats/stats.h"
+
+namespace Envoy {
+namespace Stats {
+
+/**
+ * Log-linear histogram buckets in the style of HdrHistogram. Values below 64 each get their own
+ * bucket. Above that, each power of two range is split into 32 equal buckets, so the width of a
+ * bucket is at most 1/32 of its lower bound and any value is known to within ~3%.
+ *
+ * Buckets are allocated lazily in groups of 32, so a histogram only pays for the ranges it sees.
+ * Recording is lock free but must only be done by a single thread. Any thread may read the
+ * counts concurrently; a value recorded during a read may or may not be included.
+ */
+class HistogramBuckets {
+public:
+  static const uint32_t SUB_BUCKET_BITS = 5;
+  static const uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static const uint32_t NUM_GROUPS = 64 - SUB_BUCKET_BITS + 1;
+  static const uint32_t NUM_BUCKETS = NUM_GROUPS * SUB_BUCKETS;
+
+  HistogramBuckets() {
+    for (auto& group : groups_) {
+      group = nullptr;
+    }
+  }
+  ~HistogramBuckets();
+
+  /**
+   * Record a value. Must only be called from a single thread.
+   */
+  void recordValue(uint64_t value) {
+    const uint32_t index = bucketIndex(value);
+    const uint32_t group_index = index >> SUB_BUCKET_BITS;
+    std::atomic<uint64_t>* group = groups_[group_index].load(std::memory_order_relaxed);
+    if (group == nullptr) {
+      group = allocateGroup(group_index);
+    }
+
+    // There is a single writer so a plain increment is enough. This avoids a locked instruction.
+    std::atomic<uint64_t>& count = group[index & (SUB_BUCKETS - 1)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Add the count of every non-empty bucket to a sparse set of counts keyed by bucket index.
+   */
+  void addTo(std::map<uint32_t, uint64_t>& counts) const;
+
+  /**
+   * @return the index of the bucket containing value.
+   */
+  static uint32_t bucketIndex(uint64_t value) {
+    if (value < 2 * SUB_BUCKETS) {
+      return value;
+    }
+
+    const uint32_t msb = 63 - __builtin_clzll(value);
+    const uint32_t shift = msb - SUB_BUCKET_BITS;
+    return ((shift + 1) << SUB_BUCKET_BITS) + ((value >> shift) & (SUB_BUCKETS - 1));
+  }
+
+  /**
+   * @return the smallest value in a bucket.
+   */
+  static uint64_t bucketLowerBound(uint32_t index);
+
+  /**
+   * @return the number of values in a bucket.
+   */
+  static uint64_t bucketWidth(uint32_t index);
+
+private:
+  std::atomic<uint64_t>* allocateGroup(uint32_t group_index);
+
+  std::atomic<std::atomic<uint64_t>*> groups_[NUM_GROUPS];
+};
+
+/**
+ * Statistics computed from a sparse set of bucket counts.
+ */
+class HistogramStatisticsImpl : public HistogramStatistics {
+public:
+  HistogramStatisticsImpl();
+  HistogramStatisticsImpl(const std::map<uint32_t, uint64_t>& counts);
+
+  // Stats::HistogramStatistics
+  const std::vector<double>& supportedQuantiles() const override;
+  const std::vector<double>& computedQuantiles() const override { return computed_quantiles_; }
+  uint64_t sampleCount() const override { return sample_count_; }
+  std::string summary() const override;
+
+private:
+  std::vector<double> computed_quantiles_;
+  uint64_t sample_count_{};
+};
+
+} // namespace Stats
+} // namespace Envoy
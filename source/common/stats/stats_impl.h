@@ -16,6 +16,7 @@
 
 #include "common/common/assert.h"
 #include "common/protobuf/protobuf.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "api/bootstrap.pb.h"
 
@@ -350,10 +351,19 @@ public:
     Histogram& histogram = histograms_.get(name);
     return histogram;
   }
+  SymbolTable& symbolTable() override { return symbol_table_; }
+  Counter& counterFromStatName(const StatName& name) override { return counter(name.toString()); }
+  Gauge& gaugeFromStatName(const StatName& name) override { return gauge(name.toString()); }
+  Histogram& histogramFromStatName(const StatName& name) override {
+    return histogram(name.toString());
+  }
 
   // Stats::Store
   std::list<CounterSharedPtr> counters() const override { return counters_.toList(); }
   std::list<GaugeSharedPtr> gauges() const override { return gauges_.toList(); }
+  // Histograms in an isolated store only deliver values to the (absent) sinks, so there is no
+  // distribution to report.
+  std::list<ParentHistogramSharedPtr> histograms() const override { return {}; }
 
 private:
   struct ScopeImpl : public Scope {
@@ -370,11 +380,18 @@ private:
     Histogram& histogram(const std::string& name) override {
       return parent_.histogram(prefix_ + name);
     }
+    SymbolTable& symbolTable() override { return parent_.symbol_table_; }
+    Counter& counterFromStatName(const StatName& name) override { return counter(name.toString()); }
+    Gauge& gaugeFromStatName(const StatName& name) override { return gauge(name.toString()); }
+    Histogram& histogramFromStatName(const StatName& name) override {
+      return histogram(name.toString());
+    }
 
     IsolatedStoreImpl& parent_;
     const std::string prefix_;
   };
 
+  SymbolTableImpl symbol_table_;
   HeapRawStatDataAllocator alloc_;
   IsolatedStatsCache<Counter, CounterImpl> counters_;
   IsolatedStatsCache<Gauge, GaugeImpl> gauges_;
@@ -54,6 +54,8 @@ public:
   void flushGauge(const Gauge& gauge, uint64_t value) override;
   void endFlush() override {}
   void onHistogramComplete(const Histogram& histogram, uint64_t value) override;
+  // statsd computes its own percentiles from the individual timer values.
+  void flushHistogram(const ParentHistogram&) override {}
 
   // Called in unit test to validate writer construction and address.
   int getFdForTests() { return tls_->getTyped<Writer>().getFdForTests(); }
@@ -96,6 +98,9 @@ public:
                                                  std::chrono::milliseconds(value));
   }
 
+  // statsd computes its own percentiles from the individual timer values.
+  void flushHistogram(const ParentHistogram&) override {}
+
 private:
   struct TlsSink : public ThreadLocal::ThreadLocalObject, public Network::ConnectionCallbacks {
     TlsSink(TcpStatsdSink& parent, Event::Dispatcher& dispatcher);
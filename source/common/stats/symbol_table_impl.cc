@@ -0,0 +1,117 @@
+#include "common/stats/symbol_table_impl.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+
+#include "xxhash.h"
+
+namespace Envoy {
+namespace Stats {
+
+size_t SymbolVectorHash::operator()(const SymbolVector& symbols) const {
+  return XXH64(symbols.data(), symbols.size() * sizeof(Symbol), 0);
+}
+
+StatNameImpl::~StatNameImpl() { table_.free(symbols_); }
+
+std::string StatNameImpl::toString() const { return table_.decode(symbols_); }
+
+StatNamePtr SymbolTableImpl::encode(const std::string& name) {
+  // The empty name encodes to no symbols. Every other name has at least one (possibly empty)
+  // token, so that decode() gives back exactly the original name.
+  SymbolVector symbols;
+  if (name.empty()) {
+    return StatNamePtr{new StatNameImpl(std::move(symbols), *this)};
+  }
+
+  std::unique_lock<std::mutex> lock(lock_);
+  size_t start = 0;
+  while (true) {
+    const size_t end = name.find('.', start);
+    if (end == std::string::npos) {
+      symbols.push_back(toSymbol(name.substr(start)));
+      break;
+    }
+
+    symbols.push_back(toSymbol(name.substr(start, end - start)));
+    start = end + 1;
+  }
+
+  return StatNamePtr{new StatNameImpl(std::move(symbols), *this)};
+}
+
+StatNamePtr SymbolTableImpl::copy(const SymbolVector& symbols) {
+  std::unique_lock<std::mutex> lock(lock_);
+  for (Symbol symbol : symbols) {
+    ASSERT(decode_map_[symbol].token_ != nullptr);
+    decode_map_[symbol].ref_count_++;
+  }
+
+  return StatNamePtr{new StatNameImpl(SymbolVector(symbols), *this)};
+}
+
+std::string SymbolTableImpl::decode(const SymbolVector& symbols) const {
+  std::string name;
+  std::unique_lock<std::mutex> lock(lock_);
+  for (size_t i = 0; i < symbols.size(); i++) {
+    if (i > 0) {
+      name += '.';
+    }
+    ASSERT(decode_map_[symbols[i]].token_ != nullptr);
+    name += *decode_map_[symbols[i]].token_;
+  }
+
+  return name;
+}
+
+uint64_t SymbolTableImpl::size() const {
+  std::unique_lock<std::mutex> lock(lock_);
+  return encode_map_.size();
+}
+
+void SymbolTableImpl::free(const SymbolVector& symbols) {
+  if (symbols.empty()) {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(lock_);
+  for (Symbol symbol : symbols) {
+    SharedSymbol& shared_symbol = decode_map_[symbol];
+    ASSERT(shared_symbol.token_ != nullptr);
+    if (--shared_symbol.ref_count_ == 0) {
+      auto it = encode_map_.find(*shared_symbol.token_);
+      ASSERT(it != encode_map_.end());
+      shared_symbol.token_ = nullptr;
+      encode_map_.erase(it);
+      free_symbols_.push(symbol);
+    }
+  }
+}
+
+Symbol SymbolTableImpl::toSymbol(const std::string& token) {
+  auto it = encode_map_.find(token);
+  if (it != encode_map_.end()) {
+    decode_map_[it->second].ref_count_++;
+    return it->second;
+  }
+
+  Symbol symbol;
+  if (free_symbols_.empty()) {
+    symbol = decode_map_.size();
+    decode_map_.push_back({nullptr, 0});
+  } else {
+    symbol = free_symbols_.top();
+    free_symbols_.pop();
+  }
+
+  // Elements of an unordered_map are never moved, so the decode map can point at the key.
+  it = encode_map_.emplace(token, symbol).first;
+  decode_map_[symbol] = {&it->first, 1};
+  return symbol;
+}
+
+} // namespace Stats
+} // namespace Envoy
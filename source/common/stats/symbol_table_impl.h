@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "envoy/stats/symbol_table.h"
+
+namespace Envoy {
+namespace Stats {
+
+typedef uint32_t Symbol;
+typedef std::vector<Symbol> SymbolVector;
+
+struct SymbolVectorHash {
+  size_t operator()(const SymbolVector& symbols) const;
+};
+
+class SymbolTableImpl;
+
+/**
+ * A stat name encoded as the symbols of its tokens. The references on the symbols are released
+ * through the table when the name is destroyed.
+ */
+class StatNameImpl : public StatName {
+public:
+  StatNameImpl(SymbolVector&& symbols, SymbolTableImpl& table)
+      : symbols_(std::move(symbols)), table_(table) {}
+  ~StatNameImpl();
+
+  // Stats::StatName
+  std::string toString() const override;
+
+  const SymbolVector& symbols() const { return symbols_; }
+
+private:
+  const SymbolVector symbols_;
+  SymbolTableImpl& table_;
+};
+
+/**
+ * Symbol table with reference counted symbols, so that tokens which are no longer used by any
+ * name (e.g. the name of a removed cluster) are released and their symbols recycled.
+ */
+class SymbolTableImpl : public SymbolTable {
+public:
+  // Stats::SymbolTable
+  StatNamePtr encode(const std::string& name) override;
+
+  /**
+   * @param symbols supplies the symbols of a name encoded in this table, which must still hold its
+   *        references.
+   * @return StatNamePtr a name with the same symbols which holds references of its own.
+   */
+  StatNamePtr copy(const SymbolVector& symbols);
+
+  /**
+   * @param symbols supplies the symbols of a name encoded in this table.
+   * @return std::string the name.
+   */
+  std::string decode(const SymbolVector& symbols) const;
+
+  /**
+   * @return uint64_t the number of distinct tokens currently in the table.
+   */
+  uint64_t size() const;
+
+private:
+  friend class StatNameImpl;
+
+  struct SharedSymbol {
+    // Points at the key of the token's encode_map_ entry, or nullptr if the symbol is free.
+    const std::string* token_;
+    uint32_t ref_count_;
+  };
+
+  void free(const SymbolVector& symbols);
+  Symbol toSymbol(const std::string& token);
+
+  mutable std::mutex lock_;
+  std::unordered_map<std::string, Symbol> encode_map_;
+  // Indexed by symbol.
+  std::vector<SharedSymbol> decode_map_;
+  std::stack<Symbol> free_symbols_;
+};
+
+} // namespace Stats
+} // namespace Envoy
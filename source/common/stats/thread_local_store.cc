@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -27,7 +28,7 @@ std::list<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   std::unordered_set<std::string> names;
   std::unique_lock<std::mutex> lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    for (auto counter : scope->central_cache_.counters_) {
+    for (auto& counter : scope->central_cache_.counters_) {
       if (names.insert(counter.first).second) {
         ret.push_back(counter.second);
       }
@@ -50,7 +51,7 @@ std::list<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   std::unordered_set<std::string> names;
   std::unique_lock<std::mutex> lock(lock_);
   for (ScopeImpl* scope : scopes_) {
-    for (auto gauge : scope->central_cache_.gauges_) {
+    for (auto& gauge : scope->central_cache_.gauges_) {
       if (names.insert(gauge.first).second) {
         ret.push_back(gauge.second);
       }
@@ -60,6 +61,22 @@ std::list<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   return ret;
 }
 
+std::list<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
+  // Handle de-dup due to overlapping scopes.
+  std::list<ParentHistogramSharedPtr> ret;
+  std::unordered_set<std::string> names;
+  std::unique_lock<std::mutex> lock(lock_);
+  for (ScopeImpl* scope : scopes_) {
+    for (auto& histogram : scope->central_cache_.histograms_) {
+      if (names.insert(histogram.first).second) {
+        ret.push_back(histogram.second);
+      }
+    }
+  }
+
+  return ret;
+}
+
 void ThreadLocalStoreImpl::initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                                                ThreadLocal::Instance& tls) {
   main_thread_dispatcher_ = &main_thread_dispatcher;
@@ -121,23 +138,10 @@ ThreadLocalStoreImpl::SafeAllocData ThreadLocalStoreImpl::safeAlloc(const std::s
 
 ThreadLocalStoreImpl::ScopeImpl::~ScopeImpl() { parent_.releaseScopeCrossThread(this); }
 
-Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
+CounterSharedPtr ThreadLocalStoreImpl::ScopeImpl::centralCounter(const std::string& name) {
   // Determine the final name based on the prefix and the passed name.
   std::string final_name = prefix_ + name;
 
-  // We now try to acquire a *reference* to the TLS cache shared pointer. This might remain null
-  // if we don't have TLS initialized currently. The de-referenced pointer might be null if there
-  // is no cache entry.
-  CounterSharedPtr* tls_ref = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].counters_[final_name];
-  }
-
-  // If we have a valid cache entry, return it.
-  if (tls_ref && *tls_ref) {
-    return **tls_ref;
-  }
-
   // We must now look in the central store so we must be locked. We grab a reference to the
   // central store location. It might contain nothing. In this case, we allocate a new stat.
   std::unique_lock<std::mutex> lock(parent_.lock_);
@@ -150,13 +154,62 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
         new CounterImpl(alloc.data_, alloc.free_, std::move(tag_extracted_name), std::move(tags)));
   }
 
+  return central_ref;
+}
+
+void ThreadLocalStoreImpl::ScopeImpl::keepStatName(const SymbolVector& symbols) {
+  std::unique_lock<std::mutex> lock(parent_.lock_);
+  StatNamePtr& stat_name = central_cache_.stat_names_[symbols];
+  if (!stat_name) {
+    stat_name = parent_.symbol_table_.copy(symbols);
+  }
+}
+
+Counter& ThreadLocalStoreImpl::ScopeImpl::counter(const std::string& name) {
+  // We now try to acquire a *reference* to the TLS cache shared pointer. This might remain null
+  // if we don't have TLS initialized currently. The de-referenced pointer might be null if there
+  // is no cache entry. The TLS cache is per scope, so it is keyed by the name without the prefix.
+  CounterSharedPtr* tls_ref = nullptr;
+  if (!parent_.shutting_down_ && parent_.tls_) {
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].counters_[name];
+  }
+
+  // If we have a valid cache entry, return it.
+  if (tls_ref && *tls_ref) {
+    return **tls_ref;
+  }
+
+  CounterSharedPtr central = centralCounter(name);
+
   // If we have a TLS location to store or allocation into, do it.
   if (tls_ref) {
-    *tls_ref = central_ref;
+    *tls_ref = central;
   }
 
-  // Finally we return the reference.
-  return *central_ref;
+  // Finally we return the reference. The central cache keeps the counter alive.
+  return *central;
+}
+
+Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(const StatName& name) {
+  // See comments in counter(). The name was encoded in the parent's table, so it is a
+  // StatNameImpl. A cache hit only hashes its symbols.
+  const SymbolVector& symbols = static_cast<const StatNameImpl&>(name).symbols();
+  CounterSharedPtr* tls_ref = nullptr;
+  if (!parent_.shutting_down_ && parent_.tls_) {
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].stat_name_counters_[symbols];
+  }
+
+  if (tls_ref && *tls_ref) {
+    return **tls_ref;
+  }
+
+  CounterSharedPtr central = centralCounter(name.toString());
+  if (tls_ref) {
+    keepStatName(symbols);
+    *tls_ref = central;
+  }
+
+  return *central;
 }
 
 void ThreadLocalStoreImpl::ScopeImpl::deliverHistogramToSinks(const Histogram& histogram,
@@ -175,19 +228,10 @@ void ThreadLocalStoreImpl::ScopeImpl::deliverHistogramToSinks(const Histogram& h
   }
 }
 
-Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
-  // See comments in counter(). There is no super clean way (via templates or otherwise) to
+GaugeSharedPtr ThreadLocalStoreImpl::ScopeImpl::centralGauge(const std::string& name) {
+  // See comments in centralCounter(). There is no super clean way (via templates or otherwise) to
   // share this code so I'm leaving it largely duplicated for now.
   std::string final_name = prefix_ + name;
-  GaugeSharedPtr* tls_ref = nullptr;
-  if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].gauges_[final_name];
-  }
-
-  if (tls_ref && *tls_ref) {
-    return **tls_ref;
-  }
-
   std::unique_lock<std::mutex> lock(parent_.lock_);
   GaugeSharedPtr& central_ref = central_cache_.gauges_[final_name];
   if (!central_ref) {
@@ -198,40 +242,158 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
         new GaugeImpl(alloc.data_, alloc.free_, std::move(tag_extracted_name), std::move(tags)));
   }
 
+  return central_ref;
+}
+
+Gauge& ThreadLocalStoreImpl::ScopeImpl::gauge(const std::string& name) {
+  // See comments in counter().
+  GaugeSharedPtr* tls_ref = nullptr;
+  if (!parent_.shutting_down_ && parent_.tls_) {
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].gauges_[name];
+  }
+
+  if (tls_ref && *tls_ref) {
+    return **tls_ref;
+  }
+
+  GaugeSharedPtr central = centralGauge(name);
   if (tls_ref) {
-    *tls_ref = central_ref;
+    *tls_ref = central;
   }
 
-  return *central_ref;
+  return *central;
 }
 
-Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
-  // See comments in counter(). There is no super clean way (via templates or otherwise) to
-  // share this code so I'm leaving it largely duplicated for now.
-  std::string final_name = prefix_ + name;
-  HistogramSharedPtr* tls_ref = nullptr;
+Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatName(const StatName& name) {
+  // See comments in counterFromStatName().
+  const SymbolVector& symbols = static_cast<const StatNameImpl&>(name).symbols();
+  GaugeSharedPtr* tls_ref = nullptr;
   if (!parent_.shutting_down_ && parent_.tls_) {
-    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].histograms_[final_name];
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].stat_name_gauges_[symbols];
   }
 
   if (tls_ref && *tls_ref) {
     return **tls_ref;
   }
 
+  GaugeSharedPtr central = centralGauge(name.toString());
+  if (tls_ref) {
+    keepStatName(symbols);
+    *tls_ref = central;
+  }
+
+  return *central;
+}
+
+ParentHistogramImplSharedPtr
+ThreadLocalStoreImpl::ScopeImpl::centralHistogram(const std::string& name) {
+  // See comments in centralCounter().
+  std::string final_name = prefix_ + name;
   std::unique_lock<std::mutex> lock(parent_.lock_);
-  HistogramSharedPtr& central_ref = central_cache_.histograms_[final_name];
+  ParentHistogramImplSharedPtr& central_ref = central_cache_.histograms_[final_name];
   if (!central_ref) {
     std::vector<Tag> tags;
     std::string tag_extracted_name = parent_.getTagsForName(final_name, tags);
-    central_ref.reset(
-        new HistogramImpl(final_name, parent_, std::move(tag_extracted_name), std::move(tags)));
+    central_ref.reset(new ParentHistogramImpl(final_name, parent_, std::move(tag_extracted_name),
+                                              std::move(tags)));
+  }
+
+  return central_ref;
+}
+
+Histogram& ThreadLocalStoreImpl::ScopeImpl::histogram(const std::string& name) {
+  // See comments in counter(). Unlike counters and gauges, each thread caches its own histogram
+  // which records into per thread buckets, and the central cache holds the parent which merges
+  // them.
+  ThreadLocalHistogramSharedPtr* tls_ref = nullptr;
+  if (!parent_.shutting_down_ && parent_.tls_) {
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].histograms_[name];
   }
 
+  if (tls_ref && *tls_ref) {
+    return **tls_ref;
+  }
+
+  ParentHistogramImplSharedPtr central = centralHistogram(name);
+  if (tls_ref) {
+    *tls_ref = central->addTlsHistogram();
+    return **tls_ref;
+  }
+
+  return *central;
+}
+
+Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatName(const StatName& name) {
+  // See comments in counterFromStatName() and histogram().
+  const SymbolVector& symbols = static_cast<const StatNameImpl&>(name).symbols();
+  ThreadLocalHistogramSharedPtr* tls_ref = nullptr;
+  if (!parent_.shutting_down_ && parent_.tls_) {
+    tls_ref = &parent_.tls_->getTyped<TlsCache>().scope_cache_[this].stat_name_histograms_[symbols];
+  }
+
+  if (tls_ref && *tls_ref) {
+    return **tls_ref;
+  }
+
+  ParentHistogramImplSharedPtr central = centralHistogram(name.toString());
   if (tls_ref) {
-    *tls_ref = central_ref;
+    keepStatName(symbols);
+    *tls_ref = central->addTlsHistogram();
+    return **tls_ref;
+  }
+
+  return *central;
+}
+
+ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
+  parent_histogram_->removeTlsHistogram(*this);
+}
+
+ThreadLocalHistogramSharedPtr ParentHistogramImpl::addTlsHistogram() {
+  ThreadLocalHistogramSharedPtr histogram = std::make_shared<ThreadLocalHistogramImpl>(
+      name(), parent_, shared_from_this(), std::string(tagExtractedName()),
+      std::vector<Tag>(tags()));
+  std::unique_lock<std::mutex> lock(tls_histograms_lock_);
+  tls_histograms_.insert(histogram.get());
+  return histogram;
+}
+
+void ParentHistogramImpl::removeTlsHistogram(const ThreadLocalHistogramImpl& histogram) {
+  std::unique_lock<std::mutex> lock(tls_histograms_lock_);
+  histogram.buckets().addTo(removed_tls_counts_);
+  tls_histograms_.erase(&histogram);
+}
+
+void ParentHistogramImpl::merge() {
+  // Bucket counts only ever grow, so the interval counts are the difference from the counts seen
+  // at the last merge.
+  std::map<uint32_t, uint64_t> counts;
+  {
+    std::unique_lock<std::mutex> lock(buckets_lock_);
+    buckets_.addTo(counts);
+  }
+  {
+    std::unique_lock<std::mutex> lock(tls_histograms_lock_);
+    for (const auto& count : removed_tls_counts_) {
+      counts[count.first] += count.second;
+    }
+    for (const ThreadLocalHistogramImpl* tls_histogram : tls_histograms_) {
+      tls_histogram->buckets().addTo(counts);
+    }
+  }
+
+  std::map<uint32_t, uint64_t> interval_counts;
+  for (const auto& count : counts) {
+    auto last_count = last_counts_.find(count.first);
+    const uint64_t last = last_count == last_counts_.end() ? 0 : last_count->second;
+    if (count.second > last) {
+      interval_counts.emplace_hint(interval_counts.end(), count.first, count.second - last);
+    }
   }
 
-  return *central_ref;
+  interval_statistics_ = HistogramStatisticsImpl(interval_counts);
+  cumulative_statistics_ = HistogramStatisticsImpl(counts);
+  last_counts_.swap(counts);
 }
 
 } // namespace Stats
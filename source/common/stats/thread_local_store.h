@@ -4,6 +4,7 @@
 #include <chrono>
 #include <cstdint>
 #include <list>
+#include <map>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -11,11 +12,99 @@
 
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/stats/histogram_impl.h"
 #include "common/stats/stats_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 namespace Envoy {
 namespace Stats {
 
+class ParentHistogramImpl;
+typedef std::shared_ptr<ParentHistogramImpl> ParentHistogramImplSharedPtr;
+
+/**
+ * Histogram which records values for a single thread, into buckets which are merged by its
+ * ParentHistogramImpl. Only the owning thread may record values. The parent is kept alive until
+ * the thread local cache releases this histogram, which hands its buckets back to the parent.
+ */
+class ThreadLocalHistogramImpl : public Histogram, public MetricImpl {
+public:
+  ThreadLocalHistogramImpl(const std::string& name, Store& parent,
+                           ParentHistogramImplSharedPtr parent_histogram,
+                           std::string&& tag_extracted_name, std::vector<Tag>&& tags)
+      : MetricImpl(name, std::move(tag_extracted_name), std::move(tags)), parent_(parent),
+        parent_histogram_(std::move(parent_histogram)) {}
+  ~ThreadLocalHistogramImpl();
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override {
+    buckets_.recordValue(value);
+    parent_.deliverHistogramToSinks(*this, value);
+  }
+
+  const HistogramBuckets& buckets() const { return buckets_; }
+
+private:
+  Store& parent_;
+  ParentHistogramImplSharedPtr parent_histogram_;
+  HistogramBuckets buckets_;
+};
+
+typedef std::shared_ptr<ThreadLocalHistogramImpl> ThreadLocalHistogramSharedPtr;
+
+/**
+ * Central histogram for a stat name. Each thread records into its own ThreadLocalHistogramImpl,
+ * and the per thread buckets are merged on the main thread by merge(). Before threading is
+ * initialized and once it is shutting down, values are recorded directly into the parent. Any
+ * thread may do so during shutdown, so recording into the parent takes a lock.
+ */
+class ParentHistogramImpl : public ParentHistogram,
+                            public MetricImpl,
+                            public std::enable_shared_from_this<ParentHistogramImpl> {
+public:
+  ParentHistogramImpl(const std::string& name, Store& parent, std::string&& tag_extracted_name,
+                      std::vector<Tag>&& tags)
+      : MetricImpl(name, std::move(tag_extracted_name), std::move(tags)), parent_(parent) {}
+
+  /**
+   * @return a new histogram for the calling thread to record into.
+   */
+  ThreadLocalHistogramSharedPtr addTlsHistogram();
+
+  /**
+   * Called when a thread local histogram is destroyed. Its counts are kept by the parent so that
+   * the cumulative statistics do not go backwards.
+   */
+  void removeTlsHistogram(const ThreadLocalHistogramImpl& histogram);
+
+  // Stats::Histogram
+  void recordValue(uint64_t value) override {
+    {
+      std::unique_lock<std::mutex> lock(buckets_lock_);
+      buckets_.recordValue(value);
+    }
+    parent_.deliverHistogramToSinks(*this, value);
+  }
+
+  // Stats::ParentHistogram
+  void merge() override;
+  const HistogramStatistics& intervalStatistics() const override { return interval_statistics_; }
+  const HistogramStatistics& cumulativeStatistics() const override {
+    return cumulative_statistics_;
+  }
+
+private:
+  Store& parent_;
+  std::mutex buckets_lock_;
+  HistogramBuckets buckets_;
+  std::mutex tls_histograms_lock_;
+  std::unordered_set<const ThreadLocalHistogramImpl*> tls_histograms_;
+  std::map<uint32_t, uint64_t> removed_tls_counts_;
+  std::map<uint32_t, uint64_t> last_counts_;
+  HistogramStatisticsImpl interval_statistics_;
+  HistogramStatisticsImpl cumulative_statistics_;
+};
+
 /**
  * Store implementation with thread local caching. This implementation supports the following
  * features:
@@ -31,6 +120,12 @@ namespace Stats {
  * - Scopes can be deleted from any thread, and they are in practice as scopes are likely to be
  *   shared across all worker threads.
  * - Per thread caches are checked, and if empty, they are populated from the central cache.
+ * - Per thread caches are keyed by the name passed to the scope, so that a cache hit does not need
+ *   to build the prefixed name. Names passed as a StatName have their own per thread caches keyed
+ *   by their symbols, so that a cache hit only hashes a few integers. The string lookups do not
+ *   use the store's SymbolTable at all.
+ * - The central cache is keyed by the prefixed name. It also holds a copy of each name that has
+ *   been passed as a StatName, which keeps the symbols of the per thread keys from being recycled.
  * - Scopes are entirely owned by the caller. The store only keeps weak pointers.
  * - When a scope is destroyed, a cache flush operation is run on all threads to flush any cached
  *   data owned by the destroyed scope.
@@ -38,8 +133,9 @@ namespace Stats {
  *         with the same address, and a cache flush operation could race and delete cache data
  *         for the new scope. This is extremely unlikely, and if it happens the cache will be
  *         repopulated on the next access.
- * - Since it's possible to have overlapping scopes, we de-dup stats when counters() or gauges() is
- *   called since these are very uncommon operations.
+ * - Since it's possible to have overlapping scopes, we de-dup stats when counters(), gauges() or
+ *   histograms() is called since these are very uncommon operations.
+ * - Histograms are recorded per thread, see ParentHistogramImpl.
  * - Though this implementation is designed to work with a fixed shared memory space, it will fall
  *   back to heap allocated stats if needed. NOTE: In this case, overlapping scopes will not share
  *   the same backing store. This is to keep things simple, it could be done in the future if
@@ -60,10 +156,21 @@ public:
   Histogram& histogram(const std::string& name) override {
     return default_scope_->histogram(name);
   };
+  SymbolTable& symbolTable() override { return symbol_table_; }
+  Counter& counterFromStatName(const StatName& name) override {
+    return default_scope_->counterFromStatName(name);
+  }
+  Gauge& gaugeFromStatName(const StatName& name) override {
+    return default_scope_->gaugeFromStatName(name);
+  }
+  Histogram& histogramFromStatName(const StatName& name) override {
+    return default_scope_->histogramFromStatName(name);
+  }
 
   // Stats::Store
   std::list<CounterSharedPtr> counters() const override;
   std::list<GaugeSharedPtr> gauges() const override;
+  std::list<ParentHistogramSharedPtr> histograms() const override;
 
   // Stats::StoreRoot
   void addSink(Sink& sink) override { timer_sinks_.push_back(sink); }
@@ -78,7 +185,21 @@ private:
   struct TlsCacheEntry {
     std::unordered_map<std::string, CounterSharedPtr> counters_;
     std::unordered_map<std::string, GaugeSharedPtr> gauges_;
-    std::unordered_map<std::string, HistogramSharedPtr> histograms_;
+    std::unordered_map<std::string, ThreadLocalHistogramSharedPtr> histograms_;
+    // The keys do not hold references on their symbols. See CentralCacheEntry::stat_names_.
+    std::unordered_map<SymbolVector, CounterSharedPtr, SymbolVectorHash> stat_name_counters_;
+    std::unordered_map<SymbolVector, GaugeSharedPtr, SymbolVectorHash> stat_name_gauges_;
+    std::unordered_map<SymbolVector, ThreadLocalHistogramSharedPtr, SymbolVectorHash>
+        stat_name_histograms_;
+  };
+
+  struct CentralCacheEntry {
+    std::unordered_map<std::string, CounterSharedPtr> counters_;
+    std::unordered_map<std::string, GaugeSharedPtr> gauges_;
+    std::unordered_map<std::string, ParentHistogramImplSharedPtr> histograms_;
+    // A copy of every name passed to the scope as a StatName, so that the symbols of the per
+    // thread cache keys stay valid for as long as the scope does.
+    std::unordered_map<SymbolVector, StatNamePtr, SymbolVectorHash> stat_names_;
   };
 
   struct ScopeImpl : public Scope {
@@ -94,10 +215,28 @@ private:
     void deliverHistogramToSinks(const Histogram& histogram, uint64_t value) override;
     Gauge& gauge(const std::string& name) override;
     Histogram& histogram(const std::string& name) override;
+    SymbolTable& symbolTable() override { return parent_.symbol_table_; }
+    Counter& counterFromStatName(const StatName& name) override;
+    Gauge& gaugeFromStatName(const StatName& name) override;
+    Histogram& histogramFromStatName(const StatName& name) override;
+
+    /**
+     * Look a stat up in the central cache, allocating it if needed.
+     * @param name supplies the name passed to the scope.
+     */
+    CounterSharedPtr centralCounter(const std::string& name);
+    GaugeSharedPtr centralGauge(const std::string& name);
+    ParentHistogramImplSharedPtr centralHistogram(const std::string& name);
+
+    /**
+     * Keep a copy of a name passed as a StatName, so that its symbols can be used as a per thread
+     * cache key.
+     */
+    void keepStatName(const SymbolVector& symbols);
 
     ThreadLocalStoreImpl& parent_;
     const std::string prefix_;
-    TlsCacheEntry central_cache_;
+    CentralCacheEntry central_cache_;
   };
 
   struct TlsCache : public ThreadLocal::ThreadLocalObject {
@@ -115,6 +254,8 @@ private:
   SafeAllocData safeAlloc(const std::string& name);
 
   RawStatDataAllocator& alloc_;
+  // Declared before the scopes, whose central caches release their names into it.
+  SymbolTableImpl symbol_table_;
   Event::Dispatcher* main_thread_dispatcher_{};
   ThreadLocal::SlotPtr tls_;
   mutable std::mutex lock_;
@@ -10,6 +10,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/dns.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/stats/timespan.h"
 
 #include "common/common/enum_to_int.h"
 #include "common/common/utility.h"
@@ -25,6 +26,7 @@
 #include "common/router/shadow_writer_impl.h"
 #include "common/upstream/cds_api_impl.h"
 #include "common/upstream/load_balancer_impl.h"
+#include "common/upstream/maglev_lb.h"
 #include "common/upstream/original_dst_cluster.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/subset_lb.h"
@@ -33,6 +35,31 @@
 
 namespace Envoy {
 namespace Upstream {
+namespace {
+
+uint64_t hostListBytes(const std::vector<HostSharedPtr>& hosts) {
+  return sizeof(hosts) + hosts.capacity() * sizeof(HostSharedPtr);
+}
+
+/**
+ * @return uint64_t the approximate memory used by the host lists of a priority set. The hosts
+ *         themselves are not counted.
+ */
+uint64_t hostListsBytes(const PrioritySet& priority_set) {
+  uint64_t bytes = 0;
+  for (const auto& host_set : priority_set.hostSetsPerPriority()) {
+    bytes += hostListBytes(host_set->hosts()) + hostListBytes(host_set->healthyHosts());
+    for (const auto& hosts : host_set->hostsPerLocality()) {
+      bytes += hostListBytes(hosts);
+    }
+    for (const auto& hosts : host_set->healthyHostsPerLocality()) {
+      bytes += hostListBytes(hosts);
+    }
+  }
+  return bytes;
+}
+
+} // namespace
 
 void ClusterManagerInitHelper::addCluster(Cluster& cluster) {
   if (state_ == State::AllClustersInitialized) {
@@ -422,24 +449,42 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(
   }
 
   const auto& host_set = primary_cluster.prioritySet().hostSetsPerPriority()[priority];
-
-  HostVectorConstSharedPtr hosts_copy(new std::vector<HostSharedPtr>(host_set->hosts()));
-  HostVectorConstSharedPtr healthy_hosts_copy(
-      new std::vector<HostSharedPtr>(host_set->healthyHosts()));
-  HostListsConstSharedPtr hosts_per_locality_copy(
-      new std::vector<std::vector<HostSharedPtr>>(host_set->hostsPerLocality()));
-  HostListsConstSharedPtr healthy_hosts_per_locality_copy(
-      new std::vector<std::vector<HostSharedPtr>>(host_set->healthyHostsPerLocality()));
+  const ClusterInfo& info = *primary_cluster.info();
+  Stats::Timespan build_time(info.stats().membership_snapshot_build_ms_);
+
+  // Host lists are never modified once they are in a host set, an update replaces them instead.
+  // So rather than copying the lists for the workers, every worker shares the primary cluster's
+  // lists. Memory for the lists does not grow with the number of workers, and lists which are
+  // replaced are freed once the last worker has moved on to the new ones.
+  HostVectorConstSharedPtr hosts = host_set->hostsPtr();
+  HostVectorConstSharedPtr healthy_hosts = host_set->healthyHostsPtr();
+  HostListsConstSharedPtr hosts_per_locality = host_set->hostsPerLocalityPtr();
+  HostListsConstSharedPtr healthy_hosts_per_locality = host_set->healthyHostsPerLocalityPtr();
+
+  // Consistent hashing tables are expensive to build and large, so they are built once here and
+  // shared read only by every worker rather than rebuilt by each of them. Subset load balancers
+  // build tables for their own subsets and are not covered by this.
+  ThreadAwareLoadBalancerBase::TablesConstSharedPtr lb_tables;
+  const bool shared_lb_tables = priority == 0 && !info.lbSubsetInfo().isEnabled();
+  if (shared_lb_tables && info.lbType() == LoadBalancerType::RingHash) {
+    lb_tables = RingHashLoadBalancer::buildRings(primary_cluster.prioritySet(), info.stats(),
+                                                 info.lbRingHashConfig());
+  } else if (shared_lb_tables && info.lbType() == LoadBalancerType::Maglev) {
+    lb_tables = MaglevLoadBalancer::buildMaglevTables(primary_cluster.prioritySet(), info.stats());
+  }
+
+  build_time.complete();
+  info.stats().membership_snapshot_bytes_.set(hostListsBytes(primary_cluster.prioritySet()));
 
   tls_->runOnAllThreads([
-    this, name = primary_cluster.info()->name(), priority, hosts_copy, healthy_hosts_copy,
-    hosts_per_locality_copy, healthy_hosts_per_locality_copy, hosts_added, hosts_removed
+    this, name = info.name(), priority, hosts, healthy_hosts, hosts_per_locality,
+    healthy_hosts_per_locality, hosts_added, hosts_removed, lb_tables
   ]()
                             ->void {
                               ThreadLocalClusterManagerImpl::updateClusterMembership(
-                                  name, priority, hosts_copy, healthy_hosts_copy,
-                                  hosts_per_locality_copy, healthy_hosts_per_locality_copy,
-                                  hosts_added, hosts_removed, *tls_);
+                                  name, priority, hosts, healthy_hosts, hosts_per_locality,
+                                  healthy_hosts_per_locality, hosts_added, hosts_removed,
+                                  lb_tables, *tls_);
                             });
 }
 
@@ -578,12 +623,18 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     HostVectorConstSharedPtr healthy_hosts, HostListsConstSharedPtr hosts_per_locality,
     HostListsConstSharedPtr healthy_hosts_per_locality,
     const std::vector<HostSharedPtr>& hosts_added, const std::vector<HostSharedPtr>& hosts_removed,
-    ThreadLocal::Slot& tls) {
+    ThreadAwareLoadBalancerBase::TablesConstSharedPtr lb_tables, ThreadLocal::Slot& tls) {
 
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
   ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
-  config.thread_local_clusters_[name]->priority_set_.getOrCreateHostSet(priority).updateHosts(
+  ClusterEntry& cluster_entry = *config.thread_local_clusters_[name];
+  if (lb_tables) {
+    ASSERT(cluster_entry.thread_aware_lb_ != nullptr);
+    cluster_entry.thread_aware_lb_->tables(std::move(lb_tables));
+  }
+
+  cluster_entry.priority_set_.getOrCreateHostSet(priority).updateHosts(
       std::move(hosts), std::move(healthy_hosts), std::move(hosts_per_locality),
       std::move(healthy_hosts_per_locality), hosts_added, hosts_removed);
 }
@@ -644,8 +695,20 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
       break;
     }
     case LoadBalancerType::RingHash: {
-      lb_.reset(new RingHashLoadBalancer(priority_set_, cluster->stats(), parent.parent_.runtime_,
-                                         parent.parent_.random_, cluster->lbRingHashConfig()));
+      // Rings are built once on the main thread and delivered with each membership update. See
+      // postThreadLocalClusterUpdate().
+      thread_aware_lb_ =
+          new RingHashLoadBalancer(priority_set_, cluster->stats(), parent.parent_.runtime_,
+                                   parent.parent_.random_, nullptr);
+      lb_.reset(thread_aware_lb_);
+      break;
+    }
+    case LoadBalancerType::Maglev: {
+      // Same as above.
+      thread_aware_lb_ = new MaglevLoadBalancer(priority_set_, cluster->stats(),
+                                                parent.parent_.runtime_, parent.parent_.random_,
+                                                nullptr);
+      lb_.reset(thread_aware_lb_);
       break;
     }
     case LoadBalancerType::OriginalDst: {
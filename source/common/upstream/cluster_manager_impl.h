@@ -19,6 +19,7 @@
 #include "common/config/grpc_mux_impl.h"
 #include "common/http/async_client_impl.h"
 #include "common/upstream/load_stats_reporter.h"
+#include "common/upstream/thread_aware_lb_impl.h"
 #include "common/upstream/upstream_impl.h"
 
 #include "api/bootstrap.pb.h"
@@ -205,6 +206,9 @@ private:
       ThreadLocalClusterManagerImpl& parent_;
       PrioritySetImpl priority_set_;
       LoadBalancerPtr lb_;
+      // Set when lb_ is a consistent hashing load balancer which uses tables built on the main
+      // thread. It is owned by lb_.
+      ThreadAwareLoadBalancerBase* thread_aware_lb_{};
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
     };
@@ -223,6 +227,7 @@ private:
                                         HostListsConstSharedPtr healthy_hosts_per_locality,
                                         const std::vector<HostSharedPtr>& hosts_added,
                                         const std::vector<HostSharedPtr>& hosts_removed,
+                                        ThreadAwareLoadBalancerBase::TablesConstSharedPtr lb_tables,
                                         ThreadLocal::Slot& tls);
     static void onHostHealthFailure(const HostSharedPtr& host, ThreadLocal::Slot& tls);
 
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <vector>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Earliest deadline first (EDF) scheduler used for weighted round robin, see
+ * https://en.wikipedia.org/wiki/Earliest_deadline_first_scheduling. Each pick from the schedule
+ * has the earliest deadline entry selected. Entries have deadline set at current time + 1 / weight,
+ * providing weighted round robin behavior with O(log n) pick and add, where n is the number of
+ * entries. Picks of entries with different weights are smoothly interleaved rather than bunched
+ * together (with weights 1 and 3 the picks are B, B, A, B rather than A, B, B, B).
+ *
+ * Entries are held as weak pointers, so an entry which is destroyed while it is scheduled is
+ * skipped by pick().
+ */
+template <class C> class EdfScheduler {
+public:
+  /**
+   * Pick the entry with the earliest deadline and remove it from the schedule. The caller is
+   * expected to add() it back with its current weight if it should be picked again.
+   * @return std::shared_ptr<C> the picked entry or nullptr if there are no live entries.
+   */
+  std::shared_ptr<C> pick() {
+    while (!queue_.empty()) {
+      const EdfEntry& edf_entry = queue_.top();
+      std::shared_ptr<C> ret = edf_entry.entry_.lock();
+      // Time advances to the deadline of the picked entry, so entries added afterwards are
+      // scheduled behind the entries which are already waiting.
+      current_time_ = edf_entry.deadline_;
+      queue_.pop();
+      if (ret != nullptr) {
+        return ret;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * Insert an entry into the schedule.
+   * @param weight supplies the entry's weight, which must be positive.
+   * @param entry supplies the entry.
+   */
+  void add(double weight, std::shared_ptr<C> entry) {
+    ASSERT(weight > 0);
+    const double deadline = current_time_ + 1.0 / weight;
+    queue_.push({deadline, order_offset_++, entry});
+    ASSERT(queue_.top().deadline_ >= current_time_);
+  }
+
+  /**
+   * @return bool whether there are no entries in the schedule.
+   */
+  bool empty() const { return queue_.empty(); }
+
+private:
+  struct EdfEntry {
+    double deadline_;
+    // Tie breaker for entries with the same deadline, which are picked in the order they were
+    // added. This keeps the schedule deterministic (FIFO among equal deadlines).
+    uint64_t order_offset_;
+    std::weak_ptr<C> entry_;
+
+    // priority_queue is a max heap, so the comparison is inverted to pop the earliest deadline.
+    bool operator<(const EdfEntry& other) const {
+      if (deadline_ == other.deadline_) {
+        return order_offset_ > other.order_offset_;
+      }
+      return deadline_ > other.deadline_;
+    }
+  };
+
+  // Current time in the schedule, which is the deadline of the last picked entry.
+  double current_time_{};
+  // Offset of the next entry added, see EdfEntry.
+  uint64_t order_offset_{};
+  std::priority_queue<EdfEntry> queue_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -16,11 +16,15 @@ namespace Upstream {
 static const std::string RuntimeZoneEnabled = "upstream.zone_routing.enabled";
 static const std::string RuntimeMinClusterSize = "upstream.zone_routing.min_cluster_size";
 static const std::string RuntimePanicThreshold = "upstream.healthy_panic_threshold";
+static const std::string RuntimeWeightEnabled = "upstream.weight_enabled";
 
 LoadBalancerBase::LoadBalancerBase(const PrioritySet& priority_set,
                                    const PrioritySet* local_priority_set, ClusterStats& stats,
                                    Runtime::Loader& runtime, Runtime::RandomGenerator& random)
     : stats_(stats), runtime_(runtime), random_(random),
+      zone_enabled_key_(runtime.registerKey(RuntimeZoneEnabled)),
+      min_cluster_size_key_(runtime.registerKey(RuntimeMinClusterSize)),
+      panic_threshold_key_(LoadBalancerUtility::registerPanicThresholdKey(runtime)),
       host_set_(*priority_set.hostSetsPerPriority()[0]),
       local_host_set_(local_priority_set ? local_priority_set->hostSetsPerPriority()[0].get()
                                          : nullptr) {
@@ -126,7 +130,7 @@ bool LoadBalancerBase::earlyExitNonLocalityRouting() {
   }
 
   // Do not perform locality routing for small clusters.
-  uint64_t min_cluster_size = runtime_.snapshot().getInteger(RuntimeMinClusterSize, 6U);
+  uint64_t min_cluster_size = runtime_.snapshot().getInteger(min_cluster_size_key_, 6U);
   if (host_set_.healthyHosts().size() < min_cluster_size) {
     stats_.lb_zone_cluster_too_small_.inc();
     return true;
@@ -135,9 +139,10 @@ bool LoadBalancerBase::earlyExitNonLocalityRouting() {
   return false;
 }
 
-bool LoadBalancerUtility::isGlobalPanic(const HostSet& host_set, Runtime::Loader& runtime) {
+bool LoadBalancerUtility::isGlobalPanic(const HostSet& host_set, Runtime::Loader& runtime,
+                                        const Runtime::Key& panic_threshold_key) {
   uint64_t global_panic_threshold =
-      std::min<uint64_t>(100, runtime.snapshot().getInteger(RuntimePanicThreshold, 50));
+      std::min<uint64_t>(100, runtime.snapshot().getInteger(panic_threshold_key, 50));
   double healthy_percent = host_set.hosts().size() == 0
                                ? 0
                                : 100.0 * host_set.healthyHosts().size() / host_set.hosts().size();
@@ -150,6 +155,10 @@ bool LoadBalancerUtility::isGlobalPanic(const HostSet& host_set, Runtime::Loader
   return false;
 }
 
+Runtime::Key LoadBalancerUtility::registerPanicThresholdKey(Runtime::Loader& runtime) {
+  return runtime.registerKey(RuntimePanicThreshold);
+}
+
 void LoadBalancerBase::calculateLocalityPercentage(
     const std::vector<std::vector<HostSharedPtr>>& hosts_per_locality, uint64_t* ret) {
   uint64_t total_hosts = 0;
@@ -163,7 +172,7 @@ void LoadBalancerBase::calculateLocalityPercentage(
   }
 }
 
-const std::vector<HostSharedPtr>& LoadBalancerBase::tryChooseLocalLocalityHosts() {
+uint32_t LoadBalancerBase::tryChooseLocalLocalityHosts() {
   ASSERT(locality_routing_state_ != LocalityRoutingState::NoLocalityRouting);
 
   // At this point it's guaranteed to be at least 2 localities.
@@ -176,7 +185,7 @@ const std::vector<HostSharedPtr>& LoadBalancerBase::tryChooseLocalLocalityHosts(
   // Try to push all of the requests to the same locality first.
   if (locality_routing_state_ == LocalityRoutingState::LocalityDirect) {
     stats_.lb_zone_routing_all_directly_.inc();
-    return host_set_.healthyHostsPerLocality()[0];
+    return 0;
   }
 
   ASSERT(locality_routing_state_ == LocalityRoutingState::LocalityResidual);
@@ -185,7 +194,7 @@ const std::vector<HostSharedPtr>& LoadBalancerBase::tryChooseLocalLocalityHosts(
   // push to the local locality, check if we can push to local locality on current iteration.
   if (random_.random() % 10000 < local_percent_to_route_) {
     stats_.lb_zone_routing_sampled_.inc();
-    return host_set_.healthyHostsPerLocality()[0];
+    return 0;
   }
 
   // At this point we must route cross locality as we cannot route to the local locality.
@@ -195,7 +204,7 @@ const std::vector<HostSharedPtr>& LoadBalancerBase::tryChooseLocalLocalityHosts(
   // locality percentages. In this case just select random locality.
   if (residual_capacity_[number_of_localities - 1] == 0) {
     stats_.lb_zone_no_capacity_left_.inc();
-    return host_set_.healthyHostsPerLocality()[random_.random() % number_of_localities];
+    return random_.random() % number_of_localities;
   }
 
   // Random sampling to select specific locality for cross locality traffic based on the additional
@@ -204,100 +213,140 @@ const std::vector<HostSharedPtr>& LoadBalancerBase::tryChooseLocalLocalityHosts(
 
   // This potentially can be optimized to be O(log(N)) where N is the number of localities.
   // Linear scan should be faster for smaller N, in most of the scenarios N will be small.
-  int i = 0;
+  uint32_t i = 0;
   while (threshold > residual_capacity_[i]) {
     i++;
   }
 
-  return host_set_.healthyHostsPerLocality()[i];
+  return i;
 }
 
-const std::vector<HostSharedPtr>& LoadBalancerBase::hostsToUse() {
+LoadBalancerBase::HostsSource LoadBalancerBase::hostSourceToUse() {
   ASSERT(host_set_.healthyHosts().size() <= host_set_.hosts().size());
 
-  if (LoadBalancerUtility::isGlobalPanic(host_set_, runtime_)) {
+  if (LoadBalancerUtility::isGlobalPanic(host_set_, runtime_, panic_threshold_key_)) {
     stats_.lb_healthy_panic_.inc();
-    return host_set_.hosts();
+    return HostsSource(HostsSource::SourceType::AllHosts);
   }
 
   if (locality_routing_state_ == LocalityRoutingState::NoLocalityRouting) {
-    return host_set_.healthyHosts();
+    return HostsSource(HostsSource::SourceType::HealthyHosts);
   }
 
-  if (!runtime_.snapshot().featureEnabled(RuntimeZoneEnabled, 100)) {
-    return host_set_.healthyHosts();
+  if (!runtime_.snapshot().featureEnabled(zone_enabled_key_, 100)) {
+    return HostsSource(HostsSource::SourceType::HealthyHosts);
   }
 
-  if (LoadBalancerUtility::isGlobalPanic(*local_host_set_, runtime_)) {
+  if (LoadBalancerUtility::isGlobalPanic(*local_host_set_, runtime_, panic_threshold_key_)) {
     stats_.lb_local_cluster_not_ok_.inc();
-    return host_set_.healthyHosts();
+    return HostsSource(HostsSource::SourceType::HealthyHosts);
   }
 
-  return tryChooseLocalLocalityHosts();
+  return HostsSource(HostsSource::SourceType::LocalityHealthyHosts,
+                     tryChooseLocalLocalityHosts());
 }
 
-HostConstSharedPtr RoundRobinLoadBalancer::chooseHost(LoadBalancerContext*) {
-  const std::vector<HostSharedPtr>& hosts_to_use = hostsToUse();
-  if (hosts_to_use.empty()) {
-    return nullptr;
+const std::vector<HostSharedPtr>&
+LoadBalancerBase::hostSourceToHosts(const HostsSource& hosts_source) const {
+  switch (hosts_source.source_type_) {
+  case HostsSource::SourceType::AllHosts:
+    return host_set_.hosts();
+  case HostsSource::SourceType::HealthyHosts:
+    return host_set_.healthyHosts();
+  case HostsSource::SourceType::LocalityHealthyHosts:
+    return host_set_.healthyHostsPerLocality()[hosts_source.locality_index_];
   }
-
-  return hosts_to_use[rr_index_++ % hosts_to_use.size()];
+  NOT_REACHED;
 }
 
-LeastRequestLoadBalancer::LeastRequestLoadBalancer(const PrioritySet& priority_set,
-                                                   const PrioritySet* local_priority_set,
-                                                   ClusterStats& stats, Runtime::Loader& runtime,
-                                                   Runtime::RandomGenerator& random)
-    : LoadBalancerBase(priority_set, local_priority_set, stats, runtime, random) {
-  host_set_.addMemberUpdateCb([this](uint32_t, const std::vector<HostSharedPtr>&,
-                                     const std::vector<HostSharedPtr>& hosts_removed) -> void {
-    if (last_host_) {
-      for (const HostSharedPtr& host : hosts_removed) {
-        if (host == last_host_) {
-          hits_left_ = 0;
-          last_host_.reset();
-
-          break;
-        }
-      }
-    }
-  });
+EdfLoadBalancerBase::EdfLoadBalancerBase(const PrioritySet& priority_set,
+                                         const PrioritySet* local_priority_set,
+                                         ClusterStats& stats, Runtime::Loader& runtime,
+                                         Runtime::RandomGenerator& random)
+    : LoadBalancerBase(priority_set, local_priority_set, stats, runtime, random),
+      priority_set_(priority_set), weight_enabled_key_(runtime.registerKey(RuntimeWeightEnabled)) {}
+
+void EdfLoadBalancerBase::initialize() {
+  for (uint32_t priority = 0; priority < priority_set_.hostSetsPerPriority().size(); ++priority) {
+    refresh(priority);
+  }
+  priority_set_.addMemberUpdateCb(
+      [this](uint32_t priority, const std::vector<HostSharedPtr>&,
+             const std::vector<HostSharedPtr>&) -> void { refresh(priority); });
 }
 
-HostConstSharedPtr LeastRequestLoadBalancer::chooseHost(LoadBalancerContext*) {
-  bool is_weight_imbalanced = stats_.max_host_weight_.value() != 1;
-  bool is_weight_enabled = runtime_.snapshot().getInteger("upstream.weight_enabled", 1UL) != 0;
+void EdfLoadBalancerBase::refresh(uint32_t priority) {
+  if (priority >= schedulers_.size()) {
+    schedulers_.resize(priority + 1);
+  }
+
+  // Health changes are delivered as host set updates too, so every source of the priority may have
+  // changed. The schedulers of other priorities are left as they are.
+  SchedulerMap& schedulers = schedulers_[priority];
+  schedulers.clear();
+  const HostSet& host_set = *priority_set_.hostSetsPerPriority()[priority];
+  refreshSource(schedulers, HostsSource(HostsSource::SourceType::AllHosts), host_set.hosts());
+  refreshSource(schedulers, HostsSource(HostsSource::SourceType::HealthyHosts),
+                host_set.healthyHosts());
+  const auto& healthy_hosts_per_locality = host_set.healthyHostsPerLocality();
+  for (uint32_t i = 0; i < healthy_hosts_per_locality.size(); ++i) {
+    refreshSource(schedulers, HostsSource(HostsSource::SourceType::LocalityHealthyHosts, i),
+                  healthy_hosts_per_locality[i]);
+  }
+}
 
-  if (is_weight_imbalanced && hits_left_ > 0 && is_weight_enabled) {
-    --hits_left_;
+void EdfLoadBalancerBase::refreshSource(SchedulerMap& schedulers, const HostsSource& source,
+                                        const std::vector<HostSharedPtr>& hosts) {
+  // Sources whose hosts all have the same weight are left to unweightedHostPick(), which does
+  // not need a scheduler.
+  bool weights_equal = true;
+  for (const HostSharedPtr& host : hosts) {
+    if (host->weight() != hosts[0]->weight()) {
+      weights_equal = false;
+      break;
+    }
+  }
+  if (weights_equal) {
+    return;
+  }
 
-    return last_host_;
-  } else {
-    // To avoid hit stale last_host_ when all hosts become weight balanced.
-    hits_left_ = 0;
-    last_host_.reset();
+  EdfScheduler<Host>& scheduler = schedulers[source];
+  for (const HostSharedPtr& host : hosts) {
+    scheduler.add(hostWeight(*host), host);
   }
+}
 
-  const std::vector<HostSharedPtr>& hosts_to_use = hostsToUse();
+HostConstSharedPtr EdfLoadBalancerBase::chooseHost(LoadBalancerContext*) {
+  const HostsSource hosts_source = hostSourceToUse();
+  const std::vector<HostSharedPtr>& hosts_to_use = hostSourceToHosts(hosts_source);
   if (hosts_to_use.empty()) {
     return nullptr;
   }
 
-  // Make weighed random if we have hosts with non 1 weights.
-  if (is_weight_imbalanced & is_weight_enabled) {
-    last_host_ = hosts_to_use[random_.random() % hosts_to_use.size()];
-    hits_left_ = last_host_->weight() - 1;
+  // Hosts are only picked from priority 0 so far, like host_set_.
+  SchedulerMap& schedulers = schedulers_[0];
+  auto scheduler = schedulers.find(hosts_source);
+  if (scheduler != schedulers.end() &&
+      runtime_.snapshot().getInteger(weight_enabled_key_, 1UL) != 0) {
+    const HostSharedPtr host = scheduler->second.pick();
+    if (host != nullptr) {
+      // Every pick is followed by an add, so the scheduler always holds each live host once.
+      scheduler->second.add(hostWeight(*host), host);
+      return host;
+    }
+  }
+
+  return unweightedHostPick(hosts_to_use, hosts_source);
+}
 
-    return last_host_;
+HostSharedPtr LeastRequestLoadBalancer::unweightedHostPick(
+    const std::vector<HostSharedPtr>& hosts_to_use, const HostsSource&) {
+  HostSharedPtr host1 = hosts_to_use[random_.random() % hosts_to_use.size()];
+  HostSharedPtr host2 = hosts_to_use[random_.random() % hosts_to_use.size()];
+  if (host1->stats().rq_active_.value() < host2->stats().rq_active_.value()) {
+    return host1;
   } else {
-    HostSharedPtr host1 = hosts_to_use[random_.random() % hosts_to_use.size()];
-    HostSharedPtr host2 = hosts_to_use[random_.random() % hosts_to_use.size()];
-    if (host1->stats().rq_active_.value() < host2->stats().rq_active_.value()) {
-      return host1;
-    } else {
-      return host2;
-    }
+    return host2;
   }
 }
 
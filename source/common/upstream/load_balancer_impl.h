@@ -1,13 +1,17 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/upstream/edf_scheduler.h"
+
 #include "api/cds.pb.h"
 
 namespace Envoy {
@@ -22,8 +26,15 @@ public:
    * For the given host_set @return if we should be in a panic mode or not. For example, if the
    * majority of hosts are unhealthy we'll be likely in a panic mode. In this case we'll route
    * requests to hosts regardless of whether they are healthy or not.
+   * @param panic_threshold_key supplies the key returned by registerPanicThresholdKey().
+   */
+  static bool isGlobalPanic(const HostSet& host_set, Runtime::Loader& runtime,
+                            const Runtime::Key& panic_threshold_key);
+
+  /**
+   * @return Runtime::Key the registered runtime key of the healthy panic threshold.
    */
-  static bool isGlobalPanic(const HostSet& host_set, Runtime::Loader& runtime);
+  static Runtime::Key registerPanicThresholdKey(Runtime::Loader& runtime);
 };
 
 /**
@@ -35,14 +46,54 @@ protected:
                    ClusterStats& stats, Runtime::Loader& runtime, Runtime::RandomGenerator& random);
   ~LoadBalancerBase();
 
+  /**
+   * Identifies one of the host lists of the host set which a host may be picked from.
+   */
+  struct HostsSource {
+    enum class SourceType { AllHosts, HealthyHosts, LocalityHealthyHosts };
+
+    HostsSource() {}
+    HostsSource(SourceType source_type, uint32_t locality_index = 0)
+        : source_type_(source_type), locality_index_(locality_index) {}
+
+    bool operator==(const HostsSource& other) const {
+      return source_type_ == other.source_type_ && locality_index_ == other.locality_index_;
+    }
+
+    SourceType source_type_{SourceType::AllHosts};
+    // Only used for LocalityHealthyHosts.
+    uint32_t locality_index_{};
+  };
+
+  struct HostsSourceHash {
+    size_t operator()(const HostsSource& hosts_source) const {
+      return (static_cast<size_t>(hosts_source.source_type_) << 32) |
+             hosts_source.locality_index_;
+    }
+  };
+
   /**
    * Pick the host list to use (healthy or all depending on how many in the set are not healthy).
    */
-  const std::vector<HostSharedPtr>& hostsToUse();
+  const std::vector<HostSharedPtr>& hostsToUse() { return hostSourceToHosts(hostSourceToUse()); }
+
+  /**
+   * Like hostsToUse(), but returns which host list to use rather than the list itself.
+   */
+  HostsSource hostSourceToUse();
+
+  /**
+   * @return the host list identified by hosts_source.
+   */
+  const std::vector<HostSharedPtr>& hostSourceToHosts(const HostsSource& hosts_source) const;
 
   ClusterStats& stats_;
   Runtime::Loader& runtime_;
   Runtime::RandomGenerator& random_;
+  // Runtime keys are registered once so that per pick lookups don't hash the key names.
+  const Runtime::Key zone_enabled_key_;
+  const Runtime::Key min_cluster_size_key_;
+  const Runtime::Key panic_threshold_key_;
 
   // TODO(alyssawilk) make load balancers priority-aware and remove.
 protected:
@@ -59,8 +110,9 @@ private:
 
   /**
    * Try to select upstream hosts from the same locality.
+   * @return the index of the locality in healthyHostsPerLocality() to pick a host from.
    */
-  const std::vector<HostSharedPtr>& tryChooseLocalLocalityHosts();
+  uint32_t tryChooseLocalLocalityHosts();
 
   /**
    * @return (number of hosts in a given locality)/(total number of hosts) in ret param.
@@ -83,48 +135,109 @@ private:
   Common::CallbackHandle* local_host_set_member_update_cb_handle_{};
 };
 
+/**
+ * Base class for the weighted round robin and least request load balancers. When the hosts of the
+ * host list being picked from do not all have the same weight, hosts are picked with an
+ * EdfScheduler, otherwise the derived class picks with unweightedHostPick().
+ *
+ * A scheduler is kept for each host list (all hosts, healthy hosts and the healthy hosts of each
+ * locality) of each priority whose hosts have unequal weights. The schedulers of a priority are
+ * rebuilt each time its host set changes, so picking stays O(log n) in the number of hosts.
+ * Weighted picking can be turned off with the upstream.weight_enabled runtime key.
+ */
+class EdfLoadBalancerBase : public LoadBalancer, protected LoadBalancerBase {
+public:
+  EdfLoadBalancerBase(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                      ClusterStats& stats, Runtime::Loader& runtime,
+                      Runtime::RandomGenerator& random);
+
+  // Upstream::LoadBalancer
+  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+
+protected:
+  /**
+   * Build the schedulers now and each time a host set changes. Must be called by derived
+   * constructors, since building calls hostWeight().
+   */
+  void initialize();
+
+private:
+  typedef std::unordered_map<HostsSource, EdfScheduler<Host>, HostsSourceHash> SchedulerMap;
+
+  void refresh(uint32_t priority);
+  void refreshSource(SchedulerMap& schedulers, const HostsSource& source,
+                     const std::vector<HostSharedPtr>& hosts);
+
+  /**
+   * @return double the weight of a host when it is added to a scheduler.
+   */
+  virtual double hostWeight(const Host& host) PURE;
+
+  /**
+   * Pick a host when the hosts of a source all have the same weight.
+   * @param hosts_to_use supplies the hosts of the source, which is never empty.
+   * @param source supplies the source.
+   */
+  virtual HostSharedPtr unweightedHostPick(const std::vector<HostSharedPtr>& hosts_to_use,
+                                           const HostsSource& source) PURE;
+
+  const PrioritySet& priority_set_;
+  const Runtime::Key weight_enabled_key_;
+  // Indexed by priority.
+  std::vector<SchedulerMap> schedulers_;
+};
+
 /**
  * Implementation of LoadBalancer that performs RR selection across the hosts in the cluster.
+ * Hosts with unequal weights are picked in proportion to their weights, interleaved smoothly.
  */
-class RoundRobinLoadBalancer : public LoadBalancer, LoadBalancerBase {
+class RoundRobinLoadBalancer : public EdfLoadBalancerBase {
 public:
   RoundRobinLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                          ClusterStats& stats, Runtime::Loader& runtime,
                          Runtime::RandomGenerator& random)
-      : LoadBalancerBase(priority_set, local_priority_set, stats, runtime, random) {}
-
-  // Upstream::LoadBalancer
-  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random) {
+    initialize();
+  }
 
 private:
+  // EdfLoadBalancerBase
+  double hostWeight(const Host& host) override { return host.weight(); }
+  HostSharedPtr unweightedHostPick(const std::vector<HostSharedPtr>& hosts_to_use,
+                                   const HostsSource&) override {
+    return hosts_to_use[rr_index_++ % hosts_to_use.size()];
+  }
+
   size_t rr_index_{};
 };
 
 /**
  * Weighted Least Request load balancer.
  *
- * In a normal setup when all hosts have the same weight of 1 it randomly picks up two healthy hosts
+ * In a normal setup when all hosts have the same weight it randomly picks up two healthy hosts
  * and compares number of active requests.
  * Technique is based on http://www.eecs.harvard.edu/~michaelm/postscripts/mythesis.pdf
  *
- * When any of the hosts have non 1 weight, apply random weighted balancing.
- * Randomly pickup the host and send 'weight' number of requests to it.
- * This technique is acceptable for load testing but
- * will not work well in situations where requests take a long time.
- * In that case a different algorithm using a full scan will be required.
+ * When the hosts have unequal weights, hosts are picked with an EdfScheduler. Each time a host is
+ * picked it is scheduled again with its weight divided by its number of active requests + 1, so
+ * hosts which are busy relative to their weight are picked less often.
  */
-class LeastRequestLoadBalancer : public LoadBalancer, LoadBalancerBase {
+class LeastRequestLoadBalancer : public EdfLoadBalancerBase {
 public:
   LeastRequestLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
                            ClusterStats& stats, Runtime::Loader& runtime,
-                           Runtime::RandomGenerator& random);
-
-  // Upstream::LoadBalancer
-  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+                           Runtime::RandomGenerator& random)
+      : EdfLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random) {
+    initialize();
+  }
 
 private:
-  HostSharedPtr last_host_;
-  uint32_t hits_left_{};
+  // EdfLoadBalancerBase
+  double hostWeight(const Host& host) override {
+    return static_cast<double>(host.weight()) / (host.stats().rq_active_.value() + 1);
+  }
+  HostSharedPtr unweightedHostPick(const std::vector<HostSharedPtr>& hosts_to_use,
+                                   const HostsSource& source) override;
 };
 
 /**
@@ -0,0 +1,104 @@
+#include "common/upstream/maglev_lb.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Upstream {
+
+MaglevLoadBalancer::MaglevLoadBalancer(PrioritySet& priority_set, ClusterStats& stats,
+                                       Runtime::Loader& runtime, Runtime::RandomGenerator& random)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, nullptr) {
+  refreshOnMemberUpdate([](const std::vector<HostSharedPtr>& hosts) {
+    return std::make_shared<const MaglevTable>(hosts);
+  });
+}
+
+MaglevLoadBalancer::MaglevLoadBalancer(PrioritySet& priority_set, ClusterStats& stats,
+                                       Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                                       TablesConstSharedPtr tables)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, std::move(tables)) {}
+
+ThreadAwareLoadBalancerBase::TablesConstSharedPtr
+MaglevLoadBalancer::buildMaglevTables(const PrioritySet& priority_set, ClusterStats& stats) {
+  return buildTables(priority_set, stats, [](const std::vector<HostSharedPtr>& hosts) {
+    return std::make_shared<const MaglevTable>(hosts);
+  });
+}
+
+uint64_t MaglevLoadBalancer::MaglevTable::tableSize(uint64_t num_hosts) {
+  static const uint64_t table_sizes[] = {65537, 655373, 6553621};
+  for (uint64_t table_size : table_sizes) {
+    if (num_hosts * 100 <= table_size) {
+      return table_size;
+    }
+  }
+
+  return table_sizes[sizeof(table_sizes) / sizeof(table_sizes[0]) - 1];
+}
+
+MaglevLoadBalancer::MaglevTable::MaglevTable(const std::vector<HostSharedPtr>& hosts,
+                                             uint64_t table_size) {
+  ENVOY_LOG(trace, "maglev: building table");
+  if (hosts.empty()) {
+    return;
+  }
+
+  if (table_size == 0) {
+    table_size = tableSize(hosts.size());
+  }
+  // Every host must be able to claim at least one slot.
+  RELEASE_ASSERT(hosts.size() < table_size);
+
+  // Each host visits the slots in the order offset, offset + skip, offset + 2 * skip, ... (mod
+  // table_size). Since table_size is prime and 0 < skip < table_size this is a permutation of all
+  // the slots.
+  struct Permutation {
+    uint64_t next_;
+    uint64_t skip_;
+  };
+  std::vector<Permutation> permutations;
+  permutations.reserve(hosts.size());
+  hosts_.reserve(hosts.size());
+  for (const auto& host : hosts) {
+    const std::string& address = host->address()->asString();
+    permutations.push_back({HashUtil::xxHash64(address) % table_size,
+                            HashUtil::xxHash64(address, 1) % (table_size - 1) + 1});
+    hosts_.push_back(host);
+  }
+
+  const uint32_t empty_slot = hosts.size();
+  table_.assign(table_size, empty_slot);
+  uint64_t filled = 0;
+  while (true) {
+    for (uint32_t i = 0; i < permutations.size(); i++) {
+      Permutation& permutation = permutations[i];
+      while (table_[permutation.next_] != empty_slot) {
+        permutation.next_ = (permutation.next_ + permutation.skip_) % table_size;
+      }
+
+      table_[permutation.next_] = i;
+      permutation.next_ = (permutation.next_ + permutation.skip_) % table_size;
+      if (++filled == table_size) {
+        ENVOY_LOG(debug, "maglev: table_size={} hosts={}", table_size, hosts.size());
+        return;
+      }
+    }
+  }
+}
+
+HostConstSharedPtr MaglevLoadBalancer::MaglevTable::chooseHost(uint64_t hash) const {
+  if (table_.empty()) {
+    return nullptr;
+  }
+
+  return hosts_[table_[hash % table_.size()]];
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/runtime/runtime.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "common/common/logger.h"
+#include "common/upstream/thread_aware_lb_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A load balancer that implements Maglev consistent hashing, see "Maglev: A Fast and Reliable
+ * Software Network Load Balancer" (https://research.google.com/pubs/pub44824.html). Each host
+ * derives a permutation of the slots of a prime sized lookup table from its address, and hosts take
+ * turns claiming their next preferred free slot until the table is full. Host selection is then a
+ * single table index, and a membership change only moves a small fraction of the slots. See
+ * ThreadAwareLoadBalancerBase for how tables are built and shared. Like the ring hash load
+ * balancer, host weights and zone aware routing are not currently supported.
+ */
+class MaglevLoadBalancer : public ThreadAwareLoadBalancerBase {
+public:
+  /**
+   * Construct a load balancer which builds its own tables each time the host set changes.
+   */
+  MaglevLoadBalancer(PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
+                     Runtime::RandomGenerator& random);
+
+  /**
+   * Construct a load balancer which uses tables built elsewhere (see buildMaglevTables()). The
+   * tables are not rebuilt when the host set changes; the owner is expected to call tables()
+   * instead.
+   */
+  MaglevLoadBalancer(PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
+                     Runtime::RandomGenerator& random, TablesConstSharedPtr tables);
+
+  /**
+   * Build the tables for the primary host set of a priority set.
+   */
+  static TablesConstSharedPtr buildMaglevTables(const PrioritySet& priority_set,
+                                                ClusterStats& stats);
+
+  class MaglevTable : public HashingTable, Logger::Loggable<Logger::Id::upstream> {
+  public:
+    /**
+     * @param hosts supplies the hosts to place in the table.
+     * @param table_size supplies the table size. It must be prime. If 0, a size is chosen based on
+     *        the number of hosts.
+     */
+    MaglevTable(const std::vector<HostSharedPtr>& hosts, uint64_t table_size = 0);
+
+    // ThreadAwareLoadBalancerBase::HashingTable
+    HostConstSharedPtr chooseHost(uint64_t hash) const override;
+
+    /**
+     * @return the number of slots in the table, or 0 if there are no hosts.
+     */
+    uint64_t size() const { return table_.size(); }
+
+    /**
+     * @return the smallest supported prime table size which gives each of num_hosts hosts at
+     *         least ~100 slots, so that the difference in slots owned by any two hosts stays
+     *         within ~1%.
+     */
+    static uint64_t tableSize(uint64_t num_hosts);
+
+  private:
+    // Indices into hosts_, so that each slot costs 4 bytes rather than a shared pointer.
+    std::vector<uint32_t> table_;
+    std::vector<HostConstSharedPtr> hosts_;
+  };
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -41,7 +41,7 @@ public:
 private:
   struct ResourceImpl : public Resource {
     ResourceImpl(uint64_t max, Runtime::Loader& runtime, const std::string& runtime_key)
-        : max_(max), runtime_(runtime), runtime_key_(runtime_key) {}
+        : max_(max), runtime_(runtime), runtime_key_(runtime.registerKey(runtime_key)) {}
     ~ResourceImpl() { ASSERT(current_ == 0); }
 
     // Upstream::Resource
@@ -56,7 +56,7 @@ private:
     const uint64_t max_;
     std::atomic<uint64_t> current_{};
     Runtime::Loader& runtime_;
-    const std::string runtime_key_;
+    const Runtime::Key runtime_key_;
   };
 
   ResourceImpl connections_;
@@ -1,6 +1,7 @@
 #include "common/upstream/ring_hash_lb.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -14,38 +15,31 @@ RingHashLoadBalancer::RingHashLoadBalancer(
     PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
     Runtime::RandomGenerator& random,
     const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config)
-    : host_set_(*priority_set.hostSetsPerPriority()[0]), stats_(stats), runtime_(runtime),
-      random_(random), config_(config) {
-  host_set_.addMemberUpdateCb([this](uint32_t, const std::vector<HostSharedPtr>&,
-                                     const std::vector<HostSharedPtr>&) -> void { refresh(); });
-
-  refresh();
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, nullptr) {
+  refreshOnMemberUpdate([&config](const std::vector<HostSharedPtr>& hosts) {
+    return std::make_shared<const Ring>(config, hosts);
+  });
 }
 
-HostConstSharedPtr RingHashLoadBalancer::chooseHost(LoadBalancerContext* context) {
-  if (LoadBalancerUtility::isGlobalPanic(host_set_, runtime_)) {
-    stats_.lb_healthy_panic_.inc();
-    return all_hosts_ring_.chooseHost(context, random_);
-  } else {
-    return healthy_hosts_ring_.chooseHost(context, random_);
-  }
+RingHashLoadBalancer::RingHashLoadBalancer(PrioritySet& priority_set, ClusterStats& stats,
+                                           Runtime::Loader& runtime,
+                                           Runtime::RandomGenerator& random,
+                                           TablesConstSharedPtr rings)
+    : ThreadAwareLoadBalancerBase(priority_set, stats, runtime, random, std::move(rings)) {}
+
+ThreadAwareLoadBalancerBase::TablesConstSharedPtr RingHashLoadBalancer::buildRings(
+    const PrioritySet& priority_set, ClusterStats& stats,
+    const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config) {
+  return buildTables(priority_set, stats, [&config](const std::vector<HostSharedPtr>& hosts) {
+    return std::make_shared<const Ring>(config, hosts);
+  });
 }
 
-HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(LoadBalancerContext* context,
-                                                          Runtime::RandomGenerator& random) {
+HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
   if (ring_.empty()) {
     return nullptr;
   }
 
-  // If there is no hash in the context, just choose a random value (this effectively becomes
-  // the random LB but it won't crash if someone configures it this way).
-  // computeHashKey() may be computed on demand, so get it only once.
-  Optional<uint64_t> hash;
-  if (context) {
-    hash = context->computeHashKey();
-  }
-  const uint64_t h = hash.valid() ? hash.value() : random.random();
-
   // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
   // I've generally kept the variable names to make the code easier to compare.
   // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
@@ -78,11 +72,10 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(LoadBalancerContext* c
   }
 }
 
-void RingHashLoadBalancer::Ring::create(
+RingHashLoadBalancer::Ring::Ring(
     const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
     const std::vector<HostSharedPtr>& hosts) {
   ENVOY_LOG(trace, "ring hash: building ring");
-  ring_.clear();
   if (hosts.empty()) {
     return;
   }
@@ -90,11 +83,6 @@ void RingHashLoadBalancer::Ring::create(
   // Currently we specify the minimum size of the ring, and determine the replication factor
   // based on the number of hosts. It's possible we might want to support more sophisticated
   // configuration in the future.
-  // NOTE: Currently we keep a ring for healthy hosts and unhealthy hosts, and this is done per
-  //       thread. This is the simplest implementation, but it's expensive from a memory
-  //       standpoint and duplicates the regeneration computation. In the future we might want
-  //       to generate the rings centrally and then just RCU them out to each thread. This is
-  //       sufficient for getting started.
   const uint64_t min_ring_size =
       config.valid() ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value(), minimum_ring_size, 1024)
                      : 1024;
@@ -114,9 +102,16 @@ void RingHashLoadBalancer::Ring::create(
       config.valid()
           ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.value().deprecated_v1(), use_std_hash, true)
           : true;
+  // The hash key of each ring entry is "<address>_<i>". Build the address part once per host and
+  // only rewrite the suffix, rather than formatting a new string for every entry.
+  std::string hash_key;
   for (const auto& host : hosts) {
+    hash_key = host->address()->asString();
+    hash_key.push_back('_');
+    const size_t suffix_start = hash_key.size();
     for (uint64_t i = 0; i < hashes_per_host; i++) {
-      const std::string hash_key(host->address()->asString() + "_" + std::to_string(i));
+      hash_key.resize(suffix_start);
+      hash_key.append(std::to_string(i));
       const uint64_t hash =
           use_std_hash ? std::hash<std::string>()(hash_key) : HashUtil::xxHash64(hash_key);
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
@@ -134,10 +129,5 @@ void RingHashLoadBalancer::Ring::create(
 #endif
 }
 
-void RingHashLoadBalancer::refresh() {
-  all_hosts_ring_.create(config_, host_set_.hosts());
-  healthy_hosts_ring_.create(config_, host_set_.healthyHosts());
-}
-
 } // namespace Upstream
 } // namespace Envoy
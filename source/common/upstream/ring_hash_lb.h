@@ -7,51 +7,60 @@
 #include "envoy/upstream/load_balancer.h"
 
 #include "common/common/logger.h"
+#include "common/upstream/thread_aware_lb_impl.h"
 
 namespace Envoy {
 namespace Upstream {
 
 /**
  * A load balancer that implements consistent modulo hashing ("ketama"). Currently, zone aware
- * routing is not supported. A ring is kept for all hosts as well as a ring for healthy hosts.
- * Unless we are in panic mode, the healthy host ring is used.
+ * routing is not supported. See ThreadAwareLoadBalancerBase for how rings are built and shared.
  * In the future it would be nice to support:
  * 1) Weighting.
  * 2) Per-zone rings and optional zone aware routing (not all applications will want this).
  * 3) Max request fallback to support hot shards (not all applications will want this).
  */
-class RingHashLoadBalancer : public LoadBalancer, Logger::Loggable<Logger::Id::upstream> {
+class RingHashLoadBalancer : public ThreadAwareLoadBalancerBase {
 public:
+  /**
+   * Construct a load balancer which builds its own rings each time the host set changes.
+   */
   RingHashLoadBalancer(PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
                        Runtime::RandomGenerator& random,
                        const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config);
 
-  // Upstream::LoadBalancer
-  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+  /**
+   * Construct a load balancer which uses rings built elsewhere (see buildRings()). The rings are
+   * not rebuilt when the host set changes; the owner is expected to call tables() instead.
+   */
+  RingHashLoadBalancer(PrioritySet& priority_set, ClusterStats& stats, Runtime::Loader& runtime,
+                       Runtime::RandomGenerator& random, TablesConstSharedPtr rings);
 
-private:
-  struct RingEntry {
-    uint64_t hash_;
-    HostConstSharedPtr host_;
-  };
+  /**
+   * Build the rings for the primary host set of a priority set.
+   */
+  static TablesConstSharedPtr
+  buildRings(const PrioritySet& priority_set, ClusterStats& stats,
+             const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config);
 
-  struct Ring {
-    HostConstSharedPtr chooseHost(LoadBalancerContext* context, Runtime::RandomGenerator& random);
-    void create(const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
-                const std::vector<HostSharedPtr>& hosts);
+  class Ring : public HashingTable, Logger::Loggable<Logger::Id::upstream> {
+  public:
+    Ring(const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
+         const std::vector<HostSharedPtr>& hosts);
 
-    std::vector<RingEntry> ring_;
-  };
+    // ThreadAwareLoadBalancerBase::HashingTable
+    HostConstSharedPtr chooseHost(uint64_t hash) const override;
 
-  void refresh();
+    size_t size() const { return ring_.size(); }
 
-  HostSet& host_set_;
-  ClusterStats& stats_;
-  Runtime::Loader& runtime_;
-  Runtime::RandomGenerator& random_;
-  const Optional<envoy::api::v2::Cluster::RingHashLbConfig>& config_;
-  Ring all_hosts_ring_;
-  Ring healthy_hosts_ring_;
+  private:
+    struct RingEntry {
+      uint64_t hash_;
+      HostConstSharedPtr host_;
+    };
+
+    std::vector<RingEntry> ring_;
+  };
 };
 
 } // namespace Upstream
@@ -9,6 +9,7 @@
 #include "common/config/well_known_names.h"
 #include "common/protobuf/utility.h"
 #include "common/upstream/load_balancer_impl.h"
+#include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 
 #include "api/cds.pb.h"
@@ -349,6 +350,11 @@ void SubsetLoadBalancer::LbSubsetEntry::initLoadBalancer(const SubsetLoadBalance
                                        subset_lb.random_, subset_lb.lb_ring_hash_config_));
     break;
 
+  case LoadBalancerType::Maglev:
+    lb_.reset(new MaglevLoadBalancer(*priority_subset_, subset_lb.stats_, subset_lb.runtime_,
+                                     subset_lb.random_));
+    break;
+
   case LoadBalancerType::OriginalDst:
     NOT_REACHED;
   }
@@ -0,0 +1,73 @@
+#include "common/upstream/thread_aware_lb_impl.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/stats/timespan.h"
+
+#include "common/upstream/load_balancer_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+ThreadAwareLoadBalancerBase::ThreadAwareLoadBalancerBase(PrioritySet& priority_set,
+                                                         ClusterStats& stats,
+                                                         Runtime::Loader& runtime,
+                                                         Runtime::RandomGenerator& random,
+                                                         TablesConstSharedPtr tables)
+    : host_set_(*priority_set.hostSetsPerPriority()[0]), stats_(stats), runtime_(runtime),
+      random_(random),
+      panic_threshold_key_(LoadBalancerUtility::registerPanicThresholdKey(runtime)),
+      tables_(std::move(tables)) {}
+
+ThreadAwareLoadBalancerBase::TablesConstSharedPtr
+ThreadAwareLoadBalancerBase::buildTables(const PrioritySet& priority_set, ClusterStats& stats,
+                                         const TableBuilder& builder) {
+  const HostSet& host_set = *priority_set.hostSetsPerPriority()[0];
+  Stats::Timespan build_time(stats.lb_hash_table_build_ms_);
+  TablesConstSharedPtr tables(
+      new Tables{builder(host_set.hosts()), builder(host_set.healthyHosts())});
+  build_time.complete();
+  stats.lb_hash_table_rebuilds_.inc();
+  return tables;
+}
+
+void ThreadAwareLoadBalancerBase::refreshOnMemberUpdate(TableBuilder builder) {
+  builder_ = std::move(builder);
+  host_set_.addMemberUpdateCb([this](uint32_t, const std::vector<HostSharedPtr>&,
+                                     const std::vector<HostSharedPtr>&) -> void { refresh(); });
+
+  refresh();
+}
+
+void ThreadAwareLoadBalancerBase::refresh() {
+  tables_.reset(new Tables{builder_(host_set_.hosts()), builder_(host_set_.healthyHosts())});
+}
+
+HostConstSharedPtr ThreadAwareLoadBalancerBase::chooseHost(LoadBalancerContext* context) {
+  if (tables_ == nullptr) {
+    return nullptr;
+  }
+
+  const HashingTable& table = [this]() -> const HashingTable& {
+    if (LoadBalancerUtility::isGlobalPanic(host_set_, runtime_, panic_threshold_key_)) {
+      stats_.lb_healthy_panic_.inc();
+      return *tables_->all_hosts_table_;
+    } else {
+      return *tables_->healthy_hosts_table_;
+    }
+  }();
+
+  // If there is no hash in the context, just choose a random value (this effectively becomes
+  // the random LB but it won't crash if someone configures it this way).
+  // computeHashKey() may be computed on demand, so get it only once.
+  Optional<uint64_t> hash;
+  if (context) {
+    hash = context->computeHashKey();
+  }
+  return table.chooseHost(hash.valid() ? hash.value() : random_.random());
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/runtime/runtime.h"
+#include "envoy/upstream/load_balancer.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Base class for consistent hashing load balancers (ring hash, maglev) whose lookup tables are
+ * expensive to build. A table is kept for all hosts as well as for healthy hosts. Unless we are in
+ * panic mode, the healthy hosts table is used.
+ *
+ * Tables are immutable once built. A load balancer either builds its own tables each time the host
+ * set changes (this is what subset load balancers do), or is handed tables which were built once on
+ * the main thread and are shared read only by every worker (this is what the cluster manager does,
+ * see ClusterManagerImpl::postThreadLocalClusterUpdate()).
+ */
+class ThreadAwareLoadBalancerBase : public LoadBalancer, Logger::Loggable<Logger::Id::upstream> {
+public:
+  /**
+   * Immutable host lookup table.
+   */
+  class HashingTable {
+  public:
+    virtual ~HashingTable() {}
+
+    /**
+     * @return the host for a hash value or nullptr if the table is empty.
+     */
+    virtual HostConstSharedPtr chooseHost(uint64_t hash) const PURE;
+  };
+
+  typedef std::shared_ptr<const HashingTable> HashingTableConstSharedPtr;
+  typedef std::function<HashingTableConstSharedPtr(const std::vector<HostSharedPtr>& hosts)>
+      TableBuilder;
+
+  /**
+   * The all hosts and healthy hosts tables of a host set.
+   */
+  struct Tables {
+    const HashingTableConstSharedPtr all_hosts_table_;
+    const HashingTableConstSharedPtr healthy_hosts_table_;
+  };
+
+  typedef std::shared_ptr<const Tables> TablesConstSharedPtr;
+
+  /**
+   * Build the tables for the primary host set of a priority set and record the build time.
+   * @param priority_set supplies the priority set. Only priority 0 is used.
+   * @param stats supplies the cluster stats used to record the build.
+   * @param builder supplies the table builder.
+   * @return TablesConstSharedPtr the new tables.
+   */
+  static TablesConstSharedPtr buildTables(const PrioritySet& priority_set, ClusterStats& stats,
+                                          const TableBuilder& builder);
+
+  /**
+   * Replace the tables in use.
+   */
+  void tables(TablesConstSharedPtr tables) { tables_ = std::move(tables); }
+
+  // Upstream::LoadBalancer
+  HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
+
+protected:
+  ThreadAwareLoadBalancerBase(PrioritySet& priority_set, ClusterStats& stats,
+                              Runtime::Loader& runtime, Runtime::RandomGenerator& random,
+                              TablesConstSharedPtr tables);
+
+  /**
+   * Build tables now and each time the primary host set changes. Must be called by derived
+   * classes that are not handed tables built elsewhere.
+   */
+  void refreshOnMemberUpdate(TableBuilder builder);
+
+  HostSet& host_set_;
+  ClusterStats& stats_;
+  Runtime::Loader& runtime_;
+  Runtime::RandomGenerator& random_;
+  const Runtime::Key panic_threshold_key_;
+
+private:
+  void refresh();
+
+  TableBuilder builder_;
+  TablesConstSharedPtr tables_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
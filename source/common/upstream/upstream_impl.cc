@@ -2,9 +2,11 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -48,6 +50,43 @@ getSourceAddress(const envoy::api::v2::Cluster& cluster,
   // If there's no source address in the cluster config, use any default from the bootstrap proto.
   return source_address;
 }
+
+/**
+ * Hashes an address by its binary IP address and port, so that hosts can be matched by address
+ * without hashing their string form. Pipes are hashed by path.
+ */
+struct AddressHash {
+  size_t operator()(const Network::Address::Instance* address) const {
+    const Network::Address::Ip* ip = address->ip();
+    if (ip == nullptr) {
+      return std::hash<std::string>()(address->asString());
+    }
+
+    uint64_t high = 0;
+    uint64_t low;
+    if (ip->version() == Network::Address::IpVersion::v4) {
+      low = ip->ipv4()->address();
+    } else {
+      const std::array<uint8_t, 16> bytes = ip->ipv6()->address();
+      memcpy(&high, &bytes[0], sizeof(high));
+      memcpy(&low, &bytes[8], sizeof(low));
+    }
+    // Mix the parts with the 64 bit golden ratio so that addresses which only differ in a few
+    // bits (e.g. consecutive addresses in a subnet) are spread across buckets.
+    const uint64_t mix = 0x9e3779b97f4a7c15ULL;
+    uint64_t hash = (high * mix) ^ low;
+    hash = (hash * mix) ^ ip->port();
+    return hash * mix;
+  }
+};
+
+struct AddressEqual {
+  bool operator()(const Network::Address::Instance* lhs,
+                  const Network::Address::Instance* rhs) const {
+    return *lhs == *rhs;
+  }
+};
+
 } // namespace
 
 Host::CreateConnectionData HostImpl::createConnection(Event::Dispatcher& dispatcher) const {
@@ -138,6 +177,9 @@ ClusterInfoImpl::ClusterInfoImpl(const envoy::api::v2::Cluster& config,
     }
     lb_type_ = LoadBalancerType::OriginalDst;
     break;
+  case MaglevLbPolicy:
+    lb_type_ = LoadBalancerType::Maglev;
+    break;
   default:
     NOT_REACHED;
   }
@@ -380,12 +422,10 @@ void ClusterImplBase::reloadHealthyHosts() {
     return;
   }
 
+  // Only health changed, so the host lists are kept and only the healthy lists are rebuilt.
   for (auto& host_set : prioritySet().hostSetsPerPriority()) {
-    HostVectorConstSharedPtr hosts_copy(new std::vector<HostSharedPtr>(host_set->hosts()));
-    HostListsConstSharedPtr hosts_per_locality_copy(
-        new std::vector<std::vector<HostSharedPtr>>(host_set->hostsPerLocality()));
-    host_set->updateHosts(hosts_copy, createHealthyHostList(host_set->hosts()),
-                          hosts_per_locality_copy,
+    host_set->updateHosts(host_set->hostsPtr(), createHealthyHostList(host_set->hosts()),
+                          host_set->hostsPerLocalityPtr(),
                           createHealthyHostLists(host_set->hostsPerLocality()), {}, {});
   }
 }
@@ -481,43 +521,47 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const std::vector<HostSharedP
                                                    std::vector<HostSharedPtr>& hosts_removed,
                                                    bool depend_on_hc) {
   uint64_t max_host_weight = 1;
+  bool weights_changed = false;
 
   // Go through and see if the list we have is different from what we just got. If it is, we
-  // make a new host list and raise a change notification. This uses an N^2 search given that
-  // this does not happen very often and the list sizes should be small. We also check for
-  // duplicates here. It's possible for DNS to return the same address multiple times, and a bad
-  // SDS implementation could do the same thing.
-  std::unordered_set<std::string> host_addresses;
+  // make a new host list and raise a change notification. Clusters can have many thousands of
+  // hosts, so the current hosts are indexed by address and the diff is linear in the size of the
+  // two lists. We also check for duplicates here. It's possible for DNS to return the same address
+  // multiple times, and a bad SDS implementation could do the same thing.
+  std::unordered_map<const Network::Address::Instance*, size_t, AddressHash, AddressEqual>
+      current_hosts_by_address;
+  current_hosts_by_address.reserve(current_hosts.size());
+  for (size_t i = 0; i < current_hosts.size(); ++i) {
+    current_hosts_by_address.emplace(current_hosts[i]->address().get(), i);
+  }
+  std::vector<bool> current_host_kept(current_hosts.size());
+
+  std::unordered_set<const Network::Address::Instance*, AddressHash, AddressEqual>
+      host_addresses;
+  host_addresses.reserve(new_hosts.size());
   std::vector<HostSharedPtr> final_hosts;
+  final_hosts.reserve(new_hosts.size());
   for (const HostSharedPtr& host : new_hosts) {
-    if (host_addresses.count(host->address()->asString())) {
+    if (!host_addresses.insert(host->address().get()).second) {
       continue;
     }
-    host_addresses.emplace(host->address()->asString());
-
-    bool found = false;
-    for (auto i = current_hosts.begin(); i != current_hosts.end();) {
-      // If we find a host matched based on address, we keep it. However we do change weight inline
-      // so do that here.
-      if (*(*i)->address() == *host->address()) {
-        if (host->weight() > max_host_weight) {
-          max_host_weight = host->weight();
-        }
 
-        (*i)->weight(host->weight());
-        final_hosts.push_back(*i);
-        i = current_hosts.erase(i);
-        found = true;
-      } else {
-        i++;
-      }
+    if (host->weight() > max_host_weight) {
+      max_host_weight = host->weight();
     }
 
-    if (!found) {
-      if (host->weight() > max_host_weight) {
-        max_host_weight = host->weight();
+    auto existing = current_hosts_by_address.find(host->address().get());
+    if (existing != current_hosts_by_address.end()) {
+      // If we find a host matched based on address, we keep it. However we do change weight inline
+      // so do that here.
+      const HostSharedPtr& current_host = current_hosts[existing->second];
+      if (current_host->weight() != host->weight()) {
+        current_host->weight(host->weight());
+        weights_changed = true;
       }
-
+      final_hosts.push_back(current_host);
+      current_host_kept[existing->second] = true;
+    } else {
       final_hosts.push_back(host);
       hosts_added.push_back(host);
 
@@ -529,33 +573,30 @@ bool BaseDynamicClusterImpl::updateDynamicHostList(const std::vector<HostSharedP
   }
 
   // If there are removed hosts, check to see if we should only delete if unhealthy.
-  if (!current_hosts.empty() && depend_on_hc) {
-    for (auto i = current_hosts.begin(); i != current_hosts.end();) {
-      if (!(*i)->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
-        if ((*i)->weight() > max_host_weight) {
-          max_host_weight = (*i)->weight();
-        }
+  for (size_t i = 0; i < current_hosts.size(); ++i) {
+    if (current_host_kept[i]) {
+      continue;
+    }
 
-        final_hosts.push_back(*i);
-        i = current_hosts.erase(i);
-      } else {
-        i++;
+    HostSharedPtr& host = current_hosts[i];
+    if (depend_on_hc && !host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
+      if (host->weight() > max_host_weight) {
+        max_host_weight = host->weight();
       }
+
+      final_hosts.push_back(std::move(host));
+    } else {
+      hosts_removed.push_back(std::move(host));
     }
   }
 
   info_->stats().max_host_weight_.set(max_host_weight);
 
-  if (!hosts_added.empty() || !current_hosts.empty()) {
-    hosts_removed = std::move(current_hosts);
-    current_hosts = std::move(final_hosts);
-    return true;
-  } else {
-    // During the search we moved all of the hosts from hosts_ into final_hosts so just
-    // move them back.
-    current_hosts = std::move(final_hosts);
-    return false;
-  }
+  current_hosts = std::move(final_hosts);
+
+  // A weight change is reported as a change with no hosts added or removed, so that load
+  // balancers which schedule by weight see the new weights.
+  return !hosts_added.empty() || !hosts_removed.empty() || weights_changed;
 }
 
 StrictDnsClusterImpl::StrictDnsClusterImpl(const envoy::api::v2::Cluster& cluster,
@@ -200,6 +200,12 @@ public:
   const std::vector<std::vector<HostSharedPtr>>& healthyHostsPerLocality() const override {
     return *healthy_hosts_per_locality_;
   }
+  HostVectorConstSharedPtr hostsPtr() const override { return hosts_; }
+  HostVectorConstSharedPtr healthyHostsPtr() const override { return healthy_hosts_; }
+  HostListsConstSharedPtr hostsPerLocalityPtr() const override { return hosts_per_locality_; }
+  HostListsConstSharedPtr healthyHostsPerLocalityPtr() const override {
+    return healthy_hosts_per_locality_;
+  }
   Common::CallbackHandle* addMemberUpdateCb(MemberUpdateCb callback) const override {
     return member_update_cb_helper_.add(callback);
   }
@@ -0,0 +1,48 @@
+#include "server/config/access_log/binary_file_access_log.h"
+
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/access_log/access_log_impl.h"
+#include "common/access_log/binary_access_log_format.h"
+#include "common/config/well_known_names.h"
+#include "common/protobuf/protobuf.h"
+
+#include "api/filter/accesslog/accesslog.pb.validate.h"
+#include "fmt/format.h"
+
+namespace Envoy {
+namespace Server {
+namespace Configuration {
+
+AccessLog::InstanceSharedPtr BinaryFileAccessLogFactory::createAccessLogInstance(
+    const Protobuf::Message& config, AccessLog::FilterPtr&& filter, FactoryContext& context) {
+  const auto& fal_config =
+      MessageUtil::downcastAndValidate<const envoy::api::v2::filter::accesslog::FileAccessLog&>(
+          config);
+  if (!fal_config.format().empty()) {
+    throw EnvoyException(
+        fmt::format("{}: format is not supported", Config::AccessLogNames::get().BINARY_FILE));
+  }
+
+  AccessLog::FormatterPtr formatter{new AccessLog::BinaryFormatter()};
+  return AccessLog::InstanceSharedPtr{new AccessLog::FileAccessLog(
+      fal_config.path(), std::move(filter), std::move(formatter), context.accessLogManager())};
+}
+
+ProtobufTypes::MessagePtr BinaryFileAccessLogFactory::createEmptyConfigProto() {
+  return ProtobufTypes::MessagePtr{new envoy::api::v2::filter::accesslog::FileAccessLog()};
+}
+
+std::string BinaryFileAccessLogFactory::name() const {
+  return Config::AccessLogNames::get().BINARY_FILE;
+}
+
+/**
+ * Static registration for the binary file access log. @see RegisterFactory.
+ */
+static Registry::RegisterFactory<BinaryFileAccessLogFactory, AccessLogInstanceFactory> register_;
+
+} // namespace Configuration
+} // namespace Server
+} // namespace Envoy
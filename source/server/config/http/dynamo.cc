@@ -12,9 +12,11 @@ namespace Configuration {
 
 HttpFilterFactoryCb DynamoFilterConfig::createFilter(const std::string& stat_prefix,
                                                      FactoryContext& context) {
-  return [&context, stat_prefix](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+  Dynamo::DynamoStatsSharedPtr stats(
+      new Dynamo::DynamoStats(stat_prefix, context.scope(), context.threadLocal()));
+  return [&context, stat_prefix, stats](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(Http::StreamFilterSharedPtr{
-        new Dynamo::DynamoFilter(context.runtime(), stat_prefix, context.scope())});
+        new Dynamo::DynamoFilter(context.runtime(), stat_prefix, context.scope(), stats)});
   };
 }
 
@@ -12,9 +12,11 @@ namespace Server {
 namespace Configuration {
 
 HttpFilterFactoryCb IpTaggingFilterConfig::createFilterFactory(const Json::Object& json_config,
-                                                               const std::string&,
-                                                               FactoryContext&) {
-  Http::IpTaggingFilterConfigSharedPtr config(new Http::IpTaggingFilterConfig(json_config));
+                                                               const std::string& stat_prefix,
+                                                               FactoryContext& context) {
+  Http::IpTaggingFilterConfigSharedPtr config(
+      new Http::IpTaggingFilterConfig(json_config, stat_prefix, context.scope(),
+                                      context.dispatcher(), context.threadLocal()));
   return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamDecoderFilter(
         Http::StreamDecoderFilterSharedPtr{new Http::IpTaggingFilter(config)});
@@ -121,6 +121,7 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
       route_config_provider_manager_(route_config_provider_manager),
       http2_settings_(Http::Utility::parseHttp2Settings(config.http2_protocol_options())),
       http1_settings_(Http::Utility::parseHttp1Settings(config.http_protocol_options())),
+      fast_request_parser_key_(context_.runtime().registerKey("http.http1.fast_request_parser")),
       drain_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, drain_timeout, 5000)),
       generate_request_id_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, generate_request_id, true)),
       date_provider_(date_provider),
@@ -251,7 +252,7 @@ HttpConnectionManagerConfig::createCodec(Network::Connection& connection,
   switch (codec_type_) {
   case CodecType::HTTP1:
     return Http::ServerConnectionPtr{
-        new Http::Http1::ServerConnectionImpl(connection, callbacks, http1_settings_)};
+        new Http::Http1::ServerConnectionImpl(connection, callbacks, http1Settings())};
   case CodecType::HTTP2:
     return Http::ServerConnectionPtr{new Http::Http2::ServerConnectionImpl(
         connection, callbacks, context_.scope(), http2_settings_)};
@@ -262,13 +263,20 @@ HttpConnectionManagerConfig::createCodec(Network::Connection& connection,
           connection, callbacks, context_.scope(), http2_settings_)};
     } else {
       return Http::ServerConnectionPtr{
-          new Http::Http1::ServerConnectionImpl(connection, callbacks, http1_settings_)};
+          new Http::Http1::ServerConnectionImpl(connection, callbacks, http1Settings())};
     }
   }
 
   NOT_REACHED;
 }
 
+Http::Http1Settings HttpConnectionManagerConfig::http1Settings() {
+  Http::Http1Settings settings = http1_settings_;
+  settings.fast_request_parser_ =
+      context_.runtime().snapshot().featureEnabled(fast_request_parser_key_, 0);
+  return settings;
+}
+
 void HttpConnectionManagerConfig::createFilterChain(Http::FilterChainFactoryCallbacks& callbacks) {
   for (const HttpFilterFactoryCb& factory : filter_factories_) {
     factory(callbacks);
@@ -102,6 +102,12 @@ public:
 private:
   enum class CodecType { HTTP1, HTTP2, AUTO };
 
+  /**
+   * @return Http::Http1Settings the configured settings, with the runtime controlled ones for a
+   *         new connection.
+   */
+  Http::Http1Settings http1Settings();
+
   FactoryContext& context_;
   std::list<HttpFilterFactoryCb> filter_factories_;
   std::list<AccessLog::InstanceSharedPtr> access_logs_;
@@ -115,6 +121,7 @@ private:
   CodecType codec_type_;
   const Http::Http2Settings http2_settings_;
   const Http::Http1Settings http1_settings_;
+  const Runtime::Key fast_request_parser_key_;
   std::string server_name_;
   Http::TracingConnectionManagerConfigPtr tracing_config_;
   Optional<std::string> user_agent_;
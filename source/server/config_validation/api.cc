@@ -5,8 +5,9 @@
 namespace Envoy {
 namespace Api {
 
-ValidationImpl::ValidationImpl(std::chrono::milliseconds file_flush_interval_msec)
-    : Impl(file_flush_interval_msec) {}
+ValidationImpl::ValidationImpl(std::chrono::milliseconds file_flush_interval_msec,
+                               Filesystem::WriteOverflowPolicy file_overflow_policy)
+    : Impl(file_flush_interval_msec, file_overflow_policy) {}
 
 Event::DispatcherPtr ValidationImpl::allocateDispatcher() {
   return Event::DispatcherPtr{new Event::ValidationDispatcher()};
@@ -14,7 +14,9 @@ namespace Api {
  */
 class ValidationImpl : public Impl {
 public:
-  ValidationImpl(std::chrono::milliseconds file_flush_interval_msec);
+  ValidationImpl(std::chrono::milliseconds file_flush_interval_msec,
+                 Filesystem::WriteOverflowPolicy file_overflow_policy =
+                     Filesystem::WriteOverflowPolicy::Spill);
 
   Event::DispatcherPtr allocateDispatcher() override;
 };
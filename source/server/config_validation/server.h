@@ -100,13 +100,17 @@ public:
     // validation mock.
     return nullptr;
   }
+  Network::ListenSocketSharedPtr
+  createReusePortListenSocket(Network::Address::InstanceConstSharedPtr, uint32_t) override {
+    return nullptr;
+  }
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType) override {
     return nullptr;
   }
   uint64_t nextListenerTag() override { return 0; }
 
   // Server::WorkerFactory
-  WorkerPtr createWorker() override {
+  WorkerPtr createWorker(uint32_t) override {
     // Returned workers are not currently used so we can return nothing here safely vs. a
     // validation mock.
     return nullptr;
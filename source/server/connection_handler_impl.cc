@@ -5,11 +5,18 @@
 #include "envoy/network/filter.h"
 #include "envoy/stats/timespan.h"
 
+#include "fmt/format.h"
+
 namespace Envoy {
 namespace Server {
 
 ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher)
-    : logger_(logger), dispatcher_(dispatcher) {}
+    : logger_(logger), dispatcher_(dispatcher), per_handler_stat_prefix_("main_thread.") {}
+
+ConnectionHandlerImpl::ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                                             uint32_t worker_index)
+    : logger_(logger), dispatcher_(dispatcher),
+      per_handler_stat_prefix_(fmt::format("worker_{}.", worker_index)) {}
 
 void ConnectionHandlerImpl::addListener(Network::FilterChainFactory& factory,
                                         Network::ListenSocket& socket, Stats::Scope& scope,
@@ -76,7 +83,8 @@ ConnectionHandlerImpl::ActiveListener::ActiveListener(ConnectionHandlerImpl& par
                                                       Network::FilterChainFactory& factory,
                                                       Stats::Scope& scope, uint64_t listener_tag)
     : parent_(parent), factory_(factory), listener_(std::move(listener)),
-      stats_(generateStats(scope)), listener_tag_(listener_tag) {}
+      stats_(generateStats(scope)), per_handler_stats_(parent.generatePerHandlerStats(scope)),
+      listener_tag_(listener_tag) {}
 
 ConnectionHandlerImpl::ActiveListener::~ActiveListener() {
   while (!connections_.empty()) {
@@ -155,11 +163,14 @@ ConnectionHandlerImpl::ActiveConnection::ActiveConnection(ActiveListener& listen
   connection_->addConnectionCallbacks(*this);
   listener_.stats_.downstream_cx_total_.inc();
   listener_.stats_.downstream_cx_active_.inc();
+  listener_.per_handler_stats_.downstream_cx_total_.inc();
+  listener_.per_handler_stats_.downstream_cx_active_.inc();
 }
 
 ConnectionHandlerImpl::ActiveConnection::~ActiveConnection() {
   listener_.stats_.downstream_cx_active_.dec();
   listener_.stats_.downstream_cx_destroy_.inc();
+  listener_.per_handler_stats_.downstream_cx_active_.dec();
   conn_length_->complete();
 }
 
@@ -167,5 +178,10 @@ ListenerStats ConnectionHandlerImpl::generateStats(Stats::Scope& scope) {
   return {ALL_LISTENER_STATS(POOL_COUNTER(scope), POOL_GAUGE(scope), POOL_HISTOGRAM(scope))};
 }
 
+PerHandlerListenerStats ConnectionHandlerImpl::generatePerHandlerStats(Stats::Scope& scope) {
+  return {ALL_PER_HANDLER_LISTENER_STATS(POOL_COUNTER_PREFIX(scope, per_handler_stat_prefix_),
+                                         POOL_GAUGE_PREFIX(scope, per_handler_stat_prefix_))};
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <string>
 
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
@@ -37,6 +38,23 @@ struct ListenerStats {
   ALL_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
+/**
+ * Listener stats kept by each connection handler, which show how connections are spread across
+ * workers. @see stats_macros.h
+ */
+// clang-format off
+#define ALL_PER_HANDLER_LISTENER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(downstream_cx_total)                                                                     \
+  GAUGE  (downstream_cx_active)
+// clang-format on
+
+/**
+ * Wrapper struct for per handler listener stats. @see stats_macros.h
+ */
+struct PerHandlerListenerStats {
+  ALL_PER_HANDLER_LISTENER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
 /**
  * Server side connection handler. This is used both by workers as well as the
  * main thread for non-threaded listeners.
@@ -45,6 +63,13 @@ class ConnectionHandlerImpl : public Network::ConnectionHandler, NonCopyable {
 public:
   ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher);
 
+  /**
+   * @param worker_index supplies the index of the worker the handler runs on. Per handler stats
+   *        are prefixed with "worker_<index>.", or with "main_thread." for handlers without one.
+   */
+  ConnectionHandlerImpl(spdlog::logger& logger, Event::Dispatcher& dispatcher,
+                        uint32_t worker_index);
+
   // Network::ConnectionHandler
   uint64_t numConnections() override { return num_connections_; }
   void addListener(Network::FilterChainFactory& factory, Network::ListenSocket& socket,
@@ -92,6 +117,7 @@ private:
     Network::FilterChainFactory& factory_;
     Network::ListenerPtr listener_;
     ListenerStats stats_;
+    PerHandlerListenerStats per_handler_stats_;
     std::list<ActiveConnectionPtr> connections_;
     const uint64_t listener_tag_;
   };
@@ -131,9 +157,11 @@ private:
   };
 
   static ListenerStats generateStats(Stats::Scope& scope);
+  PerHandlerListenerStats generatePerHandlerStats(Stats::Scope& scope);
 
   spdlog::logger& logger_;
   Event::Dispatcher& dispatcher_;
+  const std::string per_handler_stat_prefix_;
   std::list<std::pair<Network::Address::InstanceConstSharedPtr, ActiveListenerPtr>> listeners_;
   std::atomic<uint64_t> num_connections_{};
 };
@@ -5,8 +5,10 @@
 #include <sys/types.h>
 #include <sys/un.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
+#include <unordered_set>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/file_event.h"
@@ -14,8 +16,10 @@
 #include "envoy/server/options.h"
 
 #include "common/api/os_sys_calls_impl.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/network/utility.h"
+#include "common/ssl/session_cache_impl.h"
 
 #include "fmt/format.h"
 
@@ -24,13 +28,16 @@ namespace Server {
 
 // Increment this whenever there is a shared memory / RPC change that will prevent a hot restart
 // from working. Operations code can then cope with this and do a full restart.
-const uint64_t SharedMemory::VERSION = 9;
+const uint64_t SharedMemory::VERSION = 12;
 
 SharedMemory& SharedMemory::initialize(Options& options) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
 
+  // Slots are referenced by 32 bit indices in the stat index.
+  RELEASE_ASSERT(options.maxStats() < UINT32_MAX);
   const uint64_t entry_size = Stats::RawStatData::size();
-  const uint64_t total_size = sizeof(SharedMemory) + (entry_size * options.maxStats());
+  const uint64_t total_size =
+      totalSize(options.maxStats(), entry_size, options.sslSessionCacheSize());
 
   int flags = O_RDWR;
   const std::string shmem_name = fmt::format("/envoy_shared_memory_{}", options.baseId());
@@ -63,6 +70,8 @@ SharedMemory& SharedMemory::initialize(Options& options) {
     shmem->version_ = VERSION;
     shmem->num_stats_ = options.maxStats();
     shmem->entry_size_ = entry_size;
+    shmem->ssl_session_cache_size_ = options.sslSessionCacheSize();
+    shmem->initializeStatIndex();
     shmem->initializeMutex(shmem->log_lock_);
     shmem->initializeMutex(shmem->access_log_lock_);
     shmem->initializeMutex(shmem->stat_lock_);
@@ -72,6 +81,7 @@ SharedMemory& SharedMemory::initialize(Options& options) {
     RELEASE_ASSERT(shmem->version_ == VERSION);
     RELEASE_ASSERT(shmem->num_stats_ == options.maxStats());
     RELEASE_ASSERT(shmem->entry_size_ == entry_size);
+    RELEASE_ASSERT(shmem->ssl_session_cache_size_ == options.sslSessionCacheSize());
   }
 
   // Stats::RawStatData must be naturally aligned for atomics to work properly.
@@ -99,19 +109,57 @@ void SharedMemory::initializeMutex(pthread_mutex_t& mutex) {
   pthread_mutex_init(&mutex, &attribute);
 }
 
-std::string SharedMemory::version(size_t max_num_stats, size_t max_stat_name_len) {
-  return fmt::format("{}.{}.{}.{}", VERSION, sizeof(SharedMemory), max_num_stats,
-                     max_stat_name_len);
+uint64_t SharedMemory::indexSize(uint64_t max_num_stats) {
+  uint64_t index_size = 1;
+  while (index_size < max_num_stats * 2) {
+    index_size <<= 1;
+  }
+  return index_size;
+}
+
+uint64_t SharedMemory::totalSize(uint64_t max_num_stats, uint64_t entry_size,
+                                 uint64_t ssl_session_cache_size) {
+  uint64_t total_size = sizeof(SharedMemory) + (entry_size * max_num_stats) +
+                        (sizeof(uint32_t) * (indexSize(max_num_stats) + max_num_stats));
+  if (ssl_session_cache_size > 0) {
+    // Leave room to align the cache.
+    total_size += sizeof(uint64_t) + Ssl::SessionCacheImpl::size(ssl_session_cache_size);
+  }
+  return total_size;
+}
+
+void SharedMemory::initializeStatIndex() {
+  index_size_ = indexSize(num_stats_);
+  index_used_ = 0;
+  memset(statIndex(), 0, sizeof(uint32_t) * index_size_);
+
+  // Push the slots in reverse so that they are handed out in order.
+  num_free_slots_ = 0;
+  for (uint64_t slot = num_stats_; slot > 0; slot--) {
+    freeSlots()[num_free_slots_++] = slot - 1;
+  }
+}
+
+std::string SharedMemory::version(uint64_t max_num_stats, uint64_t max_stat_name_len,
+                                  uint64_t ssl_session_cache_size) {
+  return fmt::format("{}.{}.{}.{}.{}", VERSION, sizeof(SharedMemory), max_num_stats,
+                     max_stat_name_len, ssl_session_cache_size);
 }
 
 std::string SharedMemory::version() {
-  return version(num_stats_, Stats::RawStatData::maxNameLength());
+  return version(num_stats_, Stats::RawStatData::maxNameLength(), ssl_session_cache_size_);
 }
 
 HotRestartImpl::HotRestartImpl(Options& options)
     : options_(options), shmem_(SharedMemory::initialize(options)), log_lock_(shmem_.log_lock_),
       access_log_lock_(shmem_.access_log_lock_), stat_lock_(shmem_.stat_lock_),
       init_lock_(shmem_.init_lock_) {
+  if (shmem_.ssl_session_cache_size_ > 0) {
+    // Sessions written by earlier generations are kept, so their clients can still resume.
+    ssl_session_cache_.reset(new Ssl::SessionCacheImpl(shmem_.sslSessionCacheMemory(),
+                                                       shmem_.ssl_session_cache_size_));
+  }
+
   my_domain_socket_ = bindDomainSocket(options.restartEpoch());
   child_address_ = createDomainSocketAddress((options.restartEpoch() + 1));
   initDomainSocketAddress(&parent_address_);
@@ -127,26 +175,55 @@ HotRestartImpl::HotRestartImpl(Options& options)
 }
 
 Stats::RawStatData* HotRestartImpl::alloc(const std::string& name) {
-  // Try to find the existing slot in shared memory, otherwise allocate a new one.
-  Stats::RawStatData* unused = nullptr;
+  // Look up the name in the stat index, which is an open addressing hash table with linear probing
+  // kept in shared memory, so that all processes see the same stats. Stats are keyed on their
+  // possibly truncated names.
+  const std::string key = name.substr(0, Stats::RawStatData::maxNameLength());
+  const uint64_t hash = HashUtil::xxHash64(key);
+  const uint64_t mask = shmem_.index_size_ - 1;
+  uint32_t* index = shmem_.statIndex();
+  uint32_t* insert_bucket = nullptr;
+
   std::unique_lock<Thread::BasicLockable> lock(stat_lock_);
-  for (uint64_t i = 0; i < shmem_.num_stats_; i++) {
-    const size_t offset = shmem_.entry_size_ * i;
-    Stats::RawStatData* data = reinterpret_cast<Stats::RawStatData*>(shmem_.stats_slots_ + offset);
-    if (!data->initialized()) {
-      unused = data;
-    } else if (data->matches(name)) {
-      data->ref_count_++;
-      return data;
+  for (uint64_t i = hash & mask;; i = (i + 1) & mask) {
+    const uint32_t bucket = index[i];
+    if (bucket == SharedMemory::EMPTY_BUCKET) {
+      if (insert_bucket == nullptr) {
+        insert_bucket = &index[i];
+      }
+      break;
+    } else if (bucket == SharedMemory::DELETED_BUCKET) {
+      if (insert_bucket == nullptr) {
+        insert_bucket = &index[i];
+      }
+    } else {
+      Stats::RawStatData& data = shmem_.statSlot(bucket - 1);
+      if (data.matches(key)) {
+        data.ref_count_++;
+        return &data;
+      }
     }
   }
 
-  if (unused != nullptr) {
-    unused->initialize(name);
-    return unused;
+  if (shmem_.num_free_slots_ == 0) {
+    return nullptr;
+  }
+
+  const uint32_t slot = shmem_.freeSlots()[--shmem_.num_free_slots_];
+  Stats::RawStatData& data = shmem_.statSlot(slot);
+  data.initialize(name);
+  if (*insert_bucket == SharedMemory::EMPTY_BUCKET) {
+    shmem_.index_used_++;
+  }
+  *insert_bucket = slot + 1;
+
+  // Deleted buckets are only reclaimed by inserts that happen to probe them. If they build up to
+  // the point where misses need long probes, rebuild the index from the used slots.
+  if (shmem_.index_used_ * 4 > shmem_.index_size_ * 3) {
+    rebuildStatIndex();
   }
 
-  return nullptr;
+  return &data;
 }
 
 void HotRestartImpl::free(Stats::RawStatData& data) {
@@ -157,7 +234,39 @@ void HotRestartImpl::free(Stats::RawStatData& data) {
     return;
   }
 
+  const uint64_t slot = shmem_.slotIndex(data);
+  const uint64_t mask = shmem_.index_size_ - 1;
+  uint32_t* index = shmem_.statIndex();
+  for (uint64_t i = HashUtil::xxHash64(data.name_) & mask;; i = (i + 1) & mask) {
+    ASSERT(index[i] != SharedMemory::EMPTY_BUCKET);
+    if (index[i] == slot + 1) {
+      index[i] = SharedMemory::DELETED_BUCKET;
+      break;
+    }
+  }
+
   memset(&data, 0, Stats::RawStatData::size());
+  shmem_.freeSlots()[shmem_.num_free_slots_++] = slot;
+}
+
+void HotRestartImpl::rebuildStatIndex() {
+  const uint64_t mask = shmem_.index_size_ - 1;
+  uint32_t* index = shmem_.statIndex();
+  memset(index, 0, sizeof(uint32_t) * shmem_.index_size_);
+  shmem_.index_used_ = 0;
+  for (uint64_t slot = 0; slot < shmem_.num_stats_; slot++) {
+    Stats::RawStatData& data = shmem_.statSlot(slot);
+    if (!data.initialized()) {
+      continue;
+    }
+
+    uint64_t i = HashUtil::xxHash64(data.name_) & mask;
+    while (index[i] != SharedMemory::EMPTY_BUCKET) {
+      i = (i + 1) & mask;
+    }
+    index[i] = slot + 1;
+    shmem_.index_used_++;
+  }
 }
 
 int HotRestartImpl::bindDomainSocket(uint64_t id) {
@@ -207,7 +316,9 @@ void HotRestartImpl::drainParentListeners() {
   shmem_.flags_ &= ~SharedMemory::Flags::INITIALIZING;
 }
 
-int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
+int HotRestartImpl::duplicateParentListenSocket(const std::string& address,
+                                                uint32_t worker_index, uint32_t& parent_sockets) {
+  parent_sockets = 0;
   if (options_.restartEpoch() == 0 || parent_terminated_) {
     return -1;
   }
@@ -215,9 +326,11 @@ int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
   RpcGetListenSocketRequest rpc;
   ASSERT(address.length() < sizeof(rpc.address_));
   StringUtil::strlcpy(rpc.address_, address.c_str(), sizeof(rpc.address_));
+  rpc.worker_index_ = worker_index;
   sendMessage(parent_address_, rpc);
   RpcGetListenSocketReply* reply =
       receiveTypedRpc<RpcGetListenSocketReply, RpcMessageType::GetListenSocketReply>();
+  parent_sockets = reply->num_sockets_;
   return reply->fd_;
 }
 
@@ -349,7 +462,22 @@ void HotRestartImpl::onGetListenSocket(RpcGetListenSocketRequest& rpc) {
       Network::Utility::resolveUrl(std::string(rpc.address_));
   for (const auto& listener : server_->listenerManager().listeners()) {
     if (*listener.get().socket().localAddress() == *addr) {
-      reply.fd_ = listener.get().socket().fd();
+      // If this process has fewer workers than the child, the child binds new sockets for the
+      // rest of its workers.
+      Network::ListenSocket* socket = listener.get().workerSocket(rpc.worker_index_);
+      if (socket != nullptr) {
+        reply.fd_ = socket->fd();
+      }
+
+      // The child refuses to start if it would leave some of our SO_REUSEPORT sockets behind.
+      std::unordered_set<Network::ListenSocket*> sockets;
+      for (uint32_t i = 0; i < std::max(1U, options_.concurrency()); i++) {
+        socket = listener.get().workerSocket(i);
+        if (socket != nullptr) {
+          sockets.insert(socket);
+        }
+      }
+      reply.num_sockets_ = sockets.size();
       break;
     }
   }
@@ -24,7 +24,8 @@ namespace Server {
 class SharedMemory {
 public:
   static void configure(size_t max_num_stats, size_t max_stat_name_len);
-  static std::string version(uint64_t max_num_stats, uint64_t max_stat_name_len);
+  static std::string version(uint64_t max_num_stats, uint64_t max_stat_name_len,
+                             uint64_t ssl_session_cache_size);
   std::string version();
 
 private:
@@ -48,12 +49,59 @@ private:
    */
   void initializeMutex(pthread_mutex_t& mutex);
 
+  /**
+   * @return the number of buckets in the stat index for a given number of stats. This is a power
+   *         of two at least twice the number of stats, so that the index is never more than half
+   *         full of live entries.
+   */
+  static uint64_t indexSize(uint64_t max_num_stats);
+
+  /**
+   * @return the total size of the shared memory segment.
+   */
+  static uint64_t totalSize(uint64_t max_num_stats, uint64_t entry_size,
+                            uint64_t ssl_session_cache_size);
+
+  /**
+   * Initialize the stat index and free slot stack of a newly created segment.
+   */
+  void initializeStatIndex();
+
+  Stats::RawStatData& statSlot(uint64_t slot) {
+    return *reinterpret_cast<Stats::RawStatData*>(stats_slots_ + entry_size_ * slot);
+  }
+
+  uint64_t slotIndex(const Stats::RawStatData& data) {
+    return (reinterpret_cast<const uint8_t*>(&data) - stats_slots_) / entry_size_;
+  }
+
+  // The stat index follows the stat slots. Each bucket holds EMPTY_BUCKET, DELETED_BUCKET or the
+  // index of a used stat slot plus one.
+  uint32_t* statIndex() {
+    return reinterpret_cast<uint32_t*>(stats_slots_ + entry_size_ * num_stats_);
+  }
+
+  // The free slot stack follows the stat index.
+  uint32_t* freeSlots() { return statIndex() + index_size_; }
+
+  // The TLS session cache, if any, follows the free slot stack, aligned to 8 bytes.
+  uint8_t* sslSessionCacheMemory() {
+    const uintptr_t end = reinterpret_cast<uintptr_t>(freeSlots() + num_stats_);
+    return reinterpret_cast<uint8_t*>((end + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1));
+  }
+
   static const uint64_t VERSION;
+  static const uint32_t EMPTY_BUCKET = 0;
+  static const uint32_t DELETED_BUCKET = UINT32_MAX;
 
   uint64_t size_;
   uint64_t version_;
   uint64_t num_stats_;
   uint64_t entry_size_;
+  uint64_t index_size_;
+  uint64_t index_used_; // buckets which are not EMPTY_BUCKET
+  uint64_t num_free_slots_;
+  uint64_t ssl_session_cache_size_;
   std::atomic<uint64_t> flags_;
   pthread_mutex_t log_lock_;
   pthread_mutex_t access_log_lock_;
@@ -61,7 +109,8 @@ private:
   pthread_mutex_t init_lock_;
   alignas(Stats::RawStatData) uint8_t
       stats_slots_[]; // array of Stats::RawStatData, which has a flexible-array-length member
-                      // so non-fixed size
+                      // so non-fixed size. It is followed by the stat index and the free slot
+                      // stack, both arrays of uint32_t, and then the TLS session cache.
 
   friend class HotRestartImpl;
 };
@@ -122,13 +171,15 @@ public:
 
   // Server::HotRestart
   void drainParentListeners() override;
-  int duplicateParentListenSocket(const std::string& address) override;
+  int duplicateParentListenSocket(const std::string& address, uint32_t worker_index,
+                                  uint32_t& parent_sockets) override;
   void getParentStats(GetParentStatsInfo& info) override;
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server) override;
   void shutdownParentAdmin(ShutdownParentAdminInfo& info) override;
   void terminateParent() override;
   void shutdown() override;
   std::string version() override;
+  Ssl::SessionCache* sslSessionCache() override { return ssl_session_cache_.get(); }
 
   // RawStatDataAllocator
   Stats::RawStatData* alloc(const std::string& name) override;
@@ -159,12 +210,14 @@ private:
     RpcGetListenSocketRequest() : RpcBase(RpcMessageType::GetListenSocketRequest, sizeof(*this)) {}
 
     char address_[256]{0};
+    uint32_t worker_index_{0};
   } __attribute__((packed));
 
   struct RpcGetListenSocketReply : public RpcBase {
     RpcGetListenSocketReply() : RpcBase(RpcMessageType::GetListenSocketReply, sizeof(*this)) {}
 
     int fd_{0};
+    uint32_t num_sockets_{0};
   } __attribute__((packed));
 
   struct RpcShutdownAdminReply : public RpcBase {
@@ -191,6 +244,7 @@ private:
   int bindDomainSocket(uint64_t id);
   void initDomainSocketAddress(sockaddr_un* address);
   sockaddr_un createDomainSocketAddress(uint64_t id);
+  void rebuildStatIndex();
   void onGetListenSocket(RpcGetListenSocketRequest& rpc);
   void onSocketEvent();
   RpcBase* receiveRpc(bool block);
@@ -202,6 +256,7 @@ private:
   ProcessSharedMutex access_log_lock_;
   ProcessSharedMutex stat_lock_;
   ProcessSharedMutex init_lock_;
+  Ssl::SessionCachePtr ssl_session_cache_;
   int my_domain_socket_{-1};
   sockaddr_un parent_address_;
   sockaddr_un child_address_;
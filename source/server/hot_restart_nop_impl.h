@@ -15,13 +15,18 @@ public:
   HotRestartNopImpl(){};
 
   void drainParentListeners() override {}
-  int duplicateParentListenSocket(const std::string&) override { return -1; }
+  int duplicateParentListenSocket(const std::string&, uint32_t,
+                                  uint32_t& parent_sockets) override {
+    parent_sockets = 0;
+    return -1;
+  }
   void getParentStats(GetParentStatsInfo& info) override { memset(&info, 0, sizeof(info)); }
   void initialize(Event::Dispatcher&, Server::Instance&) override {}
   void shutdownParentAdmin(ShutdownParentAdminInfo&) override {}
   void terminateParent() override {}
   void shutdown() override {}
   std::string version() override { return "disabled"; }
+  Ssl::SessionCache* sslSessionCache() override { return nullptr; }
 };
 
 } // namespace Server
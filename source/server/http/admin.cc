@@ -283,8 +283,8 @@ Http::Code AdminImpl::handlerServerInfo(const std::string&, Buffer::Instance& re
 }
 
 Http::Code AdminImpl::handlerStats(const std::string& url, Buffer::Instance& response) {
-  // We currently don't support timers locally (only via statsd) so just group all the counters
-  // and gauges together, alpha sort them, and spit them out.
+  // Group all the counters and gauges together, alpha sort them, and spit them out. Histograms
+  // follow in the plain text format as quantile summaries.
   Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
   std::map<std::string, uint64_t> all_stats;
@@ -301,6 +301,14 @@ Http::Code AdminImpl::handlerStats(const std::string& url, Buffer::Instance& res
     for (auto stat : all_stats) {
       response.add(fmt::format("{}: {}\n", stat.first, stat.second));
     }
+
+    std::map<std::string, std::string> all_histograms;
+    for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
+      all_histograms.emplace(histogram->name(), histogramSummary(*histogram));
+    }
+    for (auto histogram : all_histograms) {
+      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
+    }
   } else {
     const std::string format_key = params.begin()->first;
     const std::string format_value = params.begin()->second;
@@ -317,6 +325,25 @@ Http::Code AdminImpl::handlerStats(const std::string& url, Buffer::Instance& res
   return rc;
 }
 
+std::string AdminImpl::histogramSummary(const Stats::ParentHistogram& histogram) {
+  // Each quantile is shown as P<quantile>(<interval value>,<cumulative value>), where the interval
+  // is the last stats flush interval.
+  const Stats::HistogramStatistics& interval = histogram.intervalStatistics();
+  const Stats::HistogramStatistics& cumulative = histogram.cumulativeStatistics();
+  if (cumulative.sampleCount() == 0) {
+    return "No recorded values";
+  }
+
+  std::vector<std::string> summary;
+  const std::vector<double>& quantiles = cumulative.supportedQuantiles();
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    summary.push_back(fmt::format("P{:g}({:.1f},{:.1f})", 100 * quantiles[i],
+                                  interval.computedQuantiles()[i],
+                                  cumulative.computedQuantiles()[i]));
+  }
+  return StringUtil::join(summary, " ");
+}
+
 std::string AdminImpl::sanitizePrometheusName(const std::string& name) {
   std::string stats_name = name;
   std::replace(stats_name.begin(), stats_name.end(), '.', '_');
@@ -1,9 +1,14 @@
 #include "server/listener_manager_impl.h"
 
+#include <unistd.h>
+
+#include <algorithm>
+
 #include "envoy/registry/registry.h"
 
 #include "common/common/assert.h"
 #include "common/config/utility.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/listen_socket_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
@@ -56,7 +61,9 @@ ProdListenerComponentFactory::createListenSocket(Network::Address::InstanceConst
   // TODO(mattklein123): UDS support.
   ASSERT(address->type() == Network::Address::Type::Ip);
   const std::string addr = fmt::format("tcp://{}", address->asString());
-  const int fd = server_.hotRestart().duplicateParentListenSocket(addr);
+  uint32_t parent_sockets{};
+  const int fd = server_.hotRestart().duplicateParentListenSocket(addr, 0, parent_sockets);
+  checkParentSockets(addr, fd, parent_sockets, 1);
   if (fd != -1) {
     ENVOY_LOG(debug, "obtained socket for address {} from parent", addr);
     return std::make_shared<Network::TcpListenSocket>(fd, address);
@@ -65,6 +72,41 @@ ProdListenerComponentFactory::createListenSocket(Network::Address::InstanceConst
   }
 }
 
+Network::ListenSocketSharedPtr ProdListenerComponentFactory::createReusePortListenSocket(
+    Network::Address::InstanceConstSharedPtr address, uint32_t worker_index) {
+  // As above, the parent's socket for the same worker is used if it has one. Otherwise another
+  // socket joins the SO_REUSEPORT group of the address, which fails if the address is already
+  // bound by a socket without SO_REUSEPORT.
+  ASSERT(address->type() == Network::Address::Type::Ip);
+  const std::string addr = fmt::format("tcp://{}", address->asString());
+  uint32_t parent_sockets{};
+  const int fd =
+      server_.hotRestart().duplicateParentListenSocket(addr, worker_index, parent_sockets);
+  checkParentSockets(addr, fd, parent_sockets, std::max(1U, server_.options().concurrency()));
+  if (fd != -1) {
+    ENVOY_LOG(debug, "obtained socket for address {} worker {} from parent", addr, worker_index);
+    return std::make_shared<Network::TcpListenSocket>(fd, address);
+  } else {
+    return std::make_shared<Network::TcpListenSocket>(address, true, true);
+  }
+}
+
+void ProdListenerComponentFactory::checkParentSockets(const std::string& address, int fd,
+                                                      uint32_t parent_sockets, uint32_t sockets) {
+  // Sockets in the parent's SO_REUSEPORT group which we don't take over keep getting new
+  // connections from the kernel, but nobody accepts them once the parent stops listening.
+  if (parent_sockets > sockets) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+    throw EnvoyException(fmt::format(
+        "cannot hot restart listener on {}: the parent has {} SO_REUSEPORT sockets for it and this "
+        "process would take over {}. Use --listener-reuse-port with at least as many workers as "
+        "the parent, or do a full restart.",
+        address, parent_sockets, sockets));
+  }
+}
+
 DrainManagerPtr
 ProdListenerComponentFactory::createDrainManager(envoy::api::v2::Listener::DrainType drain_type) {
   return DrainManagerPtr{new DrainManagerImpl(server_, drain_type)};
@@ -86,6 +128,8 @@ ListenerImpl::ListenerImpl(const envoy::api::v2::Listener& config, ListenerManag
       use_original_dst_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, use_original_dst, false)),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
+      connection_balancer_(parent_.balance_connections_ ? new Network::ConnectionBalancerImpl()
+                                                        : nullptr),
       listener_tag_(parent_.factory_.nextListenerTag()), name_(name),
       workers_started_(workers_started), hash_(hash),
       local_drain_manager_(parent.factory_.createDrainManager(config.drain_type())) {
@@ -184,17 +228,29 @@ Init::Manager& ListenerImpl::initManager() {
   }
 }
 
-void ListenerImpl::setSocket(const Network::ListenSocketSharedPtr& socket) {
-  ASSERT(!socket_);
-  socket_ = socket;
+void ListenerImpl::setSockets(const std::vector<Network::ListenSocketSharedPtr>& sockets) {
+  ASSERT(sockets_.empty());
+  ASSERT(!sockets.empty());
+  sockets_ = sockets;
+}
+
+Network::ListenSocket* ListenerImpl::workerSocket(uint32_t worker_index) {
+  if (sockets_.size() == 1) {
+    return sockets_[0].get();
+  }
+  return worker_index < sockets_.size() ? sockets_[worker_index].get() : nullptr;
 }
 
 ListenerManagerImpl::ListenerManagerImpl(Instance& server,
                                          ListenerComponentFactory& listener_factory,
                                          WorkerFactory& worker_factory)
-    : server_(server), factory_(listener_factory), stats_(generateStats(server.stats())) {
+    : server_(server), factory_(listener_factory),
+      reuse_port_(server.options().listenerReusePort()),
+      accept_batch_size_(server.options().listenerAcceptBatchSize()),
+      balance_connections_(server.options().listenerBalanceConnections()),
+      stats_(generateStats(server.stats())) {
   for (uint32_t i = 0; i < std::max(1U, server.options().concurrency()); i++) {
-    workers_.emplace_back(worker_factory.createWorker());
+    workers_.emplace_back(worker_factory.createWorker(i));
   }
 }
 
@@ -251,12 +307,12 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // In this case we can just replace inline.
     ASSERT(workers_started_);
     new_listener->debugLog("update warming listener");
-    new_listener->setSocket((*existing_warming_listener)->getSocket());
+    new_listener->setSockets((*existing_warming_listener)->getSockets());
     *existing_warming_listener = std::move(new_listener);
   } else if (existing_active_listener != active_listeners_.end()) {
     // In this case we have no warming listener, so what we do depends on whether workers
     // have been started or not. Either way we get the socket from the existing listener.
-    new_listener->setSocket((*existing_active_listener)->getSocket());
+    new_listener->setSockets((*existing_active_listener)->getSockets());
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -285,20 +341,15 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
     // to see if there is a listener that has a socket bound to the address we are configured for.
     // This is an edge case, but may happen if a listener is removed and then added back with a same
     // or different name and intended to listen on the same address. This should work and not fail.
-    Network::ListenSocketSharedPtr draining_listener_socket;
     auto existing_draining_listener = std::find_if(
         draining_listeners_.cbegin(), draining_listeners_.cend(),
         [&new_listener](const DrainingListener& listener) {
           return *new_listener->address() == *listener.listener_->socket().localAddress();
         });
-    if (existing_draining_listener != draining_listeners_.cend()) {
-      draining_listener_socket = existing_draining_listener->listener_->getSocket();
-    }
 
-    new_listener->setSocket(
-        draining_listener_socket
-            ? draining_listener_socket
-            : factory_.createListenSocket(new_listener->address(), new_listener->bindToPort()));
+    new_listener->setSockets(existing_draining_listener != draining_listeners_.cend()
+                                 ? existing_draining_listener->listener_->getSockets()
+                                 : createListenSockets(*new_listener));
     if (workers_started_) {
       new_listener->debugLog("add warming listener");
       warming_listeners_.emplace_back(std::move(new_listener));
@@ -321,6 +372,27 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::api::v2::Listener& co
   return true;
 }
 
+std::vector<Network::ListenSocketSharedPtr>
+ListenerManagerImpl::createListenSockets(ListenerImpl& listener) {
+  if (!reuse_port_ || !listener.bindToPort()) {
+    return {factory_.createListenSocket(listener.address(), listener.bindToPort())};
+  }
+
+  // Each worker accepts on a SO_REUSEPORT socket of its own, and the kernel spreads connections
+  // across them by hash, instead of waking workers which then race to accept from one socket.
+  std::vector<Network::ListenSocketSharedPtr> sockets;
+  Network::Address::InstanceConstSharedPtr address = listener.address();
+  for (uint32_t i = 0; i < workers_.size(); i++) {
+    sockets.push_back(factory_.createReusePortListenSocket(address, i));
+    // If the first socket bound port zero, the others bind the port it was given. Config
+    // validation creates no sockets.
+    if (i == 0 && sockets[0] != nullptr) {
+      address = sockets[0]->localAddress();
+    }
+  }
+  return sockets;
+}
+
 bool ListenerManagerImpl::hasListenerWithAddress(const ListenerList& list,
                                                  const Network::Address::Instance& address) {
   for (const auto& listener : list) {
@@ -39,10 +39,24 @@ public:
   }
   Network::ListenSocketSharedPtr
   createListenSocket(Network::Address::InstanceConstSharedPtr address, bool bind_to_port) override;
+  Network::ListenSocketSharedPtr
+  createReusePortListenSocket(Network::Address::InstanceConstSharedPtr address,
+                              uint32_t worker_index) override;
   DrainManagerPtr createDrainManager(envoy::api::v2::Listener::DrainType drain_type) override;
   uint64_t nextListenerTag() override { return next_listener_tag_++; }
 
 private:
+  /**
+   * Refuse to take over a parent's listener which has more sockets than we would take. Closes
+   * fd, if any, before throwing.
+   * @param address supplies the address of the listener.
+   * @param fd supplies the socket obtained from the parent, or -1.
+   * @param parent_sockets supplies the number of sockets the parent's listener has.
+   * @param sockets supplies the number of sockets this process creates for the listener.
+   */
+  void checkParentSockets(const std::string& address, int fd, uint32_t parent_sockets,
+                          uint32_t sockets);
+
   Instance& server_;
   uint64_t next_listener_tag_{1};
 };
@@ -106,6 +120,7 @@ private:
   };
 
   void addListenerToWorker(Worker& worker, ListenerImpl& listener);
+  std::vector<Network::ListenSocketSharedPtr> createListenSockets(ListenerImpl& listener);
   static ListenerManagerStats generateStats(Stats::Scope& scope);
   static bool hasListenerWithAddress(const ListenerList& list,
                                      const Network::Address::Instance& address);
@@ -143,6 +158,9 @@ private:
   // and any remaining connections are closed.
   std::list<DrainingListener> draining_listeners_;
   std::list<WorkerPtr> workers_;
+  const bool reuse_port_;
+  const uint32_t accept_batch_size_;
+  const bool balance_connections_;
   bool workers_started_{};
   ListenerManagerStats stats_;
 };
@@ -183,16 +201,17 @@ public:
   }
 
   Network::Address::InstanceConstSharedPtr address() const { return address_; }
-  const Network::ListenSocketSharedPtr& getSocket() const { return socket_; }
+  const std::vector<Network::ListenSocketSharedPtr>& getSockets() const { return sockets_; }
   uint64_t hash() const { return hash_; }
   void debugLog(const std::string& message);
   void initialize();
   DrainManager& localDrainManager() const { return *local_drain_manager_; }
-  void setSocket(const Network::ListenSocketSharedPtr& socket);
+  void setSockets(const std::vector<Network::ListenSocketSharedPtr>& sockets);
 
   // Server::Listener
   Network::FilterChainFactory& filterChainFactory() override { return *this; }
-  Network::ListenSocket& socket() override { return *socket_; }
+  Network::ListenSocket& socket() override { return *sockets_[0]; }
+  Network::ListenSocket* workerSocket(uint32_t worker_index) override;
   bool bindToPort() override { return bind_to_port_; }
   Ssl::ServerContext* defaultSslContext() override {
     return tls_contexts_.empty() ? nullptr : tls_contexts_[0].get();
@@ -200,6 +219,8 @@ public:
   bool useProxyProto() override { return use_proxy_proto_; }
   bool useOriginalDst() override { return use_original_dst_; }
   uint32_t perConnectionBufferLimitBytes() override { return per_connection_buffer_limit_bytes_; }
+  uint32_t acceptBatchSize() override { return parent_.accept_batch_size_; }
+  Network::ConnectionBalancer* connectionBalancer() override { return connection_balancer_.get(); }
   Stats::Scope& listenerScope() override { return *listener_scope_; }
   uint64_t listenerTag() override { return listener_tag_; }
   const std::string& name() const override { return name_; }
@@ -235,7 +256,8 @@ public:
 private:
   ListenerManagerImpl& parent_;
   Network::Address::InstanceConstSharedPtr address_;
-  Network::ListenSocketSharedPtr socket_;
+  // Either a single socket which all workers share, or a SO_REUSEPORT socket for each worker.
+  std::vector<Network::ListenSocketSharedPtr> sockets_;
   Stats::ScopePtr global_scope_;   // Stats with global named scope, but needed for LDS cleanup.
   Stats::ScopePtr listener_scope_; // Stats with listener named scope.
   std::vector<Ssl::ServerContextPtr> tls_contexts_;
@@ -243,6 +265,8 @@ private:
   const bool use_proxy_proto_;
   const bool use_original_dst_;
   const uint32_t per_connection_buffer_limit_bytes_;
+  // Shared by the listeners of all workers, which unregister from it before it is destroyed.
+  const Network::ConnectionBalancerPtr connection_balancer_;
   const uint64_t listener_tag_;
   const std::string name_;
   const bool workers_started_;
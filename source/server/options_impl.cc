@@ -73,6 +73,10 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
   TCLAP::ValueArg<uint32_t> file_flush_interval_msec("", "file-flush-interval-msec",
                                                      "Interval for log flushing in msec", false,
                                                      10000, "uint32_t", cmd);
+  TCLAP::ValueArg<std::string> file_overflow_policy(
+      "", "file-overflow-policy",
+      "What to do with log writes when flushing falls behind (spill, block, drop or sample)",
+      false, "spill", "string", cmd);
   TCLAP::ValueArg<uint32_t> drain_time_s("", "drain-time-s", "Hot restart drain time in seconds",
                                          false, 600, "uint32_t", cmd);
   TCLAP::ValueArg<uint32_t> parent_shutdown_time_s("", "parent-shutdown-time-s",
@@ -92,6 +96,25 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
                                              " the cluster name)",
                                              false, ENVOY_DEFAULT_MAX_OBJ_NAME_LENGTH, "uint64_t",
                                              cmd);
+  TCLAP::ValueArg<uint64_t> ssl_session_cache_size(
+      "", "ssl-session-cache-size",
+      "Number of TLS sessions kept in a session cache shared by all listeners and workers, and "
+      "by hot restarted processes (0 keeps a separate cache per listener).",
+      false, 0, "uint64_t", cmd);
+  TCLAP::SwitchArg listener_reuse_port(
+      "", "listener-reuse-port",
+      "Give each worker a SO_REUSEPORT socket of its own for each listener, so the kernel spreads "
+      "new connections evenly across workers. A hot restart must also use this option, with at "
+      "least as many workers",
+      cmd, false);
+  TCLAP::ValueArg<uint32_t> listener_accept_batch_size(
+      "", "listener-accept-batch-size",
+      "Maximum number of connections a listener accepts each time its socket becomes readable "
+      "(0 accepts until the accept queue is empty)",
+      false, 0, "uint32_t", cmd);
+  TCLAP::SwitchArg listener_balance_connections(
+      "", "listener-balance-connections",
+      "Hand each accepted connection to the worker which has the fewest connections", cmd, false);
 
   cmd.setExceptionHandling(false);
   try {
@@ -121,7 +144,8 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
   if (hot_restart_version_option.getValue()) {
     std::cerr << hot_restart_version_cb(max_stats.getValue(),
                                         max_obj_name_len.getValue() +
-                                            Stats::RawStatData::maxStatSuffixLength());
+                                            Stats::RawStatData::maxStatSuffixLength(),
+                                        ssl_session_cache_size.getValue());
     throw NoServingException();
   }
 
@@ -153,6 +177,21 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
     throw MalformedArgvException(message);
   }
 
+  if (file_overflow_policy.getValue() == "spill") {
+    file_overflow_policy_ = Filesystem::WriteOverflowPolicy::Spill;
+  } else if (file_overflow_policy.getValue() == "block") {
+    file_overflow_policy_ = Filesystem::WriteOverflowPolicy::Block;
+  } else if (file_overflow_policy.getValue() == "drop") {
+    file_overflow_policy_ = Filesystem::WriteOverflowPolicy::Drop;
+  } else if (file_overflow_policy.getValue() == "sample") {
+    file_overflow_policy_ = Filesystem::WriteOverflowPolicy::Sample;
+  } else {
+    const std::string message =
+        fmt::format("error: unknown file overflow policy '{}'", file_overflow_policy.getValue());
+    std::cerr << message << std::endl;
+    throw MalformedArgvException(message);
+  }
+
   // For base ID, scale what the user inputs by 10 so that we have spread for domain sockets.
   base_id_ = base_id.getValue() * 10;
   concurrency_ = concurrency.getValue();
@@ -169,5 +208,9 @@ OptionsImpl::OptionsImpl(int argc, char** argv, const HotRestartVersionCb& hot_r
   parent_shutdown_time_ = std::chrono::seconds(parent_shutdown_time_s.getValue());
   max_stats_ = max_stats.getValue();
   max_obj_name_length_ = max_obj_name_len.getValue();
+  ssl_session_cache_size_ = ssl_session_cache_size.getValue();
+  listener_reuse_port_ = listener_reuse_port.getValue();
+  listener_accept_batch_size_ = listener_accept_batch_size.getValue();
+  listener_balance_connections_ = listener_balance_connections.getValue();
 }
 } // namespace Envoy
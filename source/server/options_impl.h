@@ -15,7 +15,7 @@ namespace Envoy {
  */
 class OptionsImpl : public Server::Options {
 public:
-  typedef std::function<std::string(uint64_t, uint64_t)> HotRestartVersionCb;
+  typedef std::function<std::string(uint64_t, uint64_t, uint64_t)> HotRestartVersionCb;
 
   /**
    * @throw NoServingException if Envoy has already done everything specified by the argv (e.g.
@@ -41,11 +41,16 @@ public:
   uint64_t restartEpoch() override { return restart_epoch_; }
   Server::Mode mode() const override { return mode_; }
   std::chrono::milliseconds fileFlushIntervalMsec() override { return file_flush_interval_msec_; }
+  Filesystem::WriteOverflowPolicy fileOverflowPolicy() override { return file_overflow_policy_; }
   const std::string& serviceClusterName() override { return service_cluster_; }
   const std::string& serviceNodeName() override { return service_node_; }
   const std::string& serviceZone() override { return service_zone_; }
   uint64_t maxStats() override { return max_stats_; }
   uint64_t maxObjNameLength() override { return max_obj_name_length_; }
+  uint64_t sslSessionCacheSize() override { return ssl_session_cache_size_; }
+  bool listenerReusePort() override { return listener_reuse_port_; }
+  uint32_t listenerAcceptBatchSize() override { return listener_accept_batch_size_; }
+  bool listenerBalanceConnections() override { return listener_balance_connections_; }
 
 private:
   uint64_t base_id_;
@@ -61,11 +66,16 @@ private:
   std::string service_node_;
   std::string service_zone_;
   std::chrono::milliseconds file_flush_interval_msec_;
+  Filesystem::WriteOverflowPolicy file_overflow_policy_;
   std::chrono::seconds drain_time_;
   std::chrono::seconds parent_shutdown_time_;
   Server::Mode mode_;
   uint64_t max_stats_;
   uint64_t max_obj_name_length_;
+  uint64_t ssl_session_cache_size_;
+  bool listener_reuse_port_;
+  uint32_t listener_accept_batch_size_;
+  bool listener_balance_connections_;
 };
 
 /**
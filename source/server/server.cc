@@ -27,6 +27,7 @@
 #include "common/router/rds_impl.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/singleton/manager_impl.h"
+#include "common/ssl/session_cache_impl.h"
 #include "common/stats/thread_local_store.h"
 #include "common/upstream/cluster_manager_impl.h"
 
@@ -47,7 +48,8 @@ InstanceImpl::InstanceImpl(Options& options, Network::Address::InstanceConstShar
                            ComponentFactory& component_factory, ThreadLocal::Instance& tls)
     : options_(options), restarter_(restarter), start_time_(time(nullptr)),
       original_start_time_(start_time_), stats_store_(store), thread_local_(tls),
-      api_(new Api::Impl(options.fileFlushIntervalMsec())), dispatcher_(api_->allocateDispatcher()),
+      api_(new Api::Impl(options.fileFlushIntervalMsec(), options.fileOverflowPolicy())),
+      dispatcher_(api_->allocateDispatcher()),
       singleton_manager_(new Singleton::ManagerImpl()),
       handler_(new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher_)),
       listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks),
@@ -99,8 +101,8 @@ void InstanceImpl::failHealthcheck(bool fail) {
   server_stats_->live_.set(!fail);
 }
 
-void InstanceUtil::flushCountersAndGaugesToSinks(const std::list<Stats::SinkPtr>& sinks,
-                                                 Stats::Store& store) {
+void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
+                                       Stats::Store& store) {
   for (const auto& sink : sinks) {
     sink->beginFlush();
   }
@@ -122,6 +124,15 @@ void InstanceUtil::flushCountersAndGaugesToSinks(const std::list<Stats::SinkPtr>
     }
   }
 
+  // Histograms are recorded per worker. Merging them here gives the interval statistics a period
+  // of the flush interval.
+  for (const Stats::ParentHistogramSharedPtr& histogram : store.histograms()) {
+    histogram->merge();
+    for (const auto& sink : sinks) {
+      sink->flushHistogram(*histogram);
+    }
+  }
+
   for (const auto& sink : sinks) {
     sink->endFlush();
   }
@@ -140,7 +151,7 @@ void InstanceImpl::flushStats() {
   server_stats_->days_until_first_cert_expiring_.set(
       sslContextManager().daysUntilFirstCertExpires());
 
-  InstanceUtil::flushCountersAndGaugesToSinks(config_->statsSinks(), stats_store_);
+  InstanceUtil::flushMetricsToSinks(config_->statsSinks(), stats_store_);
   stat_flush_timer_->enableTimer(config_->statsFlushInterval());
 }
 
@@ -230,8 +241,15 @@ void InstanceImpl::initialize(Options& options,
   // load things may grab a reference to the loader for later use.
   runtime_loader_ = component_factory.createRuntime(*this, initial_config);
 
-  // Once we have runtime we can initialize the SSL context manager.
-  ssl_context_manager_.reset(new Ssl::ContextManagerImpl(*runtime_loader_));
+  // Once we have runtime we can initialize the SSL context manager. Server contexts share the
+  // restarter's session cache, whose sessions outlive hot restarts, or else a cache of our own.
+  Ssl::SessionCache* ssl_session_cache = restarter_.sslSessionCache();
+  if (ssl_session_cache == nullptr && options.sslSessionCacheSize() > 0) {
+    ssl_session_cache_.reset(new Ssl::SessionCacheImpl(options.sslSessionCacheSize()));
+    ssl_session_cache = ssl_session_cache_.get();
+  }
+  ssl_context_manager_.reset(
+      new Ssl::ContextManagerImpl(*runtime_loader_, *dispatcher_, ssl_session_cache));
 
   cluster_manager_factory_.reset(new Upstream::ProdClusterManagerFactory(
       runtime(), stats(), threadLocal(), random(), dnsResolver(), sslContextManager(), dispatcher(),
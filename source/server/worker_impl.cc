@@ -14,16 +14,19 @@
 namespace Envoy {
 namespace Server {
 
-WorkerPtr ProdWorkerFactory::createWorker() {
+WorkerPtr ProdWorkerFactory::createWorker(uint32_t index) {
   Event::DispatcherPtr dispatcher(api_.allocateDispatcher());
-  return WorkerPtr{new WorkerImpl(
-      tls_, hooks_, std::move(dispatcher),
-      Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(ENVOY_LOGGER(), *dispatcher)})};
+  return WorkerPtr{new WorkerImpl(tls_, hooks_, std::move(dispatcher),
+                                  Network::ConnectionHandlerPtr{new ConnectionHandlerImpl(
+                                      ENVOY_LOGGER(), *dispatcher, index)},
+                                  index)};
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks,
-                       Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler)
-    : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)) {
+                       Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
+                       uint32_t index)
+    : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
+      index_(index) {
   tls_.registerThread(*dispatcher_, false);
 }
 
@@ -43,18 +46,21 @@ void WorkerImpl::addListener(Listener& listener, AddListenerCompletion completio
 }
 
 void WorkerImpl::addListenerWorker(Listener& listener) {
-  const Network::ListenerOptions listener_options = {.bind_to_port_ = listener.bindToPort(),
-                                                     .use_proxy_proto_ = listener.useProxyProto(),
-                                                     .use_original_dst_ = listener.useOriginalDst(),
-                                                     .per_connection_buffer_limit_bytes_ =
-                                                         listener.perConnectionBufferLimitBytes()};
+  const Network::ListenerOptions listener_options = {
+      .bind_to_port_ = listener.bindToPort(),
+      .use_proxy_proto_ = listener.useProxyProto(),
+      .use_original_dst_ = listener.useOriginalDst(),
+      .per_connection_buffer_limit_bytes_ = listener.perConnectionBufferLimitBytes(),
+      .accept_batch_size_ = listener.acceptBatchSize(),
+      .connection_balancer_ = listener.connectionBalancer()};
+  Network::ListenSocket* socket = listener.workerSocket(index_);
+  ASSERT(socket != nullptr);
   if (listener.defaultSslContext()) {
-    handler_->addSslListener(listener.filterChainFactory(), *listener.defaultSslContext(),
-                             listener.socket(), listener.listenerScope(), listener.listenerTag(),
-                             listener_options);
+    handler_->addSslListener(listener.filterChainFactory(), *listener.defaultSslContext(), *socket,
+                             listener.listenerScope(), listener.listenerTag(), listener_options);
   } else {
-    handler_->addListener(listener.filterChainFactory(), listener.socket(),
-                          listener.listenerScope(), listener.listenerTag(), listener_options);
+    handler_->addListener(listener.filterChainFactory(), *socket, listener.listenerScope(),
+                          listener.listenerTag(), listener_options);
   }
 
   hooks_.onWorkerListenerAdded();
@@ -24,7 +24,7 @@ public:
       : tls_(tls), api_(api), hooks_(hooks) {}
 
   // Server::WorkerFactory
-  WorkerPtr createWorker() override;
+  WorkerPtr createWorker(uint32_t index) override;
 
 private:
   ThreadLocal::Instance& tls_;
@@ -38,7 +38,7 @@ private:
 class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, TestHooks& hooks, Event::DispatcherPtr&& dispatcher,
-             Network::ConnectionHandlerPtr handler);
+             Network::ConnectionHandlerPtr handler, uint32_t index);
 
   // Server::Worker
   void addListener(Listener& listener, AddListenerCompletion completion) override;
@@ -57,6 +57,7 @@ private:
   TestHooks& hooks_;
   Event::DispatcherPtr dispatcher_;
   Network::ConnectionHandlerPtr handler_;
+  const uint32_t index_;
   Thread::ThreadPtr thread_;
 };
 
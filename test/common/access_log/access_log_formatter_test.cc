@@ -4,12 +4,14 @@
 #include <vector>
 
 #include "common/access_log/access_log_formatter.h"
+#include "common/access_log/request_info_impl.h"
 #include "common/common/utility.h"
 #include "common/http/header_map_impl.h"
 
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/speed_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -276,6 +278,42 @@ TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   }
 }
 
+TEST(AccessLogFormatterTest, CompositeFormatterAppend) {
+  NiceMock<MockRequestInfo> request_info;
+  Http::TestHeaderMapImpl request_header{{":method", "GET"}, {":path", "/"}};
+  Http::TestHeaderMapImpl response_header{{"test", "test"}};
+  FormatterImpl formatter("%REQ(:METHOD)% %RESP(TEST)% %RESPONSE_FLAGS%");
+
+  // Lines are appended to whatever is already in the buffer.
+  std::string output = "prefix ";
+  formatter.appendTo(request_header, response_header, request_info, output);
+  EXPECT_EQ("prefix GET test -", output);
+  formatter.appendTo(request_header, response_header, request_info, output);
+  EXPECT_EQ("prefix GET test -GET test -", output);
+
+  ON_CALL(request_info, getResponseFlag(ResponseFlag::LocalReset)).WillByDefault(Return(true));
+  ON_CALL(request_info, getResponseFlag(ResponseFlag::NoRouteFound)).WillByDefault(Return(true));
+  output = "x";
+  formatter.appendTo(request_header, response_header, request_info, output);
+  EXPECT_EQ("xGET test LR,NR", output);
+}
+
+TEST(AccessLogFormatterTest, InlineRequestHeaders) {
+  MockRequestInfo request_info;
+  Http::TestHeaderMapImpl request_header{{":authority", "host"},
+                                         {"user-agent", "curl"},
+                                         {"x-envoy-original-path", "/original"},
+                                         {"x-custom", "custom"}};
+  Http::TestHeaderMapImpl response_header;
+
+  // Inline headers, including ones only reached through the alternative header, are found the
+  // same way as other headers.
+  FormatterImpl formatter("%REQ(:AUTHORITY)% %REQ(USER-AGENT):2% %REQ(X-CUSTOM)% "
+                          "%REQ(:PATH?X-ENVOY-ORIGINAL-PATH)% %REQ(X-REQUEST-ID)%");
+  EXPECT_EQ("host cu custom /original -",
+            formatter.format(request_header, response_header, request_info));
+}
+
 TEST(AccessLogFormatterTest, ParserFailures) {
   AccessLogFormatParser parser;
 
@@ -302,5 +340,27 @@ TEST(AccessLogFormatterTest, ParserFailures) {
   }
 }
 
+// Measures formatting the default access log format into a reused buffer.
+TEST(DISABLED_AccessLogFormatterTest, DefaultFormatSpeed) {
+  const uint64_t iterations = 1000000;
+  FormatterPtr formatter = AccessLogFormatUtils::defaultAccessLogFormatter();
+  Http::TestHeaderMapImpl request_header{{":method", "GET"},
+                                         {":path", "/some/path?query=value"},
+                                         {":authority", "example.com"},
+                                         {"user-agent", "curl/7.54.0"},
+                                         {"x-forwarded-for", "10.0.0.1"},
+                                         {"x-request-id", "ea4bf8d8-48d7-4fcb-9d1d-0e5a2c31c1ec"},
+                                         {"x-custom", "value"}};
+  Http::TestHeaderMapImpl response_header{{":status", "200"},
+                                          {"x-envoy-upstream-service-time", "10"}};
+  RequestInfoImpl request_info(Http::Protocol::Http11);
+
+  std::string output;
+  SpeedTest::run("appendTo", iterations, [&]() -> void {
+    output.clear();
+    formatter->appendTo(request_header, response_header, request_info, output);
+  });
+}
+
 } // namespace AccessLog
 } // namespace Envoy
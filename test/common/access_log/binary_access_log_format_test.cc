@@ -0,0 +1,192 @@
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/access_log/binary_access_log_format.h"
+#include "common/access_log/request_info_impl.h"
+
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/speed_test.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace AccessLog {
+
+class BinaryAccessLogFormatTest : public testing::Test {
+public:
+  // Copy the log into aligned memory, as a mapped file would be.
+  std::vector<BinaryAccessLogEntry> readAll(const std::string& log) {
+    aligned_log_.reset(new uint64_t[log.size() / sizeof(uint64_t) + 1]);
+    memcpy(aligned_log_.get(), log.data(), log.size());
+    BinaryAccessLogReader reader(reinterpret_cast<const char*>(aligned_log_.get()), log.size());
+
+    std::vector<BinaryAccessLogEntry> entries;
+    BinaryAccessLogEntry entry;
+    while (reader.next(entry)) {
+      entries.push_back(entry);
+    }
+    offset_ = reader.offset();
+    return entries;
+  }
+
+  BinaryFormatter formatter_;
+  Http::TestHeaderMapImpl empty_headers_;
+  std::unique_ptr<uint64_t[]> aligned_log_;
+  uint64_t offset_{};
+};
+
+TEST_F(BinaryAccessLogFormatTest, RoundTrip) {
+  Http::TestHeaderMapImpl request_headers{{":method", "GET"},
+                                          {":path", "/rewritten"},
+                                          {"x-envoy-original-path", "/original?query=1"},
+                                          {":authority", "example.com"},
+                                          {"user-agent", "curl/7.54.0"},
+                                          {"x-request-id", "id"},
+                                          {"x-forwarded-for", "10.0.0.1"}};
+  RequestInfoImpl request_info(Http::Protocol::Http2);
+  request_info.response_received_duration_.value(std::chrono::microseconds(1500));
+  request_info.bytes_received_ = 10;
+  request_info.bytes_sent_ = 20;
+  request_info.response_code_.value(503);
+  request_info.setResponseFlag(ResponseFlag::UpstreamOverflow);
+  request_info.setResponseFlag(ResponseFlag::RateLimited);
+  request_info.hc_request_ = true;
+  request_info.downstream_address_ = "127.0.0.1";
+  request_info.upstream_host_.reset(new NiceMock<Upstream::MockHostDescription>());
+
+  const std::string log = formatter_.format(request_headers, empty_headers_, request_info);
+  EXPECT_EQ(0UL, log.size() % BinaryAccessLogRecord::RECORD_ALIGNMENT);
+
+  const std::vector<BinaryAccessLogEntry> entries = readAll(log);
+  ASSERT_EQ(1UL, entries.size());
+  const BinaryAccessLogRecord& record = *entries[0].header_;
+  EXPECT_EQ(log.size(), record.length_);
+  EXPECT_EQ(std::chrono::duration_cast<std::chrono::microseconds>(
+                request_info.startTime().time_since_epoch())
+                .count(),
+            static_cast<int64_t>(record.start_time_us_));
+  EXPECT_EQ(BinaryAccessLogRecord::UNSET_DURATION, record.request_received_duration_us_);
+  EXPECT_EQ(1500, record.response_received_duration_us_);
+  EXPECT_EQ(10UL, record.bytes_received_);
+  EXPECT_EQ(20UL, record.bytes_sent_);
+  EXPECT_EQ(503UL, record.response_code_);
+  EXPECT_EQ(ResponseFlag::UpstreamOverflow | ResponseFlag::RateLimited, record.response_flags_);
+  EXPECT_EQ(static_cast<uint8_t>(Http::Protocol::Http2) + 1, record.protocol_);
+  EXPECT_EQ(1, record.health_check_);
+
+  EXPECT_EQ("GET", entries[0].field(BinaryAccessLogRecord::Method));
+  EXPECT_EQ("/original?query=1", entries[0].field(BinaryAccessLogRecord::Path));
+  EXPECT_EQ("example.com", entries[0].field(BinaryAccessLogRecord::Authority));
+  EXPECT_EQ("curl/7.54.0", entries[0].field(BinaryAccessLogRecord::UserAgent));
+  EXPECT_EQ("id", entries[0].field(BinaryAccessLogRecord::RequestId));
+  EXPECT_EQ("10.0.0.1", entries[0].field(BinaryAccessLogRecord::ForwardedFor));
+  EXPECT_EQ("10.0.0.1:443", entries[0].field(BinaryAccessLogRecord::UpstreamHost));
+  EXPECT_EQ("fake_cluster", entries[0].field(BinaryAccessLogRecord::UpstreamCluster));
+  EXPECT_EQ("127.0.0.1", entries[0].field(BinaryAccessLogRecord::DownstreamAddress));
+}
+
+TEST_F(BinaryAccessLogFormatTest, EmptyRequest) {
+  RequestInfoImpl request_info;
+  const std::string log = formatter_.format(empty_headers_, empty_headers_, request_info);
+  EXPECT_EQ(sizeof(BinaryAccessLogRecord), log.size());
+
+  const std::vector<BinaryAccessLogEntry> entries = readAll(log);
+  ASSERT_EQ(1UL, entries.size());
+  EXPECT_EQ(0UL, entries[0].header_->response_code_);
+  EXPECT_EQ(0, entries[0].header_->protocol_);
+  for (size_t i = 0; i < BinaryAccessLogRecord::NumStringFields; i++) {
+    EXPECT_EQ("", entries[0].field(static_cast<BinaryAccessLogRecord::StringField>(i)));
+  }
+}
+
+TEST_F(BinaryAccessLogFormatTest, MultipleRecordsAndPartialRecord) {
+  RequestInfoImpl request_info;
+  std::string log;
+  for (uint32_t i = 0; i < 3; i++) {
+    Http::TestHeaderMapImpl request_headers{{":path", std::string(i * 5 + 1, 'a')}};
+    formatter_.appendTo(request_headers, empty_headers_, request_info, log);
+  }
+  const size_t complete_length = log.size();
+  formatter_.appendTo(empty_headers_, empty_headers_, request_info, log);
+  log.resize(log.size() - 1);
+
+  const std::vector<BinaryAccessLogEntry> entries = readAll(log);
+  ASSERT_EQ(3UL, entries.size());
+  for (uint32_t i = 0; i < 3; i++) {
+    EXPECT_EQ(std::string(i * 5 + 1, 'a'), entries[i].field(BinaryAccessLogRecord::Path));
+  }
+  EXPECT_EQ(complete_length, offset_);
+}
+
+TEST_F(BinaryAccessLogFormatTest, LongHeaderIsTruncated) {
+  Http::TestHeaderMapImpl request_headers{{"user-agent", std::string(70000, 'a')}};
+  RequestInfoImpl request_info;
+  const std::vector<BinaryAccessLogEntry> entries =
+      readAll(formatter_.format(request_headers, empty_headers_, request_info));
+  ASSERT_EQ(1UL, entries.size());
+  EXPECT_EQ(std::string(UINT16_MAX, 'a'), entries[0].field(BinaryAccessLogRecord::UserAgent));
+}
+
+TEST_F(BinaryAccessLogFormatTest, CorruptRecord) {
+  RequestInfoImpl request_info;
+  std::string log = formatter_.format(empty_headers_, empty_headers_, request_info);
+  log[offsetof(BinaryAccessLogRecord, magic_)] ^= 1;
+  EXPECT_THROW_WITH_MESSAGE(readAll(log), EnvoyException,
+                            "corrupt binary access log record at offset 0");
+
+  log = formatter_.format(empty_headers_, empty_headers_, request_info);
+  log[offsetof(BinaryAccessLogRecord, string_lengths_)] = 8;
+  EXPECT_THROW_WITH_MESSAGE(readAll(log), EnvoyException,
+                            "corrupt binary access log record at offset 0");
+}
+
+// Compare with DISABLED_AccessLogFormatterTest.DefaultFormatSpeed, which formats the same request
+// as text.
+TEST(DISABLED_BinaryAccessLogFormatTest, FormatAndReadSpeed) {
+  const uint64_t iterations = 1000000;
+  BinaryFormatter formatter;
+  Http::TestHeaderMapImpl request_header{{":method", "GET"},
+                                         {":path", "/some/path?query=value"},
+                                         {":authority", "example.com"},
+                                         {"user-agent", "curl/7.54.0"},
+                                         {"x-forwarded-for", "10.0.0.1"},
+                                         {"x-request-id", "ea4bf8d8-48d7-4fcb-9d1d-0e5a2c31c1ec"},
+                                         {"x-custom", "value"}};
+  Http::TestHeaderMapImpl response_header{{":status", "200"},
+                                          {"x-envoy-upstream-service-time", "10"}};
+  RequestInfoImpl request_info(Http::Protocol::Http11);
+
+  std::string output;
+  SpeedTest::run("appendTo", iterations, [&]() -> void {
+    output.clear();
+    formatter.appendTo(request_header, response_header, request_info, output);
+  });
+
+  std::string log;
+  for (uint64_t i = 0; i < iterations; i++) {
+    formatter.appendTo(request_header, response_header, request_info, log);
+  }
+  std::unique_ptr<uint64_t[]> aligned_log(new uint64_t[log.size() / sizeof(uint64_t) + 1]);
+  memcpy(aligned_log.get(), log.data(), log.size());
+
+  uint64_t bytes_sent = 0;
+  const std::chrono::nanoseconds duration = SpeedTest::time([&]() -> void {
+    BinaryAccessLogReader reader(reinterpret_cast<const char*>(aligned_log.get()), log.size());
+    BinaryAccessLogEntry entry;
+    while (reader.next(entry)) {
+      bytes_sent += entry.header_->bytes_sent_;
+    }
+  });
+  EXPECT_EQ(0UL, bytes_sent);
+  SpeedTest::print("next", duration, iterations);
+}
+
+} // namespace AccessLog
+} // namespace Envoy
@@ -0,0 +1,346 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/slice_buffer_impl.h"
+
+#include "test/test_common/speed_test.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+std::string toString(const Instance& buffer) {
+  std::string output(buffer.length(), '\0');
+  buffer.copyOut(0, output.size(), &output[0]);
+  return output;
+}
+
+class SocketPair {
+public:
+  SocketPair() { EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds_)); }
+  ~SocketPair() {
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  int fds_[2];
+};
+
+TEST(SliceBufferImplTest, AddAndDrain) {
+  SliceBufferImpl buffer(16);
+  buffer.add("hello");
+  buffer.add(std::string(" world, this spans slices"));
+  EXPECT_EQ(30, buffer.length());
+  EXPECT_EQ("hello world, this spans slices", toString(buffer));
+  EXPECT_EQ(2, buffer.getRawSlices(nullptr, 0));
+
+  buffer.drain(6);
+  EXPECT_EQ("world, this spans slices", toString(buffer));
+  buffer.drain(14);
+  EXPECT_EQ(1, buffer.getRawSlices(nullptr, 0));
+  EXPECT_EQ("ans slices", toString(buffer));
+  buffer.drain(10);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(0, buffer.getRawSlices(nullptr, 0));
+}
+
+TEST(SliceBufferImplTest, LargeAddUsesOneSlice) {
+  SliceBufferImpl buffer(16);
+  buffer.add(std::string(100, 'a'));
+  EXPECT_EQ(1, buffer.getRawSlices(nullptr, 0));
+}
+
+TEST(SliceBufferImplTest, GetRawSlicesReportsAllSlices) {
+  SliceBufferImpl buffer(4);
+  buffer.add("aaaa");
+  buffer.add("bbbb");
+  buffer.add("cc");
+  RawSlice slices[2];
+  EXPECT_EQ(3, buffer.getRawSlices(slices, 2));
+  EXPECT_EQ("aaaa", std::string(static_cast<char*>(slices[0].mem_), slices[0].len_));
+  EXPECT_EQ("bbbb", std::string(static_cast<char*>(slices[1].mem_), slices[1].len_));
+}
+
+TEST(SliceBufferImplTest, CopyOut) {
+  SliceBufferImpl buffer(4);
+  buffer.add("hello");
+  buffer.add(" world");
+  char out[5];
+  buffer.copyOut(6, 5, out);
+  EXPECT_EQ("world", std::string(out, 5));
+  buffer.copyOut(2, 5, out);
+  EXPECT_EQ("llo w", std::string(out, 5));
+  buffer.copyOut(4, 0, out);
+}
+
+TEST(SliceBufferImplTest, AddBufferSharesStorage) {
+  SliceBufferImpl source(16);
+  source.add("shared data");
+  SliceBufferImpl copy(16);
+  copy.add(source);
+  EXPECT_EQ("shared data", toString(copy));
+
+  RawSlice source_slice;
+  RawSlice copy_slice;
+  source.getRawSlices(&source_slice, 1);
+  copy.getRawSlices(&copy_slice, 1);
+  EXPECT_EQ(source_slice.mem_, copy_slice.mem_);
+
+  // Shared storage is never appended to.
+  source.add("!");
+  copy.add("?");
+  EXPECT_EQ("shared data!", toString(source));
+  EXPECT_EQ("shared data?", toString(copy));
+}
+
+TEST(SliceBufferImplTest, AddSelf) {
+  SliceBufferImpl buffer(4);
+  buffer.add("abcdef");
+  buffer.add(buffer);
+  EXPECT_EQ("abcdefabcdef", toString(buffer));
+}
+
+TEST(SliceBufferImplTest, AddOwnedImpl) {
+  OwnedImpl source("from libevent");
+  SliceBufferImpl buffer;
+  buffer.add(source);
+  EXPECT_EQ("from libevent", toString(buffer));
+  EXPECT_EQ(13, source.length());
+}
+
+TEST(SliceBufferImplTest, Move) {
+  SliceBufferImpl source(4);
+  source.add("0123456789");
+  RawSlice before;
+  source.getRawSlices(&before, 1);
+
+  SliceBufferImpl destination;
+  destination.add("head:");
+  destination.move(source);
+  EXPECT_EQ(0, source.length());
+  EXPECT_EQ("head:0123456789", toString(destination));
+
+  // The slices were transferred rather than copied.
+  RawSlice after[2];
+  destination.getRawSlices(after, 2);
+  EXPECT_EQ(before.mem_, after[1].mem_);
+}
+
+TEST(SliceBufferImplTest, MoveLength) {
+  SliceBufferImpl source(4);
+  source.add("0123");
+  source.add("4567");
+  source.add("89");
+  SliceBufferImpl destination;
+
+  // Moves two whole slices and splits the third.
+  destination.move(source, 9);
+  EXPECT_EQ("012345678", toString(destination));
+  EXPECT_EQ("9", toString(source));
+  EXPECT_EQ(9, destination.length());
+  EXPECT_EQ(1, source.length());
+
+  // Neither side may append into the shared storage of the split slice.
+  destination.add("a");
+  source.add("b");
+  EXPECT_EQ("012345678a", toString(destination));
+  EXPECT_EQ("9b", toString(source));
+
+  destination.move(source, 2);
+  EXPECT_EQ("012345678a9b", toString(destination));
+  EXPECT_EQ(0, source.length());
+}
+
+TEST(SliceBufferImplTest, MoveOwnedImpl) {
+  OwnedImpl source("0123456789");
+  SliceBufferImpl destination;
+  destination.move(source, 4);
+  EXPECT_EQ("0123", toString(destination));
+  EXPECT_EQ("456789", toString(source));
+  destination.move(source);
+  EXPECT_EQ("0123456789", toString(destination));
+  EXPECT_EQ(0, source.length());
+}
+
+TEST(SliceBufferImplTest, Linearize) {
+  SliceBufferImpl buffer(4);
+  buffer.add("0123");
+  buffer.add("4567");
+  buffer.add("89");
+  EXPECT_EQ("0123", std::string(static_cast<char*>(buffer.linearize(4)), 4));
+  EXPECT_EQ(3, buffer.getRawSlices(nullptr, 0));
+  EXPECT_EQ("0123456", std::string(static_cast<char*>(buffer.linearize(7)), 7));
+  EXPECT_EQ(3, buffer.getRawSlices(nullptr, 0));
+  EXPECT_EQ("0123456789", toString(buffer));
+}
+
+TEST(SliceBufferImplTest, Search) {
+  SliceBufferImpl buffer(4);
+  buffer.add("abca");
+  buffer.add("bcda");
+  buffer.add("bcde");
+  ASSERT_EQ(3, buffer.getRawSlices(nullptr, 0));
+  EXPECT_EQ(0, buffer.search("abc", 3, 0));
+  EXPECT_EQ(3, buffer.search("abcd", 4, 0));
+  EXPECT_EQ(7, buffer.search("abcde", 5, 0));
+  EXPECT_EQ(7, buffer.search("abc", 3, 4));
+  EXPECT_EQ(-1, buffer.search("abcdef", 6, 0));
+  EXPECT_EQ(-1, buffer.search("x", 1, 0));
+  EXPECT_EQ(-1, buffer.search("a", 1, 13));
+  EXPECT_EQ(5, buffer.search("", 0, 5));
+}
+
+TEST(SliceBufferImplTest, ReserveCommit) {
+  SliceBufferImpl buffer(16);
+  buffer.add("abc");
+
+  // The free space at the end of the last slice is used first.
+  RawSlice slices[2];
+  EXPECT_EQ(2, buffer.reserve(20, slices, 2));
+  EXPECT_EQ(13, slices[0].len_);
+  EXPECT_LE(7, slices[1].len_);
+  memcpy(slices[0].mem_, "defghijklmnop", 13);
+  memcpy(slices[1].mem_, "qr", 2);
+  slices[1].len_ = 2;
+  buffer.commit(slices, 2);
+  EXPECT_EQ("abcdefghijklmnopqr", toString(buffer));
+
+  // A single slice reservation is contiguous.
+  EXPECT_EQ(1, buffer.reserve(20, slices, 1));
+  EXPECT_LE(20, slices[0].len_);
+  memcpy(slices[0].mem_, "s", 1);
+  slices[0].len_ = 1;
+  buffer.commit(slices, 1);
+  EXPECT_EQ("abcdefghijklmnopqrs", toString(buffer));
+
+  // Committing nothing releases the reservation.
+  EXPECT_EQ(1, buffer.reserve(100, slices, 1));
+  slices[0].len_ = 0;
+  buffer.commit(slices, 1);
+  EXPECT_EQ(19, buffer.length());
+}
+
+TEST(SliceBufferImplTest, ReadWrite) {
+  SocketPair sockets;
+  SliceBufferImpl buffer(4);
+  buffer.add("hello world");
+  EXPECT_EQ(11, buffer.write(sockets.fds_[0]));
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(0, buffer.write(sockets.fds_[0]));
+
+  SliceBufferImpl read_buffer(4);
+  read_buffer.add("<");
+  EXPECT_EQ(5, read_buffer.read(sockets.fds_[1], 5));
+  EXPECT_EQ(6, read_buffer.read(sockets.fds_[1], 100));
+  EXPECT_EQ("<hello world", toString(read_buffer));
+
+  shutdown(sockets.fds_[0], SHUT_WR);
+  EXPECT_EQ(0, read_buffer.read(sockets.fds_[1], 100));
+  EXPECT_EQ(12, read_buffer.length());
+}
+
+TEST(SliceBufferImplTest, ReadError) {
+  SliceBufferImpl buffer;
+  buffer.add("abc");
+  EXPECT_EQ(-1, buffer.read(-1, 100));
+  EXPECT_EQ(EBADF, errno);
+  EXPECT_EQ("abc", toString(buffer));
+}
+
+class TestFragment : public BufferFragmentImpl {
+public:
+  TestFragment(const std::string& data, bool& done)
+      : BufferFragmentImpl(data.data(), data.size(),
+                           [&done](const void*, size_t, const BufferFragmentImpl*) -> void {
+                             done = true;
+                           }) {}
+};
+
+TEST(SliceBufferImplTest, BufferFragment) {
+  const std::string data = "external";
+  bool done = false;
+  TestFragment fragment(data, done);
+  {
+    SliceBufferImpl buffer;
+    buffer.add("an ");
+    buffer.addBufferFragment(fragment);
+    EXPECT_EQ("an external", toString(buffer));
+    RawSlice slices[2];
+    buffer.getRawSlices(slices, 2);
+    EXPECT_EQ(data.data(), slices[1].mem_);
+
+    // Data is never appended into the fragment.
+    buffer.add("!");
+    EXPECT_EQ("an external!", toString(buffer));
+
+    SliceBufferImpl other;
+    other.move(buffer, 6);
+    buffer.drain(buffer.length());
+    EXPECT_FALSE(done);
+  }
+  EXPECT_TRUE(done);
+}
+
+TEST(OwnedImplTest, BufferFragment) {
+  const std::string data = "external";
+  bool done = false;
+  TestFragment fragment(data, done);
+  OwnedImpl buffer;
+  buffer.addBufferFragment(fragment);
+  EXPECT_EQ("external", toString(buffer));
+  buffer.drain(4);
+  EXPECT_FALSE(done);
+  buffer.drain(4);
+  EXPECT_TRUE(done);
+}
+
+template <class BufferType> void benchmarkBuffer(const std::string& name) {
+  const uint64_t iterations = 100000;
+  const std::string chunk(1024, 'a');
+
+  SpeedTest::run(name + " add/drain 16 x 1KB", iterations, [&]() -> void {
+    BufferType buffer;
+    for (uint32_t j = 0; j < 16; j++) {
+      buffer.add(chunk);
+    }
+    buffer.drain(buffer.length());
+  });
+
+  BufferType source;
+  BufferType destination;
+  SpeedTest::run(name + " add/move/drain 1KB", iterations, [&]() -> void {
+    source.add(chunk);
+    destination.move(source, 512);
+    destination.move(source);
+    destination.drain(destination.length());
+  });
+
+  SocketPair sockets;
+  BufferType write_buffer;
+  BufferType read_buffer;
+  SpeedTest::run(name + " write/read 1KB", iterations, [&]() -> void {
+    write_buffer.add(chunk);
+    while (write_buffer.length() > 0) {
+      write_buffer.write(sockets.fds_[0]);
+    }
+    uint64_t bytes_read = 0;
+    while (bytes_read < chunk.size()) {
+      bytes_read += read_buffer.read(sockets.fds_[1], 16384);
+    }
+    read_buffer.drain(read_buffer.length());
+  });
+}
+
+TEST(DISABLED_SliceBufferImplTest, Speed) {
+  benchmarkBuffer<OwnedImpl>("OwnedImpl");
+  benchmarkBuffer<SliceBufferImpl>("SliceBufferImpl");
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
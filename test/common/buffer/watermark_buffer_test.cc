@@ -62,6 +62,18 @@ TEST_F(WatermarkBufferTest, AddBuffer) {
   EXPECT_EQ(11, buffer_.length());
 }
 
+TEST_F(WatermarkBufferTest, AddBufferFragment) {
+  buffer_.add(TEN_BYTES, 10);
+  EXPECT_EQ(0, times_high_watermark_called_);
+  BufferFragmentImpl fragment("a", 1, nullptr);
+  buffer_.addBufferFragment(fragment);
+  EXPECT_EQ(1, times_high_watermark_called_);
+  EXPECT_EQ(11, buffer_.length());
+
+  // Release the fragment before it goes out of scope.
+  buffer_.drain(11);
+}
+
 TEST_F(WatermarkBufferTest, Commit) {
   buffer_.add(TEN_BYTES, 10);
   EXPECT_EQ(0, times_high_watermark_called_);
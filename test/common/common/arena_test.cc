@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "common/common/arena.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+
+TEST(ArenaTest, Alignment) {
+  Arena arena;
+  for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+    void* memory = arena.allocate(3, alignment);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(memory) % alignment);
+  }
+  EXPECT_EQ(1, arena.heapBlocks());
+}
+
+TEST(ArenaTest, Blocks) {
+  Arena arena;
+  EXPECT_EQ(0, arena.heapBlocks());
+
+  uint8_t* first = static_cast<uint8_t*>(arena.allocate(100, 1));
+  uint8_t* second = static_cast<uint8_t*>(arena.allocate(100, 1));
+  EXPECT_EQ(first + 100, second);
+  EXPECT_EQ(1, arena.heapBlocks());
+
+  // An allocation which does not fit in the rest of the block starts a new one, and one larger
+  // than a block gets its own.
+  arena.allocate(Arena::BLOCK_SIZE - 100, 1);
+  EXPECT_EQ(2, arena.heapBlocks());
+  arena.allocate(Arena::BLOCK_SIZE * 3, 1);
+  EXPECT_EQ(3, arena.heapBlocks());
+}
+
+TEST(ArenaTest, InlineArena) {
+  InlineArena<256> arena;
+  for (uint32_t i = 0; i < 4; i++) {
+    arena.allocate(64, 8);
+  }
+  EXPECT_EQ(0, arena.heapBlocks());
+  arena.allocate(1, 1);
+  EXPECT_EQ(1, arena.heapBlocks());
+}
+
+TEST(ArenaTest, ContainerAndDeleter) {
+  InlineArena<1024> arena;
+  typedef std::unique_ptr<std::string, ArenaDeleter<std::string>> StringPtr;
+  std::list<StringPtr, ArenaAllocator<StringPtr>> strings{ArenaAllocator<StringPtr>(arena)};
+
+  for (uint32_t i = 0; i < 10; i++) {
+    strings.emplace_back(arena.create<std::string>(std::to_string(i)));
+  }
+  strings.pop_front();
+  EXPECT_EQ(9, strings.size());
+  EXPECT_EQ("1", *strings.front());
+  EXPECT_EQ("9", *strings.back());
+  EXPECT_EQ(0, arena.heapBlocks());
+}
+
+} // namespace Envoy
@@ -10,4 +10,10 @@ TEST(Hash, xxHash) {
   EXPECT_EQ(4400747396090729504U, HashUtil::xxHash64("lyft"));
   EXPECT_EQ(17241709254077376921U, HashUtil::xxHash64(""));
 }
+
+TEST(Hash, xxHashWithSeed) {
+  EXPECT_EQ(3728699739546630719U, HashUtil::xxHash64("foo", 0));
+  EXPECT_EQ(14071536367944281277U, HashUtil::xxHash64("foo", 1));
+  EXPECT_EQ(81692559072577057U, HashUtil::xxHash64("lyft", 1));
+}
 } // namespace Envoy
@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/thread.h"
@@ -26,6 +32,17 @@ using testing::Throw;
 using testing::_;
 
 namespace Envoy {
+namespace {
+
+std::string iovecsToString(const iovec* iov, int iovcnt) {
+  std::string data;
+  for (int i = 0; i < iovcnt; i++) {
+    data.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+  }
+  return data;
+}
+
+} // namespace
 
 TEST(FileSystemImpl, BadFile) {
   Event::MockDispatcher dispatcher;
@@ -90,16 +107,19 @@ TEST(FileSystemImpl, flushToLogFilePeriodically) {
   Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
 
   EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(40)));
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
         EXPECT_EQ("test", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
+  // Small writes are only flushed when the timer fires.
   file.write("test");
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(40)));
+  timer->callback_();
 
   {
     std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
@@ -108,13 +128,13 @@ TEST(FileSystemImpl, flushToLogFilePeriodically) {
     }
   }
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
         EXPECT_EQ("test2", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   // make sure timer is re-enabled on callback call
@@ -147,8 +167,10 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
   // The first write to a given file will start the flush thread, which can flush
   // immediately (race on whether it will or not). So do a write and flush to
   // get that state out of the way, then test that small writes don't trigger a flush.
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int, const void*, size_t num_bytes) -> ssize_t { return num_bytes; }));
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int iovcnt) -> ssize_t {
+        return iovecsToString(iov, iovcnt).size();
+      }));
   file.write("prime-it");
   file.flush();
   uint32_t expected_writes = 1;
@@ -157,13 +179,13 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
     EXPECT_EQ(expected_writes, os_sys_calls.num_writes_);
   }
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
         EXPECT_EQ("test", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("test");
@@ -180,13 +202,13 @@ TEST(FileSystemImpl, flushToLogFileOnDemand) {
     EXPECT_EQ(expected_writes, os_sys_calls.num_writes_);
   }
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
         EXPECT_EQ("test2", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   // make sure timer is re-enabled on callback call
@@ -216,14 +238,14 @@ TEST(FileSystemImpl, reopenFile) {
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(5));
   Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
       .InSequence(sq)
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+      .WillOnce(Invoke([](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
         EXPECT_EQ("before", written);
         EXPECT_EQ(5, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("before");
@@ -239,14 +261,14 @@ TEST(FileSystemImpl, reopenFile) {
   EXPECT_CALL(os_sys_calls, close(5)).InSequence(sq);
   EXPECT_CALL(os_sys_calls, open_(_, _, _)).InSequence(sq).WillOnce(Return(10));
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
       .InSequence(sq)
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
+      .WillOnce(Invoke([](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
         EXPECT_EQ("reopened", written);
         EXPECT_EQ(10, fd);
 
-        return num_bytes;
+        return written.size();
       }));
 
   EXPECT_CALL(os_sys_calls, close(10)).InSequence(sq);
@@ -272,12 +294,9 @@ TEST(FilesystemImpl, reopenThrows) {
   NiceMock<Api::MockOsSysCalls> os_sys_calls;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillRepeatedly(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        UNREFERENCED_PARAMETER(fd);
-        UNREFERENCED_PARAMETER(buffer);
-
-        return num_bytes;
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillRepeatedly(Invoke([](int, const iovec* iov, int iovcnt) -> ssize_t {
+        return iovecsToString(iov, iovcnt).size();
       }));
 
   Sequence sq;
@@ -321,18 +340,20 @@ TEST(FilesystemImpl, bigDataChunkShouldBeFlushedWithoutTimer) {
 
   Filesystem::FileImpl file("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40));
 
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        UNREFERENCED_PARAMETER(fd);
-
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
-        std::string expected("a");
+  // A small write just sits in the buffer of this thread. A big string should be flushed, along
+  // with the small write, even when timer is not enabled.
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .WillOnce(Invoke([](int, const iovec* iov, int iovcnt) -> ssize_t {
+        std::string written = iovecsToString(iov, iovcnt);
+        std::string expected = "a" + std::string(1024 * 64 + 1, 'b');
         EXPECT_EQ(expected, written);
 
-        return num_bytes;
+        return written.size();
       }));
 
   file.write("a");
+  std::string big_string(1024 * 64 + 1, 'b');
+  file.write(big_string);
 
   {
     std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
@@ -340,28 +361,260 @@ TEST(FilesystemImpl, bigDataChunkShouldBeFlushedWithoutTimer) {
       os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
     }
   }
+}
 
-  // First write happens without waiting on thread_flush_. Now make a big string and it should be
-  // flushed even when timer is not enabled
-  EXPECT_CALL(os_sys_calls, write_(_, _, _))
-      .WillOnce(Invoke([](int fd, const void* buffer, size_t num_bytes) -> ssize_t {
-        UNREFERENCED_PARAMETER(fd);
+TEST(FilesystemImpl, sharedFlushThread) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<Event::MockTimer>* timer1 = new NiceMock<Event::MockTimer>(&dispatcher);
+  new NiceMock<Event::MockTimer>(&dispatcher);
 
-        std::string written = std::string(reinterpret_cast<const char*>(buffer), num_bytes);
-        std::string expected(1024 * 64 + 1, 'b');
-        EXPECT_EQ(expected, written);
+  Thread::MutexBasicLockable mutex;
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
 
-        return num_bytes;
+  EXPECT_CALL(os_sys_calls, open_(_, _, _)).WillOnce(Return(5)).WillOnce(Return(6));
+  Filesystem::FlushThreadSharedPtr flush_thread = std::make_shared<Filesystem::FlushThread>();
+  Filesystem::FileImpl file1("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40),
+                             flush_thread);
+  Filesystem::FileImpl file2("", dispatcher, mutex, stats_store, std::chrono::milliseconds(40),
+                             flush_thread);
+
+  // Writes from several threads all go out in one writev() per file.
+  std::string written[2];
+  EXPECT_CALL(os_sys_calls, writev_(_, _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&written](int fd, const iovec* iov, int iovcnt) -> ssize_t {
+        written[fd - 5] = iovecsToString(iov, iovcnt);
+        return written[fd - 5].size();
       }));
 
-  std::string big_string(1024 * 64 + 1, 'b');
-  file.write(big_string);
+  std::vector<std::thread> threads;
+  for (char c : {'a', 'b', 'c'}) {
+    threads.emplace_back([&file1, &file2, c]() -> void {
+      file1.write(std::string(2, c));
+      file2.write(std::string(1, c));
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
 
+  // Either file's timer flushes both files.
+  timer1->callback_();
   {
     std::unique_lock<Thread::BasicLockable> lock(os_sys_calls.write_mutex_);
     while (os_sys_calls.num_writes_ != 2) {
       os_sys_calls.write_event_.wait(os_sys_calls.write_mutex_);
     }
   }
+
+  std::sort(written[0].begin(), written[0].end());
+  std::sort(written[1].begin(), written[1].end());
+  EXPECT_EQ("aabbcc", written[0]);
+  EXPECT_EQ("abc", written[1]);
+  EXPECT_EQ(6UL, stats_store.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(1UL, stats_store.counter("filesystem.flushed_by_timer").value());
+  EXPECT_EQ(0UL, stats_store.gauge("filesystem.write_total_buffered").value());
+}
+
+TEST(FilesystemImpl, WriteRingWrapsAround) {
+  Filesystem::WriteRing ring(8);
+  iovec iov[2];
+
+  EXPECT_EQ(0, ring.peek(iov));
+  EXPECT_TRUE(ring.push("abcdef"));
+  EXPECT_FALSE(ring.push("ghi"));
+  EXPECT_EQ(6UL, ring.used());
+  ASSERT_EQ(1, ring.peek(iov));
+  EXPECT_EQ("abcdef", iovecsToString(iov, 1));
+  ring.consume(4);
+
+  // The second write wraps around the end of the ring.
+  EXPECT_TRUE(ring.push("ghijkl"));
+  EXPECT_EQ(8UL, ring.used());
+  EXPECT_FALSE(ring.push("m"));
+  ASSERT_EQ(2, ring.peek(iov));
+  EXPECT_EQ("efghijkl", iovecsToString(iov, 2));
+  ring.consume(8);
+  EXPECT_EQ(0UL, ring.used());
+  EXPECT_EQ(0, ring.peek(iov));
+}
+
+/**
+ * Fills the buffer of a single writing thread while the flush thread is stuck in writev().
+ */
+class FileOverflowTest : public testing::Test {
+public:
+  FileOverflowTest() : os_calls_(&os_sys_calls_) {
+    EXPECT_CALL(os_sys_calls_, writev_(_, _, _))
+        .WillRepeatedly(Invoke([this](int, const iovec* iov, int iovcnt) -> ssize_t {
+          std::unique_lock<std::mutex> lock(lock_);
+          release_event_.wait(lock, [this]() -> bool { return released_; });
+          const std::string data = iovecsToString(iov, iovcnt);
+          written_ += data;
+          return data.size();
+        }));
+  }
+
+  void createFile(Filesystem::WriteOverflowPolicy policy) {
+    file_.reset(new Filesystem::FileImpl("", dispatcher_, mutex_, stats_store_,
+                                         std::chrono::milliseconds(40), nullptr, policy));
+  }
+
+  void writeLines(uint64_t num_lines) {
+    for (uint64_t i = 0; i < num_lines; i++) {
+      file_->write(std::string(LINE_SIZE, 'a' + i % 26));
+    }
+  }
+
+  void releaseWrites() {
+    {
+      std::lock_guard<std::mutex> lock(lock_);
+      released_ = true;
+    }
+    release_event_.notify_all();
+  }
+
+  static const uint64_t LINE_SIZE = 1024;
+  static const uint64_t LINES_PER_RING = Filesystem::FileImpl::RING_SIZE / LINE_SIZE;
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Thread::MutexBasicLockable mutex_;
+  Stats::IsolatedStoreImpl stats_store_;
+  NiceMock<Api::MockOsSysCalls> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_;
+  std::mutex lock_;
+  std::condition_variable release_event_;
+  bool released_{};
+  std::string written_;
+  std::unique_ptr<Filesystem::FileImpl> file_;
+};
+
+TEST_F(FileOverflowTest, Spill) {
+  createFile(Filesystem::WriteOverflowPolicy::Spill);
+
+  // The writer neither waits nor loses anything, and the lines are written in order.
+  writeLines(LINES_PER_RING + 8);
+  releaseWrites();
+  file_->flush();
+
+  std::string expected;
+  for (uint64_t i = 0; i < LINES_PER_RING + 8; i++) {
+    expected += std::string(LINE_SIZE, 'a' + i % 26);
+  }
+  EXPECT_EQ(expected, written_);
+  EXPECT_EQ(LINES_PER_RING + 8, stats_store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(0UL, stats_store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, stats_store_.counter("filesystem.write_blocked").value());
+}
+
+TEST_F(FileOverflowTest, SpillWhileFlushing) {
+  createFile(Filesystem::WriteOverflowPolicy::Spill);
+  releaseWrites();
+
+  // Flushes run concurrently with a writer that keeps moving between its ring and the overflow
+  // buffer. Every line must still be written in order.
+  const uint64_t num_lines = LINES_PER_RING * 16;
+  std::atomic<bool> done{};
+  std::thread writer([this, &done]() -> void {
+    writeLines(num_lines);
+    done = true;
+  });
+  while (!done) {
+    file_->flush();
+  }
+  writer.join();
+  file_->flush();
+
+  std::string expected;
+  for (uint64_t i = 0; i < num_lines; i++) {
+    expected += std::string(LINE_SIZE, 'a' + i % 26);
+  }
+  EXPECT_EQ(expected, written_);
+}
+
+TEST_F(FileOverflowTest, Drop) {
+  createFile(Filesystem::WriteOverflowPolicy::Drop);
+
+  // Nothing is consumed from the ring until writev() returns, so everything beyond the size of the
+  // ring is dropped.
+  writeLines(LINES_PER_RING + 8);
+  releaseWrites();
+  file_->flush();
+
+  EXPECT_EQ(LINES_PER_RING * LINE_SIZE, written_.size());
+  EXPECT_EQ(LINES_PER_RING, stats_store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(8UL, stats_store_.counter("filesystem.write_dropped").value());
+  EXPECT_EQ(0UL, stats_store_.counter("filesystem.write_blocked").value());
+}
+
+TEST_F(FileOverflowTest, Sample) {
+  createFile(Filesystem::WriteOverflowPolicy::Sample);
+
+  // Once the ring is half full only every tenth line is kept.
+  writeLines(LINES_PER_RING / 2 + 24);
+  releaseWrites();
+  file_->flush();
+
+  EXPECT_EQ((LINES_PER_RING / 2 + 3) * LINE_SIZE, written_.size());
+  EXPECT_EQ(21UL, stats_store_.counter("filesystem.write_dropped").value());
+}
+
+TEST_F(FileOverflowTest, OversizedWriteStaysInOrder) {
+  releaseWrites();
+
+  // A write too large for the ring is queued in the overflow buffer whatever the policy, and the
+  // writes after it must not overtake it.
+  const std::string oversized(Filesystem::FileImpl::RING_SIZE + 1, 'b');
+  for (Filesystem::WriteOverflowPolicy policy :
+       {Filesystem::WriteOverflowPolicy::Spill, Filesystem::WriteOverflowPolicy::Drop,
+        Filesystem::WriteOverflowPolicy::Sample, Filesystem::WriteOverflowPolicy::Block}) {
+    createFile(policy);
+    file_->write("a");
+    file_->write(oversized);
+    file_->write("c");
+    file_->flush();
+
+    std::lock_guard<std::mutex> lock(lock_);
+    EXPECT_EQ("a" + oversized + "c", written_);
+    written_.clear();
+  }
+}
+
+TEST_F(FileOverflowTest, ExitedThreadRingsRemoved) {
+  createFile(Filesystem::WriteOverflowPolicy::Spill);
+  releaseWrites();
+
+  // Each writing thread gets a ring, which is removed by the first flush after the thread exits.
+  for (uint32_t i = 0; i < 4; i++) {
+    std::thread writer([this]() -> void { writeLines(2); });
+    writer.join();
+  }
+  EXPECT_EQ(4UL, file_->numRings());
+  file_->flush();
+  EXPECT_EQ(8 * LINE_SIZE, written_.size());
+  EXPECT_EQ(0UL, file_->numRings());
+
+  // The ring of a thread which is still running is kept.
+  writeLines(1);
+  file_->flush();
+  EXPECT_EQ(9 * LINE_SIZE, written_.size());
+  EXPECT_EQ(1UL, file_->numRings());
+}
+
+TEST_F(FileOverflowTest, Block) {
+  createFile(Filesystem::WriteOverflowPolicy::Block);
+
+  // The writer waits for the flush thread rather than losing anything.
+  std::thread writer([this]() -> void { writeLines(LINES_PER_RING + 8); });
+  releaseWrites();
+  writer.join();
+  file_->flush();
+
+  EXPECT_EQ((LINES_PER_RING + 8) * LINE_SIZE, written_.size());
+  EXPECT_EQ(LINES_PER_RING + 8, stats_store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(0UL, stats_store_.counter("filesystem.write_dropped").value());
 }
+
 } // namespace Envoy
@@ -7,6 +7,7 @@
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
 #include "common/stats/stats_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "test/mocks/stats/mocks.h"
 #include "test/test_common/printers.h"
@@ -30,7 +31,8 @@ public:
                    const std::string& to_az = EMPTY_STRING) {
     CodeUtility::ResponseStatInfo info{
         global_store_,      cluster_scope_,        "prefix.", code,  internal_request,
-        request_vhost_name, request_vcluster_name, from_az,   to_az, canary};
+        request_vhost_name, request_vcluster_name, from_az,   to_az, canary,
+        nullptr};
 
     CodeUtility::chargeResponseStat(info);
   }
@@ -90,6 +92,61 @@ TEST_F(CodeUtilityTest, Canary) {
   EXPECT_EQ(16U, cluster_scope_.counters().size());
 }
 
+TEST_F(CodeUtilityTest, StatNames) {
+  CodeStatNames stat_names(cluster_scope_.symbolTable());
+  auto add_response = [&](uint64_t code, bool canary, bool internal_request) -> void {
+    CodeUtility::ResponseStatInfo info{global_store_,
+                                       cluster_scope_,
+                                       EMPTY_STRING,
+                                       code,
+                                       internal_request,
+                                       EMPTY_STRING,
+                                       EMPTY_STRING,
+                                       EMPTY_STRING,
+                                       EMPTY_STRING,
+                                       canary,
+                                       &stat_names};
+    CodeUtility::chargeResponseStat(info);
+  };
+
+  add_response(200, true, true);
+  add_response(503, false, false);
+  // Not a known code, so it is charged by string.
+  add_response(299, false, false);
+
+  EXPECT_EQ(2U, cluster_scope_.counter("upstream_rq_2xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("upstream_rq_200").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("internal.upstream_rq_2xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("internal.upstream_rq_200").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_2xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("canary.upstream_rq_200").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("upstream_rq_503").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_5xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_503").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("upstream_rq_299").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_2xx").value());
+  EXPECT_EQ(1U, cluster_scope_.counter("external.upstream_rq_299").value());
+
+  EXPECT_EQ(13U, cluster_scope_.counters().size());
+}
+
+TEST(CodeStatNamesTest, Lookup) {
+  Stats::SymbolTableImpl symbol_table;
+  {
+    CodeStatNames stat_names(symbol_table);
+    EXPECT_EQ("upstream_rq_404", stat_names.codeNames(404)->upstream_rq_->toString());
+    EXPECT_EQ("canary.upstream_rq_4xx",
+              stat_names.groupNames(404)->canary_upstream_rq_->toString());
+    EXPECT_EQ(nullptr, stat_names.codeNames(299));
+    EXPECT_EQ(nullptr, stat_names.codeNames(600));
+    EXPECT_EQ(nullptr, stat_names.groupNames(100));
+    EXPECT_EQ(nullptr, stat_names.groupNames(600));
+  }
+
+  EXPECT_EQ(0U, symbol_table.size());
+}
+
 TEST_F(CodeUtilityTest, All) {
   const std::vector<std::pair<Code, std::string>> test_set = {
       std::make_pair(Code::Continue, "Continue"),
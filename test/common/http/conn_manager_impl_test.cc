@@ -3,6 +3,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/buffer/buffer.h"
@@ -32,6 +33,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/allocation_counter.h"
 #include "test/test_common/printers.h"
 
 #include "gmock/gmock.h"
@@ -1233,6 +1235,86 @@ TEST_F(HttpConnectionManagerImplTest, DownstreamDisconnect) {
   conn_manager_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+namespace {
+
+class PassThroughFilter : public StreamFilter {
+public:
+  // Http::StreamFilterBase
+  void onDestroy() override {}
+
+  // Http::StreamDecoderFilter
+  FilterHeadersStatus decodeHeaders(HeaderMap&, bool) override {
+    return FilterHeadersStatus::Continue;
+  }
+  FilterDataStatus decodeData(Buffer::Instance&, bool) override {
+    return FilterDataStatus::Continue;
+  }
+  FilterTrailersStatus decodeTrailers(HeaderMap&) override {
+    return FilterTrailersStatus::Continue;
+  }
+  void setDecoderFilterCallbacks(StreamDecoderFilterCallbacks&) override {}
+
+  // Http::StreamEncoderFilter
+  FilterHeadersStatus encodeHeaders(HeaderMap&, bool) override {
+    return FilterHeadersStatus::Continue;
+  }
+  FilterDataStatus encodeData(Buffer::Instance&, bool) override {
+    return FilterDataStatus::Continue;
+  }
+  FilterTrailersStatus encodeTrailers(HeaderMap&) override {
+    return FilterTrailersStatus::Continue;
+  }
+  void setEncoderFilterCallbacks(StreamEncoderFilterCallbacks&) override {}
+};
+
+} // namespace
+
+// Filter wrappers come from the stream's arena, so creating a stream takes the same number of
+// allocations however long its filter chain is.
+TEST_F(HttpConnectionManagerImplTest, FilterChainAllocations) {
+  if (!TestAllocationCounter::enabled()) {
+    return;
+  }
+  setup(false, "");
+
+  std::vector<StreamFilterSharedPtr> filters;
+  for (uint32_t i = 0; i < 4; i++) {
+    filters.push_back(std::make_shared<PassThroughFilter>());
+  }
+  uint32_t num_filters = 0;
+  ON_CALL(filter_factory_, createFilterChain(_))
+      .WillByDefault(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        for (uint32_t i = 0; i < num_filters; i++) {
+          callbacks.addStreamFilter(filters[i]);
+        }
+      }));
+
+  NiceMock<MockStreamEncoder> encoder;
+  std::vector<uint64_t> allocations;
+  ON_CALL(*codec_, dispatch(_)).WillByDefault(Invoke([&](Buffer::Instance& data) -> void {
+    uint64_t count;
+    {
+      TestAllocationCounter counter;
+      conn_manager_->newStream(encoder);
+      count = counter.count();
+    }
+    allocations.push_back(count);
+    data.drain(data.length());
+  }));
+
+  // The first stream warms up anything allocated once.
+  for (uint32_t filter_count : {1, 1, 4}) {
+    num_filters = filter_count;
+    Buffer::OwnedImpl fake_input("1234");
+    conn_manager_->onData(fake_input);
+  }
+
+  ASSERT_EQ(3, allocations.size());
+  EXPECT_EQ(allocations[1], allocations[2]);
+
+  conn_manager_->onEvent(Network::ConnectionEvent::RemoteClose);
+}
+
 TEST_F(HttpConnectionManagerImplTest, DownstreamProtocolError) {
   InSequence s;
   setup(false, "");
@@ -339,6 +339,29 @@ TEST_F(ConnectionManagerUtilityTest, ExternalAddressExternalRequestUseRemote) {
   EXPECT_FALSE(headers.has("custom_header"));
 }
 
+// Tags for external requests are only set by the ip tagging filter, so a client can't spoof them.
+TEST_F(ConnectionManagerUtilityTest, ExternalRequestRemovesIpTags) {
+  Network::Address::Ipv4Instance external_ip("50.0.0.1");
+  ON_CALL(connection_, remoteAddress()).WillByDefault(ReturnRef(external_ip));
+  ON_CALL(config_, useRemoteAddress()).WillByDefault(Return(true));
+
+  TestHeaderMapImpl headers{{"x-envoy-ip-tags", "internal_only"}};
+  ConnectionManagerUtility::mutateRequestHeaders(headers, Protocol::Http2, connection_, config_,
+                                                 route_config_, random_, runtime_, local_info_);
+  EXPECT_FALSE(headers.has("x-envoy-internal"));
+  EXPECT_FALSE(headers.has("x-envoy-ip-tags"));
+
+  // Tags from a trusted internal hop are kept.
+  Network::Address::Ipv4Instance internal_ip("10.0.0.1");
+  ON_CALL(connection_, remoteAddress()).WillByDefault(ReturnRef(internal_ip));
+  TestHeaderMapImpl internal_headers{{"x-envoy-ip-tags", "upstream_tag"}};
+  ConnectionManagerUtility::mutateRequestHeaders(internal_headers, Protocol::Http2, connection_,
+                                                 config_, route_config_, random_, runtime_,
+                                                 local_info_);
+  EXPECT_TRUE(internal_headers.has("x-envoy-internal"));
+  EXPECT_EQ("upstream_tag", internal_headers.get_("x-envoy-ip-tags"));
+}
+
 TEST_F(ConnectionManagerUtilityTest, ExternalAddressExternalRequestDontUseRemote) {
   Network::Address::Ipv4Instance external_ip("60.0.0.1");
   ON_CALL(connection_, remoteAddress()).WillByDefault(ReturnRef(external_ip));
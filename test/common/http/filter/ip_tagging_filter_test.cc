@@ -2,14 +2,24 @@
 #include "common/http/filter/ip_tagging_filter.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
+#include "common/network/address_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/stats_impl.h"
 
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::NiceMock;
 using testing::Return;
+using testing::SaveArg;
 using testing::_;
 
 namespace Envoy {
@@ -53,45 +63,254 @@ public:
     }
   )EOF";
 
+  const std::string nested_json = R"EOF(
+    {
+      "ip_tags" : [
+        {
+          "ip_tag_name" : "private",
+          "ip_list" : ["10.0.0.0/8", "fd00::/8"]
+        },
+        {
+          "ip_tag_name" : "vpn",
+          "ip_list" : ["10.1.0.0/16"]
+        },
+        {
+          "ip_tag_name" : "bad_actor",
+          "ip_list" : ["10.1.2.3", "192.0.2.0/24"]
+        }
+      ]
+    }
+  )EOF";
+
   void SetUpTest(const std::string json) {
     Json::ObjectSharedPtr config = Json::Factory::loadFromString(json);
-    config_.reset(new IpTaggingFilterConfig(*config));
+    config_.reset(new IpTaggingFilterConfig(*config, "prefix.", stats_, dispatcher_, tls_));
     filter_.reset(new IpTaggingFilter(config_));
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
+    ON_CALL(filter_callbacks_, connection()).WillByDefault(Return(&connection_));
+  }
+
+  void setRemoteAddress(const std::string& address) {
+    connection_.remote_address_ = Network::Utility::parseInternetAddress(address);
   }
 
-  ~IpTaggingFilterTest() { filter_->onDestroy(); }
+  ~IpTaggingFilterTest() {
+    if (filter_) {
+      filter_->onDestroy();
+    }
+  }
 
+  void expectTags(const std::string& address, const std::string& tags) {
+    TestHeaderMapImpl headers;
+    filter_callbacks_.downstream_address_ = address;
+    EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+    EXPECT_EQ(tags, headers.get_(Headers::get().EnvoyIpTags));
+  }
+
+  Stats::IsolatedStoreImpl stats_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
   IpTaggingFilterConfigSharedPtr config_;
   std::unique_ptr<IpTaggingFilter> filter_;
   NiceMock<MockStreamDecoderFilterCallbacks> filter_callbacks_;
+  NiceMock<Network::MockConnection> connection_;
   TestHeaderMapImpl request_headers_;
   Buffer::OwnedImpl data_;
 };
 
 TEST_F(IpTaggingFilterTest, InternalRequest) {
   SetUpTest(internal_request_json);
+  setRemoteAddress("1.2.3.4");
 
+  TestHeaderMapImpl internal_headers{{"x-envoy-internal", "true"}};
+  EXPECT_CALL(filter_callbacks_, clearRouteCache());
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(internal_headers, false));
+  EXPECT_EQ("test_internal", internal_headers.get_(Headers::get().EnvoyIpTags));
+  EXPECT_EQ(1U, stats_.counter("prefix.ip_tagging.test_internal.hit").value());
+  EXPECT_EQ(1U, stats_.counter("prefix.ip_tagging.total").value());
+
+  // External requests are not tagged.
+  EXPECT_CALL(filter_callbacks_, clearRouteCache()).Times(0);
   EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_FALSE(request_headers_.has(Headers::get().EnvoyIpTags));
+  EXPECT_EQ(1U, stats_.counter("prefix.ip_tagging.total").value());
+
   EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(data_, false));
   EXPECT_EQ(FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers_));
 }
 
 TEST_F(IpTaggingFilterTest, ExternalRequest) {
   SetUpTest(external_request_json);
+  setRemoteAddress("1.2.3.4");
 
+  EXPECT_CALL(filter_callbacks_, clearRouteCache());
   EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ("test_external", request_headers_.get_(Headers::get().EnvoyIpTags));
+
+  // Internal requests are not tagged.
+  TestHeaderMapImpl internal_headers{{"x-envoy-internal", "true"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(internal_headers, false));
+  EXPECT_FALSE(internal_headers.has(Headers::get().EnvoyIpTags));
+
   EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(data_, false));
   EXPECT_EQ(FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers_));
 }
 
 TEST_F(IpTaggingFilterTest, BothRequest) {
   SetUpTest(both_request_json);
+  setRemoteAddress("1.2.3.4");
 
   EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ("test_both", request_headers_.get_(Headers::get().EnvoyIpTags));
+
+  TestHeaderMapImpl internal_headers{{"x-envoy-internal", "true"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(internal_headers, false));
+  EXPECT_EQ("test_both", internal_headers.get_(Headers::get().EnvoyIpTags));
+  EXPECT_EQ(2U, stats_.counter("prefix.ip_tagging.test_both.hit").value());
+
   EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(data_, false));
   EXPECT_EQ(FilterTrailersStatus::Continue, filter_->decodeTrailers(request_headers_));
 }
 
+TEST_F(IpTaggingFilterTest, NestedRanges) {
+  SetUpTest(nested_json);
+
+  expectTags("10.0.0.1", "private");
+  expectTags("10.1.0.1", "private,vpn");
+  expectTags("10.1.2.3", "private,vpn,bad_actor");
+  expectTags("192.0.2.77", "bad_actor");
+  expectTags("fd12::1", "private");
+  expectTags("11.0.0.1", "");
+  expectTags("::1", "");
+  EXPECT_EQ(2U, stats_.counter("prefix.ip_tagging.no_hit").value());
+  EXPECT_EQ(7U, stats_.counter("prefix.ip_tagging.total").value());
+  EXPECT_EQ(4U, stats_.counter("prefix.ip_tagging.private.hit").value());
+}
+
+TEST_F(IpTaggingFilterTest, AppendToExistingHeader) {
+  SetUpTest(nested_json);
+  setRemoteAddress("10.1.0.1");
+
+  TestHeaderMapImpl headers{{"x-envoy-ip-tags", "upstream_tag"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ("upstream_tag,private,vpn", headers.get_(Headers::get().EnvoyIpTags));
+}
+
+TEST_F(IpTaggingFilterTest, TagsByForwardedForAddress) {
+  SetUpTest(nested_json);
+  // A front proxy connects from 10.1.0.1 on behalf of a client at 1.2.3.4. The connection manager
+  // resolves the trusted x-forwarded-for address into downstreamAddress().
+  setRemoteAddress("10.1.0.1");
+  filter_callbacks_.downstream_address_ = "1.2.3.4";
+
+  TestHeaderMapImpl headers{{"x-forwarded-for", "1.2.3.4"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has(Headers::get().EnvoyIpTags));
+
+  filter_callbacks_.downstream_address_ = "10.2.0.1";
+  TestHeaderMapImpl private_headers{{"x-forwarded-for", "10.2.0.1"}};
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(private_headers, false));
+  EXPECT_EQ("private", private_headers.get_(Headers::get().EnvoyIpTags));
+  EXPECT_EQ(1U, stats_.counter("prefix.ip_tagging.no_hit").value());
+}
+
+TEST_F(IpTaggingFilterTest, FallBackToRemoteAddress) {
+  SetUpTest(nested_json);
+  setRemoteAddress("10.1.0.1");
+
+  filter_callbacks_.downstream_address_ = "";
+  TestHeaderMapImpl headers;
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_EQ("private,vpn", headers.get_(Headers::get().EnvoyIpTags));
+
+  filter_callbacks_.downstream_address_ = "not an address";
+  TestHeaderMapImpl bad_headers;
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(bad_headers, false));
+  EXPECT_EQ("private,vpn", bad_headers.get_(Headers::get().EnvoyIpTags));
+}
+
+TEST_F(IpTaggingFilterTest, NoIpRemoteAddress) {
+  SetUpTest(nested_json);
+
+  TestHeaderMapImpl headers;
+  connection_.remote_address_.reset(new Network::Address::PipeInstance("/foo"));
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has(Headers::get().EnvoyIpTags));
+
+  EXPECT_CALL(filter_callbacks_, connection()).WillOnce(Return(nullptr));
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has(Headers::get().EnvoyIpTags));
+  EXPECT_EQ(2U, stats_.counter("prefix.ip_tagging.no_hit").value());
+}
+
+TEST_F(IpTaggingFilterTest, InvalidConfig) {
+  const std::string bad_range_json = R"EOF(
+    {
+      "ip_tags" : [
+        {
+          "ip_tag_name" : "bad",
+          "ip_list" : ["10.0.0.0/foo"]
+        }
+      ]
+    }
+  )EOF";
+  EXPECT_THROW_WITH_MESSAGE(
+      SetUpTest(bad_range_json), EnvoyException,
+      "ip tagging: invalid ip/mask combo '10.0.0.0/foo' (format is <ip>[/<# mask bits>])");
+
+  const std::string bad_address_json = R"EOF(
+    {
+      "ip_tags" : [
+        {
+          "ip_tag_name" : "bad",
+          "ip_list" : ["foo"]
+        }
+      ]
+    }
+  )EOF";
+  EXPECT_THROW_WITH_MESSAGE(SetUpTest(bad_address_json), EnvoyException,
+                            "ip tagging: invalid ip/mask combo 'foo' (format is <ip>[/<# mask "
+                            "bits>])");
+
+  const std::string path_and_tags_json = R"EOF(
+    {
+      "ip_tags_path" : "/foo",
+      "ip_tags" : [
+        {
+          "ip_tag_name" : "bad",
+          "ip_list" : ["10.0.0.0/8"]
+        }
+      ]
+    }
+  )EOF";
+  EXPECT_THROW_WITH_MESSAGE(SetUpTest(path_and_tags_json), EnvoyException,
+                            "ip tagging: only one of 'ip_tags' and 'ip_tags_path' may be set");
+}
+
+TEST_F(IpTaggingFilterTest, TagsFromFile) {
+  const std::string path = TestEnvironment::writeStringToFileForTest("ip_tags.json", nested_json);
+
+  Filesystem::MockWatcher* watcher = new Filesystem::MockWatcher();
+  Filesystem::Watcher::OnChangedCb on_changed;
+  EXPECT_CALL(dispatcher_, createFilesystemWatcher_()).WillOnce(Return(watcher));
+  EXPECT_CALL(*watcher, addWatch(path, Filesystem::Watcher::Events::MovedTo, _))
+      .WillOnce(SaveArg<2>(&on_changed));
+  SetUpTest(fmt::format(R"EOF({{"ip_tags_path" : "{}"}})EOF", path));
+  expectTags("10.1.2.3", "private,vpn,bad_actor");
+
+  // A new file replaces the tags.
+  TestEnvironment::writeStringToFileForTest("ip_tags.json", internal_request_json);
+  on_changed(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(1U, stats_.counter("prefix.ip_tagging.reload_success").value());
+  expectTags("10.1.2.3", "");
+  expectTags("1.2.3.4", "test_internal");
+
+  // A bad file keeps the current tags.
+  TestEnvironment::writeStringToFileForTest("ip_tags.json", "{\"ip_tags\" : [{}]}");
+  on_changed(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(1U, stats_.counter("prefix.ip_tagging.reload_failed").value());
+  expectTags("1.2.3.4", "test_internal");
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -1,10 +1,15 @@
+#include <list>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "common/http/header_map_impl.h"
 
 #include "test/test_common/printers.h"
+#include "test/test_common/speed_test.h"
 #include "test/test_common/utility.h"
 
+#include "fmt/format.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -545,5 +550,145 @@ TEST(HeaderMapImplTest, IterateReverse) {
       &cb);
 }
 
+// Headers are spread over several blocks, and the slots of removed headers are reused without
+// changing the order.
+TEST(HeaderMapImplTest, ManyHeaders) {
+  TestHeaderMapImpl headers;
+  headers.insertHost().value(std::string("host"));
+  const HeaderEntry* host = headers.Host();
+  for (uint32_t i = 0; i < 100; i++) {
+    headers.addCopy(fmt::format("x-header-{}", i), std::to_string(i));
+  }
+  EXPECT_EQ(101UL, headers.size());
+  EXPECT_EQ(host, headers.Host());
+  EXPECT_EQ("42", headers.get_("x-header-42"));
+
+  for (uint32_t i = 0; i < 100; i += 2) {
+    headers.remove(LowerCaseString(fmt::format("x-header-{}", i)));
+  }
+  headers.removeHost();
+  EXPECT_EQ(50UL, headers.size());
+  for (uint32_t i = 100; i < 150; i++) {
+    headers.addCopy(fmt::format("x-header-{}", i), std::to_string(i));
+  }
+  EXPECT_EQ(100UL, headers.size());
+
+  std::vector<std::string> keys;
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &keys);
+  std::vector<std::string> expected_keys;
+  for (uint32_t i = 1; i < 100; i += 2) {
+    expected_keys.push_back(fmt::format("x-header-{}", i));
+  }
+  for (uint32_t i = 100; i < 150; i++) {
+    expected_keys.push_back(fmt::format("x-header-{}", i));
+  }
+  EXPECT_EQ(expected_keys, keys);
+
+  std::vector<std::string> reverse_keys;
+  headers.iterateReverse(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        static_cast<std::vector<std::string>*>(context)->push_back(header.key().c_str());
+        return HeaderMap::Iterate::Continue;
+      },
+      &reverse_keys);
+  EXPECT_EQ(std::vector<std::string>(expected_keys.rbegin(), expected_keys.rend()), reverse_keys);
+
+  TestHeaderMapImpl copy(static_cast<const HeaderMap&>(headers));
+  EXPECT_EQ(copy, headers);
+}
+
+namespace {
+
+// The layout of HeaderMapImpl before HeaderList, with a list node per header, as a baseline.
+typedef std::list<std::pair<HeaderString, HeaderString>> ListHeaders;
+
+const HeaderString* find(const ListHeaders& headers, const LowerCaseString& key) {
+  for (const auto& header : headers) {
+    if (header.first == key.get().c_str()) {
+      return &header.second;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace
+
+TEST(DISABLED_HeaderMapImplTest, Speed) {
+  const uint64_t iterations = 200000;
+  // A request with 5 inline and 20 other headers.
+  std::vector<std::pair<LowerCaseString, std::string>> request{
+      {Headers::get().Method, "GET"},
+      {Headers::get().Path, "/some/path?query=value"},
+      {Headers::get().Host, "example.com"},
+      {Headers::get().UserAgent, "curl/7.54.0"},
+      {Headers::get().RequestId, "ea4bf8d8-48d7-4fcb-9d1d-0e5a2c31c1ec"}};
+  for (uint32_t i = 0; i < 20; i++) {
+    request.emplace_back(LowerCaseString(fmt::format("x-custom-{}", i)), "value");
+  }
+  const LowerCaseString lookup_key("x-custom-10");
+
+  SpeedTest::run("HeaderMapImpl insert", iterations, [&]() -> void {
+    HeaderMapImpl headers;
+    for (const auto& header : request) {
+      headers.addReference(header.first, header.second);
+    }
+  });
+  SpeedTest::run("ListHeaders insert", iterations, [&]() -> void {
+    ListHeaders headers;
+    for (const auto& header : request) {
+      headers.emplace_back(std::piecewise_construct, std::forward_as_tuple(header.first),
+                           std::forward_as_tuple(header.second));
+    }
+  });
+
+  HeaderMapImpl headers;
+  ListHeaders list_headers;
+  for (const auto& header : request) {
+    headers.addReference(header.first, header.second);
+    list_headers.emplace_back(std::piecewise_construct, std::forward_as_tuple(header.first),
+                              std::forward_as_tuple(header.second));
+  }
+
+  uint64_t found = 0;
+  SpeedTest::run("HeaderMapImpl lookup", iterations,
+                 [&]() -> void { found += headers.get(lookup_key) != nullptr; });
+  SpeedTest::run("ListHeaders lookup", iterations,
+                 [&]() -> void { found += find(list_headers, lookup_key) != nullptr; });
+  EXPECT_EQ(2 * iterations, found);
+
+  uint64_t bytes = 0;
+  SpeedTest::run("HeaderMapImpl iterate", iterations, [&]() -> void {
+    headers.iterate(
+        [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+          *static_cast<uint64_t*>(context) += header.value().size();
+          return HeaderMap::Iterate::Continue;
+        },
+        &bytes);
+  });
+  uint64_t list_bytes = 0;
+  SpeedTest::run("ListHeaders iterate", iterations, [&]() -> void {
+    for (const auto& header : list_headers) {
+      list_bytes += header.second.size();
+    }
+  });
+  EXPECT_EQ(list_bytes, bytes);
+
+  SpeedTest::run("HeaderMapImpl copy", iterations,
+                 [&]() -> void { HeaderMapImpl copy(static_cast<const HeaderMap&>(headers)); });
+  SpeedTest::run("ListHeaders copy", iterations, [&]() -> void {
+    ListHeaders copy;
+    for (const auto& header : list_headers) {
+      copy.emplace_back();
+      copy.back().first.setCopy(header.first.c_str(), header.first.size());
+      copy.back().second.setCopy(header.second.c_str(), header.second.size());
+    }
+  });
+}
+
 } // namespace Http
 } // namespace Envoy
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <string>
 
 #include "envoy/buffer/buffer.h"
@@ -12,7 +13,10 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/speed_test.h"
+#include "test/test_common/utility.h"
 
+#include "fmt/format.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -473,6 +477,94 @@ TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// Requests in the common form are parsed by RequestParser and others by http_parser, which both
+// raise the same callbacks and leave the connection ready for the next request.
+TEST_F(Http1ServerConnectionImplTest, ParsedAndFallbackRequests) {
+  codec_settings_.fast_request_parser_ = true;
+  initialize();
+
+  InSequence sequence;
+
+  std::string output;
+  ON_CALL(connection_, write(_)).WillByDefault(AddBufferToString(&output));
+
+  Http::MockStreamDecoder decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  auto new_stream = [&](Http::StreamEncoder& encoder) -> Http::StreamDecoder& {
+    response_encoder = &encoder;
+    return decoder;
+  };
+
+  EXPECT_CALL(callbacks_, newStream(_)).WillOnce(Invoke(new_stream));
+  TestHeaderMapImpl expected_headers1{{"accept", "*/*"}, {":path", "/a"}, {":method", "GET"}};
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers1), true));
+
+  EXPECT_CALL(callbacks_, newStream(_)).WillOnce(Invoke(new_stream));
+  TestHeaderMapImpl expected_headers2{
+      {"content-length", "1"}, {":path", "/b"}, {":method", "POST"}};
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers2), false));
+  EXPECT_CALL(decoder, decodeData(_, false));
+  EXPECT_CALL(decoder, decodeData(_, true));
+
+  EXPECT_CALL(callbacks_, newStream(_)).WillOnce(Invoke(new_stream));
+  TestHeaderMapImpl expected_headers3{{"connection", "close"}, {":path", "/c"}, {":method", "GET"}};
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers3), true));
+
+  Buffer::OwnedImpl buffer("GET /a HTTP/1.1\r\naccept: */*\r\n\r\n"
+                           "POST /b HTTP/1.1\r\ncontent-length: 1\r\n\r\nx"
+                           "GET /c HTTP/1.1\r\nconnection: close\r\n\r\n");
+  for (uint32_t i = 0; i < 3; i++) {
+    codec_->dispatch(buffer);
+    response_encoder->encodeHeaders(TestHeaderMapImpl{{":status", "200"}}, true);
+  }
+  EXPECT_EQ(0U, buffer.length());
+
+  // Nothing may follow a request which closes the connection.
+  output.clear();
+  buffer.add("GET /d HTTP/1.1\r\n\r\n");
+  EXPECT_THROW(codec_->dispatch(buffer), CodecProtocolException);
+  EXPECT_EQ("HTTP/1.1 400 Bad Request\r\ncontent-length: 0\r\nconnection: close\r\n\r\n", output);
+}
+
+// A request which RequestParser rejects before scanning it, here one split across reads followed
+// by one with a body, is parsed by http_parser alone.
+TEST_F(Http1ServerConnectionImplTest, SplitRequestFallback) {
+  codec_settings_.fast_request_parser_ = true;
+  initialize();
+
+  InSequence sequence;
+
+  Http::MockStreamDecoder decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  auto new_stream = [&](Http::StreamEncoder& encoder) -> Http::StreamDecoder& {
+    response_encoder = &encoder;
+    return decoder;
+  };
+
+  EXPECT_CALL(callbacks_, newStream(_)).WillOnce(Invoke(new_stream));
+  TestHeaderMapImpl expected_headers1{{"accept", "*/*"}, {":path", "/a"}, {":method", "GET"}};
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers1), true));
+
+  Buffer::OwnedImpl buffer("GET /a HTTP/1.1\r\nacc");
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+  buffer.add("ept: */*\r\n\r\n");
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+  response_encoder->encodeHeaders(TestHeaderMapImpl{{":status", "200"}}, true);
+
+  EXPECT_CALL(callbacks_, newStream(_)).WillOnce(Invoke(new_stream));
+  TestHeaderMapImpl expected_headers2{
+      {"content-length", "4"}, {":path", "/b"}, {":method", "POST"}};
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers2), false));
+  EXPECT_CALL(decoder, decodeData(_, false));
+  EXPECT_CALL(decoder, decodeData(_, true));
+
+  buffer.add("POST /b HTTP/1.1\r\ncontent-length: 4\r\n\r\n\r\n\r\n");
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+}
+
 TEST_F(Http1ServerConnectionImplTest, RequestWithTrailers) {
   initialize();
 
@@ -524,6 +616,38 @@ TEST_F(Http1ServerConnectionImplTest, WatermarkTest) {
       ->onUnderlyingConnectionBelowWriteBufferLowWatermark();
 }
 
+// Encode cost by header value size.
+TEST(DISABLED_Http1ServerConnectionImplTest, EncodeHeadersSpeed) {
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<Http::MockServerConnectionCallbacks> callbacks;
+  ServerConnectionImpl codec(connection, callbacks, Http1Settings());
+  NiceMock<Http::MockStreamDecoder> decoder;
+  Http::StreamEncoder* response_encoder = nullptr;
+  ON_CALL(callbacks, newStream(_))
+      .WillByDefault(Invoke([&](Http::StreamEncoder& encoder) -> Http::StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  ON_CALL(connection, write(_))
+      .WillByDefault(Invoke([](Buffer::Instance& data) -> void { data.drain(data.length()); }));
+
+  const uint64_t iterations = 20000;
+  const LowerCaseString key("x-value");
+  for (uint32_t size = 16; size <= 64 * 1024; size *= 4) {
+    TestHeaderMapImpl headers{{":status", "200"}, {"content-length", "0"}};
+    headers.addCopy(key, std::string(size, 'v'));
+
+    std::chrono::nanoseconds duration{};
+    for (uint64_t i = 0; i < iterations; i++) {
+      Buffer::OwnedImpl request("GET / HTTP/1.1\r\n\r\n");
+      codec.dispatch(request);
+      duration +=
+          SpeedTest::time([&]() -> void { response_encoder->encodeHeaders(headers, true); });
+    }
+    SpeedTest::print(fmt::format("{} byte value", size), duration, iterations);
+  }
+}
+
 class Http1ClientConnectionImplTest : public testing::Test {
 public:
   void initialize() { codec_.reset(new ClientConnectionImpl(connection_, callbacks_)); }
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -12,6 +13,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/network/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/speed_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -173,6 +175,20 @@ TEST_P(Http2CodecImplTest, ExpectContinueTrailersResponse) {
   response_encoder_->encodeTrailers(response_trailers);
 }
 
+// Pseudo-headers which follow other headers in the map are still sent first.
+TEST_P(Http2CodecImplTest, PseudoHeadersAfterHeaders) {
+  initialize();
+
+  TestHeaderMapImpl request_headers{{"x-first", "1"}};
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_headers.addCopy("x-last", "2");
+  TestHeaderMapImpl expected_headers{{":scheme", "http"}, {":method", "GET"},
+                                     {":authority", "host"}, {":path", "/"},
+                                     {"x-first", "1"},       {"x-last", "2"}};
+  EXPECT_CALL(request_decoder_, decodeHeaders_(HeaderMapEqual(&expected_headers), true));
+  request_encoder_->encodeHeaders(request_headers, true);
+}
+
 TEST_P(Http2CodecImplTest, ShutdownNotice) {
   initialize();
 
@@ -648,6 +664,68 @@ TEST(Http2CodecUtility, reconstituteCrumbledCookies) {
   }
 }
 
+// Response header encode cost for gRPC like responses, whose headers repeat on every stream.
+TEST(DISABLED_Http2CodecImplTest, EncodeHeadersSpeed) {
+  Stats::IsolatedStoreImpl stats_store;
+  NiceMock<Network::MockConnection> client_connection;
+  NiceMock<MockConnectionCallbacks> client_callbacks;
+  ClientConnectionImpl client(client_connection, client_callbacks, stats_store, Http2Settings());
+  NiceMock<Network::MockConnection> server_connection;
+  NiceMock<MockServerConnectionCallbacks> server_callbacks;
+  ServerConnectionImpl server(server_connection, server_callbacks, stats_store, Http2Settings());
+
+  // Frames are handed over outside of the timed encodes.
+  Buffer::OwnedImpl to_client;
+  Buffer::OwnedImpl to_server;
+  ON_CALL(client_connection, write(_))
+      .WillByDefault(Invoke([&](Buffer::Instance& data) -> void { to_server.move(data); }));
+  ON_CALL(server_connection, write(_))
+      .WillByDefault(Invoke([&](Buffer::Instance& data) -> void { to_client.move(data); }));
+
+  NiceMock<MockStreamDecoder> decoder;
+  StreamEncoder* response_encoder = nullptr;
+  ON_CALL(server_callbacks, newStream(_))
+      .WillByDefault(Invoke([&](StreamEncoder& encoder) -> StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  TestHeaderMapImpl request_headers{{":method", "POST"},
+                                    {":path", "/helloworld.Greeter/SayHello"},
+                                    {":scheme", "http"},
+                                    {":authority", "greeter"},
+                                    {"content-type", "application/grpc"},
+                                    {"te", "trailers"}};
+  TestHeaderMapImpl small_headers{{"content-type", "application/grpc"}, {":status", "200"}};
+  TestHeaderMapImpl large_headers{{"content-type", "application/grpc"},
+                                  {"grpc-encoding", "identity"},
+                                  {"grpc-accept-encoding", "identity,deflate,gzip"},
+                                  {"x-request-id", "ea4bf8d8-48d7-4fcb-9d1d-0e5a2c31c1ec"},
+                                  {"server", "envoy"},
+                                  {"date", "Mon, 01 Jan 2018 00:00:00 GMT"}};
+  for (uint32_t i = 0; i < 10; i++) {
+    large_headers.addCopy(fmt::format("x-custom-{}", i), "value");
+  }
+  large_headers.addCopy(":status", "200");
+
+  const uint64_t iterations = 100000;
+  for (const auto& response_headers :
+       {std::make_pair("small", &small_headers), std::make_pair("large", &large_headers)}) {
+    std::chrono::nanoseconds duration{};
+    for (uint64_t i = 0; i < iterations; i++) {
+      client.newStream(decoder).encodeHeaders(request_headers, true);
+      server.dispatch(to_server);
+      duration += SpeedTest::time(
+          [&]() -> void { response_encoder->encodeHeaders(*response_headers.second, true); });
+      client.dispatch(to_client);
+      client_connection.dispatcher_.clearDeferredDeleteList();
+      server_connection.dispatcher_.clearDeferredDeleteList();
+    }
+    SpeedTest::print(fmt::format("{} response headers", response_headers.first), duration,
+                     iterations);
+  }
+}
+
 // For issue #1421 regression test that Envoy's H2 codec applies header limits early.
 TEST_P(Http2CodecImplTest, TestCodecHeaderLimits) {
   initialize();
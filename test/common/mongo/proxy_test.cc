@@ -138,6 +138,8 @@ TEST_F(MongoProxyFilterTest, DelayFaults) {
 
   EXPECT_EQ(Network::FilterStatus::StopIteration, filter_->onData(fake_data_));
   EXPECT_EQ(2U, store_.counter("test.op_query").value());
+  // Both queries are charged to the names interned for the collection by the first one.
+  EXPECT_EQ(2U, store_.counter("test.collection.test.query.total").value());
 
   EXPECT_CALL(*filter_->decoder_, onData(_)).WillOnce(Invoke([&](Buffer::Instance&) -> void {
     GetMoreMessagePtr message(new GetMoreMessageImpl(0, 0));
@@ -0,0 +1,84 @@
+#include "common/network/address_impl.h"
+#include "common/network/connection_balancer_impl.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+using testing::_;
+
+namespace Envoy {
+namespace Network {
+
+class ConnectionBalancerImplTest : public testing::Test {
+public:
+  ConnectionBalancerImplTest() {
+    for (NiceMock<MockBalancedListener>& listener : listeners_) {
+      balancer_.registerListener(listener);
+    }
+  }
+
+  ~ConnectionBalancerImplTest() {
+    for (NiceMock<MockBalancedListener>& listener : listeners_) {
+      balancer_.unregisterListener(listener);
+    }
+  }
+
+  bool balance(MockBalancedListener& listener) {
+    return balancer_.balanceConnection(listener, 42, remote_address_, local_address_, false);
+  }
+
+  ConnectionBalancerImpl balancer_;
+  NiceMock<MockBalancedListener> listeners_[3];
+  const Address::InstanceConstSharedPtr remote_address_{
+      new Address::Ipv4Instance("10.0.0.1", 50000)};
+  const Address::InstanceConstSharedPtr local_address_{new Address::Ipv4Instance("10.0.0.2", 80)};
+};
+
+TEST_F(ConnectionBalancerImplTest, PostToLeastLoaded) {
+  ON_CALL(listeners_[0], numConnections()).WillByDefault(Return(5));
+  ON_CALL(listeners_[1], numConnections()).WillByDefault(Return(3));
+  ON_CALL(listeners_[2], numConnections()).WillByDefault(Return(1));
+
+  EXPECT_CALL(listeners_[0], post(_, _, _, _)).Times(0);
+  EXPECT_CALL(listeners_[1], post(_, _, _, _)).Times(0);
+  EXPECT_CALL(listeners_[2], post(42, remote_address_, local_address_, false));
+  EXPECT_TRUE(balance(listeners_[0]));
+}
+
+TEST_F(ConnectionBalancerImplTest, KeepOnTie) {
+  ON_CALL(listeners_[0], numConnections()).WillByDefault(Return(2));
+  ON_CALL(listeners_[1], numConnections()).WillByDefault(Return(2));
+  ON_CALL(listeners_[2], numConnections()).WillByDefault(Return(3));
+
+  EXPECT_CALL(listeners_[0], post(_, _, _, _)).Times(0);
+  EXPECT_CALL(listeners_[1], post(_, _, _, _)).Times(0);
+  EXPECT_CALL(listeners_[2], post(_, _, _, _)).Times(0);
+  EXPECT_FALSE(balance(listeners_[0]));
+  EXPECT_FALSE(balance(listeners_[1]));
+}
+
+TEST_F(ConnectionBalancerImplTest, Unregister) {
+  ON_CALL(listeners_[0], numConnections()).WillByDefault(Return(5));
+  ON_CALL(listeners_[1], numConnections()).WillByDefault(Return(3));
+  ON_CALL(listeners_[2], numConnections()).WillByDefault(Return(1));
+
+  // An unregistered listener gets no connections, but may still hand its own to others.
+  NiceMock<MockBalancedListener> listener;
+  ON_CALL(listener, numConnections()).WillByDefault(Return(0));
+  balancer_.registerListener(listener);
+  balancer_.unregisterListener(listener);
+  EXPECT_CALL(listener, post(_, _, _, _)).Times(0);
+  EXPECT_CALL(listeners_[2], post(_, _, _, _));
+  EXPECT_TRUE(balance(listeners_[0]));
+
+  ON_CALL(listener, numConnections()).WillByDefault(Return(4));
+  EXPECT_CALL(listeners_[2], post(_, _, _, _));
+  EXPECT_TRUE(balance(listener));
+}
+
+} // namespace Network
+} // namespace Envoy
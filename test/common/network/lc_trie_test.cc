@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/network/address_impl.h"
+#include "common/network/cidr_range.h"
+#include "common/network/lc_trie.h"
+
+#include "test/test_common/speed_test.h"
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace LcTrie {
+
+typedef std::vector<std::pair<std::string, std::vector<std::string>>> TagData;
+
+LcTrie<std::string> makeTrie(const TagData& tag_data, double fill_factor = 0.5,
+                             uint32_t root_branching_factor = 0) {
+  std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> data;
+  for (const auto& tag : tag_data) {
+    data.emplace_back(tag.first, std::vector<Address::CidrRange>());
+    for (const std::string& range : tag.second) {
+      data.back().second.push_back(Address::CidrRange::create(range));
+    }
+  }
+  return LcTrie<std::string>(data, fill_factor, root_branching_factor);
+}
+
+std::vector<std::string> sorted(std::vector<std::string> tags) {
+  std::sort(tags.begin(), tags.end());
+  return tags;
+}
+
+std::vector<std::string> lookup(const LcTrie<std::string>& trie, const std::string& address) {
+  if (address.find(':') != std::string::npos) {
+    return sorted(trie.getData(Address::Ipv6Instance(address)));
+  }
+  return sorted(trie.getData(Address::Ipv4Instance(address)));
+}
+
+TEST(LcTrieTest, Empty) {
+  LcTrie<std::string> trie = makeTrie({});
+  EXPECT_TRUE(trie.empty());
+  EXPECT_TRUE(lookup(trie, "1.2.3.4").empty());
+  EXPECT_TRUE(lookup(trie, "::1").empty());
+}
+
+TEST(LcTrieTest, Ipv4) {
+  LcTrie<std::string> trie = makeTrie({
+      {"a", {"10.0.0.0/8"}},
+      {"b", {"10.1.0.0/16", "192.168.0.0/24"}},
+      {"c", {"10.1.2.0/24"}},
+      {"d", {"10.3.0.0/16"}},
+      {"e", {"172.16.0.0/12"}},
+      {"f", {"1.2.3.4/32"}},
+  });
+  EXPECT_FALSE(trie.empty());
+
+  EXPECT_EQ(std::vector<std::string>({"a"}), lookup(trie, "10.0.0.1"));
+  EXPECT_EQ(std::vector<std::string>({"a"}), lookup(trie, "10.2.0.1"));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), lookup(trie, "10.1.3.1"));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), lookup(trie, "10.1.2.255"));
+  EXPECT_EQ(std::vector<std::string>({"a", "d"}), lookup(trie, "10.3.255.255"));
+  EXPECT_EQ(std::vector<std::string>({"b"}), lookup(trie, "192.168.0.7"));
+  EXPECT_EQ(std::vector<std::string>({"e"}), lookup(trie, "172.31.0.1"));
+  EXPECT_EQ(std::vector<std::string>({"f"}), lookup(trie, "1.2.3.4"));
+
+  EXPECT_TRUE(lookup(trie, "1.2.3.5").empty());
+  EXPECT_TRUE(lookup(trie, "11.0.0.1").empty());
+  EXPECT_TRUE(lookup(trie, "172.32.0.1").empty());
+  EXPECT_TRUE(lookup(trie, "192.168.1.0").empty());
+  EXPECT_TRUE(lookup(trie, "::a00:1").empty());
+  EXPECT_TRUE(trie.getData(Address::PipeInstance("/foo")).empty());
+}
+
+TEST(LcTrieTest, Ipv6) {
+  LcTrie<std::string> trie = makeTrie({
+      {"a", {"2001:db8::/32"}},
+      {"b", {"2001:db8:85a3::/48"}},
+      {"c", {"2001:db8:85a3::8a2e:370:7334/128"}},
+      {"d", {"ffee::/16", "10.0.0.0/8"}},
+  });
+
+  EXPECT_EQ(std::vector<std::string>({"a"}), lookup(trie, "2001:db8:1::"));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), lookup(trie, "2001:db8:85a3::1"));
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}),
+            lookup(trie, "2001:db8:85a3::8a2e:370:7334"));
+  EXPECT_EQ(std::vector<std::string>({"d"}), lookup(trie, "ffee:1::"));
+  EXPECT_EQ(std::vector<std::string>({"d"}), lookup(trie, "10.1.1.1"));
+
+  EXPECT_TRUE(lookup(trie, "2001:db9::").empty());
+  EXPECT_TRUE(lookup(trie, "::1").empty());
+}
+
+TEST(LcTrieTest, MatchAll) {
+  LcTrie<std::string> trie = makeTrie({
+      {"all", {"0.0.0.0/0", "::/0"}},
+      {"local", {"127.0.0.0/8", "::1/128"}},
+  });
+
+  EXPECT_EQ(std::vector<std::string>({"all"}), lookup(trie, "1.1.1.1"));
+  EXPECT_EQ(std::vector<std::string>({"all"}), lookup(trie, "255.255.255.255"));
+  EXPECT_EQ(std::vector<std::string>({"all", "local"}), lookup(trie, "127.0.0.1"));
+  EXPECT_EQ(std::vector<std::string>({"all"}), lookup(trie, "::"));
+  EXPECT_EQ(std::vector<std::string>({"all", "local"}), lookup(trie, "::1"));
+}
+
+// Validate that a range listed more than once, or for more than one piece of data, is handled.
+TEST(LcTrieTest, DuplicateRanges) {
+  LcTrie<std::string> trie = makeTrie({
+      {"a", {"10.0.0.0/8", "10.0.0.0/8"}},
+      {"b", {"10.0.0.0/8"}},
+      {"a", {"10.0.0.0/16"}},
+  });
+
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), lookup(trie, "10.1.0.0"));
+  EXPECT_EQ(std::vector<std::string>({"a", "b"}), lookup(trie, "10.0.1.0"));
+}
+
+class LcTrieRandomTest : public testing::TestWithParam<std::pair<double, uint32_t>> {};
+
+// Compare lookups against a linear scan of the ranges, for random ranges with plenty of nesting.
+TEST_P(LcTrieRandomTest, MatchesLinearScan) {
+  std::mt19937 random(1);
+  std::vector<std::pair<uint32_t, std::vector<Address::CidrRange>>> data(32);
+  for (uint32_t i = 0; i < 2000; i++) {
+    // Keep the addresses in a small part of the space so that ranges overlap.
+    const uint32_t address = (10U << 24) | (random() & 0xffff) << (random() % 8);
+    const std::string ip = fmt::format("{}.{}.{}.{}", address >> 24, (address >> 16) & 0xff,
+                                       (address >> 8) & 0xff, address & 0xff);
+    data[i % data.size()].second.push_back(
+        Address::CidrRange::create(fmt::format("{}/{}", ip, 8 + random() % 25)));
+    data[i % data.size()].second.push_back(Address::CidrRange::create(fmt::format(
+        "2001:db8::{:x}:{:x}/{}", address >> 16, address & 0xffff, 96 + random() % 33)));
+  }
+  for (uint32_t i = 0; i < data.size(); i++) {
+    data[i].first = i;
+  }
+
+  LcTrie<uint32_t> trie(data, GetParam().first, GetParam().second);
+  for (uint32_t i = 0; i < 20000; i++) {
+    const uint32_t address = (10U << 24) | (random() & 0xffffff);
+    const std::string ip = fmt::format("{}.{}.{}.{}", address >> 24, (address >> 16) & 0xff,
+                                       (address >> 8) & 0xff, address & 0xff);
+    for (const Address::InstanceConstSharedPtr& instance :
+         {Address::InstanceConstSharedPtr{new Address::Ipv4Instance(ip)},
+          Address::InstanceConstSharedPtr{new Address::Ipv6Instance(
+              fmt::format("2001:db8::{:x}:{:x}", address >> 16, address & 0xffff))}}) {
+      std::vector<uint32_t> expected;
+      for (const auto& entry : data) {
+        for (const Address::CidrRange& range : entry.second) {
+          if (range.isInRange(*instance)) {
+            expected.push_back(entry.first);
+            break;
+          }
+        }
+      }
+
+      std::vector<uint32_t> actual = trie.getData(*instance);
+      std::sort(actual.begin(), actual.end());
+      ASSERT_EQ(expected, actual) << instance->asString();
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(FillFactors, LcTrieRandomTest,
+                        testing::Values(std::make_pair(0.25, 0U), std::make_pair(0.5, 0U),
+                                        std::make_pair(1.0, 0U), std::make_pair(0.5, 16U)));
+
+// Build and lookup speed for 100k ranges, compared to a linear scan of the ranges.
+TEST(LcTrieTest, DISABLED_Benchmark100kPrefixes) {
+  const uint32_t num_prefixes = 100000;
+  const uint32_t num_lookups = 1000000;
+  std::mt19937 random(1);
+
+  std::vector<std::pair<uint32_t, std::vector<Address::CidrRange>>> data(1);
+  std::vector<std::pair<uint32_t, uint32_t>> ranges;
+  for (uint32_t i = 0; i < num_prefixes; i++) {
+    const uint32_t length = 16 + random() % 17;
+    const uint32_t address = random() & (~0U << (32 - length));
+    data[0].second.push_back(Address::CidrRange::create(
+        fmt::format("{}.{}.{}.{}/{}", address >> 24, (address >> 16) & 0xff,
+                    (address >> 8) & 0xff, address & 0xff, length)));
+    ranges.emplace_back(address, length);
+  }
+
+  std::vector<Address::InstanceConstSharedPtr> addresses;
+  std::vector<uint32_t> raw_addresses;
+  for (uint32_t i = 0; i < 1000; i++) {
+    raw_addresses.push_back(random());
+    const uint32_t address = raw_addresses.back();
+    addresses.emplace_back(new Address::Ipv4Instance(
+        fmt::format("{}.{}.{}.{}", address >> 24, (address >> 16) & 0xff, (address >> 8) & 0xff,
+                    address & 0xff)));
+  }
+
+  for (uint32_t root_branching_factor : {0, 16}) {
+    std::unique_ptr<LcTrie<uint32_t>> trie;
+    const std::chrono::nanoseconds build_time = SpeedTest::time([&]() -> void {
+      trie.reset(new LcTrie<uint32_t>(data, 0.5, root_branching_factor));
+    });
+    SpeedTest::print(fmt::format("root branching factor {} build", root_branching_factor),
+                     build_time, 1);
+
+    uint32_t matches = 0;
+    const std::chrono::nanoseconds lookup_time = SpeedTest::time([&]() -> void {
+      for (uint32_t i = 0; i < num_lookups; i++) {
+        matches += trie->getData(*addresses[i % addresses.size()]).size();
+      }
+    });
+    SpeedTest::print(fmt::format("root branching factor {} lookup ({} matches)",
+                                 root_branching_factor, matches),
+                     lookup_time, num_lookups);
+  }
+
+  uint32_t matches = 0;
+  const std::chrono::nanoseconds linear_time = SpeedTest::time([&]() -> void {
+    for (uint32_t address : raw_addresses) {
+      for (const auto& range : ranges) {
+        if ((address & (~0U << (32 - range.second))) == range.first) {
+          matches++;
+          break;
+        }
+      }
+    }
+  });
+  SpeedTest::print(fmt::format("linear scan lookup ({} matches)", matches), linear_time,
+                   raw_addresses.size());
+}
+
+} // namespace LcTrie
+} // namespace Network
+} // namespace Envoy
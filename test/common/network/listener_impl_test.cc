@@ -1,4 +1,5 @@
 #include "common/network/address_impl.h"
+#include "common/network/connection_balancer_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/stats_impl.h"
@@ -327,5 +328,146 @@ TEST_P(ListenerImplTest, WildcardListenerUseActualDst) {
   dispatcher.run(Event::Dispatcher::RunType::Block);
 }
 
+TEST_P(ListenerImplTest, AcceptBatch) {
+  Stats::IsolatedStoreImpl stats_store;
+  Event::DispatcherImpl dispatcher;
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), true);
+  Network::MockListenerCallbacks listener_callbacks;
+  Network::MockConnectionHandler connection_handler;
+  // Connections beyond the batch are accepted on later wakeups rather than dropped.
+  Network::TestListenerImpl listener(connection_handler, dispatcher, socket, listener_callbacks,
+                                     stats_store,
+                                     {.bind_to_port_ = true,
+                                      .use_proxy_proto_ = false,
+                                      .use_original_dst_ = false,
+                                      .per_connection_buffer_limit_bytes_ = 0,
+                                      .accept_batch_size_ = 1});
+
+  std::vector<Network::ClientConnectionPtr> client_connections;
+  for (uint32_t i = 0; i < 3; i++) {
+    client_connections.push_back(dispatcher.createClientConnection(
+        socket.localAddress(), Network::Address::InstanceConstSharedPtr()));
+    client_connections.back()->connect();
+  }
+
+  std::vector<Network::ConnectionPtr> server_connections;
+  EXPECT_CALL(listener, newConnection(_, _, _, _)).Times(3);
+  EXPECT_CALL(listener_callbacks, onNewConnection_(_))
+      .Times(3)
+      .WillRepeatedly(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        server_connections.push_back(std::move(conn));
+        if (server_connections.size() == 3) {
+          dispatcher.exit();
+        }
+      }));
+
+  dispatcher.run(Event::Dispatcher::RunType::Block);
+
+  for (Network::ConnectionPtr& conn : server_connections) {
+    conn->close(ConnectionCloseType::NoFlush);
+  }
+  for (Network::ClientConnectionPtr& conn : client_connections) {
+    conn->close(ConnectionCloseType::NoFlush);
+  }
+}
+
+TEST_P(ListenerImplTest, BalanceConnection) {
+  Stats::IsolatedStoreImpl stats_store;
+  Event::DispatcherImpl dispatcher;
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), true);
+  ConnectionBalancerImpl balancer;
+  // Both listeners run on one dispatcher here, but have the connection counts of two workers.
+  Network::MockConnectionHandler connection_handler1;
+  Network::MockListenerCallbacks listener_callbacks1;
+  Network::TestListenerImpl listener1(connection_handler1, dispatcher, socket,
+                                      listener_callbacks1, stats_store,
+                                      {.bind_to_port_ = true,
+                                       .use_proxy_proto_ = false,
+                                       .use_original_dst_ = false,
+                                       .per_connection_buffer_limit_bytes_ = 0,
+                                       .accept_batch_size_ = 0,
+                                       .connection_balancer_ = &balancer});
+  Network::MockConnectionHandler connection_handler2;
+  Network::MockListenerCallbacks listener_callbacks2;
+  Network::TestListenerImpl listener2(connection_handler2, dispatcher, socket,
+                                      listener_callbacks2, stats_store,
+                                      {.bind_to_port_ = false,
+                                       .use_proxy_proto_ = false,
+                                       .use_original_dst_ = false,
+                                       .per_connection_buffer_limit_bytes_ = 0,
+                                       .accept_batch_size_ = 0,
+                                       .connection_balancer_ = &balancer});
+
+  Network::ClientConnectionPtr client_connection = dispatcher.createClientConnection(
+      socket.localAddress(), Network::Address::InstanceConstSharedPtr());
+  client_connection->connect();
+
+  EXPECT_CALL(connection_handler1, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(connection_handler2, numConnections()).WillRepeatedly(Return(1));
+  EXPECT_CALL(listener1, newConnection(_, _, _, _)).Times(0);
+  EXPECT_CALL(listener2, newConnection(_, _, _, _));
+  EXPECT_CALL(listener_callbacks2, onNewConnection_(_))
+      .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+        EXPECT_EQ(*socket.localAddress(), conn->localAddress());
+        client_connection->close(ConnectionCloseType::NoFlush);
+        conn->close(ConnectionCloseType::NoFlush);
+        dispatcher.exit();
+      }));
+
+  dispatcher.run(Event::Dispatcher::RunType::Block);
+}
+
+TEST_P(ListenerImplTest, BalanceConnectionToDestroyedDispatcher) {
+  Stats::IsolatedStoreImpl stats_store;
+  Event::DispatcherImpl dispatcher;
+  Network::TcpListenSocket socket(Network::Test::getCanonicalLoopbackAddress(version_), true);
+  ConnectionBalancerImpl balancer;
+  Network::MockConnectionHandler connection_handler1;
+  Network::MockListenerCallbacks listener_callbacks1;
+  Network::TestListenerImpl listener1(connection_handler1, dispatcher, socket,
+                                      listener_callbacks1, stats_store,
+                                      {.bind_to_port_ = true,
+                                       .use_proxy_proto_ = false,
+                                       .use_original_dst_ = false,
+                                       .per_connection_buffer_limit_bytes_ = 0,
+                                       .accept_batch_size_ = 0,
+                                       .connection_balancer_ = &balancer});
+  // The second listener's dispatcher never runs, so the connection posted to it stays queued.
+  std::unique_ptr<Event::DispatcherImpl> dispatcher2(new Event::DispatcherImpl());
+  Network::MockConnectionHandler connection_handler2;
+  Network::MockListenerCallbacks listener_callbacks2;
+  std::unique_ptr<Network::TestListenerImpl> listener2(new Network::TestListenerImpl(
+      connection_handler2, *dispatcher2, socket, listener_callbacks2, stats_store,
+      {.bind_to_port_ = false,
+       .use_proxy_proto_ = false,
+       .use_original_dst_ = false,
+       .per_connection_buffer_limit_bytes_ = 0,
+       .accept_batch_size_ = 0,
+       .connection_balancer_ = &balancer}));
+
+  Network::ClientConnectionPtr client_connection = dispatcher.createClientConnection(
+      socket.localAddress(), Network::Address::InstanceConstSharedPtr());
+  Network::MockConnectionCallbacks client_callbacks;
+  client_connection->addConnectionCallbacks(client_callbacks);
+  client_connection->connect();
+
+  EXPECT_CALL(connection_handler1, numConnections()).WillRepeatedly(Return(3));
+  EXPECT_CALL(connection_handler2, numConnections())
+      .WillRepeatedly(Invoke([&]() -> uint64_t {
+        dispatcher.exit();
+        return 1;
+      }));
+  EXPECT_CALL(client_callbacks, onEvent(ConnectionEvent::Connected));
+  EXPECT_CALL(*listener2, newConnection(_, _, _, _)).Times(0);
+  dispatcher.run(Event::Dispatcher::RunType::Block);
+
+  // Destroying the queued connection closes the accepted fd, which the client sees.
+  listener2.reset();
+  dispatcher2.reset();
+  EXPECT_CALL(client_callbacks, onEvent(ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher.exit(); }));
+  dispatcher.run(Event::Dispatcher::RunType::Block);
+}
+
 } // namespace Network
 } // namespace Envoy
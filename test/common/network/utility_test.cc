@@ -84,6 +84,16 @@ TEST(NetworkUtility, ParseInternetAddress) {
   EXPECT_EQ("[a:b:c:d::]:0", Utility::parseInternetAddress("a:b:c:d::")->asString());
 }
 
+TEST(NetworkUtility, ParseInternetAddressNoThrow) {
+  EXPECT_EQ(nullptr, Utility::parseInternetAddressNoThrow(""));
+  EXPECT_EQ(nullptr, Utility::parseInternetAddressNoThrow("1.2.3.256"));
+  EXPECT_EQ(nullptr, Utility::parseInternetAddressNoThrow("foo"));
+  EXPECT_EQ(nullptr, Utility::parseInternetAddressNoThrow("[::1]:1"));
+
+  EXPECT_EQ("1.2.3.4:0", Utility::parseInternetAddressNoThrow("1.2.3.4")->asString());
+  EXPECT_EQ("[::1]:0", Utility::parseInternetAddressNoThrow("::1")->asString());
+}
+
 TEST(NetworkUtility, ParseInternetAddressAndPort) {
   EXPECT_THROW(Utility::parseInternetAddressAndPort("1.2.3.4"), EnvoyException);
   EXPECT_THROW(Utility::parseInternetAddressAndPort("1.2.3.4:"), EnvoyException);
@@ -995,6 +995,36 @@ TEST(RouteMatcherTest, HeaderMatchedRouting) {
   }
 }
 
+// Without a :path header there is nothing to look up in the route index, so every route is tried.
+TEST(RouteMatcherTest, NoPath) {
+  std::string json = R"EOF(
+{
+  "virtual_hosts": [
+    {
+      "name": "local_service",
+      "domains": ["*"],
+      "routes": [
+        {
+          "prefix": "/",
+          "cluster": "local_service_with_headers",
+          "headers" : [
+            {"name": "test_header", "value": "test"}
+          ]
+        }
+      ]
+    }
+  ]
+}
+  )EOF";
+
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<Upstream::MockClusterManager> cm;
+  ConfigImpl config(parseRouteConfigurationFromJson(json), runtime, cm, true);
+
+  Http::TestHeaderMapImpl headers{{":authority", "www.lyft.com"}, {":method", "GET"}};
+  EXPECT_EQ(nullptr, config.route(headers, 0));
+}
+
 class RouterMatcherHashPolicyTest : public testing::Test {
 public:
   RouterMatcherHashPolicyTest()
@@ -1659,7 +1689,8 @@ TEST(RouteMatcherTest, Shadow) {
   EXPECT_EQ("", config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
                     ->routeEntry()
                     ->shadowPolicy()
-                    .runtimeKey());
+                    .runtimeKey()
+                    .name());
 
   EXPECT_EQ("some_cluster2", config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
                                  ->routeEntry()
@@ -1668,7 +1699,8 @@ TEST(RouteMatcherTest, Shadow) {
   EXPECT_EQ("foo", config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0)
                        ->routeEntry()
                        ->shadowPolicy()
-                       .runtimeKey());
+                       .runtimeKey()
+                       .name());
 
   EXPECT_EQ("", config.route(genHeaders("www.lyft.com", "/baz", "GET"), 0)
                     ->routeEntry()
@@ -1677,7 +1709,8 @@ TEST(RouteMatcherTest, Shadow) {
   EXPECT_EQ("", config.route(genHeaders("www.lyft.com", "/baz", "GET"), 0)
                     ->routeEntry()
                     ->shadowPolicy()
-                    .runtimeKey());
+                    .runtimeKey()
+                    .name());
 }
 
 TEST(RouteMatcherTest, Retry) {
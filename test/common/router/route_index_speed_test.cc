@@ -0,0 +1,110 @@
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/common/utility.h"
+#include "common/router/route_index.h"
+
+#include "test/test_common/speed_test.h"
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * This test is for benchmarking only and should not be run as part of unit tests. It compares the
+ * compiled route index against the linear scan that VirtualHostImpl used to do, for a virtual host
+ * with a large number of prefix and path routes.
+ */
+class DISABLED_RouteIndexSpeedTest : public testing::Test {
+public:
+  struct TestRoute {
+    std::string match_;
+    bool prefix_;
+  };
+
+  void buildRoutes(uint32_t num_routes) {
+    for (uint32_t i = 0; i < num_routes; i++) {
+      if (i % 2 == 0) {
+        routes_.push_back({fmt::format("/api/v{}/service_{}/", i % 7, i), true});
+        index_.addPrefix(i, routes_.back().match_, true);
+      } else {
+        routes_.push_back({fmt::format("/api/v{}/service_{}/health", i % 7, i), false});
+        index_.addPath(i, routes_.back().match_, true);
+      }
+    }
+    routes_.push_back({"/", true});
+    index_.addPrefix(num_routes, "/", true);
+    index_.finalize();
+  }
+
+  bool matches(uint32_t route_index, const std::string& path) const {
+    const TestRoute& route = routes_[route_index];
+    if (route.prefix_) {
+      return StringUtil::startsWith(path.c_str(), route.match_, true);
+    }
+    return path == route.match_;
+  }
+
+  void run(uint32_t num_routes) {
+    buildRoutes(num_routes);
+
+    std::vector<std::string> paths;
+    for (uint32_t i = 0; i < num_routes; i += 13) {
+      paths.push_back(fmt::format("/api/v{}/service_{}/health", i % 7, i));
+      paths.push_back(fmt::format("/api/v{}/service_{}/users/1234?x=y", i % 7, i));
+    }
+    paths.push_back("/not/found");
+
+    uint64_t linear_hits = 0;
+    const std::chrono::nanoseconds linear = SpeedTest::time([&]() -> void {
+      for (uint32_t iteration = 0; iteration < iterations_; iteration++) {
+        for (const std::string& path : paths) {
+          for (uint32_t route_index = 0; route_index < routes_.size(); route_index++) {
+            if (matches(route_index, path)) {
+              linear_hits += route_index;
+              break;
+            }
+          }
+        }
+      }
+    });
+
+    uint64_t index_hits = 0;
+    const std::chrono::nanoseconds indexed = SpeedTest::time([&]() -> void {
+      for (uint32_t iteration = 0; iteration < iterations_; iteration++) {
+        for (const std::string& path : paths) {
+          index_.findFirst(path.c_str(), path.size(), [&](uint32_t route_index) -> bool {
+            if (matches(route_index, path)) {
+              index_hits += route_index;
+              return true;
+            }
+            return false;
+          });
+        }
+      }
+    });
+
+    EXPECT_EQ(linear_hits, index_hits);
+    const uint64_t lookups = paths.size() * iterations_;
+    SpeedTest::print(fmt::format("{} routes linear", num_routes), linear, lookups);
+    SpeedTest::print(fmt::format("{} routes index ({} trie nodes)", num_routes, index_.nodeCount()),
+                     indexed, lookups);
+  }
+
+  const uint32_t iterations_ = 100;
+  std::vector<TestRoute> routes_;
+  RouteIndex index_;
+};
+
+TEST_F(DISABLED_RouteIndexSpeedTest, Routes100) { run(100); }
+
+TEST_F(DISABLED_RouteIndexSpeedTest, Routes1000) { run(1000); }
+
+TEST_F(DISABLED_RouteIndexSpeedTest, Routes5000) { run(5000); }
+
+} // namespace Router
+} // namespace Envoy
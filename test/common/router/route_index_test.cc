@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/router/route_index.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+
+class RouteIndexTest : public testing::Test {
+public:
+  std::vector<uint32_t> candidates(const std::string& path) {
+    std::vector<uint32_t> ret;
+    index_.findFirst(path.c_str(), path.size(), [&ret](uint32_t route_index) -> bool {
+      ret.push_back(route_index);
+      return false;
+    });
+    return ret;
+  }
+
+  RouteIndex index_;
+};
+
+TEST_F(RouteIndexTest, Empty) {
+  index_.finalize();
+  EXPECT_EQ(std::vector<uint32_t>{}, candidates("/"));
+  EXPECT_EQ(std::vector<uint32_t>{}, candidates(""));
+}
+
+TEST_F(RouteIndexTest, PrefixAndPathInConfigOrder) {
+  index_.addPrefix(0, "/new_endpoint", true);
+  index_.addPath(1, "/", true);
+  index_.addPrefix(2, "/", true);
+  index_.addUnindexed(3);
+  index_.addPrefix(4, "", true);
+  index_.finalize();
+
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 3, 4}), candidates("/"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 2, 3, 4}), candidates("/?foo=bar"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 2, 3, 4}), candidates("/new_endpoint/foo"));
+  EXPECT_EQ((std::vector<uint32_t>{2, 3, 4}), candidates("/new"));
+  EXPECT_EQ((std::vector<uint32_t>{3, 4}), candidates("foo"));
+}
+
+TEST_F(RouteIndexTest, CaseInsensitive) {
+  index_.addPrefix(0, "/API", false);
+  index_.addPath(1, "/Foo/Bar", false);
+  index_.addPath(2, "/Foo/Bar", true);
+  index_.finalize();
+
+  EXPECT_EQ((std::vector<uint32_t>{0}), candidates("/api/v1"));
+  EXPECT_EQ((std::vector<uint32_t>{0}), candidates("/aPi"));
+  EXPECT_EQ((std::vector<uint32_t>{1}), candidates("/foo/bar?x=y"));
+  EXPECT_EQ((std::vector<uint32_t>{1, 2}), candidates("/Foo/Bar"));
+  EXPECT_EQ((std::vector<uint32_t>{}), candidates("/foo/bar/baz"));
+}
+
+TEST_F(RouteIndexTest, PathIgnoresQueryStringButPrefixDoesNot) {
+  index_.addPrefix(0, "/foo?bar", true);
+  index_.addPath(1, "/foo", true);
+  index_.finalize();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), candidates("/foo?bar=baz"));
+  EXPECT_EQ((std::vector<uint32_t>{1}), candidates("/foo?baz"));
+  EXPECT_EQ((std::vector<uint32_t>{}), candidates("/foo/?bar"));
+}
+
+TEST_F(RouteIndexTest, DuplicateKeys) {
+  index_.addPrefix(0, "/a", true);
+  index_.addPrefix(1, "/a", true);
+  index_.addPrefix(2, "/ab", true);
+  index_.addPrefix(3, "/a", true);
+  index_.finalize();
+
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 2, 3}), candidates("/abc"));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1, 3}), candidates("/a"));
+}
+
+TEST_F(RouteIndexTest, StopsAtFirstMatch) {
+  index_.addPrefix(0, "/", true);
+  index_.addUnindexed(1);
+  index_.addPrefix(2, "/", true);
+  index_.finalize();
+
+  std::vector<uint32_t> visited;
+  EXPECT_TRUE(index_.findFirst("/", 1, [&visited](uint32_t route_index) -> bool {
+    visited.push_back(route_index);
+    return route_index == 1;
+  }));
+  EXPECT_EQ((std::vector<uint32_t>{0, 1}), visited);
+}
+
+} // namespace Router
+} // namespace Envoy
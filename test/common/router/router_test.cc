@@ -41,7 +41,8 @@ public:
   using Filter::Filter;
   // Filter
   RetryStatePtr createRetryState(const RetryPolicy&, Http::HeaderMap&, const Upstream::ClusterInfo&,
-                                 Runtime::Loader&, Runtime::RandomGenerator&, Event::Dispatcher&,
+                                 Runtime::Loader&, const RetryRuntimeKeys&,
+                                 Runtime::RandomGenerator&, Event::Dispatcher&,
                                  Upstream::ResourcePriority) override {
     EXPECT_EQ(nullptr, retry_state_);
     retry_state_ = new NiceMock<MockRetryState>();
@@ -1361,7 +1362,7 @@ TEST_F(RouterTest, RetryUpstreamGrpcCancelled) {
 
 TEST_F(RouterTest, Shadow) {
   callbacks_.route_->route_entry_.shadow_policy_.cluster_ = "foo";
-  callbacks_.route_->route_entry_.shadow_policy_.runtime_key_ = "bar";
+  callbacks_.route_->route_entry_.shadow_policy_.runtime_key_ = Runtime::Key("bar", 0);
   ON_CALL(callbacks_, streamId()).WillByDefault(Return(43));
 
   NiceMock<Http::MockStreamEncoder> encoder;
@@ -1593,7 +1594,7 @@ TEST(RouterFilterUtilityTest, shouldShadow) {
   {
     TestShadowPolicy policy;
     policy.cluster_ = "cluster";
-    policy.runtime_key_ = "foo";
+    policy.runtime_key_ = Runtime::Key("foo", 0);
     NiceMock<Runtime::MockLoader> runtime;
     EXPECT_CALL(runtime.snapshot_, featureEnabled("foo", 0, 5, 10000)).WillOnce(Return(false));
     EXPECT_FALSE(FilterUtility::shouldShadow(policy, runtime, 5));
@@ -1601,7 +1602,7 @@ TEST(RouterFilterUtilityTest, shouldShadow) {
   {
     TestShadowPolicy policy;
     policy.cluster_ = "cluster";
-    policy.runtime_key_ = "foo";
+    policy.runtime_key_ = Runtime::Key("foo", 0);
     NiceMock<Runtime::MockLoader> runtime;
     EXPECT_CALL(runtime.snapshot_, featureEnabled("foo", 0, 5, 10000)).WillOnce(Return(true));
     EXPECT_TRUE(FilterUtility::shouldShadow(policy, runtime, 5));
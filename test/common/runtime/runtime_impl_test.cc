@@ -1,5 +1,6 @@
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/runtime/runtime_impl.h"
 #include "common/stats/stats_impl.h"
@@ -10,6 +11,7 @@
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/speed_test.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -18,6 +20,7 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnNew;
+using testing::SaveArg;
 using testing::_;
 
 namespace Envoy {
@@ -74,7 +77,19 @@ public:
   void setup() {
     EXPECT_CALL(dispatcher, createFilesystemWatcher_())
         .WillOnce(ReturnNew<NiceMock<Filesystem::MockWatcher>>());
+    setupOsSysCalls();
+  }
+
+  // Like setup(), but saves the callback which reloads the runtime in on_symlink_swap_.
+  void setupWithReload() {
+    Filesystem::MockWatcher* watcher = new NiceMock<Filesystem::MockWatcher>();
+    EXPECT_CALL(dispatcher, createFilesystemWatcher_()).WillOnce(Return(watcher));
+    EXPECT_CALL(*watcher, addWatch(_, Filesystem::Watcher::Events::MovedTo, _))
+        .WillOnce(SaveArg<2>(&on_symlink_swap_));
+    setupOsSysCalls();
+  }
 
+  void setupOsSysCalls() {
     os_sys_calls_ = new NiceMock<Api::MockOsSysCalls>;
     ON_CALL(*os_sys_calls_, stat(_, _))
         .WillByDefault(
@@ -94,6 +109,7 @@ public:
   Stats::IsolatedStoreImpl store;
   MockRandomGenerator generator;
   std::unique_ptr<LoaderImpl> loader;
+  Filesystem::Watcher::OnChangedCb on_symlink_swap_;
 };
 
 TEST_F(RuntimeImplTest, All) {
@@ -153,6 +169,92 @@ TEST_F(RuntimeImplTest, OverrideFolderDoesNotExist) {
   EXPECT_EQ("hello", loader->snapshot().get("file1"));
 }
 
+TEST_F(RuntimeImplTest, RegisteredKeys) {
+  setupWithReload();
+  run("test/common/runtime/test_data/current", "envoy_override");
+
+  // Registering keys after the snapshot was loaded posts a single refresh to the main thread.
+  std::function<void()> refresh;
+  EXPECT_CALL(dispatcher, post(_)).WillOnce(SaveArg<0>(&refresh));
+  const Key file3 = loader->registerKey("file3");
+  const Key file4 = loader->registerKey("file4");
+  const Key invalid = loader->registerKey("invalid");
+  EXPECT_EQ(file3.index(), loader->registerKey("file3").index());
+  EXPECT_NE(file3.index(), file4.index());
+  EXPECT_EQ("file4", file4.name());
+
+  // Until the refresh runs, the keys are looked up by name.
+  EXPECT_EQ(2UL, loader->snapshot().getInteger(file3, 1));
+  EXPECT_EQ(1UL, loader->snapshot().getInteger(invalid, 1));
+  EXPECT_EQ(2UL, loader->snapshot().getInteger(Key("file3", file4.index()), 1));
+
+  // The refreshed snapshot looks the keys up by index, not by name.
+  refresh();
+  EXPECT_EQ(123UL, loader->snapshot().getInteger(Key("file3", file4.index()), 1));
+  EXPECT_EQ(2UL, loader->snapshot().getInteger(file3, 1));
+  EXPECT_EQ(123UL, loader->snapshot().getInteger(file4, 1));
+  EXPECT_EQ(1UL, loader->snapshot().getInteger(invalid, 1));
+  EXPECT_EQ(1UL, loader->snapshot().getInteger(Key(), 1));
+
+  // Keys which are already resolved don't post another refresh, new ones do.
+  loader->registerKey("file4");
+  EXPECT_CALL(dispatcher, post(_)).WillOnce(SaveArg<0>(&refresh));
+  const Key file2 = loader->registerKey("file2");
+  refresh();
+  EXPECT_EQ(1UL, loader->snapshot().getInteger(file2, 1));
+
+  // A new snapshot resolves the values of the registered keys when it is loaded.
+  on_symlink_swap_(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(123UL, loader->snapshot().getInteger(Key("file3", file4.index()), 1));
+  EXPECT_EQ(2UL, loader->snapshot().getInteger(file3, 1));
+
+  EXPECT_CALL(generator, random()).WillOnce(Return(1));
+  EXPECT_TRUE(loader->snapshot().featureEnabled(file3, 1));
+  EXPECT_CALL(generator, random()).WillOnce(Return(2));
+  EXPECT_FALSE(loader->snapshot().featureEnabled(file3, 1));
+  EXPECT_TRUE(loader->snapshot().featureEnabled(file3, 1, 1));
+  EXPECT_FALSE(loader->snapshot().featureEnabled(file3, 1, 3));
+  EXPECT_FALSE(loader->snapshot().featureEnabled(file4, 1, 200, 300));
+  EXPECT_TRUE(loader->snapshot().featureEnabled(file4, 1, 122, 300));
+  EXPECT_FALSE(loader->snapshot().featureEnabled(invalid, 0, 0, 300));
+}
+
+TEST_F(RuntimeImplTest, RegisteredKeysAfterDestroy) {
+  setup();
+  run("test/common/runtime/test_data/current", "envoy_override");
+
+  // A refresh which runs after the loader is destroyed does nothing.
+  std::function<void()> refresh;
+  EXPECT_CALL(dispatcher, post(_)).WillOnce(SaveArg<0>(&refresh));
+  loader->registerKey("file3");
+  loader.reset();
+  refresh();
+}
+
+// Lookup speed by registered key compared to lookup by name.
+TEST_F(RuntimeImplTest, DISABLED_BenchmarkRegisteredKeys) {
+  const uint32_t num_lookups = 10000000;
+  setupWithReload();
+  run("test/common/runtime/test_data/current", "envoy_override");
+  const std::vector<std::string> names{"file4", "upstream.healthy_panic_threshold"};
+  std::vector<Key> keys;
+  for (const std::string& name : names) {
+    keys.push_back(loader->registerKey(name));
+  }
+  on_symlink_swap_(Filesystem::Watcher::Events::MovedTo);
+  Snapshot& snapshot = loader->snapshot();
+
+  for (uint32_t i = 0; i < names.size(); i++) {
+    uint64_t name_sum = 0;
+    SpeedTest::run(names[i] + " lookup by name", num_lookups,
+                   [&]() -> void { name_sum += snapshot.getInteger(names[i], 0); });
+    uint64_t key_sum = 0;
+    SpeedTest::run(names[i] + " lookup by key", num_lookups,
+                   [&]() -> void { key_sum += snapshot.getInteger(keys[i], 0); });
+    EXPECT_EQ(name_sum, key_sum);
+  }
+}
+
 TEST(NullRuntimeImplTest, All) {
   MockRandomGenerator generator;
   NullLoaderImpl loader(generator);
@@ -160,6 +262,13 @@ TEST(NullRuntimeImplTest, All) {
   EXPECT_EQ(1UL, loader.snapshot().getInteger("foo", 1));
   EXPECT_CALL(generator, random()).WillOnce(Return(49));
   EXPECT_TRUE(loader.snapshot().featureEnabled("foo", 50));
+
+  const Key foo = loader.registerKey("foo");
+  EXPECT_EQ(1UL, loader.snapshot().getInteger(foo, 1));
+  EXPECT_CALL(generator, random()).WillOnce(Return(50));
+  EXPECT_FALSE(loader.snapshot().featureEnabled(foo, 50));
+  EXPECT_TRUE(loader.snapshot().featureEnabled(foo, 50, 49));
+  EXPECT_FALSE(loader.snapshot().featureEnabled(foo, 50, 50, 100));
 }
 
 } // namespace Runtime
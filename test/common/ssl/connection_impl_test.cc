@@ -1,6 +1,9 @@
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
@@ -12,10 +15,12 @@
 #include "common/ssl/connection_impl.h"
 #include "common/ssl/context_config_impl.h"
 #include "common/ssl/context_impl.h"
+#include "common/ssl/session_cache_impl.h"
 #include "common/stats/stats_impl.h"
 
 #include "test/common/ssl/ssl_certs_test.h"
 #include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/server/mocks.h"
@@ -23,12 +28,15 @@
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/speed_test.h"
 
+#include "fmt/format.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "openssl/ssl.h"
 
 using testing::Invoke;
+using testing::ReturnPointee;
 using testing::StrictMock;
 using testing::_;
 
@@ -577,25 +585,27 @@ TEST_P(SslConnectionImplTest, ClientAuthMultipleCAs) {
 
 namespace {
 
-// Test connecting with a client to server1, then trying to reuse the session on server2
+// Test connecting with a client to server1, then trying to reuse the session on server2. With a
+// session cache, the client does not use tickets and the session is resumed by ID.
 void testTicketSessionResumption(const std::string& server_ctx_json1,
                                  const std::string& server_ctx_json2,
                                  const std::string& client_ctx_json, bool expect_reuse,
-                                 const Network::Address::IpVersion ip_version) {
+                                 const Network::Address::IpVersion ip_version,
+                                 SessionCache* session_cache = nullptr) {
   Stats::IsolatedStoreImpl stats_store;
   Runtime::MockLoader runtime;
+  Event::DispatcherImpl dispatcher;
 
   Json::ObjectSharedPtr server_ctx_loader1 = TestEnvironment::jsonLoadFromString(server_ctx_json1);
   Json::ObjectSharedPtr server_ctx_loader2 = TestEnvironment::jsonLoadFromString(server_ctx_json2);
   ServerContextConfigImpl server_ctx_config1(*server_ctx_loader1);
   ServerContextConfigImpl server_ctx_config2(*server_ctx_loader2);
-  ContextManagerImpl manager(runtime);
+  ContextManagerImpl manager(runtime, dispatcher, session_cache);
   ServerContextPtr server_ctx1(
       manager.createSslServerContext("server1", {}, stats_store, server_ctx_config1, false));
   ServerContextPtr server_ctx2(
       manager.createSslServerContext("server2", {}, stats_store, server_ctx_config2, false));
 
-  Event::DispatcherImpl dispatcher;
   Network::TcpListenSocket socket1(Network::Test::getCanonicalLoopbackAddress(ip_version), true);
   Network::TcpListenSocket socket2(Network::Test::getCanonicalLoopbackAddress(ip_version), true);
   NiceMock<Network::MockListenerCallbacks> callbacks;
@@ -615,6 +625,10 @@ void testTicketSessionResumption(const std::string& server_ctx_json1,
 
   Network::MockConnectionCallbacks client_connection_callbacks;
   client_connection->addConnectionCallbacks(client_connection_callbacks);
+  if (session_cache != nullptr) {
+    SSL_set_options(dynamic_cast<Ssl::SslSocket*>(client_connection->ssl())->rawSslForTest(),
+                    SSL_OP_NO_TICKET);
+  }
   client_connection->connect();
 
   SSL_SESSION* ssl_session = nullptr;
@@ -644,6 +658,9 @@ void testTicketSessionResumption(const std::string& server_ctx_json1,
   Ssl::SslSocket* ssl_connection = dynamic_cast<Ssl::SslSocket*>(client_connection->ssl());
   SSL_set_session(ssl_connection->rawSslForTest(), ssl_session);
   SSL_SESSION_free(ssl_session);
+  if (session_cache != nullptr) {
+    SSL_set_options(ssl_connection->rawSslForTest(), SSL_OP_NO_TICKET);
+  }
 
   client_connection->connect();
 
@@ -677,6 +694,10 @@ void testTicketSessionResumption(const std::string& server_ctx_json1,
 
   // One for client, one for server
   EXPECT_EQ(expect_reuse ? 2UL : 0UL, stats_store.counter("ssl.session_reused").value());
+  if (session_cache != nullptr) {
+    // The session is found even when it cannot be resumed by server2.
+    EXPECT_EQ(1UL, stats_store.counter("ssl.session_cache_hit").value());
+  }
 }
 } // namespace
 
@@ -842,6 +863,52 @@ TEST_P(SslConnectionImplTest, TicketSessionResumptionDifferentServerCertDifferen
                               GetParam());
 }
 
+// Sessions created by one listener are resumed by ID on another, as they would be by the next
+// process after a hot restart.
+TEST_P(SslConnectionImplTest, SessionCacheResumption) {
+  std::string server_ctx_json = R"EOF(
+  {
+    "cert_chain_file": "{{ test_tmpdir }}/unittestcert.pem",
+    "private_key_file": "{{ test_tmpdir }}/unittestkey.pem"
+  }
+  )EOF";
+
+  std::string client_ctx_json = R"EOF(
+  {
+  }
+  )EOF";
+
+  SessionCacheImpl session_cache(16);
+  testTicketSessionResumption(server_ctx_json, server_ctx_json, client_ctx_json, true, GetParam(),
+                              &session_cache);
+}
+
+// A cached session is not resumed by a listener whose certificate has different SANs.
+TEST_P(SslConnectionImplTest, SessionCacheResumptionDifferentServerCertDifferentSAN) {
+  std::string server_ctx_json1 = R"EOF(
+  {
+    "cert_chain_file": "{{ test_rundir }}/test/common/ssl/test_data/san_dns_cert.pem",
+    "private_key_file": "{{ test_rundir }}/test/common/ssl/test_data/san_dns_key.pem"
+  }
+  )EOF";
+
+  std::string server_ctx_json2 = R"EOF(
+  {
+    "cert_chain_file": "{{ test_rundir }}/test/common/ssl/test_data/san_multiple_dns_cert.pem",
+    "private_key_file": "{{ test_rundir }}/test/common/ssl/test_data/san_multiple_dns_key.pem"
+  }
+  )EOF";
+
+  std::string client_ctx_json = R"EOF(
+  {
+  }
+  )EOF";
+
+  SessionCacheImpl session_cache(16);
+  testTicketSessionResumption(server_ctx_json1, server_ctx_json2, client_ctx_json, false,
+                              GetParam(), &session_cache);
+}
+
 // Test that if two listeners use the same cert and session ticket key, but
 // different client CA, that sessions cannot be resumed.
 TEST_P(SslConnectionImplTest, ClientAuthCrossListenerSessionResumption) {
@@ -1573,6 +1640,10 @@ TEST_P(SslConnectionImplTest, SniProtocolVersions) {
 class SslReadBufferLimitTest : public SslCertsTest,
                                public testing::WithParamInterface<Network::Address::IpVersion> {
 public:
+  SslReadBufferLimitTest() {
+    ON_CALL(time_source_, currentTime()).WillByDefault(ReturnPointee(&now_));
+  }
+
   void initialize(uint32_t read_buffer_limit) {
     server_ctx_loader_ = TestEnvironment::jsonLoadFromString(server_ctx_json_);
     server_ctx_config_.reset(new ServerContextConfigImpl(*server_ctx_loader_));
@@ -1657,7 +1728,8 @@ public:
   void singleWriteTest(uint32_t read_buffer_limit, uint32_t bytes_to_write) {
     MockWatermarkBuffer* client_write_buffer = nullptr;
     MockBufferFactory* factory = new StrictMock<MockBufferFactory>;
-    dispatcher_.reset(new Event::DispatcherImpl(Buffer::WatermarkFactoryPtr{factory}));
+    dispatcher_.reset(
+        new Event::DispatcherImpl(Buffer::WatermarkFactoryPtr{factory}, time_source_));
 
     // By default, expect 4 buffers to be created - the client and server read and write buffers.
     EXPECT_CALL(*factory, create_(_, _))
@@ -1708,6 +1780,80 @@ public:
     disconnect();
   }
 
+  // Writes num_responses responses from the client, each made of separate slices of the given
+  // sizes, and returns the number of TLS records the client sent them in. If before_response is
+  // set, it is called before each response is written, and each response is received in full
+  // before the next one is written.
+  uint64_t sliceWriteTest(const std::vector<uint32_t>& slice_sizes, uint32_t num_responses,
+                          std::function<void()> before_response = nullptr) {
+    initialize(0);
+
+    EXPECT_CALL(listener_callbacks_, onNewConnection_(_))
+        .WillOnce(Invoke([&](Network::ConnectionPtr& conn) -> void {
+          server_connection_ = std::move(conn);
+          server_connection_->addConnectionCallbacks(server_callbacks_);
+          server_connection_->addReadFilter(read_filter_);
+        }));
+
+    EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+    // Each record is sealed and sent to the socket with one write.
+    uint64_t records = 0;
+    SSL* client_ssl = dynamic_cast<SslSocket*>(client_connection_->ssl())->rawSslForTest();
+    SSL_set_msg_callback(client_ssl, [](int is_write, int, int content_type, const void*, size_t,
+                                        SSL*, void* arg) -> void {
+      if (is_write && content_type == SSL3_RT_HEADER) {
+        (*static_cast<uint64_t*>(arg))++;
+      }
+    });
+    SSL_set_msg_callback_arg(client_ssl, &records);
+
+    std::string response;
+    for (uint32_t i = 0; i < slice_sizes.size(); i++) {
+      response += std::string(slice_sizes[i], 'a' + i % 26);
+    }
+    std::string expected;
+    std::string received;
+    EXPECT_CALL(*read_filter_, onNewConnection());
+    EXPECT_CALL(*read_filter_, onData(_))
+        .WillRepeatedly(Invoke([&](Buffer::Instance& data) -> Network::FilterStatus {
+          received += TestUtility::bufferToString(data);
+          data.drain(data.length());
+          if (received.size() == expected.size()) {
+            dispatcher_->exit();
+          }
+          return Network::FilterStatus::StopIteration;
+        }));
+
+    for (uint32_t i = 0; i < num_responses; i++) {
+      if (before_response) {
+        before_response();
+      }
+
+      Buffer::OwnedImpl data;
+      for (uint32_t j = 0; j < slice_sizes.size(); j++) {
+        // Moving a buffer keeps its slice.
+        Buffer::OwnedImpl slice(std::string(slice_sizes[j], 'a' + j % 26));
+        data.move(slice);
+      }
+      expected += response;
+      client_connection_->write(data);
+      if (before_response) {
+        dispatcher_->run(Event::Dispatcher::RunType::Block);
+      }
+    }
+    if (!before_response) {
+      dispatcher_->run(Event::Dispatcher::RunType::Block);
+    }
+    EXPECT_EQ(expected, received);
+    EXPECT_EQ(0UL, stats_store_.counter("ssl.connection_error").value());
+
+    disconnect();
+    return records;
+  }
+
   void disconnect() {
     EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::LocalClose));
     EXPECT_CALL(server_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
@@ -1718,7 +1864,9 @@ public:
   }
 
   Stats::IsolatedStoreImpl stats_store_;
-  Event::DispatcherPtr dispatcher_{new Event::DispatcherImpl};
+  MonotonicTime now_;
+  NiceMock<MockMonotonicTimeSource> time_source_;
+  Event::DispatcherPtr dispatcher_{new Event::DispatcherImpl(time_source_)};
   Network::TcpListenSocket socket_{Network::Test::getCanonicalLoopbackAddress(GetParam()), true};
   Network::MockListenerCallbacks listener_callbacks_;
   Network::MockConnectionHandler connection_handler_;
@@ -1773,6 +1921,72 @@ TEST_P(SslReadBufferLimitTest, WritesSmallerThanBufferLimit) { singleWriteTest(5
 
 TEST_P(SslReadBufferLimitTest, WritesLargerThanBufferLimit) { singleWriteTest(1024, 5 * 1024); }
 
+// Small slices are coalesced into records of MIN_RECORD_SIZE, also across more slices than are
+// fetched at once.
+TEST_P(SslReadBufferLimitTest, SmallSlicesShareRecords) {
+  const std::vector<uint32_t> slice_sizes(100, 100);
+  EXPECT_EQ((100 * 100 + SslSocket::MIN_RECORD_SIZE - 1) / SslSocket::MIN_RECORD_SIZE,
+            sliceWriteTest(slice_sizes, 1));
+}
+
+// Large slices are cut into records without being copied, and the pieces around them are
+// coalesced with their neighbours.
+TEST_P(SslReadBufferLimitTest, MixedSlicesShareRecords) {
+  const uint32_t large = 3 * SslSocket::MIN_RECORD_SIZE + 100;
+  EXPECT_EQ(5UL, sliceWriteTest({200, large, 200, 1, SslSocket::MIN_RECORD_SIZE}, 1));
+}
+
+// Once a connection has written RECORD_SIZE_BOOST_THRESHOLD bytes, it writes MAX_RECORD_SIZE
+// records.
+TEST_P(SslReadBufferLimitTest, RecordSizeBoost) {
+  const uint32_t size = SslSocket::RECORD_SIZE_BOOST_THRESHOLD;
+  const std::vector<uint32_t> slice_sizes(2, size);
+  EXPECT_EQ(size / SslSocket::MIN_RECORD_SIZE + 1 + size / SslSocket::MAX_RECORD_SIZE,
+            sliceWriteTest(slice_sizes, 1));
+}
+
+// A connection that goes idle for RECORD_SIZE_IDLE_TIMEOUT_MS goes back to MIN_RECORD_SIZE records.
+TEST_P(SslReadBufferLimitTest, RecordSizeResetAfterIdle) {
+  const uint32_t size = SslSocket::RECORD_SIZE_BOOST_THRESHOLD;
+  EXPECT_EQ(2 * ((size + SslSocket::MIN_RECORD_SIZE - 1) / SslSocket::MIN_RECORD_SIZE),
+            sliceWriteTest({size}, 2, [this]() -> void {
+              now_ += std::chrono::milliseconds(SslSocket::RECORD_SIZE_IDLE_TIMEOUT_MS);
+            }));
+}
+
+// Measures throughput and writes per response for common patterns of response slices. Writes are
+// counted as TLS records, each of which is sent to the socket with one write.
+TEST_P(SslReadBufferLimitTest, DISABLED_SliceWriteBenchmark) {
+  const uint32_t num_responses = 2000;
+  const std::vector<std::pair<std::string, std::vector<uint32_t>>> patterns{
+      {"headers and small body", {200, 20, 1000}},
+      {"headers and 16 body chunks", std::vector<uint32_t>(17, 512)},
+      {"headers and large body", {200, 64 * 1024}},
+      {"many tiny slices", std::vector<uint32_t>(32, 16)},
+  };
+
+  for (const auto& pattern : patterns) {
+    uint64_t response_size = 0;
+    for (uint32_t size : pattern.second) {
+      response_size += size;
+    }
+
+    uint64_t records = 0;
+    const std::chrono::nanoseconds duration = SpeedTest::time(
+        [&]() -> void { records = sliceWriteTest(pattern.second, num_responses); });
+    SpeedTest::printThroughput(
+        fmt::format("{} ({} slices per response, {:.2f} writes per response)", pattern.first,
+                    pattern.second.size(), static_cast<double>(records) / num_responses),
+        duration, num_responses, response_size * num_responses);
+
+    client_connection_.reset();
+    server_connection_.reset();
+    listener_.reset();
+    client_ctx_.reset();
+    server_ctx_.reset();
+  }
+}
+
 TEST_P(SslReadBufferLimitTest, TestBind) {
   std::string address_string = TestUtility::getIpv4Loopback();
   if (GetParam() == Network::Address::IpVersion::v4) {
@@ -7,11 +7,19 @@
 #include "common/stats/stats_impl.h"
 
 #include "test/common/ssl/ssl_certs_test.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/filesystem/mocks.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/test_common/environment.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::NiceMock;
+using testing::Return;
+using testing::SaveArg;
+using testing::_;
+
 namespace Envoy {
 namespace Ssl {
 
@@ -266,5 +274,53 @@ TEST_F(SslServerContextImplTicketTest, TicketKeyInlineFailTooSmall) {
   EXPECT_THROW(loadConfigV2(cfg), EnvoyException);
 }
 
+TEST_F(SslServerContextImplTicketTest, TicketKeyPaths) {
+  envoy::api::v2::DownstreamTlsContext cfg;
+  cfg.mutable_session_ticket_keys()->add_keys()->set_filename(
+      TestEnvironment::substitute("{{ test_rundir }}/test/common/ssl/test_data/ticket_key_a"));
+  EXPECT_EQ(std::vector<std::string>({TestEnvironment::substitute(
+                "{{ test_rundir }}/test/common/ssl/test_data/ticket_key_a")}),
+            ServerContextConfigImpl(cfg).sessionTicketKeyPaths());
+
+  // Keys are only reloaded when they all come from files.
+  cfg.mutable_session_ticket_keys()->add_keys()->set_inline_(std::string(80, '\0'));
+  EXPECT_TRUE(ServerContextConfigImpl(cfg).sessionTicketKeyPaths().empty());
+}
+
+TEST_F(SslServerContextImplTicketTest, TicketKeyReload) {
+  const std::string path =
+      TestEnvironment::writeStringToFileForTest("ticket_key", std::string(80, 'a'));
+  envoy::api::v2::DownstreamTlsContext cfg;
+  envoy::api::v2::TlsCertificate* server_cert =
+      cfg.mutable_common_tls_context()->add_tls_certificates();
+  server_cert->mutable_certificate_chain()->set_filename(
+      TestEnvironment::substitute("{{ test_tmpdir }}/unittestcert.pem"));
+  server_cert->mutable_private_key()->set_filename(
+      TestEnvironment::substitute("{{ test_tmpdir }}/unittestkey.pem"));
+  cfg.mutable_session_ticket_keys()->add_keys()->set_filename(path);
+  ServerContextConfigImpl server_context_config(cfg);
+
+  Runtime::MockLoader runtime;
+  NiceMock<Event::MockDispatcher> dispatcher;
+  Filesystem::MockWatcher* watcher = new Filesystem::MockWatcher();
+  Filesystem::Watcher::OnChangedCb on_changed;
+  EXPECT_CALL(dispatcher, createFilesystemWatcher_()).WillOnce(Return(watcher));
+  EXPECT_CALL(*watcher, addWatch(path, Filesystem::Watcher::Events::MovedTo, _))
+      .WillOnce(SaveArg<2>(&on_changed));
+  ContextManagerImpl manager(runtime, dispatcher, nullptr);
+  Stats::IsolatedStoreImpl store;
+  ServerContextPtr server_ctx(
+      manager.createSslServerContext("", {}, store, server_context_config, true));
+
+  TestEnvironment::writeStringToFileForTest("ticket_key", std::string(80, 'b'));
+  on_changed(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(1U, store.counter("ssl.session_ticket_keys_reload_success").value());
+
+  // A key of the wrong length keeps the current keys.
+  TestEnvironment::writeStringToFileForTest("ticket_key", std::string(79, 'c'));
+  on_changed(Filesystem::Watcher::Events::MovedTo);
+  EXPECT_EQ(1U, store.counter("ssl.session_ticket_keys_reload_failed").value());
+}
+
 } // namespace Ssl
 } // namespace Envoy
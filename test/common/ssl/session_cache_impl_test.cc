@@ -0,0 +1,152 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/ssl/session_cache_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Ssl {
+
+class SessionCacheImplTest : public testing::Test {
+public:
+  static std::vector<uint8_t> bytes(const std::string& value) {
+    return std::vector<uint8_t>(value.begin(), value.end());
+  }
+
+  static bool insert(SessionCache& cache, const std::string& id, const std::string& session,
+                     uint64_t expire_time = 0) {
+    return cache.insert(reinterpret_cast<const uint8_t*>(id.data()), id.size(),
+                        reinterpret_cast<const uint8_t*>(session.data()), session.size(),
+                        expire_time);
+  }
+
+  static std::string lookup(const SessionCache& cache, const std::string& id) {
+    std::vector<uint8_t> session;
+    if (!cache.lookup(reinterpret_cast<const uint8_t*>(id.data()), id.size(), session)) {
+      return "";
+    }
+    return std::string(session.begin(), session.end());
+  }
+
+  static void remove(SessionCache& cache, const std::string& id) {
+    cache.remove(reinterpret_cast<const uint8_t*>(id.data()), id.size());
+  }
+};
+
+TEST_F(SessionCacheImplTest, InsertLookupRemove) {
+  SessionCacheImpl cache(16);
+
+  EXPECT_EQ("", lookup(cache, "a"));
+  EXPECT_TRUE(insert(cache, "a", "session a"));
+  EXPECT_TRUE(insert(cache, "b", "session b"));
+  EXPECT_EQ("session a", lookup(cache, "a"));
+  EXPECT_EQ("session b", lookup(cache, "b"));
+
+  // A session with the same ID replaces the old one.
+  EXPECT_TRUE(insert(cache, "a", "new session a"));
+  EXPECT_EQ("new session a", lookup(cache, "a"));
+
+  remove(cache, "a");
+  EXPECT_EQ("", lookup(cache, "a"));
+  EXPECT_EQ("session b", lookup(cache, "b"));
+  remove(cache, "c");
+  EXPECT_EQ("session b", lookup(cache, "b"));
+}
+
+TEST_F(SessionCacheImplTest, InvalidLengths) {
+  SessionCacheImpl cache(16);
+
+  EXPECT_FALSE(insert(cache, "", "session"));
+  EXPECT_FALSE(insert(cache, std::string(SSL_MAX_SSL_SESSION_ID_LENGTH + 1, 'a'), "session"));
+  EXPECT_FALSE(insert(cache, "a", std::string(SessionCacheImpl::MAX_SESSION_SIZE + 1, 's')));
+  EXPECT_EQ("", lookup(cache, "a"));
+  EXPECT_EQ("", lookup(cache, ""));
+
+  const std::string id(SSL_MAX_SSL_SESSION_ID_LENGTH, 'a');
+  const std::string session(SessionCacheImpl::MAX_SESSION_SIZE, 's');
+  EXPECT_TRUE(insert(cache, id, session));
+  EXPECT_EQ(session, lookup(cache, id));
+}
+
+// With a single set, the session which expires first is evicted.
+TEST_F(SessionCacheImplTest, EvictsEarliestExpiry) {
+  SessionCacheImpl cache(SessionCacheImpl::WAYS);
+
+  for (uint64_t i = 0; i < SessionCacheImpl::WAYS; i++) {
+    EXPECT_TRUE(insert(cache, std::to_string(i), "session", 100 - i));
+  }
+  EXPECT_TRUE(insert(cache, "new", "new session", 200));
+
+  EXPECT_EQ("new session", lookup(cache, "new"));
+  EXPECT_EQ("", lookup(cache, std::to_string(SessionCacheImpl::WAYS - 1)));
+  for (uint64_t i = 0; i < SessionCacheImpl::WAYS - 1; i++) {
+    EXPECT_EQ("session", lookup(cache, std::to_string(i)));
+  }
+
+  // An empty slot is used before any session is evicted.
+  remove(cache, "0");
+  EXPECT_TRUE(insert(cache, "newer", "newer session", 50));
+  EXPECT_EQ("newer session", lookup(cache, "newer"));
+  EXPECT_EQ("session", lookup(cache, "1"));
+}
+
+// Caches over the same block of memory, as in successive hot restart generations, share sessions.
+TEST_F(SessionCacheImplTest, ExternalMemory) {
+  EXPECT_EQ(SessionCacheImpl::SLOT_SIZE * 8, SessionCacheImpl::size(5));
+  std::vector<uint64_t> memory(SessionCacheImpl::size(5) / sizeof(uint64_t));
+
+  SessionCacheImpl cache1(reinterpret_cast<uint8_t*>(memory.data()), 5);
+  EXPECT_TRUE(insert(cache1, "a", "session a"));
+
+  SessionCacheImpl cache2(reinterpret_cast<uint8_t*>(memory.data()), 5);
+  EXPECT_EQ("session a", lookup(cache2, "a"));
+  remove(cache2, "a");
+  EXPECT_EQ("", lookup(cache1, "a"));
+}
+
+// Readers racing with writers only ever see whole sessions.
+TEST_F(SessionCacheImplTest, ConcurrentAccess) {
+  SessionCacheImpl cache(64);
+  const uint32_t num_ids = 128;
+
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < 4; t++) {
+    threads.emplace_back([&cache, t]() -> void {
+      for (uint32_t i = 0; i < 20000; i++) {
+        const std::string id = std::to_string(i % num_ids);
+        // Each session is its ID repeated, so a torn copy is detectable.
+        std::string session;
+        for (uint32_t j = 0; j <= (i + t) % 100; j++) {
+          session += id;
+        }
+        insert(cache, id, session, i);
+        if (i % 7 == t) {
+          remove(cache, id);
+        }
+      }
+    });
+  }
+
+  for (uint32_t t = 0; t < 4; t++) {
+    threads.emplace_back([&cache]() -> void {
+      for (uint32_t i = 0; i < 20000; i++) {
+        const std::string id = std::to_string(i % num_ids);
+        const std::string session = lookup(cache, id);
+        ASSERT_EQ(0, session.size() % id.size());
+        for (size_t j = 0; j < session.size(); j += id.size()) {
+          ASSERT_EQ(id, session.substr(j, id.size()));
+        }
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+} // namespace Ssl
+} // namespace Envoy
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+
+#include "common/stats/histogram_impl.h"
+
+#include "test/test_common/speed_test.h"
+
+#include "fmt/format.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+TEST(HistogramBucketsTest, BucketBounds) {
+  for (uint64_t value : {0UL, 1UL, 63UL, 64UL, 65UL, 127UL, 128UL, 1000UL, 123456789UL,
+                         std::numeric_limits<uint64_t>::max()}) {
+    const uint32_t index = HistogramBuckets::bucketIndex(value);
+    EXPECT_LT(index, HistogramBuckets::NUM_BUCKETS);
+    EXPECT_LE(HistogramBuckets::bucketLowerBound(index), value);
+    EXPECT_LT(value - HistogramBuckets::bucketLowerBound(index),
+              HistogramBuckets::bucketWidth(index));
+  }
+
+  // Buckets are contiguous and their widths are at most 1/32 of their lower bound.
+  for (uint32_t index = 0; index < HistogramBuckets::NUM_BUCKETS - 1; index++) {
+    EXPECT_EQ(HistogramBuckets::bucketLowerBound(index + 1),
+              HistogramBuckets::bucketLowerBound(index) + HistogramBuckets::bucketWidth(index));
+    if (index >= 64) {
+      EXPECT_LE(HistogramBuckets::bucketWidth(index) * 32,
+                HistogramBuckets::bucketLowerBound(index));
+    }
+  }
+}
+
+TEST(HistogramBucketsTest, AddTo) {
+  HistogramBuckets buckets;
+  buckets.recordValue(1);
+  buckets.recordValue(1);
+  buckets.recordValue(1000);
+
+  std::map<uint32_t, uint64_t> counts{{1, 5}};
+  buckets.addTo(counts);
+  EXPECT_EQ(2UL, counts.size());
+  EXPECT_EQ(7UL, counts[1]);
+  EXPECT_EQ(1UL, counts[HistogramBuckets::bucketIndex(1000)]);
+}
+
+TEST(HistogramStatisticsImplTest, Empty) {
+  HistogramStatisticsImpl statistics;
+  EXPECT_EQ(0UL, statistics.sampleCount());
+  EXPECT_EQ(statistics.supportedQuantiles().size(), statistics.computedQuantiles().size());
+  EXPECT_TRUE(std::isnan(statistics.computedQuantiles()[0]));
+  EXPECT_EQ("No recorded values", statistics.summary());
+}
+
+TEST(HistogramStatisticsImplTest, Quantiles) {
+  HistogramBuckets buckets;
+  for (uint64_t value = 1; value <= 10000; value++) {
+    buckets.recordValue(value);
+  }
+  std::map<uint32_t, uint64_t> counts;
+  buckets.addTo(counts);
+
+  HistogramStatisticsImpl statistics(counts);
+  EXPECT_EQ(10000UL, statistics.sampleCount());
+  const std::vector<double>& quantiles = statistics.supportedQuantiles();
+  for (size_t i = 0; i < quantiles.size(); i++) {
+    const double expected = std::max(1.0, quantiles[i] * 10000);
+    EXPECT_NEAR(expected, statistics.computedQuantiles()[i], expected * 0.035) << quantiles[i];
+  }
+  EXPECT_EQ("P0: 1.0, P25: 2500.9, P50: 5000.9, P75: 7500.4, P90: 9000.8, P95: 9500.9, "
+            "P99: 9900.3, P99.9: 10089.0, P100: 10239.0",
+            statistics.summary());
+}
+
+/**
+ * This test is for benchmarking only and should not be run as part of unit tests. It reports the
+ * cost of recording a value.
+ */
+TEST(DISABLED_HistogramBucketsTest, RecordSpeed) {
+  const uint64_t iterations = 100000000;
+  HistogramBuckets buckets;
+
+  // Spread the values over many buckets, as latencies would be.
+  const std::chrono::nanoseconds duration = SpeedTest::time([&]() -> void {
+    for (uint64_t i = 0; i < iterations; i++) {
+      buckets.recordValue((i * 2654435761UL) >> 40);
+    }
+  });
+
+  std::map<uint32_t, uint64_t> counts;
+  buckets.addTo(counts);
+  SpeedTest::print(fmt::format("recordValue ({} buckets used)", counts.size()), duration,
+                   iterations);
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#include <string>
+
+#include "common/stats/symbol_table_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+
+class StatNameTest : public testing::Test {
+public:
+  const SymbolVector& symbols(const StatNamePtr& name) {
+    return dynamic_cast<const StatNameImpl&>(*name).symbols();
+  }
+
+  SymbolTableImpl table_;
+};
+
+TEST_F(StatNameTest, RoundTrip) {
+  for (const char* name : {"", ".", "..", "a", "a.b", "a..b", ".a", "a.",
+                           "cluster.foo.upstream_rq_200", "listener.0.0.0.0_80.cx"}) {
+    EXPECT_EQ(name, table_.encode(name)->toString());
+  }
+  EXPECT_EQ(0UL, table_.size());
+}
+
+TEST_F(StatNameTest, SharedTokens) {
+  StatNamePtr name1 = table_.encode("cluster.foo.upstream_rq_200");
+  StatNamePtr name2 = table_.encode("cluster.bar.upstream_rq_200");
+  EXPECT_EQ(4UL, table_.size());
+  EXPECT_EQ(symbols(name1)[0], symbols(name2)[0]);
+  EXPECT_NE(symbols(name1)[1], symbols(name2)[1]);
+  EXPECT_EQ(symbols(name1)[2], symbols(name2)[2]);
+
+  StatNamePtr name3 = table_.encode("cluster.foo.upstream_rq_200");
+  EXPECT_EQ(symbols(name1), symbols(name3));
+  EXPECT_EQ(SymbolVectorHash()(symbols(name1)), SymbolVectorHash()(symbols(name3)));
+  EXPECT_NE(symbols(name1), symbols(name2));
+
+  // Destroying a name releases its references.
+  name1.reset();
+  name2.reset();
+  EXPECT_EQ(3UL, table_.size());
+  EXPECT_EQ("cluster.foo.upstream_rq_200", name3->toString());
+  name3.reset();
+  EXPECT_EQ(0UL, table_.size());
+}
+
+TEST_F(StatNameTest, RecycleSymbols) {
+  table_.encode("a.b");
+
+  // Freed symbols are reused for new tokens.
+  StatNamePtr name = table_.encode("c.d");
+  EXPECT_EQ("c.d", name->toString());
+  for (Symbol symbol : symbols(name)) {
+    EXPECT_LT(symbol, 2U);
+  }
+}
+
+TEST_F(StatNameTest, Copy) {
+  StatNamePtr name1 = table_.encode("a.b");
+  StatNamePtr name2 = table_.copy(symbols(name1));
+  EXPECT_EQ(symbols(name1), symbols(name2));
+
+  // The copy keeps the tokens alive after the original is released.
+  name1.reset();
+  EXPECT_EQ(2UL, table_.size());
+  EXPECT_EQ("a.b", name2->toString());
+  name2.reset();
+  EXPECT_EQ(0UL, table_.size());
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -1,7 +1,9 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "common/common/c_smart_ptr.h"
 #include "common/stats/thread_local_store.h"
@@ -156,6 +158,104 @@ TEST_F(StatsThreadLocalStoreTest, Tls) {
   EXPECT_CALL(*this, free(_)).Times(3);
 }
 
+TEST_F(StatsThreadLocalStoreTest, HistogramMerge) {
+  InSequence s;
+
+  // Before threading is initialized values are recorded into the parent.
+  Histogram& h1 = store_->histogram("h1");
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 10));
+  h1.recordValue(10);
+
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+  Histogram& tls_h1 = store_->histogram("h1");
+  EXPECT_NE(&h1, &tls_h1);
+  EXPECT_EQ(&tls_h1, &store_->histogram("h1"));
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(tls_h1), 20));
+  tls_h1.recordValue(20);
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(tls_h1), 30));
+  tls_h1.recordValue(30);
+
+  std::list<ParentHistogramSharedPtr> histograms = store_->histograms();
+  EXPECT_EQ(1UL, histograms.size());
+  ParentHistogramSharedPtr parent = histograms.front();
+  EXPECT_EQ(&h1, parent.get());
+  EXPECT_EQ(0UL, parent->cumulativeStatistics().sampleCount());
+
+  parent->merge();
+  EXPECT_EQ(3UL, parent->intervalStatistics().sampleCount());
+  EXPECT_EQ(3UL, parent->cumulativeStatistics().sampleCount());
+  EXPECT_EQ(10, parent->cumulativeStatistics().computedQuantiles().front());
+  EXPECT_EQ(30, parent->cumulativeStatistics().computedQuantiles().back());
+
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(tls_h1), 40));
+  tls_h1.recordValue(40);
+  parent->merge();
+  EXPECT_EQ(1UL, parent->intervalStatistics().sampleCount());
+  EXPECT_EQ(40, parent->intervalStatistics().computedQuantiles().front());
+  EXPECT_EQ(4UL, parent->cumulativeStatistics().sampleCount());
+
+  // During shutdown values from every thread are recorded into the parent.
+  store_->shutdownThreading();
+  Histogram& shutdown_h1 = store_->histogram("h1");
+  EXPECT_EQ(&h1, &shutdown_h1);
+  const uint32_t num_threads = 4;
+  const uint32_t values_per_thread = 1000;
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 50)).Times(num_threads * values_per_thread);
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&shutdown_h1]() -> void {
+      for (uint32_t j = 0; j < values_per_thread; j++) {
+        shutdown_h1.recordValue(50);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  parent->merge();
+  EXPECT_EQ(num_threads * values_per_thread, parent->intervalStatistics().sampleCount());
+
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
+TEST_F(StatsThreadLocalStoreTest, HistogramScopeDelete) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr scope1 = store_->createScope("scope1.");
+  Histogram& h1 = scope1->histogram("h1");
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 10));
+  h1.recordValue(10);
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 20));
+  h1.recordValue(20);
+
+  std::list<ParentHistogramSharedPtr> histograms = store_->histograms();
+  EXPECT_EQ(1UL, histograms.size());
+  ParentHistogramSharedPtr parent = histograms.front();
+  histograms.clear();
+  parent->merge();
+  EXPECT_EQ(2UL, parent->cumulativeStatistics().sampleCount());
+
+  // Flushing the thread local cache destroys the thread local histogram, which must release the
+  // parent while keeping its counts.
+  EXPECT_CALL(main_thread_dispatcher_, post(_));
+  EXPECT_CALL(tls_, runOnAllThreads(_));
+  scope1.reset();
+  EXPECT_EQ(1L, parent.use_count());
+  parent->merge();
+  EXPECT_EQ(0UL, parent->intervalStatistics().sampleCount());
+  EXPECT_EQ(2UL, parent->cumulativeStatistics().sampleCount());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
 TEST_F(StatsThreadLocalStoreTest, BasicScope) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -190,6 +290,55 @@ TEST_F(StatsThreadLocalStoreTest, BasicScope) {
   EXPECT_CALL(*this, free(_)).Times(5);
 }
 
+TEST_F(StatsThreadLocalStoreTest, StatNameScope) {
+  InSequence s;
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  ScopePtr scope1 = store_->createScope("scope1.");
+  SymbolTable& symbol_table = scope1->symbolTable();
+  EXPECT_EQ(&store_->symbolTable(), &symbol_table);
+  StatNamePtr c1_name = symbol_table.encode("c1");
+  StatNamePtr g1_name = symbol_table.encode("g1");
+  StatNamePtr h1_name = symbol_table.encode("h1");
+
+  // Names passed as a StatName and as a string share the same stats.
+  EXPECT_CALL(*this, alloc(_)).Times(2);
+  Counter& c1 = scope1->counterFromStatName(*c1_name);
+  EXPECT_EQ("scope1.c1", c1.name());
+  EXPECT_EQ(&c1, &scope1->counterFromStatName(*c1_name));
+  EXPECT_EQ(&c1, &scope1->counter("c1"));
+
+  Gauge& g1 = scope1->gaugeFromStatName(*g1_name);
+  EXPECT_EQ("scope1.g1", g1.name());
+  EXPECT_EQ(&g1, &scope1->gaugeFromStatName(*g1_name));
+  EXPECT_EQ(&g1, &scope1->gauge("g1"));
+
+  Histogram& h1 = scope1->histogramFromStatName(*h1_name);
+  EXPECT_EQ("scope1.h1", h1.name());
+  EXPECT_EQ(&h1, &scope1->histogramFromStatName(*h1_name));
+  EXPECT_CALL(sink_, onHistogramComplete(Ref(h1), 100));
+  h1.recordValue(100);
+
+  // The scope keeps its own references on the names.
+  c1_name.reset();
+  g1_name.reset();
+  h1_name.reset();
+  StatNamePtr c1_name_again = symbol_table.encode("c1");
+  EXPECT_EQ(&c1, &scope1->counterFromStatName(*c1_name_again));
+  c1_name_again.reset();
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+
+  EXPECT_CALL(*this, free(_)).Times(2);
+  scope1.reset();
+  // Stats looked up by string are not interned, so no tokens are left.
+  EXPECT_EQ(0UL, dynamic_cast<SymbolTableImpl&>(store_->symbolTable()).size());
+
+  // Includes overflow stat.
+  EXPECT_CALL(*this, free(_));
+}
+
 TEST_F(StatsThreadLocalStoreTest, ScopeDelete) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -404,6 +404,32 @@ TEST_F(ClusterManagerImplTest, RingHashLoadBalancerInitialization) {
   }
   )EOF";
   create(parseBootstrapFromJson(json));
+
+  // The rings are built once on the main thread and handed to the thread local load balancer.
+  EXPECT_EQ(1UL,
+            factory_.stats_.counter("cluster.redis_cluster.lb_hash_table_rebuilds").value());
+  EXPECT_NE(nullptr, cluster_manager_->get("redis_cluster")->loadBalancer().chooseHost(nullptr));
+}
+
+TEST_F(ClusterManagerImplTest, MaglevLoadBalancerInitialization) {
+  const std::string json = R"EOF(
+  {
+    "clusters": [{
+      "name": "redis_cluster",
+      "lb_type": "maglev",
+      "connect_timeout_ms": 250,
+      "type": "static",
+      "hosts": [{"url": "tcp://127.0.0.1:8000"}, {"url": "tcp://127.0.0.1:8001"}]
+    }]
+  }
+  )EOF";
+  create(parseBootstrapFromJson(json));
+
+  // Like rings, the tables are built once on the main thread.
+  EXPECT_EQ(LoadBalancerType::Maglev, cluster_manager_->get("redis_cluster")->info()->lbType());
+  EXPECT_EQ(1UL,
+            factory_.stats_.counter("cluster.redis_cluster.lb_hash_table_rebuilds").value());
+  EXPECT_NE(nullptr, cluster_manager_->get("redis_cluster")->loadBalancer().chooseHost(nullptr));
 }
 
 TEST_F(ClusterManagerImplTest, RingHashLoadBalancerV2Initialization) {
@@ -884,6 +910,16 @@ TEST_F(ClusterManagerImplTest, DynamicHostRemove) {
 
   dns_callback(TestUtility::makeDnsResponse({"127.0.0.1", "127.0.0.2"}));
 
+  // The thread local cluster shares the primary cluster's host lists rather than copying them.
+  const HostSet& primary_host_set =
+      *cluster_manager_->clusters().at("cluster_1").get().prioritySet().hostSetsPerPriority()[0];
+  const HostSet& worker_host_set =
+      *cluster_manager_->get("cluster_1")->prioritySet().hostSetsPerPriority()[0];
+  EXPECT_EQ(2UL, worker_host_set.hosts().size());
+  EXPECT_EQ(primary_host_set.hostsPtr(), worker_host_set.hostsPtr());
+  EXPECT_EQ(primary_host_set.healthyHostsPtr(), worker_host_set.healthyHostsPtr());
+  EXPECT_LT(0UL, factory_.stats_.gauge("cluster.cluster_1.membership_snapshot_bytes").value());
+
   // After we are initialized, we should immediately get called back if someone asks for an
   // initialize callback.
   EXPECT_CALL(initialized, ready());
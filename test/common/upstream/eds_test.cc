@@ -1,3 +1,7 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
 #include "common/config/utility.h"
 #include "common/upstream/eds.h"
 
@@ -6,9 +10,11 @@
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/speed_test.h"
 #include "test/test_common/utility.h"
 
 #include "api/eds.pb.h"
+#include "fmt/format.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -287,6 +293,115 @@ TEST_F(EdsTest, EndpointHostsPerLocality) {
   }
 }
 
+// Validate that onConfigUpdate() keeps existing hosts and only reports the hosts which changed.
+TEST_F(EdsTest, EndpointUpdates) {
+  Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
+  auto* cluster_load_assignment = resources.Add();
+  cluster_load_assignment->set_cluster_name("fare");
+  auto add_endpoint = [cluster_load_assignment](uint32_t port, uint32_t weight) {
+    auto* lb_endpoint = cluster_load_assignment->mutable_endpoints(0)->add_lb_endpoints();
+    auto* socket_address =
+        lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+    lb_endpoint->mutable_load_balancing_weight()->set_value(weight);
+  };
+  cluster_load_assignment->add_endpoints();
+  add_endpoint(80, 1);
+  add_endpoint(81, 1);
+  add_endpoint(82, 1);
+
+  bool initialized = false;
+  cluster_->initialize([&initialized] { initialized = true; });
+  EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_TRUE(initialized);
+
+  uint32_t updates = 0;
+  std::vector<HostSharedPtr> last_added;
+  std::vector<HostSharedPtr> last_removed;
+  cluster_->prioritySet().addMemberUpdateCb(
+      [&](uint32_t, const std::vector<HostSharedPtr>& hosts_added,
+          const std::vector<HostSharedPtr>& hosts_removed) -> void {
+        updates++;
+        last_added = hosts_added;
+        last_removed = hosts_removed;
+      });
+  const std::vector<HostSharedPtr> initial_hosts =
+      cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(3, initial_hosts.size());
+
+  // The same endpoints are not an update.
+  EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(0, updates);
+
+  // Remove 82, change the weight of 81, add 83 and a duplicate of 83.
+  cluster_load_assignment->mutable_endpoints(0)->clear_lb_endpoints();
+  add_endpoint(80, 1);
+  add_endpoint(81, 5);
+  add_endpoint(83, 1);
+  add_endpoint(83, 7);
+  EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(1, updates);
+  ASSERT_EQ(1, last_added.size());
+  EXPECT_EQ("1.2.3.4:83", last_added[0]->address()->asString());
+  EXPECT_EQ(1U, last_added[0]->weight());
+  ASSERT_EQ(1, last_removed.size());
+  EXPECT_EQ(initial_hosts[2], last_removed[0]);
+
+  const auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+  ASSERT_EQ(3, hosts.size());
+  EXPECT_EQ(initial_hosts[0], hosts[0]);
+  EXPECT_EQ(initial_hosts[1], hosts[1]);
+  EXPECT_EQ(5U, hosts[1]->weight());
+  EXPECT_EQ(5UL, cluster_->info()->stats().max_host_weight_.value());
+
+  // A weight change alone is an update with no hosts added or removed.
+  cluster_load_assignment->mutable_endpoints(0)
+      ->mutable_lb_endpoints(1)
+      ->mutable_load_balancing_weight()
+      ->set_value(3);
+  EXPECT_NO_THROW(cluster_->onConfigUpdate(resources));
+  EXPECT_EQ(2, updates);
+  EXPECT_TRUE(last_added.empty());
+  EXPECT_TRUE(last_removed.empty());
+  EXPECT_EQ(initial_hosts[1], cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[1]);
+  EXPECT_EQ(3U, initial_hosts[1]->weight());
+}
+
+// This is a benchmark of large cluster updates and should not be run as part of unit tests.
+TEST_F(EdsTest, DISABLED_LargeClusterUpdateSpeed) {
+  const uint32_t num_hosts = 20000;
+
+  // Time an update to num_hosts hosts, numbered from first_host.
+  auto time_update = [this](const std::string& name, uint32_t first_host) {
+    Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
+    auto* cluster_load_assignment = resources.Add();
+    cluster_load_assignment->set_cluster_name("fare");
+    auto* endpoints = cluster_load_assignment->add_endpoints();
+    for (uint32_t i = first_host; i < first_host + num_hosts; ++i) {
+      auto* socket_address = endpoints->add_lb_endpoints()
+                                 ->mutable_endpoint()
+                                 ->mutable_address()
+                                 ->mutable_socket_address();
+      socket_address->set_address(fmt::format("10.{}.{}.{}", i >> 16, (i >> 8) & 0xff, i & 0xff));
+      socket_address->set_port_value(80);
+    }
+
+    const std::chrono::nanoseconds duration =
+        SpeedTest::time([&]() -> void { cluster_->onConfigUpdate(resources); });
+    SpeedTest::print(
+        fmt::format("{} update ({} hosts)", name,
+                    cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size()),
+        duration, 1);
+  };
+
+  cluster_->initialize([] {});
+  time_update("initial", 0);
+  time_update("unchanged", 0);
+  time_update("10% replaced", num_hosts / 10);
+  time_update("all replaced", num_hosts);
+}
+
 // Validate that onConfigUpdate() updates bins hosts per priority as expected.
 TEST_F(EdsTest, EndpointHostsPerPriority) {
   Protobuf::RepeatedPtrField<envoy::api::v2::ClusterLoadAssignment> resources;
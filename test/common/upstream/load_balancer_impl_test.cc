@@ -367,6 +367,84 @@ TEST_F(RoundRobinLoadBalancerTest, NoZoneAwareRoutingLocalEmpty) {
   EXPECT_EQ(1U, stats_.lb_local_cluster_not_ok_.value());
 }
 
+TEST_F(RoundRobinLoadBalancerTest, Weighted) {
+  init(false);
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
+      .WillRepeatedly(Return(1));
+  host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
+  host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // Host 1 is picked 3 times for every pick of host 0, with the picks interleaved.
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // Weights only change with a host set update.
+  host_set_.healthy_hosts_[1]->weight(1);
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
+// An update to another priority does not rebuild the schedulers of priority 0, so the interleaving
+// of its picks carries on.
+TEST_F(RoundRobinLoadBalancerTest, WeightedOtherPriorityUpdate) {
+  init(false);
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
+      .WillRepeatedly(Return(1));
+  host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
+  host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  MockHostSet& failover_host_set = *priority_set_.getMockHostSet(1);
+  failover_host_set.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:82", 1),
+                                      makeTestHost(info_, "tcp://127.0.0.1:83", 2)};
+  failover_host_set.hosts_ = failover_host_set.healthy_hosts_;
+  failover_host_set.runCallbacks({}, {});
+
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+}
+
+TEST_F(RoundRobinLoadBalancerTest, WeightedRuntimeOff) {
+  init(false);
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
+      .WillRepeatedly(Return(0));
+  host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
+  host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
+TEST_F(RoundRobinLoadBalancerTest, WeightedMaxUnhealthyPanic) {
+  init(false);
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
+      .WillRepeatedly(Return(1));
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                      makeTestHost(info_, "tcp://127.0.0.1:81", 3),
+                      makeTestHost(info_, "tcp://127.0.0.1:82", 1)};
+  host_set_.healthy_hosts_ = {host_set_.hosts_[0]};
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // In panic mode all hosts are picked from, using the all hosts schedule.
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.hosts_[2], lb_->chooseHost(nullptr));
+  EXPECT_EQ(4UL, stats_.lb_healthy_panic_.value());
+}
+
 class LeastRequestLoadBalancerTest : public LoadBalancerTestBase {
 public:
   LeastRequestLoadBalancer lb_{priority_set_, nullptr, stats_, runtime_, random_};
@@ -377,35 +455,30 @@ TEST_F(LeastRequestLoadBalancerTest, NoHosts) { EXPECT_EQ(nullptr, lb_.chooseHos
 TEST_F(LeastRequestLoadBalancerTest, SingleHost) {
   host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
   host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
 
   // Host weight is 1.
   {
     EXPECT_CALL(random_, random()).WillOnce(Return(2)).WillOnce(Return(3));
-    stats_.max_host_weight_.set(1UL);
     EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
   }
 
-  // Host weight is 100.
+  // Host weight is 100. A single host never has unequal weights.
   {
-    EXPECT_CALL(random_, random()).WillOnce(Return(2));
-    stats_.max_host_weight_.set(100UL);
+    host_set_.healthy_hosts_[0]->weight(100);
+    host_set_.runCallbacks({}, {});
+    EXPECT_CALL(random_, random()).WillOnce(Return(2)).WillOnce(Return(3));
     EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
   }
 
   std::vector<HostSharedPtr> empty;
-  {
-    host_set_.runCallbacks(empty, empty);
-    EXPECT_CALL(random_, random()).WillOnce(Return(2));
-    EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
-  }
-
   {
     std::vector<HostSharedPtr> remove_hosts;
     remove_hosts.push_back(host_set_.hosts_[0]);
-    host_set_.runCallbacks(empty, remove_hosts);
-    EXPECT_CALL(random_, random()).Times(0);
     host_set_.healthy_hosts_.clear();
     host_set_.hosts_.clear();
+    host_set_.runCallbacks(empty, remove_hosts);
+    EXPECT_CALL(random_, random()).Times(0);
     EXPECT_EQ(nullptr, lb_.chooseHost(nullptr));
   }
 }
@@ -413,8 +486,8 @@ TEST_F(LeastRequestLoadBalancerTest, SingleHost) {
 TEST_F(LeastRequestLoadBalancerTest, Normal) {
   host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80"),
                               makeTestHost(info_, "tcp://127.0.0.1:81")};
-  stats_.max_host_weight_.set(1UL);
   host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
   EXPECT_CALL(random_, random()).WillOnce(Return(2)).WillOnce(Return(3));
   EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
 
@@ -438,9 +511,9 @@ TEST_F(LeastRequestLoadBalancerTest, WeightImbalanceRuntimeOff) {
 
   host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
-  stats_.max_host_weight_.set(3UL);
-
   host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
   host_set_.healthy_hosts_[0]->stats().rq_active_.set(1);
   host_set_.healthy_hosts_[1]->stats().rq_active_.set(2);
 
@@ -454,41 +527,25 @@ TEST_F(LeastRequestLoadBalancerTest, WeightImbalanceRuntimeOff) {
 TEST_F(LeastRequestLoadBalancerTest, WeightImbalance) {
   host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
-  stats_.max_host_weight_.set(3UL);
-
   host_set_.hosts_ = host_set_.healthy_hosts_;
-  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
-      .WillRepeatedly(Return(50));
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
 
   EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
       .WillRepeatedly(Return(1));
   EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
       .WillRepeatedly(Return(50));
 
-  // As max weight higher then 1 we do random host pick and keep it for weight requests.
-  EXPECT_CALL(random_, random()).WillOnce(Return(1));
-  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
-
-  // Same host stays as we have to hit it 3 times.
-  host_set_.healthy_hosts_[0]->stats().rq_active_.set(2);
-  host_set_.healthy_hosts_[1]->stats().rq_active_.set(1);
+  // As weights are unequal, hosts are picked from the schedule without random picks. Host 1 has
+  // weight 3 and no active requests, so it is picked 3 times for every pick of host 0.
   EXPECT_CALL(random_, random()).Times(0);
   EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
-
-  // Same host stays as we have to hit it 3 times.
-  EXPECT_CALL(random_, random()).Times(0);
   EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
-
-  // Get random host after previous one was selected 3 times in a row.
-  EXPECT_CALL(random_, random()).WillOnce(Return(2));
   EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
-
-  // Select second host again.
-  EXPECT_CALL(random_, random()).WillOnce(Return(1));
   EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
 
-  // Set weight to 1, we will switch to the two random hosts mode.
-  stats_.max_host_weight_.set(1UL);
+  // Set the weights to 1, we will switch to the two random hosts mode.
+  host_set_.healthy_hosts_[1]->weight(1);
+  host_set_.runCallbacks({}, {});
   EXPECT_CALL(random_, random()).WillOnce(Return(2)).WillOnce(Return(3));
   EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
 
@@ -496,17 +553,43 @@ TEST_F(LeastRequestLoadBalancerTest, WeightImbalance) {
   EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
 }
 
+TEST_F(LeastRequestLoadBalancerTest, WeightImbalanceActiveRequests) {
+  host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", 2)};
+  host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
+      .WillRepeatedly(Return(1));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
+      .WillRepeatedly(Return(50));
+  EXPECT_CALL(random_, random()).Times(0);
+
+  // Host 1 is picked first and is scheduled again with weight 2 / (10 + 1), so host 0 takes the
+  // next 5 picks.
+  host_set_.healthy_hosts_[1]->stats().rq_active_.set(10);
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
+  for (uint32_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
+  }
+  EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
+}
+
 TEST_F(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   host_set_.healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", 3)};
-  stats_.max_host_weight_.set(3UL);
-
   host_set_.hosts_ = host_set_.healthy_hosts_;
+  host_set_.runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
 
-  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.weight_enabled", 1))
+      .WillRepeatedly(Return(1));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("upstream.healthy_panic_threshold", 50))
+      .WillRepeatedly(Return(50));
+
+  EXPECT_CALL(random_, random()).Times(0);
   EXPECT_EQ(host_set_.healthy_hosts_[1], lb_.chooseHost(nullptr));
 
-  // Same host stays as we have to hit it 3 times, but we remove it and fire callback.
+  // Host 1 would be picked again, but we remove it and fire callback.
   std::vector<HostSharedPtr> empty;
   std::vector<HostSharedPtr> hosts_removed;
   hosts_removed.push_back(host_set_.hosts_[1]);
@@ -514,7 +597,7 @@ TEST_F(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   host_set_.healthy_hosts_.erase(host_set_.healthy_hosts_.begin() + 1);
   host_set_.runCallbacks(empty, hosts_removed);
 
-  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_CALL(random_, random()).WillOnce(Return(1)).WillOnce(Return(2));
   EXPECT_EQ(host_set_.healthy_hosts_[0], lb_.chooseHost(nullptr));
 }
 
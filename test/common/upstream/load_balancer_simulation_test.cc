@@ -1,4 +1,6 @@
+#include <chrono>
 #include <cstdint>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -9,6 +11,7 @@
 
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/speed_test.h"
 
 #include "fmt/format.h"
 #include "gmock/gmock.h"
@@ -112,6 +115,73 @@ public:
     }
   }
 
+  /**
+   * Run a weighted simulation of a load balancer. Each request stays active until
+   * outstanding_requests further requests have been sent, so that least request load balancers see
+   * realistic active request counts. Print each host's share of the requests next to its share of
+   * the total weight, the longest run of consecutive picks of a host and the time per pick.
+   *
+   * @param weights weight of each upstream host.
+   * @param outstanding_requests number of requests active at any time.
+   */
+  template <class LoadBalancerType>
+  void runWeighted(const std::vector<uint32_t>& weights, uint32_t outstanding_requests) {
+    PrioritySetImpl priority_set;
+    LoadBalancerType lb(priority_set, nullptr, stats_, runtime_, random_);
+
+    HostVectorSharedPtr hosts(new std::vector<HostSharedPtr>());
+    uint64_t total_weight = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      hosts->push_back(newTestHost(info_, fmt::format("tcp://host.{}:80", i), weights[i]));
+      total_weight += weights[i];
+    }
+    HostListsSharedPtr hosts_per_locality(new std::vector<std::vector<HostSharedPtr>>());
+    priority_set.getOrCreateHostSet(0).updateHosts(hosts, hosts, hosts_per_locality,
+                                                   hosts_per_locality, *hosts, empty_vector_);
+
+    std::map<HostConstSharedPtr, uint32_t> hits;
+    std::deque<HostConstSharedPtr> active;
+    HostConstSharedPtr last_selected;
+    uint32_t run_length = 0;
+    uint32_t max_run_length = 0;
+    const std::chrono::nanoseconds duration = SpeedTest::time([&]() -> void {
+      for (uint32_t i = 0; i < total_number_of_requests; ++i) {
+        HostConstSharedPtr selected = lb.chooseHost(nullptr);
+        hits[selected]++;
+        run_length = selected == last_selected ? run_length + 1 : 1;
+        max_run_length = std::max(max_run_length, run_length);
+        last_selected = selected;
+
+        selected->stats().rq_active_.inc();
+        active.push_back(selected);
+        if (active.size() > outstanding_requests) {
+          active.front()->stats().rq_active_.dec();
+          active.pop_front();
+        }
+      }
+    });
+
+    double max_percent_diff = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+      const double expected = 100.0 * weights[i] / total_weight;
+      const double actual = 100.0 * hits[(*hosts)[i]] / total_number_of_requests;
+      max_percent_diff = std::max(max_percent_diff, std::abs(actual - expected) / expected * 100);
+      // Only print each host for small clusters.
+      if (weights.size() <= 16) {
+        std::cout << fmt::format("url:{}, weight:{}, hits:{}, {:.2f} % (expected {:.2f} %)",
+                                 (*hosts)[i]->address()->asString(), weights[i],
+                                 hits[(*hosts)[i]], actual, expected)
+                  << std::endl;
+      }
+    }
+    std::cout << fmt::format("hosts:{}, max {:.2f} % from expected share, longest run of picks of "
+                             "one host: {}",
+                             weights.size(), max_percent_diff, max_run_length)
+              << std::endl;
+    SpeedTest::print(fmt::format("{} hosts pick", weights.size()), duration,
+                     total_number_of_requests);
+  }
+
   HostSharedPtr selectOriginatingHost(const std::vector<HostSharedPtr>& hosts) {
     // Originating cluster should have roughly the same per host request distribution.
     return hosts[random_.random() % hosts.size()];
@@ -196,5 +266,29 @@ TEST_F(DISABLED_SimulationTest, unequalZoneDistribution6) {
   run({3U, 2U, 5U}, {3U, 4U, 5U}, {3U, 4U, 5U});
 }
 
+TEST_F(DISABLED_SimulationTest, weightedRoundRobinDistribution) {
+  runWeighted<RoundRobinLoadBalancer>({1U, 2U, 3U, 10U}, 100U);
+}
+
+TEST_F(DISABLED_SimulationTest, weightedRoundRobinManyHosts) {
+  std::vector<uint32_t> weights;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    weights.push_back(i % 100 + 1);
+  }
+  runWeighted<RoundRobinLoadBalancer>(weights, 100U);
+}
+
+TEST_F(DISABLED_SimulationTest, weightedLeastRequestDistribution) {
+  runWeighted<LeastRequestLoadBalancer>({1U, 2U, 3U, 10U}, 100U);
+}
+
+TEST_F(DISABLED_SimulationTest, weightedLeastRequestManyHosts) {
+  std::vector<uint32_t> weights;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    weights.push_back(i % 100 + 1);
+  }
+  runWeighted<LeastRequestLoadBalancer>(weights, 100U);
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -0,0 +1,228 @@
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "common/network/utility.h"
+#include "common/upstream/maglev_lb.h"
+#include "common/upstream/ring_hash_lb.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/speed_test.h"
+
+#include "fmt/format.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Upstream {
+
+class TestLoadBalancerContext : public LoadBalancerContext {
+public:
+  TestLoadBalancerContext(uint64_t hash_key) : hash_key_(hash_key) {}
+
+  // Upstream::LoadBalancerContext
+  Optional<uint64_t> computeHashKey() override { return hash_key_; }
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() const override { return nullptr; }
+  const Network::Connection* downstreamConnection() const override { return nullptr; }
+
+  Optional<uint64_t> hash_key_;
+};
+
+class MaglevLoadBalancerTest : public testing::Test {
+public:
+  MaglevLoadBalancerTest() : stats_(ClusterInfoImpl::generateStats(stats_store_)) {}
+
+  void init() { lb_.reset(new MaglevLoadBalancer(priority_set_, stats_, runtime_, random_)); }
+
+  std::vector<HostSharedPtr> makeHosts(uint32_t num_hosts) {
+    std::vector<HostSharedPtr> hosts;
+    for (uint32_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i)));
+    }
+    return hosts;
+  }
+
+  // Count the slots owned by each host.
+  std::unordered_map<HostConstSharedPtr, uint64_t>
+  slotsPerHost(const MaglevLoadBalancer::MaglevTable& table) {
+    std::unordered_map<HostConstSharedPtr, uint64_t> slots;
+    for (uint64_t i = 0; i < table.size(); i++) {
+      slots[table.chooseHost(i)]++;
+    }
+    return slots;
+  }
+
+  NiceMock<MockPrioritySet> priority_set_;
+  MockHostSet& host_set_ = *priority_set_.getMockHostSet(0);
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  std::unique_ptr<MaglevLoadBalancer> lb_;
+};
+
+TEST_F(MaglevLoadBalancerTest, NoHost) {
+  init();
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr));
+}
+
+TEST_F(MaglevLoadBalancerTest, TableSize) {
+  EXPECT_EQ(65537UL, MaglevLoadBalancer::MaglevTable::tableSize(1));
+  EXPECT_EQ(65537UL, MaglevLoadBalancer::MaglevTable::tableSize(655));
+  EXPECT_EQ(655373UL, MaglevLoadBalancer::MaglevTable::tableSize(656));
+  EXPECT_EQ(6553621UL, MaglevLoadBalancer::MaglevTable::tableSize(10000));
+  EXPECT_EQ(6553621UL, MaglevLoadBalancer::MaglevTable::tableSize(100000));
+}
+
+TEST_F(MaglevLoadBalancerTest, EvenSpread) {
+  const std::vector<HostSharedPtr> hosts = makeHosts(10);
+  MaglevLoadBalancer::MaglevTable table(hosts, 65537);
+  EXPECT_EQ(65537UL, table.size());
+
+  // Hosts take turns claiming slots, so each host owns either floor or ceil of size / hosts.
+  const auto slots = slotsPerHost(table);
+  EXPECT_EQ(10UL, slots.size());
+  for (const auto& host_slots : slots) {
+    EXPECT_GE(host_slots.second, 6553UL);
+    EXPECT_LE(host_slots.second, 6554UL);
+  }
+
+  // Selection wraps around the table.
+  EXPECT_EQ(table.chooseHost(5), table.chooseHost(65537 + 5));
+}
+
+TEST_F(MaglevLoadBalancerTest, MinimalDisruption) {
+  std::vector<HostSharedPtr> hosts = makeHosts(10);
+  MaglevLoadBalancer::MaglevTable before(hosts, 65537);
+  const HostSharedPtr removed = hosts.back();
+  hosts.pop_back();
+  MaglevLoadBalancer::MaglevTable after(hosts, 65537);
+
+  // Only slots of the removed host should need to move. Maglev trades a little disruption for
+  // balance, so allow up to 1% of the other slots to move as well.
+  uint64_t moved = 0;
+  for (uint64_t i = 0; i < before.size(); i++) {
+    if (before.chooseHost(i) != removed && before.chooseHost(i) != after.chooseHost(i)) {
+      moved++;
+    }
+  }
+  EXPECT_LT(moved, before.size() / 100);
+}
+
+TEST_F(MaglevLoadBalancerTest, Basic) {
+  host_set_.hosts_ = makeHosts(4);
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  init();
+
+  MaglevLoadBalancer::MaglevTable table(host_set_.hosts_);
+  for (uint64_t hash : {0UL, 1UL, 1000UL, 65536UL, std::numeric_limits<uint64_t>::max()}) {
+    TestLoadBalancerContext context(hash);
+    EXPECT_EQ(table.chooseHost(hash), lb_->chooseHost(&context));
+  }
+  {
+    EXPECT_CALL(random_, random()).WillOnce(Return(1000));
+    EXPECT_EQ(table.chooseHost(1000), lb_->chooseHost(nullptr));
+  }
+  EXPECT_EQ(0UL, stats_.lb_healthy_panic_.value());
+
+  // With no healthy hosts we go into panic mode and use all hosts.
+  host_set_.healthy_hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  {
+    TestLoadBalancerContext context(0);
+    EXPECT_EQ(table.chooseHost(0), lb_->chooseHost(&context));
+  }
+  EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
+}
+
+TEST_F(MaglevLoadBalancerTest, SharedTables) {
+  host_set_.hosts_ = makeHosts(3);
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+
+  ThreadAwareLoadBalancerBase::TablesConstSharedPtr tables =
+      MaglevLoadBalancer::buildMaglevTables(priority_set_, stats_);
+  EXPECT_EQ(1UL, stats_.lb_hash_table_rebuilds_.value());
+
+  MaglevLoadBalancer lb1(priority_set_, stats_, runtime_, random_, tables);
+  MaglevLoadBalancer lb2(priority_set_, stats_, runtime_, random_, tables);
+  for (uint64_t hash = 0; hash < 100; hash++) {
+    TestLoadBalancerContext context(hash);
+    HostConstSharedPtr host = lb1.chooseHost(&context);
+    EXPECT_NE(nullptr, host);
+    EXPECT_EQ(host, lb2.chooseHost(&context));
+  }
+
+  // Shared tables are only replaced explicitly.
+  host_set_.hosts_.clear();
+  host_set_.healthy_hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  TestLoadBalancerContext context(0);
+  EXPECT_NE(nullptr, lb1.chooseHost(&context));
+  lb1.tables(MaglevLoadBalancer::buildMaglevTables(priority_set_, stats_));
+  EXPECT_EQ(nullptr, lb1.chooseHost(&context));
+}
+
+/**
+ * This test is for benchmarking only and should not be run as part of unit tests. It reports the
+ * time to build a maglev table and a hash ring for the same hosts, and the cost of selecting a
+ * host from each.
+ */
+class DISABLED_MaglevLoadBalancerTest : public MaglevLoadBalancerTest {};
+
+TEST_F(DISABLED_MaglevLoadBalancerTest, BuildAndSelect) {
+  const uint64_t selections = 10000000;
+  Optional<envoy::api::v2::Cluster::RingHashLbConfig> ring_config;
+
+  for (uint32_t num_hosts : {10, 100, 2000}) {
+    std::vector<HostSharedPtr> hosts;
+    for (uint32_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:80", i / 256, i % 256)));
+    }
+
+    std::unique_ptr<MaglevLoadBalancer::MaglevTable> table;
+    const std::chrono::nanoseconds maglev_build = SpeedTest::time(
+        [&]() -> void { table.reset(new MaglevLoadBalancer::MaglevTable(hosts)); });
+    SpeedTest::print(fmt::format("{} hosts maglev build", num_hosts), maglev_build, 1);
+
+    std::unique_ptr<RingHashLoadBalancer::Ring> ring;
+    const std::chrono::nanoseconds ring_build = SpeedTest::time(
+        [&]() -> void { ring.reset(new RingHashLoadBalancer::Ring(ring_config, hosts)); });
+    SpeedTest::print(fmt::format("{} hosts ring build", num_hosts), ring_build, 1);
+
+    // Use a multiplicative hash of the loop counter so that lookups are not sequential.
+    uint64_t maglev_checksum = 0;
+    const std::chrono::nanoseconds maglev_select = SpeedTest::time([&]() -> void {
+      for (uint64_t i = 0; i < selections; i++) {
+        maglev_checksum +=
+            reinterpret_cast<uintptr_t>(table->chooseHost(i * 11400714819323198485UL).get());
+      }
+    });
+    SpeedTest::print(fmt::format("{} hosts maglev select (table size {})", num_hosts,
+                                 table->size()),
+                     maglev_select, selections);
+
+    uint64_t ring_checksum = 0;
+    const std::chrono::nanoseconds ring_select = SpeedTest::time([&]() -> void {
+      for (uint64_t i = 0; i < selections; i++) {
+        ring_checksum +=
+            reinterpret_cast<uintptr_t>(ring->chooseHost(i * 11400714819323198485UL).get());
+      }
+    });
+    SpeedTest::print(fmt::format("{} hosts ring select (ring size {})", num_hosts, ring->size()),
+                     ring_select, selections);
+    EXPECT_NE(0UL, maglev_checksum + ring_checksum);
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -10,6 +10,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/speed_test.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -213,6 +214,60 @@ TEST_F(RingHashLoadBalancerTest, UnevenHosts) {
   }
 }
 
+TEST_F(RingHashLoadBalancerTest, SharedRings) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90"),
+                      makeTestHost(info_, "tcp://127.0.0.1:91")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+
+  config_.value(envoy::api::v2::Cluster::RingHashLbConfig());
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  config_.value().mutable_deprecated_v1()->mutable_use_std_hash()->set_value(false);
+
+  ThreadAwareLoadBalancerBase::TablesConstSharedPtr rings =
+      RingHashLoadBalancer::buildRings(priority_set_, stats_, config_);
+  EXPECT_EQ(1UL, stats_.lb_hash_table_rebuilds_.value());
+
+  // Two load balancers sharing the same rings make the same choices.
+  RingHashLoadBalancer lb1(priority_set_, stats_, runtime_, random_, rings);
+  RingHashLoadBalancer lb2(priority_set_, stats_, runtime_, random_, rings);
+  for (uint64_t hash : {0UL, 1033482794131418490UL, 5583722120771150861UL}) {
+    TestLoadBalancerContext context(hash);
+    HostConstSharedPtr host = lb1.chooseHost(&context);
+    EXPECT_NE(nullptr, host);
+    EXPECT_EQ(host, lb2.chooseHost(&context));
+  }
+
+  // Shared rings are not rebuilt on membership changes, only when new rings are supplied.
+  host_set_.hosts_.clear();
+  host_set_.healthy_hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  {
+    TestLoadBalancerContext context(0);
+    EXPECT_NE(nullptr, lb1.chooseHost(&context));
+  }
+  lb1.tables(RingHashLoadBalancer::buildRings(priority_set_, stats_, config_));
+  {
+    TestLoadBalancerContext context(0);
+    EXPECT_EQ(nullptr, lb1.chooseHost(&context));
+  }
+  EXPECT_EQ(2UL, stats_.lb_hash_table_rebuilds_.value());
+}
+
+TEST_F(RingHashLoadBalancerTest, RingSize) {
+  RingHashLoadBalancer::Ring empty_ring(config_, {});
+  EXPECT_EQ(0UL, empty_ring.size());
+  EXPECT_EQ(nullptr, empty_ring.chooseHost(0));
+
+  RingHashLoadBalancer::Ring ring(config_, {makeTestHost(info_, "tcp://127.0.0.1:90"),
+                                            makeTestHost(info_, "tcp://127.0.0.1:91")});
+  EXPECT_EQ(1024UL, ring.size());
+}
+
+TEST_F(RingHashLoadBalancerTest, NoRings) {
+  RingHashLoadBalancer lb(priority_set_, stats_, runtime_, random_, nullptr);
+  EXPECT_EQ(nullptr, lb.chooseHost(nullptr));
+}
+
 /**
  * This test is for simulation only and should not be run as part of unit tests. In order to run the
  * simulation remove the DISABLED_ prefix from the TEST_F invocation. Run bazel with
@@ -271,5 +326,31 @@ TEST_F(DISABLED_RingHashLoadBalancerTest, DetermineSpread) {
   }
 }
 
+/**
+ * Measures the cost of building the rings for a large host set, which is done once on the main
+ * thread for each membership update.
+ */
+TEST_F(DISABLED_RingHashLoadBalancerTest, RingBuildTime) {
+  const uint64_t num_hosts = 2000;
+  const uint64_t builds = 10;
+
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    host_set_.hosts_.push_back(
+        makeTestHost(info_, fmt::format("tcp://10.0.{}.{}:6379", i / 256, i % 256)));
+  }
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+
+  for (uint64_t min_ring_size : {1024UL, 65536UL, 1048576UL}) {
+    config_.value(envoy::api::v2::Cluster::RingHashLbConfig());
+    config_.value().mutable_minimum_ring_size()->set_value(min_ring_size);
+    config_.value().mutable_deprecated_v1()->mutable_use_std_hash()->set_value(false);
+
+    SpeedTest::run(fmt::format("{} hosts, min_ring_size {} build", num_hosts, min_ring_size),
+                   builds, [&]() -> void {
+                     RingHashLoadBalancer::buildRings(priority_set_, stats_, config_);
+                   });
+  }
+}
+
 } // namespace Upstream
 } // namespace Envoy
@@ -697,7 +697,8 @@ TEST_F(SubsetLoadBalancerTest, LoadBalancerTypes) {
 
   auto types =
       std::vector<LoadBalancerType>({LoadBalancerType::RoundRobin, LoadBalancerType::LeastRequest,
-                                     LoadBalancerType::Random, LoadBalancerType::RingHash});
+                                     LoadBalancerType::Random, LoadBalancerType::RingHash,
+                                     LoadBalancerType::Maglev});
 
   for (const auto& it : types) {
     lb_type_ = it;
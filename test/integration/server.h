@@ -47,12 +47,19 @@ public:
   std::chrono::milliseconds fileFlushIntervalMsec() override {
     return std::chrono::milliseconds(50);
   }
+  Filesystem::WriteOverflowPolicy fileOverflowPolicy() override {
+    return Filesystem::WriteOverflowPolicy::Spill;
+  }
   Mode mode() const override { return Mode::Serve; }
   const std::string& serviceClusterName() override { return service_cluster_name_; }
   const std::string& serviceNodeName() override { return service_node_name_; }
   const std::string& serviceZone() override { return service_zone_; }
   uint64_t maxStats() override { return 16384; }
   uint64_t maxObjNameLength() override { return 60; }
+  uint64_t sslSessionCacheSize() override { return 0; }
+  bool listenerReusePort() override { return false; }
+  uint32_t listenerAcceptBatchSize() override { return 0; }
+  bool listenerBalanceConnections() override { return false; }
 
 private:
   const std::string config_path_;
@@ -123,6 +130,23 @@ public:
     return wrapped_scope_->histogram(name);
   }
 
+  SymbolTable& symbolTable() override { return wrapped_scope_->symbolTable(); }
+
+  Counter& counterFromStatName(const StatName& name) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return wrapped_scope_->counterFromStatName(name);
+  }
+
+  Gauge& gaugeFromStatName(const StatName& name) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return wrapped_scope_->gaugeFromStatName(name);
+  }
+
+  Histogram& histogramFromStatName(const StatName& name) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return wrapped_scope_->histogramFromStatName(name);
+  }
+
 private:
   std::mutex& lock_;
   ScopePtr wrapped_scope_;
@@ -152,6 +176,19 @@ public:
     std::unique_lock<std::mutex> lock(lock_);
     return store_.histogram(name);
   }
+  SymbolTable& symbolTable() override { return store_.symbolTable(); }
+  Counter& counterFromStatName(const StatName& name) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return store_.counterFromStatName(name);
+  }
+  Gauge& gaugeFromStatName(const StatName& name) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return store_.gaugeFromStatName(name);
+  }
+  Histogram& histogramFromStatName(const StatName& name) override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return store_.histogramFromStatName(name);
+  }
 
   // Stats::Store
   std::list<CounterSharedPtr> counters() const override {
@@ -162,6 +199,10 @@ public:
     std::unique_lock<std::mutex> lock(lock_);
     return store_.gauges();
   }
+  std::list<ParentHistogramSharedPtr> histograms() const override {
+    std::unique_lock<std::mutex> lock(lock_);
+    return store_.histograms();
+  }
 
   // Stats::StoreRoot
   void addSink(Sink&) override {}
@@ -520,6 +520,8 @@ TEST_P(XfccIntegrationTest, TagExtractedNameGenerationTest) {
         {"http.admin.downstream_cx_destroy_local", "http.downstream_cx_destroy_local"},
         {"listener_manager.listener_added", "listener_manager.listener_added"},
         {"filesystem.write_completed", "filesystem.write_completed"},
+        {"filesystem.write_dropped", "filesystem.write_dropped"},
+        {"filesystem.write_blocked", "filesystem.write_blocked"},
         {"http.admin.downstream_rq_response_before_rq_complete",
          "http.downstream_rq_response_before_rq_complete"},
         {"http.admin.downstream_cx_tx_bytes_total", "http.downstream_cx_tx_bytes_total"},
@@ -841,6 +843,8 @@ TEST_P(XfccIntegrationTest, TagExtractedNameGenerationTest) {
         {"http.admin.downstream_cx_destroy_local", "http.downstream_cx_destroy_local"},
         {"listener_manager.listener_added", "listener_manager.listener_added"},
         {"filesystem.write_completed", "filesystem.write_completed"},
+        {"filesystem.write_dropped", "filesystem.write_dropped"},
+        {"filesystem.write_blocked", "filesystem.write_blocked"},
         {"http.admin.downstream_rq_response_before_rq_complete",
          "http.downstream_rq_response_before_rq_complete"},
         {"http.admin.downstream_cx_tx_bytes_total", "http.downstream_cx_tx_bytes_total"},
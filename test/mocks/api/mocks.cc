@@ -37,5 +37,15 @@ ssize_t MockOsSysCalls::write(int fd, const void* buffer, size_t num_bytes) {
   return result;
 }
 
+ssize_t MockOsSysCalls::writev(int fd, const iovec* iov, int iovcnt) {
+  std::unique_lock<Thread::BasicLockable> lock(write_mutex_);
+
+  ssize_t result = writev_(fd, iov, iovcnt);
+  num_writes_++;
+  write_event_.notify_one();
+
+  return result;
+}
+
 } // namespace Api
 } // namespace Envoy
@@ -43,11 +43,13 @@ public:
 
   // Api::OsSysCalls
   ssize_t write(int fd, const void* buffer, size_t num_bytes) override;
+  ssize_t writev(int fd, const iovec* iov, int iovcnt) override;
   int open(const std::string& full_path, int flags, int mode) override;
   MOCK_METHOD3(bind, int(int sockfd, const sockaddr* addr, socklen_t addrlen));
   MOCK_METHOD1(close, int(int));
   MOCK_METHOD3(open_, int(const std::string& full_path, int flags, int mode));
   MOCK_METHOD3(write_, ssize_t(int, const void*, size_t));
+  MOCK_METHOD3(writev_, ssize_t(int, const iovec*, int));
   MOCK_METHOD3(shmOpen, int(const char*, int, mode_t));
   MOCK_METHOD1(shmUnlink, int(const char*));
   MOCK_METHOD2(ftruncate, int(int fd, off_t length));
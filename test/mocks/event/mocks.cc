@@ -7,6 +7,7 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnNew;
+using testing::ReturnRef;
 using testing::SaveArg;
 using testing::_;
 
@@ -19,6 +20,7 @@ MockDispatcher::MockDispatcher() {
   }));
   ON_CALL(*this, createTimer_(_)).WillByDefault(ReturnNew<NiceMock<Event::MockTimer>>());
   ON_CALL(*this, post(_)).WillByDefault(Invoke([](PostCb cb) -> void { cb(); }));
+  ON_CALL(*this, timeSource()).WillByDefault(ReturnRef(time_source_));
 }
 
 MockDispatcher::~MockDispatcher() {}
@@ -16,6 +16,8 @@
 #include "envoy/network/listener.h"
 #include "envoy/ssl/context.h"
 
+#include "test/mocks/common.h"
+
 #include "gmock/gmock.h"
 
 namespace Envoy {
@@ -110,6 +112,9 @@ public:
   MOCK_METHOD1(post, void(std::function<void()> callback));
   MOCK_METHOD1(run, void(RunType type));
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
+  MOCK_METHOD0(timeSource, MonotonicTimeSource&());
+
+  testing::NiceMock<MockMonotonicTimeSource> time_source_;
 
 private:
   std::list<DeferredDeletablePtr> to_delete_;
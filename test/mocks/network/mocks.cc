@@ -129,6 +129,9 @@ MockFilter::~MockFilter() {}
 MockListenerCallbacks::MockListenerCallbacks() {}
 MockListenerCallbacks::~MockListenerCallbacks() {}
 
+MockBalancedListener::MockBalancedListener() {}
+MockBalancedListener::~MockBalancedListener() {}
+
 MockDrainDecision::MockDrainDecision() {}
 MockDrainDecision::~MockDrainDecision() {}
 
@@ -193,6 +193,16 @@ public:
   MOCK_METHOD1(onNewConnection_, void(ConnectionPtr& conn));
 };
 
+class MockBalancedListener : public BalancedListener {
+public:
+  MockBalancedListener();
+  ~MockBalancedListener();
+
+  MOCK_METHOD0(numConnections, uint64_t());
+  MOCK_METHOD4(post, void(int fd, Address::InstanceConstSharedPtr remote_address,
+                          Address::InstanceConstSharedPtr local_address, bool using_original_dst));
+};
+
 class MockDrainDecision : public DrainDecision {
 public:
   MockDrainDecision();
@@ -33,6 +33,22 @@ public:
                                           uint64_t random_value, uint16_t num_buckets));
   MOCK_CONST_METHOD1(get, const std::string&(const std::string& key));
   MOCK_CONST_METHOD2(getInteger, uint64_t(const std::string& key, uint64_t default_value));
+
+  // Lookups by registered key are forwarded to the mocked lookups by name.
+  bool featureEnabled(const Key& key, uint64_t default_value) const override {
+    return featureEnabled(key.name(), default_value);
+  }
+  bool featureEnabled(const Key& key, uint64_t default_value,
+                      uint64_t random_value) const override {
+    return featureEnabled(key.name(), default_value, random_value);
+  }
+  bool featureEnabled(const Key& key, uint64_t default_value, uint64_t random_value,
+                      uint16_t num_buckets) const override {
+    return featureEnabled(key.name(), default_value, random_value, num_buckets);
+  }
+  uint64_t getInteger(const Key& key, uint64_t default_value) const override {
+    return getInteger(key.name(), default_value);
+  }
 };
 
 class MockLoader : public Loader {
@@ -42,6 +58,9 @@ public:
 
   MOCK_METHOD0(snapshot, Snapshot&());
 
+  // MockSnapshot looks registered keys up by name, so the index is never used.
+  Key registerKey(const std::string& name) override { return Key(name, 0); }
+
   testing::NiceMock<MockSnapshot> snapshot_;
 };
 
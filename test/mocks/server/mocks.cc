@@ -53,6 +53,7 @@ MockHotRestart::~MockHotRestart() {}
 MockListenerComponentFactory::MockListenerComponentFactory()
     : socket_(std::make_shared<NiceMock<Network::MockListenSocket>>()) {
   ON_CALL(*this, createListenSocket(_, _)).WillByDefault(Return(socket_));
+  ON_CALL(*this, createReusePortListenSocket(_, _)).WillByDefault(Return(socket_));
 }
 MockListenerComponentFactory::~MockListenerComponentFactory() {}
 
@@ -62,6 +63,7 @@ MockListenerManager::~MockListenerManager() {}
 MockListener::MockListener() {
   ON_CALL(*this, filterChainFactory()).WillByDefault(ReturnRef(filter_chain_factory_));
   ON_CALL(*this, socket()).WillByDefault(ReturnRef(socket_));
+  ON_CALL(*this, workerSocket(_)).WillByDefault(Return(&socket_));
   ON_CALL(*this, listenerScope()).WillByDefault(ReturnRef(scope_));
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
 }
@@ -55,12 +55,17 @@ public:
   MOCK_METHOD0(parentShutdownTime, std::chrono::seconds());
   MOCK_METHOD0(restartEpoch, uint64_t());
   MOCK_METHOD0(fileFlushIntervalMsec, std::chrono::milliseconds());
+  MOCK_METHOD0(fileOverflowPolicy, Filesystem::WriteOverflowPolicy());
   MOCK_CONST_METHOD0(mode, Mode());
   MOCK_METHOD0(serviceClusterName, const std::string&());
   MOCK_METHOD0(serviceNodeName, const std::string&());
   MOCK_METHOD0(serviceZone, const std::string&());
   MOCK_METHOD0(maxStats, uint64_t());
   MOCK_METHOD0(maxObjNameLength, uint64_t());
+  MOCK_METHOD0(sslSessionCacheSize, uint64_t());
+  MOCK_METHOD0(listenerReusePort, bool());
+  MOCK_METHOD0(listenerAcceptBatchSize, uint32_t());
+  MOCK_METHOD0(listenerBalanceConnections, bool());
 
   std::string config_path_;
   bool v2_config_only_{};
@@ -127,13 +132,15 @@ public:
 
   // Server::HotRestart
   MOCK_METHOD0(drainParentListeners, void());
-  MOCK_METHOD1(duplicateParentListenSocket, int(const std::string& address));
+  MOCK_METHOD3(duplicateParentListenSocket,
+               int(const std::string& address, uint32_t worker_index, uint32_t& parent_sockets));
   MOCK_METHOD1(getParentStats, void(GetParentStatsInfo& info));
   MOCK_METHOD2(initialize, void(Event::Dispatcher& dispatcher, Server::Instance& server));
   MOCK_METHOD1(shutdownParentAdmin, void(ShutdownParentAdminInfo& info));
   MOCK_METHOD0(terminateParent, void());
   MOCK_METHOD0(shutdown, void());
   MOCK_METHOD0(version, std::string());
+  MOCK_METHOD0(sslSessionCache, Ssl::SessionCache*());
 };
 
 class MockListenerComponentFactory : public ListenerComponentFactory {
@@ -152,6 +159,9 @@ public:
   MOCK_METHOD2(createListenSocket,
                Network::ListenSocketSharedPtr(Network::Address::InstanceConstSharedPtr address,
                                               bool bind_to_port));
+  MOCK_METHOD2(createReusePortListenSocket,
+               Network::ListenSocketSharedPtr(Network::Address::InstanceConstSharedPtr address,
+                                              uint32_t worker_index));
   MOCK_METHOD1(createDrainManager_, DrainManager*(envoy::api::v2::Listener::DrainType drain_type));
   MOCK_METHOD0(nextListenerTag, uint64_t());
 
@@ -179,11 +189,14 @@ public:
 
   MOCK_METHOD0(filterChainFactory, Network::FilterChainFactory&());
   MOCK_METHOD0(socket, Network::ListenSocket&());
+  MOCK_METHOD1(workerSocket, Network::ListenSocket*(uint32_t worker_index));
   MOCK_METHOD0(defaultSslContext, Ssl::ServerContext*());
   MOCK_METHOD0(useProxyProto, bool());
   MOCK_METHOD0(bindToPort, bool());
   MOCK_METHOD0(useOriginalDst, bool());
   MOCK_METHOD0(perConnectionBufferLimitBytes, uint32_t());
+  MOCK_METHOD0(acceptBatchSize, uint32_t());
+  MOCK_METHOD0(connectionBalancer, Network::ConnectionBalancer*());
   MOCK_METHOD0(listenerScope, Stats::Scope&());
   MOCK_METHOD0(listenerTag, uint64_t());
   MOCK_CONST_METHOD0(name, const std::string&());
@@ -200,7 +213,7 @@ public:
   ~MockWorkerFactory();
 
   // Server::WorkerFactory
-  WorkerPtr createWorker() override { return WorkerPtr{createWorker_()}; }
+  WorkerPtr createWorker(uint32_t) override { return WorkerPtr{createWorker_()}; }
 
   MOCK_METHOD0(createWorker_, Worker*());
 };
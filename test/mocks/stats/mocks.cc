@@ -48,6 +48,16 @@ MockStore::MockStore() {
     histograms_.emplace_back(histogram);
     return *histogram;
   }));
+  // Stats looked up by StatName are looked up again by string, so that tests can expect either.
+  ON_CALL(*this, counterFromStatName(_))
+      .WillByDefault(
+          Invoke([this](const StatName& name) -> Counter& { return counter(name.toString()); }));
+  ON_CALL(*this, gaugeFromStatName(_)).WillByDefault(Invoke([this](const StatName& name) -> Gauge& {
+    return gauge(name.toString());
+  }));
+  ON_CALL(*this, histogramFromStatName(_))
+      .WillByDefault(Invoke(
+          [this](const StatName& name) -> Histogram& { return histogram(name.toString()); }));
 }
 MockStore::~MockStore() {}
 
@@ -84,6 +84,7 @@ public:
   MOCK_METHOD2(flushGauge, void(const Gauge& gauge, uint64_t value));
   MOCK_METHOD0(endFlush, void());
   MOCK_METHOD2(onHistogramComplete, void(const Histogram& histogram, uint64_t value));
+  MOCK_METHOD1(flushHistogram, void(const ParentHistogram& histogram));
 };
 
 class MockStore : public Store {
@@ -100,7 +101,13 @@ public:
   MOCK_METHOD1(gauge, Gauge&(const std::string&));
   MOCK_CONST_METHOD0(gauges, std::list<GaugeSharedPtr>());
   MOCK_METHOD1(histogram, Histogram&(const std::string& name));
+  MOCK_CONST_METHOD0(histograms, std::list<ParentHistogramSharedPtr>());
+  SymbolTable& symbolTable() override { return symbol_table_; }
+  MOCK_METHOD1(counterFromStatName, Counter&(const StatName& name));
+  MOCK_METHOD1(gaugeFromStatName, Gauge&(const StatName& name));
+  MOCK_METHOD1(histogramFromStatName, Histogram&(const StatName& name));
 
+  SymbolTableImpl symbol_table_;
   testing::NiceMock<MockCounter> counter_;
   std::vector<std::unique_ptr<MockHistogram>> histograms_;
 };
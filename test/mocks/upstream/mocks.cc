@@ -27,6 +27,20 @@ MockHostSet::MockHostSet() {
   ON_CALL(*this, healthyHosts()).WillByDefault(ReturnRef(healthy_hosts_));
   ON_CALL(*this, hostsPerLocality()).WillByDefault(ReturnRef(hosts_per_locality_));
   ON_CALL(*this, healthyHostsPerLocality()).WillByDefault(ReturnRef(healthy_hosts_per_locality_));
+  ON_CALL(*this, hostsPtr()).WillByDefault(Invoke([this]() -> HostVectorConstSharedPtr {
+    return std::make_shared<const std::vector<HostSharedPtr>>(hosts_);
+  }));
+  ON_CALL(*this, healthyHostsPtr()).WillByDefault(Invoke([this]() -> HostVectorConstSharedPtr {
+    return std::make_shared<const std::vector<HostSharedPtr>>(healthy_hosts_);
+  }));
+  ON_CALL(*this, hostsPerLocalityPtr()).WillByDefault(Invoke([this]() -> HostListsConstSharedPtr {
+    return std::make_shared<const std::vector<std::vector<HostSharedPtr>>>(hosts_per_locality_);
+  }));
+  ON_CALL(*this, healthyHostsPerLocalityPtr())
+      .WillByDefault(Invoke([this]() -> HostListsConstSharedPtr {
+        return std::make_shared<const std::vector<std::vector<HostSharedPtr>>>(
+            healthy_hosts_per_locality_);
+      }));
 }
 
 MockPrioritySet::MockPrioritySet() {
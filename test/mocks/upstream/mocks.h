@@ -42,6 +42,10 @@ public:
   MOCK_CONST_METHOD0(healthyHosts, const std::vector<HostSharedPtr>&());
   MOCK_CONST_METHOD0(hostsPerLocality, const std::vector<std::vector<HostSharedPtr>>&());
   MOCK_CONST_METHOD0(healthyHostsPerLocality, const std::vector<std::vector<HostSharedPtr>>&());
+  MOCK_CONST_METHOD0(hostsPtr, HostVectorConstSharedPtr());
+  MOCK_CONST_METHOD0(healthyHostsPtr, HostVectorConstSharedPtr());
+  MOCK_CONST_METHOD0(hostsPerLocalityPtr, HostListsConstSharedPtr());
+  MOCK_CONST_METHOD0(healthyHostsPerLocalityPtr, HostListsConstSharedPtr());
   MOCK_METHOD6(
       updateHosts,
       void(
@@ -7,6 +7,7 @@
 #include "common/config/well_known_names.h"
 #include "common/dynamo/dynamo_filter.h"
 
+#include "server/config/access_log/binary_file_access_log.h"
 #include "server/config/access_log/file_access_log.h"
 #include "server/config/network/client_ssl_auth.h"
 #include "server/config/network/http_connection_manager.h"
@@ -516,6 +517,33 @@ TEST(AccessLogConfigTest, FileAccessLogTest) {
   EXPECT_NE(nullptr, dynamic_cast<AccessLog::FileAccessLog*>(instance.get()));
 }
 
+TEST(AccessLogConfigTest, BinaryFileAccessLogTest) {
+  auto factory = Registry::FactoryRegistry<AccessLogInstanceFactory>::getFactory(
+      Config::AccessLogNames::get().BINARY_FILE);
+  ASSERT_NE(nullptr, factory);
+
+  ProtobufTypes::MessagePtr message = factory->createEmptyConfigProto();
+  ASSERT_NE(nullptr, message);
+
+  envoy::api::v2::filter::accesslog::FileAccessLog file_access_log;
+  file_access_log.set_path("/dev/null");
+  MessageUtil::jsonConvert(file_access_log, *message);
+
+  AccessLog::FilterPtr filter;
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+
+  AccessLog::InstanceSharedPtr instance =
+      factory->createAccessLogInstance(*message, std::move(filter), context);
+  EXPECT_NE(nullptr, instance);
+  EXPECT_NE(nullptr, dynamic_cast<AccessLog::FileAccessLog*>(instance.get()));
+
+  file_access_log.set_format("%START_TIME%");
+  MessageUtil::jsonConvert(file_access_log, *message);
+  EXPECT_THROW_WITH_MESSAGE(factory->createAccessLogInstance(*message, nullptr, context),
+                            EnvoyException,
+                            "envoy.binary_file_access_log: format is not supported");
+}
+
 // Test that a minimal TcpProxy v2 config works.
 TEST(TcpProxyConfigTest, TcpProxyConfigTest) {
   NiceMock<MockFactoryContext> context;
@@ -51,6 +51,8 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   EXPECT_CALL(factory_, createFilterChain(_)).WillOnce(Return(true));
   listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
   EXPECT_EQ(1UL, handler_->numConnections());
+  EXPECT_EQ(1UL, stats_store_.counter("main_thread.downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("main_thread.downstream_cx_active").value());
 
   // Test stop/remove of not existent listener.
   handler_->stopListeners(0);
@@ -63,12 +65,41 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
   handler_->removeListeners(1);
   EXPECT_EQ(0UL, handler_->numConnections());
+  EXPECT_EQ(0UL, stats_store_.gauge("main_thread.downstream_cx_active").value());
 
   // Test stop/remove of not existent listener.
   handler_->stopListeners(0);
   handler_->removeListeners(0);
 }
 
+TEST_F(ConnectionHandlerTest, WorkerStats) {
+  handler_.reset(new ConnectionHandlerImpl(ENVOY_LOGGER(), dispatcher_, 3));
+
+  Network::MockListener* listener = new NiceMock<Network::MockListener>();
+  Network::ListenerCallbacks* listener_callbacks;
+  EXPECT_CALL(dispatcher_, createListener_(_, _, _, _, _))
+      .WillOnce(Invoke([&](Network::ConnectionHandler&, Network::ListenSocket&,
+                           Network::ListenerCallbacks& cb, Stats::Scope&,
+                           const Network::ListenerOptions&) -> Network::Listener* {
+        listener_callbacks = &cb;
+        return listener;
+      }));
+  handler_->addListener(factory_, socket_, stats_store_, 1,
+                        Network::ListenerOptions::listenerOptionsWithBindToPort());
+
+  Network::MockConnection* connection = new NiceMock<Network::MockConnection>();
+  EXPECT_CALL(factory_, createFilterChain(_)).WillOnce(Return(true));
+  listener_callbacks->onNewConnection(Network::ConnectionPtr{connection});
+  EXPECT_EQ(1UL, stats_store_.counter("downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.counter("worker_3.downstream_cx_total").value());
+  EXPECT_EQ(1UL, stats_store_.gauge("worker_3.downstream_cx_active").value());
+
+  EXPECT_CALL(*listener, onDestroy());
+  EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+  handler_->removeListeners(1);
+  EXPECT_EQ(0UL, stats_store_.gauge("worker_3.downstream_cx_active").value());
+}
+
 TEST_F(ConnectionHandlerTest, DestroyCloseConnections) {
   InSequence s;
 
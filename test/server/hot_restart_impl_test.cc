@@ -58,7 +58,30 @@ TEST_F(HotRestartImplTest, versionString) {
   EXPECT_EQ(hot_restart_->version(),
             Envoy::Server::SharedMemory::version(options_.maxStats(),
                                                  options_.maxObjNameLength() +
-                                                     Stats::RawStatData::maxStatSuffixLength()));
+                                                     Stats::RawStatData::maxStatSuffixLength(),
+                                                 options_.sslSessionCacheSize()));
+  EXPECT_EQ(nullptr, hot_restart_->sslSessionCache());
+}
+
+// Sessions cached by one generation can be resumed by the next.
+TEST_F(HotRestartImplTest, sslSessionCache) {
+  EXPECT_CALL(options_, sslSessionCacheSize()).WillRepeatedly(Return(64));
+  setup();
+  Ssl::SessionCache* cache = hot_restart_->sslSessionCache();
+  ASSERT_NE(nullptr, cache);
+  const std::vector<uint8_t> id{1, 2, 3};
+  const std::vector<uint8_t> session{4, 5, 6, 7};
+  EXPECT_TRUE(cache->insert(id.data(), id.size(), session.data(), session.size(), 0));
+
+  EXPECT_CALL(options_, restartEpoch()).WillRepeatedly(Return(1));
+  EXPECT_CALL(os_sys_calls_, shmOpen(_, _, _));
+  EXPECT_CALL(os_sys_calls_, mmap(_, _, _, _, _, _)).WillOnce(Return(buffer_.data()));
+  EXPECT_CALL(os_sys_calls_, bind(_, _, _));
+  HotRestartImpl hot_restart2(options_);
+  std::vector<uint8_t> found;
+  ASSERT_NE(nullptr, hot_restart2.sslSessionCache());
+  EXPECT_TRUE(hot_restart2.sslSessionCache()->lookup(id.data(), id.size(), found));
+  EXPECT_EQ(session, found);
 }
 
 TEST_F(HotRestartImplTest, crossAlloc) {
@@ -99,6 +122,53 @@ TEST_F(HotRestartImplTest, allocFail) {
   EXPECT_EQ(s3, nullptr);
 }
 
+TEST_F(HotRestartImplTest, allocFreeReuse) {
+  EXPECT_CALL(options_, maxStats()).WillRepeatedly(Return(2));
+  setup();
+
+  Stats::RawStatData* s1 = hot_restart_->alloc("1");
+  Stats::RawStatData* s2 = hot_restart_->alloc("2");
+  EXPECT_EQ(s1, hot_restart_->alloc("1"));
+  EXPECT_EQ(2UL, s1->ref_count_);
+  hot_restart_->free(*s1);
+  EXPECT_EQ(s1, hot_restart_->alloc("1"));
+  hot_restart_->free(*s1);
+  hot_restart_->free(*s1);
+
+  // The freed slot can be used for a new stat, after which the old name is not found.
+  Stats::RawStatData* s3 = hot_restart_->alloc("3");
+  EXPECT_EQ(s1, s3);
+  EXPECT_TRUE(s3->matches("3"));
+  EXPECT_EQ(nullptr, hot_restart_->alloc("1"));
+  EXPECT_EQ(s2, hot_restart_->alloc("2"));
+}
+
+// Churn through many more names than there are slots so that deleted index buckets build up and
+// force the index to be rebuilt, checking that live stats are always found.
+TEST_F(HotRestartImplTest, allocFreeChurn) {
+  const uint64_t num_stats = 16;
+  EXPECT_CALL(options_, maxStats()).WillRepeatedly(Return(num_stats));
+  setup();
+
+  std::vector<Stats::RawStatData*> live;
+  for (uint64_t i = 0; i < num_stats - 1; i++) {
+    live.push_back(hot_restart_->alloc(fmt::format("live.{}", i)));
+  }
+
+  for (uint64_t i = 0; i < 1000; i++) {
+    Stats::RawStatData* stat = hot_restart_->alloc(fmt::format("churn.{}", i));
+    ASSERT_NE(nullptr, stat);
+    EXPECT_EQ(nullptr, hot_restart_->alloc(fmt::format("churn.{}", i + 1)));
+    hot_restart_->free(*stat);
+
+    for (uint64_t j = 0; j < live.size(); j++) {
+      Stats::RawStatData* found = hot_restart_->alloc(fmt::format("live.{}", j));
+      EXPECT_EQ(live[j], found);
+      hot_restart_->free(*found);
+    }
+  }
+}
+
 // Because the shared memory is managed manually, make sure it meets
 // basic requirements:
 //   - Objects are correctly aligned so that std::atomic works properly
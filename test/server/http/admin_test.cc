@@ -2,10 +2,12 @@
 
 #include "common/http/message_impl.h"
 #include "common/profiler/profiler.h"
+#include "common/stats/thread_local_store.h"
 
 #include "server/http/admin.h"
 
 #include "test/mocks/server/mocks.h"
+#include "test/mocks/stats/mocks.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/printers.h"
@@ -15,6 +17,8 @@
 #include "gtest/gtest.h"
 
 using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
 using testing::_;
 
 namespace Envoy {
@@ -148,5 +152,28 @@ TEST_P(AdminInstanceTest, CustomHandler) {
   EXPECT_EQ(Http::Code::Accepted, admin_.runCallback("/foo/bar", response));
 }
 
+TEST_P(AdminInstanceTest, StatsHistograms) {
+  NiceMock<Stats::MockStore> store;
+  Stats::ParentHistogramSharedPtr histogram(
+      new Stats::ParentHistogramImpl("h1", store, "h1", std::vector<Stats::Tag>()));
+  ON_CALL(store, histograms())
+      .WillByDefault(Return(std::list<Stats::ParentHistogramSharedPtr>{histogram}));
+  ON_CALL(server_, stats()).WillByDefault(ReturnRef(store));
+
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::OK, admin_.runCallback("/stats", response));
+  EXPECT_EQ("h1: No recorded values\n", TestUtility::bufferToString(response));
+
+  histogram->recordValue(1);
+  histogram->recordValue(2);
+  histogram->merge();
+  histogram->merge();
+  response.drain(response.length());
+  EXPECT_EQ(Http::Code::OK, admin_.runCallback("/stats", response));
+  EXPECT_EQ("h1: P0(nan,1.0) P25(nan,1.0) P50(nan,1.0) P75(nan,2.0) P90(nan,2.0) P95(nan,2.0) "
+            "P99(nan,2.0) P99.9(nan,2.0) P100(nan,2.0)\n",
+            TestUtility::bufferToString(response));
+}
+
 } // namespace Server
 } // namespace Envoy
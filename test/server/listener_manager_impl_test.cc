@@ -1,3 +1,6 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+
 #include "envoy/registry/registry.h"
 
 #include "common/network/address_impl.h"
@@ -12,10 +15,12 @@
 
 #include "gtest/gtest.h"
 
+using testing::DoAll;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
+using testing::SetArgReferee;
 using testing::Throw;
 using testing::_;
 
@@ -741,6 +746,150 @@ TEST_F(ListenerManagerImplTest, DuplicateAddressDontBind) {
   EXPECT_CALL(*listener_foo, onDestroy());
 }
 
+// With SO_REUSEPORT listeners each worker gets a socket of its own, and listener updates keep the
+// sockets.
+TEST_F(ListenerManagerImplTest, ReusePort) {
+  InSequence s;
+
+  ON_CALL(server_.options_, concurrency()).WillByDefault(Return(2));
+  ON_CALL(server_.options_, listenerReusePort()).WillByDefault(Return(true));
+  MockWorker* worker1 = new MockWorker();
+  MockWorker* worker2 = new MockWorker();
+  EXPECT_CALL(worker_factory_, createWorker_()).WillOnce(Return(worker1)).WillOnce(Return(worker2));
+  manager_.reset(new ListenerManagerImpl(server_, listener_factory_, worker_factory_));
+
+  const std::string listener_foo_json = R"EOF(
+  {
+    "name": "foo",
+    "address": "tcp://127.0.0.1:0",
+    "filters": []
+  }
+  )EOF";
+
+  // The second socket binds the port the first was given.
+  ListenerHandle* listener_foo = expectListenerCreate(false);
+  auto socket1 = std::make_shared<NiceMock<Network::MockListenSocket>>();
+  auto socket2 = std::make_shared<NiceMock<Network::MockListenSocket>>();
+  EXPECT_CALL(listener_factory_, createReusePortListenSocket(_, 0)).WillOnce(Return(socket1));
+  EXPECT_CALL(listener_factory_, createReusePortListenSocket(socket1->local_address_, 1))
+      .WillOnce(Return(socket2));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromJson(listener_foo_json)));
+
+  Listener& listener = manager_->listeners()[0];
+  EXPECT_EQ(socket1.get(), &listener.socket());
+  EXPECT_EQ(socket1.get(), listener.workerSocket(0));
+  EXPECT_EQ(socket2.get(), listener.workerSocket(1));
+  EXPECT_EQ(nullptr, listener.workerSocket(2));
+
+  const std::string listener_foo_update1_json = R"EOF(
+  {
+    "name": "foo",
+    "address": "tcp://127.0.0.1:0",
+    "filters": [
+      { "type" : "read", "name" : "fake", "config" : {} }
+    ]
+  }
+  )EOF";
+
+  ListenerHandle* listener_foo_update1 = expectListenerCreate(false);
+  EXPECT_CALL(*listener_foo, onDestroy());
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromJson(listener_foo_update1_json)));
+  Listener& listener_update1 = manager_->listeners()[0];
+  EXPECT_EQ(socket1.get(), listener_update1.workerSocket(0));
+  EXPECT_EQ(socket2.get(), listener_update1.workerSocket(1));
+
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+}
+
+// Listeners which do not bind keep a single socket.
+TEST_F(ListenerManagerImplTest, ReusePortDontBind) {
+  ON_CALL(server_.options_, concurrency()).WillByDefault(Return(2));
+  ON_CALL(server_.options_, listenerReusePort()).WillByDefault(Return(true));
+  EXPECT_CALL(worker_factory_, createWorker_())
+      .WillOnce(Return(new MockWorker()))
+      .WillOnce(Return(new MockWorker()));
+  manager_.reset(new ListenerManagerImpl(server_, listener_factory_, worker_factory_));
+
+  const std::string listener_foo_json = R"EOF(
+  {
+    "name": "foo",
+    "address": "tcp://0.0.0.0:1234",
+    "filters": [],
+    "bind_to_port": false
+  }
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, false));
+  EXPECT_CALL(listener_factory_, createReusePortListenSocket(_, _)).Times(0);
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromJson(listener_foo_json)));
+
+  Listener& listener = manager_->listeners()[0];
+  EXPECT_EQ(&listener.socket(), listener.workerSocket(0));
+  EXPECT_EQ(&listener.socket(), listener.workerSocket(1));
+
+  EXPECT_CALL(*listener_foo, onDestroy());
+}
+
+// A hot restart which would take over fewer sockets than the parent's SO_REUSEPORT listener has is
+// refused, since nothing would accept on the rest once the parent stops listening.
+TEST_F(ListenerManagerImplTest, ReusePortHotRestartFewerWorkers) {
+  ProdListenerComponentFactory factory(server_);
+  Network::Address::InstanceConstSharedPtr address(
+      new Network::Address::Ipv4Instance("127.0.0.1", 1234));
+  ON_CALL(server_.options_, concurrency()).WillByDefault(Return(2));
+
+  // The parent has a socket for each of its 4 workers.
+  const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  EXPECT_CALL(server_.hot_restart_, duplicateParentListenSocket("tcp://127.0.0.1:1234", 0, _))
+      .WillOnce(DoAll(SetArgReferee<2>(4), Return(fd)));
+  EXPECT_THROW_WITH_MESSAGE(
+      factory.createReusePortListenSocket(address, 0), EnvoyException,
+      "cannot hot restart listener on tcp://127.0.0.1:1234: the parent has 4 SO_REUSEPORT sockets "
+      "for it and this process would take over 2. Use --listener-reuse-port with at least as many "
+      "workers as the parent, or do a full restart.");
+  EXPECT_EQ(-1, fcntl(fd, F_GETFD));
+
+  // Without SO_REUSEPORT only one socket would be taken over.
+  const int fd2 = ::socket(AF_INET, SOCK_STREAM, 0);
+  EXPECT_CALL(server_.hot_restart_, duplicateParentListenSocket("tcp://127.0.0.1:1234", 0, _))
+      .WillOnce(DoAll(SetArgReferee<2>(4), Return(fd2)));
+  EXPECT_THROW(factory.createListenSocket(address, true), EnvoyException);
+  EXPECT_EQ(-1, fcntl(fd2, F_GETFD));
+
+  // With as many workers as the parent, each takes over a socket.
+  ON_CALL(server_.options_, concurrency()).WillByDefault(Return(4));
+  const int fd3 = ::socket(AF_INET, SOCK_STREAM, 0);
+  EXPECT_CALL(server_.hot_restart_, duplicateParentListenSocket("tcp://127.0.0.1:1234", 3, _))
+      .WillOnce(DoAll(SetArgReferee<2>(4), Return(fd3)));
+  EXPECT_EQ(fd3, factory.createReusePortListenSocket(address, 3)->fd());
+}
+
+TEST_F(ListenerManagerImplTest, AcceptOptions) {
+  ON_CALL(server_.options_, listenerAcceptBatchSize()).WillByDefault(Return(16));
+  ON_CALL(server_.options_, listenerBalanceConnections()).WillByDefault(Return(true));
+  EXPECT_CALL(worker_factory_, createWorker_()).WillOnce(Return(new MockWorker()));
+  manager_.reset(new ListenerManagerImpl(server_, listener_factory_, worker_factory_));
+
+  const std::string listener_foo_json = R"EOF(
+  {
+    "name": "foo",
+    "address": "tcp://127.0.0.1:1234",
+    "filters": []
+  }
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, true));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromJson(listener_foo_json)));
+
+  Listener& listener = manager_->listeners()[0];
+  EXPECT_EQ(16U, listener.acceptBatchSize());
+  EXPECT_NE(nullptr, listener.connectionBalancer());
+
+  EXPECT_CALL(*listener_foo, onDestroy());
+}
+
 TEST_F(ListenerManagerImplTest, EarlyShutdown) {
   // If stopWorkers is called before the workers are started, it should be a no-op: they should be
   // neither started nor stopped.
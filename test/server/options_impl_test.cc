@@ -24,9 +24,9 @@ std::unique_ptr<OptionsImpl> createOptionsImpl(const std::string& args) {
   for (const std::string& s : words) {
     argv.push_back(s.c_str());
   }
-  return std::unique_ptr<OptionsImpl>(new OptionsImpl(argv.size(), const_cast<char**>(&argv[0]),
-                                                      [](uint64_t, uint64_t) { return "1"; },
-                                                      spdlog::level::warn));
+  return std::unique_ptr<OptionsImpl>(
+      new OptionsImpl(argv.size(), const_cast<char**>(&argv[0]),
+                      [](uint64_t, uint64_t, uint64_t) { return "1"; }, spdlog::level::warn));
 }
 
 TEST(OptionsImplTest, HotRestartVersion) {
@@ -60,8 +60,10 @@ TEST(OptionsImplTest, All) {
   std::unique_ptr<OptionsImpl> options = createOptionsImpl(
       "envoy --mode validate --concurrency 2 -c hello --admin-address-path path --restart-epoch 1 "
       "--local-address-ip-version v6 -l info --service-cluster cluster --service-node node "
-      "--service-zone zone --file-flush-interval-msec 9000 --drain-time-s 60 "
-      "--parent-shutdown-time-s 90 --log-path /foo/bar --v2-config-only");
+      "--service-zone zone --file-flush-interval-msec 9000 --file-overflow-policy sample "
+      "--drain-time-s 60 --parent-shutdown-time-s 90 --log-path /foo/bar --v2-config-only "
+      "--ssl-session-cache-size 1024 --listener-reuse-port --listener-accept-batch-size 16 "
+      "--listener-balance-connections");
   EXPECT_EQ(Server::Mode::Validate, options->mode());
   EXPECT_EQ(2U, options->concurrency());
   EXPECT_EQ("hello", options->configPath());
@@ -75,8 +77,13 @@ TEST(OptionsImplTest, All) {
   EXPECT_EQ("node", options->serviceNodeName());
   EXPECT_EQ("zone", options->serviceZone());
   EXPECT_EQ(std::chrono::milliseconds(9000), options->fileFlushIntervalMsec());
+  EXPECT_EQ(Filesystem::WriteOverflowPolicy::Sample, options->fileOverflowPolicy());
   EXPECT_EQ(std::chrono::seconds(60), options->drainTime());
   EXPECT_EQ(std::chrono::seconds(90), options->parentShutdownTime());
+  EXPECT_EQ(1024U, options->sslSessionCacheSize());
+  EXPECT_TRUE(options->listenerReusePort());
+  EXPECT_EQ(16U, options->listenerAcceptBatchSize());
+  EXPECT_TRUE(options->listenerBalanceConnections());
 }
 
 TEST(OptionsImplTest, DefaultParams) {
@@ -86,6 +93,11 @@ TEST(OptionsImplTest, DefaultParams) {
   EXPECT_EQ("", options->adminAddressPath());
   EXPECT_EQ(Network::Address::IpVersion::v4, options->localAddressIpVersion());
   EXPECT_EQ(Server::Mode::Serve, options->mode());
+  EXPECT_EQ(Filesystem::WriteOverflowPolicy::Spill, options->fileOverflowPolicy());
+  EXPECT_EQ(0U, options->sslSessionCacheSize());
+  EXPECT_FALSE(options->listenerReusePort());
+  EXPECT_EQ(0U, options->listenerAcceptBatchSize());
+  EXPECT_FALSE(options->listenerBalanceConnections());
 }
 
 TEST(OptionsImplTest, BadCliOption) {
@@ -97,6 +109,15 @@ TEST(OptionsImplTest, BadCliOption) {
   }
 }
 
+TEST(OptionsImplTest, BadFileOverflowPolicy) {
+  try {
+    createOptionsImpl("envoy -c hello --file-overflow-policy foo");
+    FAIL();
+  } catch (const MalformedArgvException& e) {
+    EXPECT_THAT(e.what(), HasSubstr("error: unknown file overflow policy 'foo'"));
+  }
+}
+
 TEST(OptionsImplTest, BadObjNameLenOption) {
   try {
     createOptionsImpl("envoy --max-obj-name-len 1");
@@ -1,5 +1,6 @@
 #include "common/common/version.h"
 #include "common/network/address_impl.h"
+#include "common/stats/thread_local_store.h"
 #include "common/thread_local/thread_local_impl.h"
 
 #include "server/server.h"
@@ -13,7 +14,10 @@
 
 using testing::HasSubstr;
 using testing::InSequence;
+using testing::NiceMock;
 using testing::Property;
+using testing::Ref;
+using testing::Return;
 using testing::SaveArg;
 using testing::StrictMock;
 using testing::_;
@@ -35,7 +39,28 @@ TEST(ServerInstanceUtil, flushHelper) {
 
   std::list<Stats::SinkPtr> sinks;
   sinks.emplace_back(std::move(sink));
-  InstanceUtil::flushCountersAndGaugesToSinks(sinks, store);
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
+TEST(ServerInstanceUtil, flushHelperHistograms) {
+  InSequence s;
+
+  NiceMock<Stats::MockStore> store;
+  Stats::ParentHistogramSharedPtr histogram(
+      new Stats::ParentHistogramImpl("hello", store, "hello", std::vector<Stats::Tag>()));
+  histogram->recordValue(5);
+  ON_CALL(store, histograms())
+      .WillByDefault(Return(std::list<Stats::ParentHistogramSharedPtr>{histogram}));
+  std::unique_ptr<Stats::MockSink> sink(new StrictMock<Stats::MockSink>());
+  EXPECT_CALL(*sink, beginFlush());
+  EXPECT_CALL(*sink, flushHistogram(Ref(*histogram)));
+  EXPECT_CALL(*sink, endFlush());
+
+  std::list<Stats::SinkPtr> sinks;
+  sinks.emplace_back(std::move(sink));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+  EXPECT_EQ(1UL, histogram->intervalStatistics().sampleCount());
+  EXPECT_EQ(1UL, histogram->cumulativeStatistics().sampleCount());
 }
 
 class RunHelperTest : public testing::Test {
@@ -12,6 +12,7 @@
 using testing::InSequence;
 using testing::InvokeWithoutArgs;
 using testing::NiceMock;
+using testing::Ref;
 using testing::Return;
 using testing::Throw;
 using testing::_;
@@ -33,7 +34,7 @@ public:
   NiceMock<MockGuardDog> guard_dog_;
   DefaultTestHooks hooks_;
   WorkerImpl worker_{tls_, hooks_, Event::DispatcherPtr{dispatcher_},
-                     Network::ConnectionHandlerPtr{handler_}};
+                     Network::ConnectionHandlerPtr{handler_}, 1};
   Event::TimerPtr no_exit_timer_ = dispatcher_->createTimer([]() -> void {});
 };
 
@@ -126,5 +127,20 @@ TEST_F(WorkerImplTest, ListenerException) {
   worker_.stop();
 }
 
+// A listener with a socket per worker is added on the socket for the worker's index.
+TEST_F(WorkerImplTest, WorkerSocket) {
+  InSequence s;
+
+  NiceMock<MockListener> listener;
+  NiceMock<Network::MockListenSocket> worker_socket;
+  ON_CALL(listener, listenerTag()).WillByDefault(Return(1));
+  EXPECT_CALL(listener, workerSocket(1)).WillOnce(Return(&worker_socket));
+  EXPECT_CALL(*handler_, addListener(_, Ref(worker_socket), _, 1, _));
+  worker_.addListener(listener, [](bool success) -> void { EXPECT_TRUE(success); });
+
+  worker_.start(guard_dog_);
+  worker_.stop();
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -0,0 +1,47 @@
+#include "test/test_common/allocation_counter.h"
+
+#include <atomic>
+#include <cstddef>
+
+#include "common/common/assert.h"
+
+#ifdef TCMALLOC
+#include "gperftools/malloc_hook.h"
+#endif
+
+namespace Envoy {
+
+namespace {
+
+std::atomic<uint64_t> allocations;
+
+#ifdef TCMALLOC
+void onNew(const void*, size_t) { allocations++; }
+#endif
+
+} // namespace
+
+TestAllocationCounter::TestAllocationCounter() {
+  allocations = 0;
+#ifdef TCMALLOC
+  RELEASE_ASSERT(MallocHook::AddNewHook(&onNew));
+#endif
+}
+
+TestAllocationCounter::~TestAllocationCounter() {
+#ifdef TCMALLOC
+  RELEASE_ASSERT(MallocHook::RemoveNewHook(&onNew));
+#endif
+}
+
+uint64_t TestAllocationCounter::count() const { return allocations; }
+
+bool TestAllocationCounter::enabled() {
+#ifdef TCMALLOC
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace Envoy
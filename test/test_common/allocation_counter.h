@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Envoy {
+
+/**
+ * Counts heap allocations made while the counter exists, for tests which guard against allocation
+ * regressions. Allocations are only seen through the tcmalloc hooks, so without tcmalloc nothing
+ * is counted and enabled() is false. Only one counter may exist at a time.
+ */
+class TestAllocationCounter {
+public:
+  TestAllocationCounter();
+  ~TestAllocationCounter();
+
+  /**
+   * @return uint64_t the number of allocations made since the counter was created.
+   */
+  uint64_t count() const;
+
+  /**
+   * @return bool whether allocations can be counted in this build.
+   */
+  static bool enabled();
+};
+
+} // namespace Envoy
@@ -0,0 +1,45 @@
+#include "test/test_common/speed_test.h"
+
+#include <iostream>
+
+#include "fmt/format.h"
+
+namespace Envoy {
+
+namespace {
+
+std::string formatDuration(double ns) {
+  if (ns >= 1000000) {
+    return fmt::format("{:.2f}ms", ns / 1000000);
+  }
+  if (ns >= 1000) {
+    return fmt::format("{:.2f}us", ns / 1000);
+  }
+  return fmt::format("{:.2f}ns", ns);
+}
+
+double perOperation(std::chrono::nanoseconds duration, uint64_t operations) {
+  return duration.count() / static_cast<double>(operations == 0 ? 1 : operations);
+}
+
+} // namespace
+
+void SpeedTest::print(const std::string& name, std::chrono::nanoseconds duration,
+                      uint64_t operations) {
+  std::cout << fmt::format("{}: {} per operation ({} operations in {})", name,
+                           formatDuration(perOperation(duration, operations)), operations,
+                           formatDuration(duration.count()))
+            << std::endl;
+}
+
+void SpeedTest::printThroughput(const std::string& name, std::chrono::nanoseconds duration,
+                                uint64_t operations, uint64_t bytes) {
+  // Bytes per nanosecond is 1000 MB/s.
+  const double mb_per_s = duration.count() == 0 ? 0 : bytes * 1000.0 / duration.count();
+  std::cout << fmt::format("{}: {:.1f} MB/s, {} per operation ({} operations in {})", name,
+                           mb_per_s, formatDuration(perOperation(duration, operations)),
+                           operations, formatDuration(duration.count()))
+            << std::endl;
+}
+
+} // namespace Envoy
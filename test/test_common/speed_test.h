@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace Envoy {
+
+/**
+ * Timing and reporting for the DISABLED_ speed tests, so that they all measure and print results
+ * the same way. Run one with --gtest_also_run_disabled_tests and --test_output=all, and build with
+ * -c opt for meaningful numbers.
+ */
+class SpeedTest {
+public:
+  /**
+   * Time one call of fn. Loops being measured should be inside fn, so that they are not timed
+   * through a function call per iteration.
+   * @param fn supplies the code to time.
+   * @return std::chrono::nanoseconds the time fn took.
+   */
+  template <class Fn> static std::chrono::nanoseconds time(Fn fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                start);
+  }
+
+  /**
+   * Call fn iterations times and print the mean time per call.
+   * @param name supplies the label for the printed result.
+   * @param iterations supplies how many times to call fn.
+   * @param fn supplies the code to time.
+   */
+  template <class Fn> static void run(const std::string& name, uint64_t iterations, Fn fn) {
+    print(name, time([&]() -> void {
+            for (uint64_t i = 0; i < iterations; i++) {
+              fn();
+            }
+          }),
+          iterations);
+  }
+
+  /**
+   * Print the mean time per operation.
+   * @param name supplies the label for the printed result.
+   * @param duration supplies the total time taken.
+   * @param operations supplies how many operations were done in that time.
+   */
+  static void print(const std::string& name, std::chrono::nanoseconds duration,
+                    uint64_t operations);
+
+  /**
+   * Print the mean time per operation and the throughput in MB/s.
+   * @param name supplies the label for the printed result.
+   * @param duration supplies the total time taken.
+   * @param operations supplies how many operations were done in that time.
+   * @param bytes supplies how many bytes were processed in that time.
+   */
+  static void printThroughput(const std::string& name, std::chrono::nanoseconds duration,
+                              uint64_t operations, uint64_t bytes);
+};
+
+} // namespace Envoy
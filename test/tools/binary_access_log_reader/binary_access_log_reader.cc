@@ -0,0 +1,122 @@
+// NOLINT(namespace-envoy)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "envoy/common/exception.h"
+
+#include "common/access_log/access_log_formatter.h"
+#include "common/access_log/binary_access_log_format.h"
+#include "common/common/utility.h"
+
+#include "fmt/format.h"
+
+using Envoy::AccessLog::BinaryAccessLogEntry;
+using Envoy::AccessLog::BinaryAccessLogRecord;
+
+namespace {
+
+std::string durationToString(int64_t duration_us) {
+  if (duration_us == BinaryAccessLogRecord::UNSET_DURATION) {
+    return "-";
+  }
+  return std::to_string(duration_us / 1000);
+}
+
+std::string fieldToString(const BinaryAccessLogEntry& entry,
+                          BinaryAccessLogRecord::StringField field) {
+  return entry.header_->string_lengths_[field] > 0 ? entry.field(field) : "-";
+}
+
+// Render a record the way the default text access log format would.
+std::string entryToString(const BinaryAccessLogEntry& entry) {
+  const BinaryAccessLogRecord& record = *entry.header_;
+  Envoy::Optional<Envoy::Http::Protocol> protocol;
+  if (record.protocol_ != 0) {
+    protocol.value(static_cast<Envoy::Http::Protocol>(record.protocol_ - 1));
+  }
+  const Envoy::SystemTime start_time{std::chrono::microseconds(record.start_time_us_)};
+
+  return fmt::format("[{}] \"{} {} {}\" {} 0x{:x} {} {} {} {} \"{}\" \"{}\" \"{}\" \"{}\" \"{}\"",
+                     Envoy::AccessLogDateTimeFormatter::fromTime(start_time),
+                     fieldToString(entry, BinaryAccessLogRecord::Method),
+                     fieldToString(entry, BinaryAccessLogRecord::Path),
+                     Envoy::AccessLog::AccessLogFormatUtils::protocolToString(protocol),
+                     record.response_code_, record.response_flags_, record.bytes_received_,
+                     record.bytes_sent_, record.duration_us_ / 1000,
+                     durationToString(record.response_received_duration_us_),
+                     fieldToString(entry, BinaryAccessLogRecord::ForwardedFor),
+                     fieldToString(entry, BinaryAccessLogRecord::UserAgent),
+                     fieldToString(entry, BinaryAccessLogRecord::RequestId),
+                     fieldToString(entry, BinaryAccessLogRecord::Authority),
+                     fieldToString(entry, BinaryAccessLogRecord::UpstreamHost));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  const bool summary = argc == 3 && std::string(argv[2]) == "--summary";
+  if (argc != 2 && !summary) {
+    std::cerr << "Usage: binary_access_log_reader PATH [--summary]\n"
+                 "\nPrint the records of a binary access log as text.\n"
+                 "\n\tPATH - the log written by envoy.binary_file_access_log."
+                 "\n\t--summary - only print the number of records and the scan rate."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const int fd = open(argv[1], O_RDONLY);
+  struct stat info;
+  if (fd == -1 || fstat(fd, &info) == -1) {
+    std::cerr << fmt::format("unable to open '{}': {}", argv[1], strerror(errno)) << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (info.st_size == 0) {
+    return EXIT_SUCCESS;
+  }
+
+  // The mapping is page aligned, which satisfies the alignment of the records.
+  void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    std::cerr << fmt::format("unable to map '{}': {}", argv[1], strerror(errno)) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Envoy::AccessLog::BinaryAccessLogReader reader(static_cast<const char*>(data), info.st_size);
+  BinaryAccessLogEntry entry;
+  uint64_t num_records = 0;
+  const auto start = std::chrono::steady_clock::now();
+  try {
+    while (reader.next(entry)) {
+      num_records++;
+      if (!summary) {
+        std::cout << entryToString(entry) << "\n";
+      }
+    }
+  } catch (const Envoy::EnvoyException& ex) {
+    std::cerr << ex.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  if (summary) {
+    std::cout << fmt::format("{} records in {:.3f}s ({:.0f} records/s)", num_records,
+                             elapsed.count(), num_records / elapsed.count())
+              << std::endl;
+  }
+  if (reader.offset() != static_cast<uint64_t>(info.st_size)) {
+    std::cerr << fmt::format("ignoring {} bytes of partial record at the end of the log",
+                             info.st_size - reader.offset())
+              << std::endl;
+  }
+
+  munmap(data, info.st_size);
+  return EXIT_SUCCESS;
+}